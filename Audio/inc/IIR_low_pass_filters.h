@@ -19,6 +19,7 @@
 /* HISTORY                                                                   */
 /*   Revision 1.00                                                           */
 /*   3rd December 2002. Created by Richard Sikora.                           */
+/*   18th October 2026. Tables moved to IIR_low_pass_filters.c.              */
 /*                                                                           */
 /*****************************************************************************/
 /*
@@ -58,56 +59,39 @@
 #ifndef IIR_LOW_PASS_FILTERS_H
 #define IIR_LOW_PASS_FILTERS_H
 
+/* Defined in IIR_low_pass_filters.c */
+
 /*****************************************************************************/
 /* First order IIR low pass filters.                                         */
 /*****************************************************************************/
 
-const signed int first_order_low_pass_1000Hz[6] = { 2015, 2015, 32767, -28736 };
-
-const signed int first_order_low_pass_2000Hz[6] = {3812, 3812, 32767, -25143 };
-
-const signed int first_order_low_pass_4000Hz[6] = { 6924, 6924, 32767, -18918 };
+extern const signed int first_order_low_pass_1000Hz[6];
+extern const signed int first_order_low_pass_2000Hz[6];
+extern const signed int first_order_low_pass_4000Hz[6];
 
 /*****************************************************************************/
 /* Second order IIR low pass filters.                                        */
 /*****************************************************************************/
 
-/* Second order low pass filter 300 Hz */
-const signed int IIR_low_pass_300Hz[6]  = {    13,     13,    13, 
-                                            32767, -31857,  30997 };
-
-/* Second order low pass filter 600 Hz */
-const signed int IIR_low_pass_600Hz[6]  = {    48,     48,    48, 
-                                            32767, -30949, 29322  };
-
-/* Second order low pass filter 1000 Hz */
-const signed int IIR_low_pass_1000Hz[6] = {   128,    128,   128, 
-                                            32767, -29742, 27330  };
-
-/* Second order low pass filter 1200 Hz */
-const signed int IIR_low_pass_1200Hz[6] = {   181,    181,   181, 
-                                            32767, -29096, 26150  };
-
-/* Second order low pass filter 2000 Hz */
-const signed int IIR_low_pass_2000Hz[6] = {    472,    472,   472,
-                                             32767, -26754, 22629  };
+extern const signed int IIR_low_pass_300Hz[6];
+extern const signed int IIR_low_pass_600Hz[6];
+extern const signed int IIR_low_pass_1000Hz[6];
+extern const signed int IIR_low_pass_1200Hz[6];
+extern const signed int IIR_low_pass_2000Hz[6];
+extern const signed int IIR_low_pass_2400Hz[6];
+extern const signed int IIR_low_pass_4000Hz[6];
+extern const signed int IIR_low_pass_4800Hz[6];
+extern const signed int IIR_low_pass_9600Hz[6];
 
-/* Second order low pass filter 2400 Hz */
-const signed int IIR_low_pass_2400Hz[6] = {    658,    658,   658,
-                                             32767, -25575, 21015  };
+/* The second order tables in order of cutoff, for a choice made at run      */
+/* time. All are in .coeffs, as any of them may be used for every sample.    */
 
-/* Second order low pass filter 4000 Hz */
-const signed int IIR_low_pass_4000Hz[6] = {   1622,   1622,  1622, 
-                                             32767, -20964, 15649  };
+#define IIR_LOW_PASS_TABLES     9
+#define IIR_LOW_PASS_4800HZ     7       /* Index of IIR_low_pass_4800Hz     */
 
-/* Second order low pass filter 4800 Hz */
-const signed int IIR_low_pass_4800Hz[6] = {   2210,   2210,  2210, 
-                                             32767, -18726, 13526  };
+extern const signed int * const IIR_low_pass_tables[IIR_LOW_PASS_TABLES];
+extern const unsigned int IIR_low_pass_cutoffs[IIR_LOW_PASS_TABLES]; /* Hz  */
 
-/* Second order low pass filter 9600 Hz */
-const signed int IIR_low_pass_9600Hz[6] = {   6769,   6769,  6768, 
-                                             32767,  -6053,  6416  };
-                                             
 #endif
 
 /*****************************************************************************/
@@ -60,6 +60,7 @@
  #define PLL_H
 
  int pll_frequency_setup(unsigned int frequency);
+ int pll_setup_hz(unsigned long hz);
 
 #endif
 
@@ -1,29 +1,82 @@
 /*****************************************************************************/
 /*                                                                           */
-/* FILENAME                                                                  */ 
-/* 	 SweepGenerator.h                                                        */                           
+/* FILENAME                                                                  */
+/* 	 SweepGenerator.h                                                        */
 /*                                                                           */
 /* DESCRIPTION                                                               */
 /*   TMS320VC5505 USB Stick.                                                 */
-/*   Header file for converting from stereo to mono.                         */
+/*   Header file for exponential sweep generator and swept-sine impulse      */
+/*   response measurement.                                                   */
 /*                                                                           */
 /* REVISION                                                                  */
-/*   Revision: 1.00	                                                         */ 
-/*   Author  : Richard Sikora                                                */ 
+/*   Revision: 1.00	                                                         */
+/*   Author  : Richard Sikora                                                */
 /*---------------------------------------------------------------------------*/
 /*                                                                           */
 /* HISTORY                                                                   */
 /*   Revision 1.00                                                           */
 /*   8th February 2010. Created by Richard Sikora.                           */
+/*   Revision 1.01                                                           */
+/*   18th October 2026. Continuous sweep and impulse response measurement.   */
 /*                                                                           */
 /*****************************************************************************/
 
 #ifndef SWEEPGENERATOR_H
 #define SWEEPGENERATOR_H
 
+#include "tms320.h"
+
+/* Impulse response measurement. 100 Hz to 20000 Hz in 8192 samples */
+
+#define SWEEP_MEASURE_F1            100
+#define SWEEP_MEASURE_F2            20000
+#define SWEEP_MEASURE_LENGTH        8192    /* Samples of sweep             */
+#define SWEEP_MEASURE_TAIL          1024    /* Extra samples recorded       */
+#define SWEEP_MEASURE_AMPLITUDE     16384   /* -6 dBFS                      */
+#define SWEEP_IR_LENGTH             512     /* Linear impulse response      */
+#define SWEEP_IR_PRE                32      /* Samples kept before the peak */
+#define SWEEP_HARMONICS             3       /* 2nd, 3rd and 4th harmonics   */
+#define SWEEP_HARMONIC_LENGTH       128
+
+typedef struct
+{
+    unsigned long phase;            /* 2^32 represents 2 pi                 */
+    unsigned long increment;        /* Phase step per sample                */
+    unsigned long start_increment;  /* Phase step at the start frequency    */
+    unsigned long rate;             /* Increment multiplier - 1, Q30        */
+    unsigned long fraction;         /* Remainder of increment, Q30          */
+    unsigned long length;           /* Samples from start to stop frequency */
+    unsigned long count;            /* Samples since start of this sweep    */
+    signed int amplitude;           /* Peak value 0 to 32767                */
+    unsigned long sampling_frequency;
+} SWEEP;
+
+typedef enum
+{
+    SWEEP_IDLE,
+    SWEEP_RECORDING,
+    SWEEP_COMPLETE
+} SWEEP_STATE;
+
+void sweep_init(SWEEP *sweep, unsigned long SamplingFrequency,
+                unsigned int start_frequency, unsigned int stop_frequency,
+                unsigned long length, signed int amplitude);
+
+void sweep_generate(SWEEP *sweep, DATA *output, unsigned int nx);
+
+unsigned int sweep_frequency(SWEEP *sweep);
 
 unsigned int SweepGenerator(void);
 
+void sweep_measure_start(unsigned long SamplingFrequency);
+signed int sweep_measure_process(signed int input);
+SWEEP_STATE sweep_measure_state(void);
+void sweep_deconvolve(void);
+
+extern DATA sweep_impulse_response[SWEEP_IR_LENGTH];
+extern DATA sweep_harmonic_response[SWEEP_HARMONICS][SWEEP_HARMONIC_LENGTH];
+extern unsigned int sweep_clipped;      /* By the last sweep_deconvolve()   */
+
 #endif
 
 /*****************************************************************************/
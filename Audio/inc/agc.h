@@ -0,0 +1,40 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 agc.h                                                                   */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for automatic gain control of the line input.               */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef AGC_H
+#define AGC_H
+
+#include "usbstk5505.h"
+
+#define AGC_BLOCK_SIZE      32      /* Samples per power measurement        */
+#define AGC_POWER_SHIFT     3       /* Input scaling so power() cannot saturate */
+
+#define AGC_UNITY_GAIN      4096    /* Digital gain in Q12 format           */
+#define AGC_MIN_GAIN        1024    /* -12 dB                               */
+#define AGC_MAX_GAIN        16383   /* +12 dB                               */
+#define AGC_PGA_UP_GAIN     8192    /* +6 dB. Move 6 dB into the codec PGA  */
+#define AGC_PGA_DOWN_GAIN   2048    /* -6 dB. Move 6 dB out of the codec PGA */
+
+#define AGC_PGA_STEP        12      /* 6 dB in 0.5 dB steps                 */
+#define AGC_PGA_MAX         95      /* 47.5 dB in 0.5 dB steps              */
+
+void agc_init(unsigned int ADCgain);
+Int16 agc_process(Int16 input);
+void agc_bypass(void);
+
+extern volatile Uint16 agc_gain;        /* Current digital gain, Q12        */
+extern volatile Uint16 agc_pga_gain;    /* Current PGA gain, 0.5 dB steps   */
+
+#endif
+
+/*****************************************************************************/
+/* End of agc.h                                                              */
+/*****************************************************************************/
@@ -46,6 +46,8 @@
 #ifndef AIC3204_H_
 #define AIC3204_H_
 
+#include "i2c_queue.h"
+
  #define AIC3204_I2C_ADDR 0x18
 
  #define XmitL 0x10
@@ -53,13 +55,66 @@
  #define RcvR 0x08
  #define RcvL 0x04
 
+ /* Register writes go through a shadow of pages 0 and 1. Page selects are */
+ /* only sent when the page changes and writes of the value already in the */
+ /* codec are not sent. Set to 0 to send every write, with a page select   */
+ /* in front of each one.                                                   */
+ #ifndef AIC3204_SHADOW
+ #define AIC3204_SHADOW 1
+ #endif
+
+ #define AIC3204_SHADOW_PAGES 2     // Pages 0 and 1 are shadowed
+ #define AIC3204_BURST_MAX 32       // Registers per auto-increment write
+
+ typedef struct
+ {
+     Uint32 transactions;           // I2C write transactions
+     Uint32 bytes;                  // Bytes sent including the address
+     Uint32 page_selects;           // Page select writes sent
+     Uint32 pages_elided;           // Page selects not needed
+     Uint32 suppressed;             // Register writes not needed
+     Uint32 async_errors;           // Queued writes that failed
+ } AIC3204_STATS;
+
+ extern AIC3204_STATS aic3204_stats;
+
+ /* One register write in a configuration table */
+ typedef struct
+ {
+     Uint16 page;                   // AIC3204_DELAY for a wait
+     Uint16 regnum;
+     Uint16 value;                  // Microseconds for a wait
+ } AIC3204_REG;
+
+ #define AIC3204_DELAY 0xFFFF
+
+ #define AIC3204_RESET_WAIT_US 1000 // Before the first I2C access after a reset
+ #define AIC3204_RESET_PULSE_US 1   // RESET held low
+
  extern void aic3204_init(void);
  extern void aic3204_hardware_init(void);
  extern void aic3204_codec_read(Int16* left_input, Int16* right_input);
  extern void aic3204_codec_write(Int16 left_input, Int16 right_input);
  extern void aic3204_disable(void);
+ extern Int16 aic3204_software_reset(void);
 
  extern Int16 AIC3204_rset( Uint16 regnum, Uint16 regval);
+ extern Int16 AIC3204_rget( Uint16 regnum, Uint16* regval);
+ extern Int16 AIC3204_write( Uint16 page, Uint16 regnum, Uint16 regval);
+ extern Int16 AIC3204_write_burst( Uint16 page, Uint16 regnum,
+                                   const Uint8* values, Uint16 count);
+ extern Int16 AIC3204_write_async( Uint16 page, Uint16 regnum,
+                                   const Uint8* values, Uint16 count,
+                                   I2C_Callback callback, void* context);
+ extern Int16 aic3204_volume_async( Int16 volume, I2C_Callback callback,
+                                    void* context);
+ extern Int16 aic3204_mute_async( Uint16 mute, I2C_Callback callback,
+                                  void* context);
+ extern Int16 aic3204_pga_gain_async( Uint16 gain, I2C_Callback callback,
+                                      void* context);
+ extern Int16 AIC3204_shadow_read( Uint16 page, Uint16 regnum, Uint16* regval);
+ extern void aic3204_shadow_invalidate(void);
+ extern Int16 aic3204_apply( const AIC3204_REG* table, Uint16 count);
 
 
  extern unsigned long set_sampling_frequency_and_gain(unsigned long SamplingFrequency, unsigned int ADCgain);
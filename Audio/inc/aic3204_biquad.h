@@ -0,0 +1,53 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 aic3204_biquad.h                                                        */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the biquad filters in the AIC3204 DAC processing block. */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef AIC3204_BIQUAD_H
+#define AIC3204_BIQUAD_H
+
+#include "usbstk5505.h"
+
+/* DAC processing blocks. Both are stereo with interpolation filter A */
+
+#define AIC3204_PRB_P1          1       /* 3 biquads per channel. Default   */
+#define AIC3204_PRB_P2          2       /* 6 biquads per channel            */
+
+#define AIC3204_BIQUADS_MAX     6
+
+/* Codec coefficients, a 1.23 fraction in the low 24 bits.                  */
+/* H(z) = ( N0 + 2 N1 z^-1 + N2 z^-2 ) / ( 1 - 2 D1 z^-1 - D2 z^-2 )        */
+
+typedef struct
+{
+    long n0;
+    long n1;
+    long n2;
+    long d1;
+    long d2;
+} AIC3204_BIQUAD;
+
+void aic3204_biquad_flat(AIC3204_BIQUAD *biquad);
+void aic3204_biquad_from_table(AIC3204_BIQUAD *biquad,
+                               const signed int *coefficients);
+void aic3204_biquad_from_float(AIC3204_BIQUAD *biquad, float b0, float b1,
+                               float b2, float a1, float a2);
+
+void aic3204_biquad_reset(void);
+Int16 aic3204_dac_processing_block(Uint16 prb);
+Int16 aic3204_dac_biquads(const AIC3204_BIQUAD *left,
+                          const AIC3204_BIQUAD *right, Uint16 count);
+Int16 aic3204_dac_biquads_async(const AIC3204_BIQUAD *left,
+                                const AIC3204_BIQUAD *right, Uint16 count);
+
+#endif
+
+/*****************************************************************************/
+/* End of aic3204_biquad.h                                                   */
+/*****************************************************************************/
@@ -0,0 +1,66 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 bode.h                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for stepped-sine frequency response (Bode) measurement.     */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef BODE_H
+#define BODE_H
+
+#include "tms320.h"
+
+#define BODE_POINTS             31      /* ISO 1/3 octave 20 Hz to 20 kHz   */
+#define BODE_AMPLITUDE          16384   /* -6 dBFS                          */
+#define BODE_SETTLE_SAMPLES     2400    /* Discarded after each step        */
+#define BODE_MEASURE_SAMPLES    4800    /* Minimum samples per point        */
+
+typedef enum
+{
+    BODE_DIGITAL,       /* Generator straight into the processing chain     */
+    BODE_ANALOG         /* Generator to line out, line in to the chain      */
+} BODE_MODE;
+
+typedef enum
+{
+    BODE_IDLE,
+    BODE_MEASURING,
+    BODE_COMPLETE
+} BODE_STATE;
+
+/* Processing chain under test. One sample in, one sample out */
+
+typedef signed int (*BODE_Chain)(signed int input);
+
+typedef struct
+{
+    unsigned int frequency;     /* Hz                                       */
+    long input_real;            /* Correlation of the stimulus with sin     */
+    long input_imag;            /* Correlation of the stimulus with cos     */
+    long output_real;           /* Correlation of the output with sin       */
+    long output_imag;           /* Correlation of the output with cos       */
+    signed int magnitude;       /* 0.01 dB. Filled in by bode_report()      */
+    signed int phase;           /* 0.1 degree, -1800 to 1800                */
+} BODE_Point;
+
+void bode_init(BODE_MODE mode, unsigned long SamplingFrequency,
+               signed int amplitude, BODE_Chain chain);
+signed int bode_process(signed int input);
+BODE_STATE bode_state(void);
+void bode_run_digital(void);
+void bode_report(void);
+void bode_print_csv(void);
+
+extern const unsigned int bode_frequencies[BODE_POINTS];
+extern BODE_Point bode_table[BODE_POINTS];
+extern unsigned int bode_points;
+
+#endif
+
+/*****************************************************************************/
+/* End of bode.h                                                             */
+/*****************************************************************************/
@@ -0,0 +1,47 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 boot.h                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the start up timeline.                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "usbstk5505.h"
+
+/* Set to 0 for the original start up, with aic3204_init() before the        */
+/* sampling frequency is set. With 1 the codec is configured once.           */
+/*                                                                           */
+/* Either way the start up messages, PLL and timer included, are log         */
+/* records. They wait in log_buffer[] until log_task() sends them, which is  */
+/* first run from the audio loop, so none of them holds up the first sample. */
+
+#ifndef BOOT_FAST
+#define BOOT_FAST               1
+#endif
+
+#define BOOT_MARKS              12
+
+typedef struct
+{
+    Uint16 stage;                       /* LOG_BOOT_ id of the stage        */
+    Uint32 ticks;                       /* delay_now() at the end of it     */
+} BOOT_MARK;
+
+void boot_mark(Uint16 stage);
+Uint32 boot_elapsed_us(void);
+void boot_report(void);
+
+extern BOOT_MARK boot_timeline[BOOT_MARKS];
+extern Uint16 boot_marks;
+
+#endif
+
+/*****************************************************************************/
+/* End of boot.h                                                             */
+/*****************************************************************************/
@@ -0,0 +1,83 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 command.h                                                               */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the binary command protocol on the UART.                */
+/*                                                                           */
+/*   Command: CMD_SYNC, command, length, length payload bytes, checksum.     */
+/*   Reply:   CMD_SYNC, command | CMD_REPLY, length, status, payload,        */
+/*            checksum. The length counts the status byte.                   */
+/*                                                                           */
+/*   The checksum makes the sum of every byte after CMD_SYNC zero. Values    */
+/*   of more than one byte are least significant byte first. Log frames,     */
+/*   which start with LOG_SYNC, come on the same line between replies.       */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include "usbstk5505.h"
+
+#define CMD_SYNC                0x5A
+#define CMD_REPLY               0x80
+#define CMD_MAX_PAYLOAD         32
+#define CMD_VERSION             3
+
+/* Commands and their payloads */
+
+#define CMD_PING                0x01    /* Reply: CMD_VERSION               */
+#define CMD_PRESET              0x02    /* preset. Stops automatic switching */
+#define CMD_AUTO                0x03    /* 1 to switch every switch_secs    */
+#define CMD_SET                 0x04    /* parameter, 16-bit value          */
+#define CMD_GET                 0x05    /* parameter. Reply: 16-bit value   */
+#define CMD_TELEMETRY           0x06    /* Reply: CMD_TELEMETRY_BYTES       */
+
+/* Presets, the values of Step */
+
+#define CMD_PRESET_BYPASS       0       /* Inputs straight to the outputs   */
+#define CMD_PRESET_LOW_PASS     1       /* Low pass, CMD_PARAM_FILTER       */
+#define CMD_PRESETS             2
+
+/* Parameters for CMD_SET and CMD_GET */
+
+#define CMD_PARAM_SWITCH_SECS   0       /* Seconds between presets, 1 up    */
+#define CMD_PARAM_CHANGES       1       /* Preset changes until the end     */
+#define CMD_PARAM_VOLUME        2       /* DAC volume, 0.5 dB, -127 to 48   */
+#define CMD_PARAM_MUTE          3       /* 1 to mute the DAC                */
+#define CMD_PARAM_FILTER        4       /* Low pass cutoff in Hz, one of    */
+                                        /* IIR_low_pass_cutoffs[]           */
+#define CMD_PARAMS              5
+
+/* Reply status */
+
+#define CMD_OK                  0
+#define CMD_BAD_COMMAND         1
+#define CMD_BAD_LENGTH          2
+#define CMD_BAD_VALUE           3
+#define CMD_BAD_CHECKSUM        4
+#define CMD_BUSY                5       /* I2C queue full. Try again        */
+
+/* CMD_TELEMETRY reply payload, offsets in bytes                             */
+/*                                                                           */
+/*  0  preset               1  automatic switching                           */
+/*  2  preset changes       4  pitch, Hz in Q12.4, 0 if unvoiced             */
+/*  6  pitch confidence Q15 8  last DTMF key, 0 if none                      */
+/*  9  PGA gain, 0.5 dB    10  AGC gain Q12                                  */
+/* 12  log records lost    16  I2C errors and timeouts                       */
+/* 20  task overruns and deadline misses                                     */
+/* 22  UART receive errors and overflows                                     */
+/* 24  samples late        28  processing level, SUPERVISOR_ in supervisor.h */
+
+#define CMD_TELEMETRY_BYTES     29
+
+void command_task(void *context);
+
+#endif
+
+/*****************************************************************************/
+/* End of command.h                                                          */
+/*****************************************************************************/
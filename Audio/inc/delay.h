@@ -0,0 +1,39 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 delay.h                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for delays and timeouts timed by general purpose timer 1.   */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef DELAY_H
+#define DELAY_H
+
+#include "usbstk5505.h"
+
+typedef struct
+{
+    Uint32 start;                       /* delay_now() when started         */
+    Uint32 ticks;                       /* Length of the timeout            */
+} DELAY_TIMEOUT;
+
+void delay_init(void);
+void delay_set_clock(void);
+Uint32 delay_now(void);
+Uint32 delay_us_to_ticks(Uint32 us);
+Uint32 delay_ticks_to_us(Uint32 ticks);
+void delay_us(Uint32 us);
+void delay_ms(Uint32 ms);
+void delay_timeout_start(DELAY_TIMEOUT *timeout, Uint32 us);
+Int16 delay_timeout_expired(DELAY_TIMEOUT *timeout);
+
+extern Uint32 delay_ticks_per_ms;       /* 0 until delay_init()             */
+
+#endif
+
+/*****************************************************************************/
+/* End of delay.h                                                            */
+/*****************************************************************************/
@@ -0,0 +1,37 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 dsplib_bench.h                                                          */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the DSPLIB cycle counts taken at start up.              */
+/*                                                                           */
+/*   Build once as usual and once with DSPLIB_ROM on the link, see lnkx.cmd, */
+/*   and compare the two log records for the cost of running from the ROM.   */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef DSPLIB_BENCH_H
+#define DSPLIB_BENCH_H
+
+#include "usbstk5505.h"
+
+/* Set to 1 to time the DSPLIB functions used here once at start up */
+
+#ifndef DSPLIB_BENCH
+#define DSPLIB_BENCH            0
+#endif
+
+#define DSPLIB_BENCH_SAMPLES    64      /* Per call                         */
+#define DSPLIB_BENCH_CALLS      32
+#define DSPLIB_BENCH_OSCILLATORS 8      /* Largest bank timed               */
+#define DSPLIB_BENCH_LAGS       35      /* For acorr_bias(), as in pitch.c  */
+
+void dsplib_bench(void);
+
+#endif
+
+/*****************************************************************************/
+/* End of dsplib_bench.h                                                     */
+/*****************************************************************************/
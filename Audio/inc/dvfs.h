@@ -0,0 +1,59 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 dvfs.h                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the CPU clock and core voltage governor.                */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef DVFS_H
+#define DVFS_H
+
+#include "usbstk5505.h"
+
+/* Set to 1 to let the governor change the clock. Off until clock changes */
+/* under load have been checked on a board; at 0 the CPU stays at the      */
+/* clock given to pll_frequency_setup() in main()                          */
+
+#ifndef DVFS_GOVERNOR
+#define DVFS_GOVERNOR           0
+#endif
+
+/* Clocks the governor uses, from the PLL.c configurations. 1, 2 and 12 MHz  */
+/* are too slow for the audio loop and 120 MHz is above the C5505 rating.    */
+/* The C5505 runs to 60 MHz with the core at 1.05 V, 100 MHz at 1.3 V.       */
+
+#define DVFS_LEVELS             4
+#define DVFS_LOW_VOLTAGE_MHZ    60
+
+#define DVFS_WINDOW_SAMPLES     4800    /* Load measured over 100 ms        */
+#define DVFS_TARGET_PERCENT     70      /* Peak load aimed for              */
+#define DVFS_LOWER_WINDOWS      10      /* Windows below before lowering    */
+#define DVFS_LDO_SETTLE_US      1000    /* After raising the core voltage   */
+
+typedef struct
+{
+    Uint16 level;                       /* Index of the clock in use        */
+    Uint16 mhz;                         /* Clock in use                     */
+    Uint16 peak_percent;                /* Highest load in the last window  */
+    Uint16 average_percent;             /* Mean load in the last window     */
+    Uint16 switches;
+    Uint16 postponed;                   /* Windows waiting for idle buses   */
+    Uint16 overloads;                   /* Windows with a sample late       */
+} DVFS_STATS;
+
+void dvfs_init(Uint16 mhz, Uint32 rate);
+void dvfs_busy_start(void);
+void dvfs_busy_end(void);
+
+extern volatile DVFS_STATS dvfs_stats;
+extern const Uint16 dvfs_mhz[DVFS_LEVELS];
+
+#endif
+
+/*****************************************************************************/
+/* End of dvfs.h                                                             */
+/*****************************************************************************/
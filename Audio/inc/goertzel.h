@@ -0,0 +1,91 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 goertzel.h                                                              */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for Goertzel tone detection bank (DTMF and pilot tones).    */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+
+#include "usbstk5505.h"
+#include "tms320.h"
+
+#define GOERTZEL_MAX_TONES      8
+#define GOERTZEL_QUEUE_SIZE     16      /* Must be a power of 2 */
+
+/* Settings for DTMF at 48000 Hz. Decimate by 6 to 8000 Hz, 205 point blocks */
+
+#define GOERTZEL_DTMF_DECIMATION    6
+#define GOERTZEL_DTMF_BLOCK_LENGTH  205
+#define GOERTZEL_DTMF_THRESHOLD     100L    /* About -48 dBFS a tone  */
+
+/* Most bits a resonator state may need. The 16 x 32 bit multiply in         */
+/* goertzel_process() doubles the state and must stay inside a long.         */
+
+#define GOERTZEL_STATE_BITS         29
+
+typedef struct
+{
+    Uint16 frequency;       /* Target frequency in Hz                       */
+    Int16  coeff;           /* 2cos(2.pi.f/fs) in Q14                       */
+    long   s1;              /* s(n-1)                                       */
+    long   s2;              /* s(n-2)                                       */
+    Uint16 present;         /* Tone detected in the previous block          */
+} GOERTZEL_Tone;
+
+typedef struct
+{
+    Uint16 tone;            /* Index into the bank                          */
+    Uint16 frequency;       /* Frequency in Hz                              */
+    Uint16 present;         /* 1 = tone started, 0 = tone ended             */
+    long   power;           /* Tone power at the end of the block           */
+    Uint32 block;           /* Block number in which the change occurred    */
+} GOERTZEL_Event;
+
+typedef struct
+{
+    Uint16 tones;           /* Number of active tones                       */
+    Uint16 block_length;    /* Decimated samples per detection block        */
+    Uint16 decimation;      /* Input samples averaged per Goertzel sample   */
+    Uint16 input_shift;     /* Right shift of decimated sum to stop overflow */
+    Uint16 output_shift;    /* Right shift of s(n) to 16 bits for the power */
+    Uint16 energy_shift;    /* Right shift of input for the block energy    */
+    long   threshold;       /* Minimum tone power for a detection           */
+
+    Uint16 count;           /* Decimated samples in the current block       */
+    Uint16 phase;           /* Input samples in the current decimated sample */
+    long   sum;             /* Running sum for decimation                   */
+    long   energy;          /* Block energy of the decimated input          */
+    Uint32 blocks;          /* Blocks processed since goertzel_init()       */
+
+    GOERTZEL_Tone tone[GOERTZEL_MAX_TONES];
+
+    GOERTZEL_Event queue[GOERTZEL_QUEUE_SIZE];
+    volatile Uint16 head;   /* Written by goertzel_process()                */
+    volatile Uint16 tail;   /* Written by goertzel_get_event()              */
+    Uint16 overflows;       /* Events lost because the queue was full       */
+} GOERTZEL_Bank;
+
+extern const Uint16 goertzel_dtmf_frequencies[8];
+
+void goertzel_init(GOERTZEL_Bank *bank, unsigned long SamplingFrequency,
+                   const Uint16 *frequencies, Uint16 tones,
+                   Uint16 block_length, Uint16 decimation,
+                   long threshold);
+
+void goertzel_process(GOERTZEL_Bank *bank, const DATA *input, Uint16 nx);
+
+Int16 goertzel_get_event(GOERTZEL_Bank *bank, GOERTZEL_Event *event);
+
+char goertzel_dtmf_key(Uint16 row_frequency, Uint16 column_frequency);
+
+#endif
+
+/*****************************************************************************/
+/* End of goertzel.h                                                         */
+/*****************************************************************************/
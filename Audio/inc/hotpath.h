@@ -0,0 +1,59 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 hotpath.h                                                               */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the placement of the per sample code and data, and the  */
+/*   cycle count of it.                                                      */
+/*                                                                           */
+/*   With HOT_SECTIONS set the kernels run for every sample go in .text:hot, */
+/*   the coefficient tables they read in .coeffs and their delay lines and   */
+/*   state in .delay. lnkx.cmd puts each in a DARAM block of its own, so a   */
+/*   coefficient and a delay line are never read from one single access      */
+/*   SARAM bank in the same cycle. tools/map_check.c checks the map file.    */
+/*                                                                           */
+/*   The TI compiler only takes a DATA_SECTION or CODE_SECTION pragma that   */
+/*   comes before every declaration of the symbol. Each file therefore       */
+/*   includes hotpath.h first and gives its pragmas before the header that   */
+/*   declares the symbol.                                                    */
+/*                                                                           */
+/*   Set HOT_SECTIONS to 0 for the layout before, everything in .text,       */
+/*   .const and .bss, to compare the cycles logged by hotpath_end().         */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef HOTPATH_H
+#define HOTPATH_H
+
+#include "usbstk5505.h"
+
+/* The pragmas are only for the TI compiler, not for host builds of tools */
+
+#ifndef HOT_SECTIONS
+#if defined(__TMS320C55X__)
+#define HOT_SECTIONS            1
+#else
+#define HOT_SECTIONS            0
+#endif
+#endif
+
+#define HOTPATH_WINDOW_SAMPLES  48000   /* Stats and a log record each 1 s  */
+
+typedef struct
+{
+    Uint32 cycles_mean;                 /* CPU cycles per sample            */
+    Uint32 cycles_worst;
+} HOTPATH_STATS;
+
+void hotpath_start(void);
+void hotpath_end(void);
+
+extern volatile HOTPATH_STATS hotpath_stats;
+
+#endif
+
+/*****************************************************************************/
+/* End of hotpath.h                                                          */
+/*****************************************************************************/
@@ -0,0 +1,70 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 i2c_queue.h                                                             */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the interrupt driven I2C transaction queue.             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef I2C_QUEUE_H
+#define I2C_QUEUE_H
+
+#include "usbstk5505.h"
+
+#define I2C_QUEUE_SIZE          16      /* Power of 2                       */
+#define I2C_QUEUE_MAX_BYTES     34      /* Register address + AIC3204 burst */
+#define I2C_QUEUE_TIMEOUT_TICKS 2       /* Calls to i2c_queue_tick()        */
+
+/* Status passed to the callback */
+
+#define I2C_QUEUE_OK            0
+#define I2C_QUEUE_NACK          -1      /* Address or data not acknowledged */
+#define I2C_QUEUE_ARBITRATION   -2      /* Arbitration lost                 */
+#define I2C_QUEUE_TIMEOUT       -3      /* No progress, module was reset    */
+#define I2C_QUEUE_FULL          -4      /* Returned by write and read only  */
+
+/* Called from the I2C interrupt when a transaction has finished. For a     */
+/* read, data holds the bytes received and is only valid during the call.   */
+
+typedef void (*I2C_Callback)(Int16 status, Uint8 *data, Uint16 length,
+                             void *context);
+
+typedef struct
+{
+    Uint16 address;                     /* 7-bit slave address              */
+    Uint16 read;                        /* 1 for read, 0 for write          */
+    Uint16 length;
+    Uint8 data[I2C_QUEUE_MAX_BYTES];
+    I2C_Callback callback;              /* May be NULL                      */
+    void *context;
+} I2C_Transaction;
+
+typedef struct
+{
+    Uint32 completed;
+    Uint32 errors;                      /* NACK or arbitration lost         */
+    Uint32 timeouts;
+    Uint32 overflows;                   /* Rejected because queue was full  */
+} I2C_QUEUE_STATS;
+
+void i2c_queue_init(void);
+Int16 i2c_queue_write(Uint16 address, const Uint8 *data, Uint16 length,
+                      I2C_Callback callback, void *context);
+Int16 i2c_queue_read(Uint16 address, Uint16 length,
+                     I2C_Callback callback, void *context);
+Uint16 i2c_queue_pending(void);
+void i2c_queue_flush(void);
+void i2c_queue_close(void);
+void i2c_queue_tick(void);
+interrupt void i2c_queue_isr(void);
+
+extern volatile I2C_QUEUE_STATS i2c_queue_stats;
+
+#endif
+
+/*****************************************************************************/
+/* End of i2c_queue.h                                                        */
+/*****************************************************************************/
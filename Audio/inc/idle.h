@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 idle.h                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for waiting for samples in the CPU idle state.              */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include "usbstk5505.h"
+
+/* Set to 0 for the audio loop to poll the codec, as before */
+
+#ifndef IDLE_WAIT
+#define IDLE_WAIT               1
+#endif
+
+#define IDLE_WINDOW_SAMPLES     48000   /* Stats and a log record each 1 s  */
+
+/* Peripheral clocks stopped by idle_init(). Not I2S0, I2C, UART, GPT0 or    */
+/* GPT1, which are in use, nor USB, which needs a handshake to stop.         */
+
+#define IDLE_GATED_PCGCR1       ( CSL_SYS_PCGCR1_I2S2CG_MASK                \
+                                | CSL_SYS_PCGCR1_TMR2CG_MASK                \
+                                | CSL_SYS_PCGCR1_EMIFCG_MASK                \
+                                | CSL_SYS_PCGCR1_I2S1CG_MASK                \
+                                | CSL_SYS_PCGCR1_MMCSD1CG_MASK              \
+                                | CSL_SYS_PCGCR1_MMCSD0CG_MASK              \
+                                | CSL_SYS_PCGCR1_DMA0CG_MASK                \
+                                | CSL_SYS_PCGCR1_SPICG_MASK                 \
+                                | CSL_SYS_PCGCR1_I2S3CG_MASK )
+
+#define IDLE_GATED_PCGCR2       ( CSL_SYS_PCGCR2_DMA3CG_MASK                \
+                                | CSL_SYS_PCGCR2_DMA2CG_MASK                \
+                                | CSL_SYS_PCGCR2_DMA1CG_MASK                \
+                                | CSL_SYS_PCGCR2_SARCG_MASK                 \
+                                | CSL_SYS_PCGCR2_LCDCG_MASK )
+
+typedef struct
+{
+    Uint16 idle_percent;                /* Time idle in the last window     */
+    Uint32 wake_ns_mean;                /* Wake up to sample in hand        */
+    Uint32 wake_ns_worst;
+    Uint32 idles;                       /* IDLE instructions executed       */
+    Uint16 missed;                      /* Samples not read in time         */
+} IDLE_STATS;
+
+void idle_init(void);
+void idle_codec_read(Int16 *left_input, Int16 *right_input);
+void idle_close(void);
+interrupt void idle_i2s_rx_isr(void);
+
+extern volatile IDLE_STATS idle_stats;
+
+#endif
+
+/*****************************************************************************/
+/* End of idle.h                                                             */
+/*****************************************************************************/
@@ -0,0 +1,73 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 log.h                                                                   */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the binary log held in a RAM ring buffer.               */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef LOG_H
+#define LOG_H
+
+#include "usbstk5505.h"
+
+/* Where log_drain() sends the records */
+
+#define LOG_SINK_RAM            0       /* Nowhere. Read log_buffer[]       */
+#define LOG_SINK_UART           1       /* Binary frames for log_decode     */
+#define LOG_SINK_CIO            2       /* printf(). Stops the CPU          */
+
+#ifndef LOG_SINK
+#define LOG_SINK                LOG_SINK_UART
+#endif
+
+#define LOG_RECORDS             64      /* Power of 2                       */
+#define LOG_ARGS                3
+
+/* UART frame: LOG_SYNC, id, ticks and arguments least significant byte      */
+/* first, then a byte that makes the sum of all but LOG_SYNC zero.           */
+
+#define LOG_SYNC                0xA5
+#define LOG_FRAME_BYTES         ( 1 + 2 + 4 + 4 * LOG_ARGS + 1 )
+
+typedef enum
+{
+    LOG_EMPTY = 0,
+#define LOG_FORMAT(id, format)  id,
+#include "log_formats.h"
+#undef LOG_FORMAT
+    LOG_FORMATS
+} LOG_ID;
+
+/* In memory each record is ticks and args, most significant word first,     */
+/* then id and one word of padding: 10 words.                                */
+
+typedef struct
+{
+    Uint32 ticks;                       /* delay_now()                      */
+    long args[LOG_ARGS];
+    Uint16 id;                          /* LOG_EMPTY if never written       */
+} LOG_RECORD;
+
+#define LOG0(id)                log_write((id), 0, 0, 0)
+#define LOG1(id, a)             log_write((id), (long) (a), 0, 0)
+#define LOG2(id, a, b)          log_write((id), (long) (a), (long) (b), 0)
+#define LOG3(id, a, b, c)       log_write((id), (long) (a), (long) (b), \
+                                          (long) (c))
+
+void log_init(void);
+void log_write(Uint16 id, long a, long b, long c);
+Uint16 log_drain(void);
+void log_flush(void);
+
+extern LOG_RECORD log_buffer[LOG_RECORDS];
+extern volatile Uint32 log_dropped;
+
+#endif
+
+/*****************************************************************************/
+/* End of log.h                                                              */
+/*****************************************************************************/
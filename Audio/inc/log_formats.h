@@ -0,0 +1,101 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 log_formats.h                                                           */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Messages written by log_write(), one LOG_FORMAT( id, format ) each.     */
+/*   Included by log.h for the ids and by tools/log_decode.c for the text.   */
+/*                                                                           */
+/*   Up to three arguments, each logged as a long, so use %ld, %lu or %lx.   */
+/*   Add new messages at the end so that logs already captured still decode. */
+/*                                                                           */
+/*****************************************************************************/
+
+LOG_FORMAT( LOG_DROPPED,            "%lu log records lost, log buffer full" )
+LOG_FORMAT( LOG_CLOCK,              "Log timestamps at %lu ticks per ms" )
+
+LOG_FORMAT( LOG_PLL_FREQUENCY,      "PLL frequency %lu MHz" )
+LOG_FORMAT( LOG_PLL_REGISTER,       "PLL_CNTRL%lu   %04lx --- %04lx" )
+LOG_FORMAT( LOG_PLL_FAILED,         "PLL set up failed at step %lu"
+                                    " (1 init, 2 config, 3 get config,"
+                                    " 4 bypass, 5 enable), status %ld" )
+LOG_FORMAT( LOG_CPU_CLOCK,          "CPU clock is running at %lukHz" )
+LOG_FORMAT( LOG_TIMER_PRESCALE,     "Timer Prescaler Divide Value is Set"
+                                    " to Divide by %lu" )
+
+LOG_FORMAT( LOG_SAMPLING,           "Sampling frequency %lu Hz Gain = %ld dB" )
+LOG_FORMAT( LOG_SAMPLING_DEFAULT,   "Sampling frequency %lu Hz not"
+                                    " recognised. Default to 48000 Hz"
+                                    " Gain = %ld dB" )
+
+LOG_FORMAT( LOG_BANNER,             "Running IIR Filters Project using main.c" )
+LOG_FORMAT( LOG_LOOPBACK,           "<-> Audio Loopback from Stereo Line IN"
+                                    " --> to HP/Lineout" )
+LOG_FORMAT( LOG_SWITCH_PERIOD,      "Changes configuration once every %lu"
+                                    " seconds" )
+LOG_FORMAT( LOG_CHANGES,            "The program will end after %ld changes" )
+
+LOG_FORMAT( LOG_BOOT_PLL,           "Start up %8lu us %6lu us  PLL" )
+LOG_FORMAT( LOG_BOOT_CODEC_RESET,   "Start up %8lu us %6lu us  Codec reset" )
+LOG_FORMAT( LOG_BOOT_DSP,           "Start up %8lu us %6lu us  DSP" )
+LOG_FORMAT( LOG_BOOT_AIC3204_INIT,  "Start up %8lu us %6lu us  aic3204_init" )
+LOG_FORMAT( LOG_BOOT_SAMPLING,      "Start up %8lu us %6lu us  Sampling"
+                                    " frequency" )
+LOG_FORMAT( LOG_BOOT_TIMER,         "Start up %8lu us %6lu us  Timer" )
+LOG_FORMAT( LOG_BOOT_FIRST_AUDIO,   "Start up %8lu us %6lu us  First audio" )
+
+LOG_FORMAT( LOG_SCHED_OVERRUN,      "Task %lu released again before it had"
+                                    " run, period %lu ms" )
+LOG_FORMAT( LOG_SCHED_DEADLINE,     "Task %lu finished %lu ms after its"
+                                    " release, deadline %lu ms" )
+LOG_FORMAT( LOG_SCHED_BUDGET,       "Task %lu ran for %lu us, budget %lu us" )
+
+LOG_FORMAT( LOG_DVFS_SWITCH,        "Clock %lu MHz to %lu MHz, peak load"
+                                    " %lu%%" )
+LOG_FORMAT( LOG_DVFS_FAILED,        "Clock change to %lu MHz failed, status"
+                                    " %ld" )
+
+LOG_FORMAT( LOG_IDLE_WINDOW,        "Idle %lu%%, wake up to sample %lu ns"
+                                    " mean, %lu ns worst" )
+
+LOG_FORMAT( LOG_SUPERVISOR_SHED,    "Overload: %lu of %lu samples late,"
+                                    " processing level %lu" )
+LOG_FORMAT( LOG_SUPERVISOR_RESTORE, "Load normal again, processing level %lu" )
+
+LOG_FORMAT( LOG_PLL_SOLVED,         "PLL %lu Hz asked for, %lu Hz set,"
+                                    " CGCR1 %04lx" )
+
+LOG_FORMAT( LOG_HOTPATH_CYCLES,     "Signal processing %lu cycles per sample"
+                                    " mean, %lu worst" )
+
+LOG_FORMAT( LOG_MEMUSE_PEAK,        "Peak use in words: stack %lu, system"
+                                    " stack %lu, heap %lu" )
+
+LOG_FORMAT( LOG_DSPLIB_BENCH,       "DSPLIB sine() at %06lx, cycles per 100"
+                                    " samples: sine() %lu, expn() %lu" )
+
+LOG_FORMAT( LOG_OSCILLATOR_BENCH,   "Oscillator cycles per 100 samples of one:"
+                                    " bank of 1 %lu, bank of 8 %lu, one"
+                                    " sample a call %lu" )
+
+LOG_FORMAT( LOG_SWEEP_CLIPPED,      "Impulse response: %lu samples clipped" )
+
+LOG_FORMAT( LOG_HOTPATH_LAYOUT,     "HOT_SECTIONS %lu: IIR filter code at"
+                                    " %06lx, coefficients at %06lx" )
+
+LOG_FORMAT( LOG_DSPLIB_BENCH_BLOCK, "DSPLIB cycles per 100 samples: power()"
+                                    " %lu, bexp() %lu, rand16() %lu" )
+
+LOG_FORMAT( LOG_DSPLIB_BENCH_ACORR, "DSPLIB cycles per 100 samples at %lu"
+                                    " lags: acorr_bias() %lu, acorr_unbias()"
+                                    " %lu" )
+
+LOG_FORMAT( LOG_DSPLIB_BENCH_AT,    "DSPLIB rand16init() %lu cycles a call,"
+                                    " power() at %06lx, acorr_bias() at"
+                                    " %06lx" )
+
+/*****************************************************************************/
+/* End of log_formats.h                                                      */
+/*****************************************************************************/
@@ -0,0 +1,60 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 memuse.h                                                                */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the stack and heap high water marks.                    */
+/*                                                                           */
+/*   memuse_paint() fills .stack, .sysstack and .sysmem with MEMUSE_PAINT    */
+/*   at the start of main(). Whatever is no longer MEMUSE_PAINT has been     */
+/*   used. tools/mem_report.c gives the worst case from the call graph,      */
+/*   these are the peaks seen on the board.                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef MEMUSE_H
+#define MEMUSE_H
+
+#include "usbstk5505.h"
+
+/* Set to 0 to leave the stacks and heap as the start up code does */
+
+#ifndef MEMUSE
+#define MEMUSE                  1
+#endif
+
+#define MEMUSE_PAINT            0xC55A
+#define MEMUSE_PAINT_MARGIN     32      /* Words left below the stack in use */
+#define MEMUSE_WORDS_PER_RUN    128     /* Checked by each memuse_task()    */
+#define MEMUSE_PERIOD_MS        10
+#define MEMUSE_PROBE_BLOCKS     16      /* Free heap blocks counted at most */
+
+/* Sizes and peaks in 16-bit words */
+
+typedef struct
+{
+    Uint16 stack_words;
+    Uint16 stack_peak;
+    Uint16 system_stack_words;
+    Uint16 system_stack_peak;
+    Uint16 heap_words;
+    Uint16 heap_peak;                   /* Highest word malloc() has used   */
+    Uint16 heap_free;                   /* From memuse_query() only         */
+    Uint16 heap_largest;                /* Largest block malloc() can give  */
+    Uint16 heap_blocks;                 /* Free blocks                      */
+    Uint16 heap_fragmentation;          /* 100 - largest as % of free       */
+} MEMUSE_STATS;
+
+void memuse_paint(void);
+void memuse_task(void *context);
+void memuse_query(MEMUSE_STATS *stats);
+
+extern volatile MEMUSE_STATS memuse_stats;
+
+#endif
+
+/*****************************************************************************/
+/* End of memuse.h                                                           */
+/*****************************************************************************/
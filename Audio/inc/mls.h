@@ -0,0 +1,51 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 mls.h                                                                   */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for maximum length sequence (MLS) generator and fast        */
+/*   Hadamard transform impulse response extraction.                         */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef MLS_H
+#define MLS_H
+
+#include "tms320.h"
+
+#define MLS_MIN_ORDER       2
+#define MLS_MAX_ORDER       15      /* 32767 samples, 0.68 s at 48000 Hz    */
+
+typedef struct
+{
+    ushort order;                   /* Sequence length is 2^order - 1       */
+    ushort length;
+    ushort taps;                    /* Feedback mask of the shift register  */
+    ushort generate_state;          /* Shift register for the output        */
+    ushort record_state;            /* Shift register for the recording     */
+    unsigned long recorded;         /* Samples added to work[]              */
+    unsigned long limit;            /* Whole periods of samples to add      */
+    unsigned long skip;             /* Samples still to be discarded        */
+    signed int amplitude;           /* Output is +/- amplitude              */
+    long *work;                     /* 2^order words, permuted recording    */
+} MLS;
+
+void mls_init(MLS *mls, ushort order, signed int amplitude, long *work);
+
+void mls_generate(MLS *mls, DATA *output, ushort nx);
+
+void mls_set_periods(MLS *mls, ushort periods);
+
+void mls_record(MLS *mls, const DATA *input, ushort nx);
+
+ushort mls_periods(MLS *mls);
+
+void mls_extract(MLS *mls, DATA *impulse_response, ushort nx);
+
+#endif
+
+/*****************************************************************************/
+/* End of mls.h                                                              */
+/*****************************************************************************/
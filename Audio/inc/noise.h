@@ -0,0 +1,40 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 noise.h                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for block white and pink noise generators.                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef NOISE_H
+#define NOISE_H
+
+#include "tms320.h"
+
+#define NOISE_BLOCK_SIZE    32      /* Samples per call to rand16()         */
+#define NOISE_PINK_ROWS     15      /* Voss-McCartney rows. 15 octaves      */
+#define NOISE_PINK_SHIFT    4       /* Each of the 16 sources is +/- 2048   */
+
+typedef struct
+{
+    DATA rows[NOISE_PINK_ROWS];     /* Held random values                   */
+    long sum;                       /* Sum of rows[]                        */
+    unsigned int counter;           /* Selects the row updated each sample  */
+    signed int amplitude;           /* Peak value 0 to 32767                */
+} PINK_NOISE;
+
+void noise_init(void);
+
+void white_noise_generate(DATA *output, ushort nx, signed int amplitude);
+
+void pink_noise_init(PINK_NOISE *pink, signed int amplitude);
+void pink_noise_generate(PINK_NOISE *pink, DATA *output, ushort nx);
+
+#endif
+
+/*****************************************************************************/
+/* End of noise.h                                                            */
+/*****************************************************************************/
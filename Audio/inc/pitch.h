@@ -0,0 +1,57 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pitch.h                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for autocorrelation based pitch (fundamental frequency)     */
+/*   tracker.                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef PITCH_H
+#define PITCH_H
+
+#include "usbstk5505.h"
+
+/* 48000 Hz decimated by 24 gives 2000 Hz. Fundamental range 60 Hz - 500 Hz */
+
+#define PITCH_DECIMATION        24
+#define PITCH_SAMPLE_RATE       2000
+#define PITCH_WINDOW            64      /* 32 ms analysis window            */
+#define PITCH_HOP               20      /* 10 ms between estimates (100 Hz) */
+#define PITCH_MIN_LAG           4       /* 500 Hz                           */
+#define PITCH_MAX_LAG           33      /* 60 Hz                            */
+
+#define PITCH_BIASED            0       /* Use acorr_bias()                 */
+#define PITCH_UNBIASED          1       /* Use acorr_unbias()               */
+
+/* Stages of an estimate, one per run of pitch_task() */
+
+#define PITCH_IDLE              0
+#define PITCH_COPY              1
+#define PITCH_NORMALISE         2
+#define PITCH_CORRELATE         3
+#define PITCH_PICK              4
+
+typedef struct
+{
+    Uint16 frequency;       /* Fundamental in Hz, Q12.4. 0 if unvoiced      */
+    Int16  confidence;      /* Normalised autocorrelation at the peak, Q15  */
+    Uint16 voiced;          /* 1 if frequency is valid                      */
+    Uint32 frame;           /* Number of estimates since pitch_init()       */
+    Uint16 late;            /* Asked for before the one before was done     */
+} PITCH_Estimate;
+
+void pitch_init(Uint16 mode);
+Int16 pitch_process(Int16 input);
+void pitch_task(void *context);
+
+extern volatile PITCH_Estimate pitch_estimate;
+
+#endif
+
+/*****************************************************************************/
+/* End of pitch.h                                                            */
+/*****************************************************************************/
@@ -0,0 +1,55 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pll_solve.h                                                             */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for working out the PLL registers for a given clock.        */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef PLL_SOLVE_H
+#define PLL_SOLVE_H
+
+#include "usbstk5505.h"
+
+#define PLL_CLOCKIN_HZ          32768UL /* RTC crystal                      */
+#define PLL_VCO_MIN_HZ          60000000UL
+#define PLL_VCO_MAX_HZ          120000000UL
+
+/* 375 times the input and 256 times 48 kHz. Any multiple of it gives a      */
+/* whole number of CPU cycles per sample at 48, 24, 16 or 8 kHz.             */
+
+#define PLL_AUDIO_HZ            12288000UL
+
+/* CGCR fields of the C5505 and C5515, as in cslr_sysctrl.h                  */
+
+#define PLL_CGCR1_RSVD          0x8000  /* Set in every TI configuration    */
+#define PLL_CGCR1_M_MASK        0x0FFF  /* Multiplier is M + 4              */
+#define PLL_CGCR2_RDBYPASS      0x8000
+#define PLL_CGCR2_RDRATIO_MASK  0x0FFF  /* Reference divider is RD + 4      */
+#define PLL_CGCR3_INIT          0x0806
+#define PLL_CGCR4_OUTDIVEN      0x0200
+#define PLL_CGCR4_ODRATIO_MASK  0x00FF  /* Output divider is OD + 1         */
+
+#define PLL_M_MAX               PLL_CGCR1_M_MASK
+#define PLL_OUTDIV_MAX          ( PLL_CGCR4_ODRATIO_MASK + 1 )
+
+typedef struct
+{
+    Uint16 cgcr1;                       /* PLL_Config PLLCNTL1              */
+    Uint16 cgcr2;                       /* PLLINCNTL                        */
+    Uint16 cgcr3;                       /* PLLCNTL2                         */
+    Uint16 cgcr4;                       /* PLLOUTCNTL                       */
+    Uint32 hz;                          /* Clock these registers give       */
+} PLL_SOLUTION;
+
+Uint32 pll_solve(Uint32 hz, PLL_SOLUTION *solution);
+Uint32 pll_clock_hz(Uint16 cgcr1, Uint16 cgcr2, Uint16 cgcr4);
+
+#endif
+
+/*****************************************************************************/
+/* End of pll_solve.h                                                        */
+/*****************************************************************************/
@@ -0,0 +1,71 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pool.h                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the fixed block memory pools.                           */
+/*                                                                           */
+/*   The memory for a pool is an array of POOL_WORDS() words. Where it goes  */
+/*   is up to its definition: lnkx.cmd has .pool:daram in DARAM and          */
+/*   .pool:saram in SARAM, and the array must start on an even word:         */
+/*                                                                           */
+/*   #pragma DATA_SECTION(frame_memory, ".pool:daram")                       */
+/*   #pragma DATA_ALIGN(frame_memory, 2)                                     */
+/*   static Uint16 frame_memory[POOL_WORDS(FRAME_WORDS, FRAMES)];            */
+/*   static POOL frames;                                                     */
+/*                                                                           */
+/*   pool_init(&frames, frame_memory, FRAME_WORDS, FRAMES);                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "usbstk5505.h"
+
+#define POOL_MAX_BLOCKS         64
+
+/* A free block holds the pointer to the next one, so blocks are at least    */
+/* that big and, like pointers, start on an even word.                       */
+
+#define POOL_ALIGN_WORDS        ( sizeof(void *) / sizeof(Uint16) )
+#define POOL_WORDS(block_words, blocks) ( (Uint32) (block_words) * (blocks) )
+
+/* Returned by pool_init() and pool_free() */
+
+#define POOL_OK                 0
+#define POOL_BAD_SIZE           -1      /* Size, count or alignment         */
+#define POOL_BAD_BLOCK          -2      /* Not the start of a block of it   */
+#define POOL_NOT_IN_USE         -3      /* Freed already                    */
+
+typedef struct
+{
+    Uint16 used;                        /* Blocks handed out now            */
+    Uint16 peak;
+    Uint32 allocs;
+    Uint32 failures;                    /* pool_alloc() with none free      */
+    Uint16 bad_frees;                   /* pool_free() refused              */
+} POOL_STATS;
+
+typedef struct
+{
+    Uint16 *memory;
+    Uint16 block_words;
+    Uint16 blocks;
+    void *free;                         /* First free block, or NULL        */
+    Uint16 in_use[POOL_MAX_BLOCKS / 16];
+    POOL_STATS stats;
+} POOL;
+
+Int16 pool_init(POOL *pool, void *memory, Uint16 block_words, Uint16 blocks);
+void *pool_alloc(POOL *pool);
+Int16 pool_free(POOL *pool, void *block);
+Uint16 pool_available(const POOL *pool);
+
+#endif
+
+/*****************************************************************************/
+/* End of pool.h                                                             */
+/*****************************************************************************/
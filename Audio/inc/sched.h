@@ -0,0 +1,73 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 sched.h                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the task scheduler driven by the GPT0 tick.             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "usbstk5505.h"
+
+#define SCHED_TICK_HZ           1000    /* Times are in ticks, that is ms   */
+#define SCHED_TASKS             8
+
+/* Longest a task run by sched_run() should take. The audio loop has one     */
+/* sample period, 20.8 us at 48 kHz, for its own work and one task.          */
+
+#ifndef SCHED_BUDGET_US
+#define SCHED_BUDGET_US         10
+#endif
+
+/* Priorities. Lower numbers first. SCHED_PRIORITY_TICK tasks run in the     */
+/* timer interrupt, so they preempt the audio loop: keep them to a few us.   */
+
+#define SCHED_PRIORITY_TICK     0
+#define SCHED_PRIORITY_HIGH     1
+#define SCHED_PRIORITY_LOW      15
+
+#define SCHED_FULL              -1      /* Returned by sched_periodic() and */
+                                        /* sched_one_shot()                 */
+
+typedef void (*SCHED_Function)(void *context);
+
+typedef struct
+{
+    SCHED_Function function;
+    void *context;
+    Uint16 priority;
+    Uint16 period;                      /* 0 for a one-shot task            */
+    Uint16 deadline;                    /* Ticks from release to finish     */
+    Uint16 release;                     /* Tick of the next release         */
+    Uint16 released_at;                 /* Tick of the release now ready    */
+    Uint16 armed;                       /* More releases to come            */
+    Uint16 ready;                       /* Released and not yet run         */
+    Uint32 runs;
+    Uint16 overruns;                    /* Released again before it had run */
+    Uint16 misses;                      /* Finished after its deadline      */
+    Uint16 over_budget;                 /* Took longer than SCHED_BUDGET_US */
+    Uint32 worst_us;                    /* Longest run                      */
+} SCHED_TASK;
+
+void sched_init(void);
+Int16 sched_periodic(SCHED_Function function, void *context, Uint16 priority,
+                     Uint16 period, Uint16 deadline);
+Int16 sched_one_shot(SCHED_Function function, void *context, Uint16 priority,
+                     Uint16 delay, Uint16 deadline);
+void sched_cancel(Int16 task);
+void sched_tick(void);
+Int16 sched_run(void);
+
+extern SCHED_TASK sched_tasks[SCHED_TASKS];
+extern volatile Uint16 sched_now;
+
+#endif
+
+/*****************************************************************************/
+/* End of sched.h                                                            */
+/*****************************************************************************/
@@ -15,6 +15,7 @@
 /*   Revision 1.00                                                           */
 /*   15th February 2010. Created by Richard Sikora from TMS320C5510 code.    */
 /*   16th June 2010. Sinewave generator added for 8000 Hz sampling rate.     */
+/*   18th October 2026. Oscillator bank with 32-bit phase accumulators.      */
 /*                                                                           */
 /*****************************************************************************/
 /*
@@ -55,14 +56,41 @@
 #ifndef SINE_WAVES_H
 #define SINE_WAVES_H
 
+#include "tms320.h"
+
+#define OSCILLATOR_BLOCK_SIZE 32    /* Samples per call to sine() */
+
+typedef struct
+{
+    unsigned long phase;            /* 2^32 represents 2 pi             */
+    unsigned long increment;        /* Phase step per sample            */
+    signed int amplitude;           /* Peak value 0 to 32767            */
+    unsigned int frequency;         /* Frequency in whole Hz            */
+    unsigned long sampling_frequency;
+} OSCILLATOR;
+
+ void oscillator_init(OSCILLATOR *oscillator, unsigned long SamplingFrequency,
+                      unsigned int frequency, signed int amplitude,
+                      unsigned int phase);
+
+ void oscillator_set_frequency(OSCILLATOR *oscillator, unsigned int frequency);
+
+ void oscillator_set_frequency_q16(OSCILLATOR *oscillator,
+                                   unsigned long frequency);
+
+ void oscillator_set_amplitude(OSCILLATOR *oscillator, signed int amplitude);
+
+ void oscillator_generate(OSCILLATOR *bank, unsigned int oscillators,
+                          DATA *output, unsigned int nx, unsigned int add);
+
  signed int generate_sinewave_1( signed short int frequency, 
                                 signed short int amplitude);
 
- signed int generate_sinewave_2( unsigned short int frequency, 
-                                unsigned short int amplitude);                                
+ signed int generate_sinewave_2( signed short int frequency, 
+                                signed short int amplitude);                                
 
- signed int generate_sinewave_3( unsigned short int frequency, 
-                                unsigned short int amplitude); 
+ signed int generate_sinewave_3( signed short int frequency, 
+                                signed short int amplitude); 
 #endif
 
 /*****************************************************************************/
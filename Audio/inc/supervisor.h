@@ -0,0 +1,58 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 supervisor.h                                                            */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the sample deadline supervisor and the watchdog.        */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include "usbstk5505.h"
+
+/* Set to 0 to run without deadline checks or the watchdog */
+
+#ifndef SUPERVISOR
+#define SUPERVISOR              1
+#endif
+
+/* Processing levels. Each one sheds the stages of the one before too */
+
+#define SUPERVISOR_FULL         0
+#define SUPERVISOR_SHED_PITCH   1       /* No pitch estimate                */
+#define SUPERVISOR_SHED_DTMF    2       /* No DTMF detection                */
+#define SUPERVISOR_SHED_AGC     3       /* No AGC. Filters only             */
+#define SUPERVISOR_LEVELS       4
+
+#define SUPERVISOR_WINDOW       480     /* Samples checked together, 10 ms  */
+#define SUPERVISOR_SHED_LATE    4       /* Late samples in a window to shed */
+#define SUPERVISOR_CALM_WINDOWS 100     /* Windows with none to restore     */
+#define SUPERVISOR_WDT_MS       200     /* Reset if the loop stops for this */
+#define SUPERVISOR_WDT_PRESCALE 0xFFFF
+
+typedef struct
+{
+    Uint16 level;                       /* SUPERVISOR_FULL when all is well */
+    Uint32 late;                        /* Samples taking over a period     */
+    Uint16 overloaded_windows;          /* Windows with too many late       */
+    Uint16 sheds;                       /* Level raised                     */
+    Uint32 worst_us;                    /* Longest time for a sample        */
+} SUPERVISOR_STATS;
+
+void supervisor_init(Uint32 rate);
+void supervisor_set_clock(void);
+void supervisor_frame_start(void);
+void supervisor_frame_end(void);
+void supervisor_close(void);
+
+extern volatile SUPERVISOR_STATS supervisor_stats;
+
+#endif
+
+/*****************************************************************************/
+/* End of supervisor.h                                                       */
+/*****************************************************************************/
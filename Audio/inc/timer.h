@@ -37,6 +37,12 @@
 
 extern void VECSTART(void);
 
+extern unsigned int Step;                   /* Preset now in use */
+extern unsigned int playnum;                /* Preset changes so far */
+extern volatile unsigned int auto_switch;   /* 0 stops the changes */
+extern volatile unsigned int switch_secs;   /* Seconds between changes */
+extern volatile unsigned int change_limit;  /* Changes until the end */
+
 /**
  *  \brief  GPT Count Rate Verification test function
  *
@@ -59,6 +65,16 @@ extern void VECSTART(void);
  */
 void CSL_gptIntrTest(void);
 
+/**
+ *  \brief  Keep the scheduler tick at SCHED_TICK_HZ after the PLL has
+ *          been changed
+ *
+ *  \param  none
+ *
+ *  \return none
+ */
+void timer_set_clock(void);
+
 /**
  *  \brief  Function to calculate the system clock
  *
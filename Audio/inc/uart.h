@@ -0,0 +1,47 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 uart.h                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Header file for the interrupt driven UART with RAM buffers.             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef UART_H
+#define UART_H
+
+#include "usbstk5505.h"
+
+#define UART_BAUD               115200
+#define UART_RX_BYTES           64      /* Power of 2                       */
+#define UART_TX_BYTES           256     /* Power of 2                       */
+
+#define UART_FULL               -1      /* Returned by uart_write()         */
+
+typedef struct
+{
+    Uint32 rx_bytes;
+    Uint32 tx_bytes;
+    Uint16 rx_overflows;                /* Bytes lost, rx buffer full       */
+    Uint16 line_errors;                 /* Overrun, parity, framing, break  */
+} UART_STATS;
+
+void uart_init(void);
+void uart_set_clock(void);
+Int16 uart_write(const Uint8 *data, Uint16 length);
+Uint16 uart_read(Uint8 *data, Uint16 length);
+Uint16 uart_tx_room(void);
+Uint16 uart_tx_pending(void);
+Uint16 uart_tx_idle(void);
+void uart_close(void);
+interrupt void uart_isr(void);
+
+extern volatile UART_STATS uart_stats;
+
+#endif
+
+/*****************************************************************************/
+/* End of uart.h                                                             */
+/*****************************************************************************/
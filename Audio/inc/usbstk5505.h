@@ -99,6 +99,7 @@
 #define I2C_SAR    	       *(volatile ioport Uint16*)(0x1A1C)
 #define I2C_DXR    	       *(volatile ioport Uint16*)(0x1A20)
 #define I2C_MDR            *(volatile ioport Uint16*)(0x1A24)
+#define I2C_IVR            *(volatile ioport Uint16*)(0x1A28)
 #define I2C_EDR    	       *(volatile ioport Uint16*)(0x1A2C)
 #define I2C_PSC    	       *(volatile ioport Uint16*)(0x1A30)
 /* ------------------------------------------------------------------------ *
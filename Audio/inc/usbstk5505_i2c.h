@@ -64,12 +64,17 @@
 #define MDR_FREE		0x4000
 #define STR_XRDY		0x0010
 #define STR_RRDY		0x0008
+#define STR_SCD			0x0020
+#define STR_NACK		0x0002
+#define STR_AL			0x0001
 #define MDR_STP 		0x0800
 /* ------------------------------------------------------------------------ *
  *  Prototypes                                                              *
  * ------------------------------------------------------------------------ */
 Int16 USBSTK5505_I2C_init ( );
 Int16 USBSTK5505_I2C_close( );
+Int16 USBSTK5505_I2C_reset( );
+Int16 USBSTK5505_I2C_waitStop( );
 Int16 USBSTK5505_I2C_read( Uint16 i2c_addr, Uint8* data, Uint16 len );
 Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len );
 
@@ -21,6 +21,14 @@
 -sysstack 0x1000      /* Secondary stack size */
 -heap     0x2000      /* Heap area size       */
 
+/* With --define=DSPLIB_ROM on the link, the DSPLIB functions in the boot */
+/* ROM are called there instead of being linked from 55xdsph.lib. Write   */
+/* dsplib_rom.sym first with tools/rom_dsplib.c.                          */
+
+#ifdef DSPLIB_ROM
+dsplib_rom.sym
+#endif
+
 -c                    /* Use C linking conventions: auto-init vars at runtime */
 -u _Reset             /* Force load of reset interrupt handler                */
 
@@ -31,7 +39,11 @@ MEMORY
  PAGE 0:  /* ---- Unified Program/Data Address Space ---- */
 
   MMR    (RWIX): origin = 0x000000, length = 0x0000c0  /* MMRs */
-  DARAM0 (RWIX): origin = 0x0000c0, length = 0x00ff40  /*  64KB - MMRs */
+  DARAM0 (RWIX): origin = 0x0000c0, length = 0x001f40  /*   8KB - MMRs */
+  DARAM1 (RWIX): origin = 0x002000, length = 0x002000  /*   8KB Hot code */
+  DARAM2 (RWIX): origin = 0x004000, length = 0x002000  /*   8KB Coeffs   */
+  DARAM3 (RWIX): origin = 0x006000, length = 0x002000  /*   8KB Delays   */
+  DARAM4 (RWIX): origin = 0x008000, length = 0x008000  /*  32KB */
   SARAM0 (RWIX): origin = 0x010000, length = 0x010000  /*  64KB */
   SARAM1 (RWIX): origin = 0x020000, length = 0x020000  /* 128KB */
   SARAM2 (RWIX): origin = 0x040000, length = 0x00FE00  /*  64KB */
@@ -47,16 +59,25 @@ MEMORY
 
 SECTIONS
 {
+   /* Per sample kernels, coefficients and delay lines, see hotpath.h.  */
+   /* A DARAM block each, so a MAC reading a coefficient and a delay    */
+   /* line never waits on one bank. Checked by tools/map_check.c.       */
+   .text:hot >  DARAM1                /* Hot kernels                 */
+   .coeffs   >  DARAM2                /* Coefficient tables          */
+   .delay    >  DARAM3                /* Delay lines and filter state */
+
    .text     >> SARAM1|SARAM2|SARAM0  /* Code                        */
 
    /* Both stacks must be on same physical memory page               */
-   .stack    >  DARAM0                /* Primary system stack        */
-   .sysstack >  DARAM0                /* Secondary system stack      */
+   .stack    >  DARAM4                /* Primary system stack        */
+   .sysstack >  DARAM4                /* Secondary system stack      */
 
-   .data     >> DARAM0|SARAM0|SARAM1  /* Initialized vars            */
-   .bss      >> DARAM0|SARAM0|SARAM1  /* Global & static vars        */
-   .const    >> DARAM0|SARAM0|SARAM1  /* Constant data               */
-   .sysmem   >  DARAM0|SARAM0|SARAM1  /* Dynamic memory (malloc)     */
+   .data     >> DARAM0|DARAM4|SARAM0|SARAM1  /* Initialized vars     */
+   .bss      >> DARAM0|DARAM4|SARAM0|SARAM1  /* Global & static vars */
+   .const    >> DARAM0|DARAM4|SARAM0|SARAM1  /* Constant data        */
+   .sysmem   >  DARAM4|SARAM0|SARAM1  /* Dynamic memory (malloc)     */
+   .pool:daram > DARAM4               /* Pool blocks, see pool.h     */
+   .pool:saram >> SARAM0|SARAM1       /* Pool blocks, see pool.h     */
    .switch   >  SARAM2                /* Switch statement tables     */
    .cinit    >  SARAM2                /* Auto-initialization tables  */
    .pinit    >  SARAM2                /* Initialization fn tables    */
@@ -73,6 +73,16 @@
 /*****************************************************************************/
 
 
+#include "hotpath.h"
+
+/* Ahead of any declaration, see hotpath.h */
+
+#if (HOT_SECTIONS)
+#pragma DATA_SECTION(df1_x, ".delay")
+#pragma DATA_SECTION(df1_y, ".delay")
+#pragma CODE_SECTION(fourth_order_IIR_direct_form_I, ".text:hot")
+#endif
+
 /* Numerator coefficients */
 #define B0 0
 #define B1 1
@@ -83,6 +93,12 @@
 #define A1 4
 #define A2 5
 
+/* Delay lines for fourth_order_IIR_direct_form_I(), at file scope so they   */
+/* can be given a section.                                                   */
+
+static signed int df1_x[2][3] = { 0, 0, 0, 0, 0, 0 }; /* x(n), x(n-1), x(n-2) */
+static signed int df1_y[2][3] = { 0, 0, 0, 0, 0, 0 }; /* y(n), y(n-1), y(n-2) */
+
 /*****************************************************************************/
 /* fourth_order_IIR_direct_form_I()                                          */
 /*---------------------------------------------------------------------------*/
@@ -97,29 +113,27 @@
 signed int fourth_order_IIR_direct_form_I( const signed int * coefficients, signed int input)
 {
   long temp;
-  static signed int x[2][3] = { 0, 0, 0, 0, 0, 0 };  /* x(n), x(n-1), x(n-2). Must be static */
-  static signed int y[2][3] = { 0, 0, 0, 0, 0, 0 };  /* y(n), y(n-1), y(n-2). Must be static */ 
   unsigned int stages;
 
   temp = (long) input; /* Copy input to temp */
 
   for ( stages = 0 ; stages < 2 ; stages++)
     {
-     x[stages][0] = (signed int) temp; /* Copy input to x[stages][0] */
+     df1_x[stages][0] = (signed int) temp; /* Copy input to x[stages][0] */
     
-     temp =  ( (long) coefficients[B0] * x[stages][0]) ;   /* B0 * x(n)     */
+     temp =  ( (long) coefficients[B0] * df1_x[stages][0]) ;   /* B0 * x(n)     */
   
-     temp += ( (long) coefficients[B1] * x[stages][1]);    /* B1/2 * x(n-1) */
+     temp += ( (long) coefficients[B1] * df1_x[stages][1]);    /* B1/2 * x(n-1) */
 
-     temp += ( (long) coefficients[B1] * x[stages][1]);    /* B1/2 * x(n-1) */
+     temp += ( (long) coefficients[B1] * df1_x[stages][1]);    /* B1/2 * x(n-1) */
 
-     temp += ( (long) coefficients[B2] * x[stages][2]);    /* B2 * x(n-2)   */
+     temp += ( (long) coefficients[B2] * df1_x[stages][2]);    /* B2 * x(n-2)   */
   
-     temp -= ( (long) coefficients[A1] * y[stages][1]);    /* A1/2 * y(n-1) */
+     temp -= ( (long) coefficients[A1] * df1_y[stages][1]);    /* A1/2 * y(n-1) */
   
-     temp -= ( (long) coefficients[A1] * y[stages][1]);    /* A1/2 * y(n-1) */
+     temp -= ( (long) coefficients[A1] * df1_y[stages][1]);    /* A1/2 * y(n-1) */
 
-     temp -= ( (long) coefficients[A2] * y[stages][2]);    /* A2 * y(n-2)   */
+     temp -= ( (long) coefficients[A2] * df1_y[stages][2]);    /* A2 * y(n-2)   */
  
      /* Divide temp by coefficients[A0] */    
 
@@ -136,15 +150,15 @@ signed int fourth_order_IIR_direct_form_I( const signed int * coefficients, sign
          temp = -32767;
        }
 
-     y[stages][0] = (short int) ( temp );
+     df1_y[stages][0] = (short int) ( temp );
 
      /* Shuffle values along one place for next time */
   
-     y[stages][2] = y[stages][1];   /* y(n-2) = y(n-1) */
-     y[stages][1] = y[stages][0];   /* y(n-1) = y(n)   */
+     df1_y[stages][2] = df1_y[stages][1];   /* y(n-2) = y(n-1) */
+     df1_y[stages][1] = df1_y[stages][0];   /* y(n-1) = y(n)   */
     
-     x[stages][2] = x[stages][1];   /* x(n-2) = x(n-1) */
-     x[stages][1] = x[stages][0];   /* x(n-1) = x(n)   */
+     df1_x[stages][2] = df1_x[stages][1];   /* x(n-2) = x(n-1) */
+     df1_x[stages][1] = df1_x[stages][0];   /* x(n-1) = x(n)   */
 
      /* temp is used as input next time through */
    }
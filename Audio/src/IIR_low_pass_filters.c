@@ -0,0 +1,144 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 IIR_low_pass_filters.c                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Coefficients of the IIR low pass filters.                               */
+/*   Filters have been designed using the BLT from Butterworth filter.       */
+/*                                                                           */
+/*   The order of the coefficients is B0, B1/2, B2, A0, A1/2, A2, where      */
+/*   B0, B1/2 and B2 are the numerator coefficients, A0, A1/2 and A2 are     */
+/*   the denominator coefficients.                                           */
+/*                                                                           */
+/* REVISION                                                                  */
+/*   Revision: 1.00	                                                         */
+/*   Author  : Richard Sikora                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* HISTORY                                                                   */
+/*   Revision 1.00                                                           */
+/*   3rd December 2002. Created by Richard Sikora.                           */
+/*   18th October 2026. Moved out of IIR_low_pass_filters.h, so the tables   */
+/*   and their section are defined once whatever includes the header.        */
+/*                                                                           */
+/*****************************************************************************/
+/*
+ * Copyright (C) 2010 Texas Instruments Incorporated - http://www.ti.com/ 
+ * 
+ * 
+ *  Redistribution and use in source and binary forms, with or without 
+ *  modification, are permitted provided that the following conditions 
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright 
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the 
+ *    documentation and/or other materials provided with the   
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+*/
+
+#include "hotpath.h"
+
+/* The second order tables, ahead of IIR_low_pass_filters.h. See hotpath.h */
+
+#if (HOT_SECTIONS)
+#pragma DATA_SECTION(IIR_low_pass_300Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_600Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_1000Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_1200Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_2000Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_2400Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_4000Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_4800Hz, ".coeffs")
+#pragma DATA_SECTION(IIR_low_pass_9600Hz, ".coeffs")
+#endif
+
+#include "IIR_low_pass_filters.h"
+
+/*****************************************************************************/
+/* First order IIR low pass filters.                                         */
+/*****************************************************************************/
+
+const signed int first_order_low_pass_1000Hz[6] = { 2015, 2015, 32767, -28736 };
+
+const signed int first_order_low_pass_2000Hz[6] = {3812, 3812, 32767, -25143 };
+
+const signed int first_order_low_pass_4000Hz[6] = { 6924, 6924, 32767, -18918 };
+
+/*****************************************************************************/
+/* Second order IIR low pass filters.                                        */
+/*****************************************************************************/
+
+/* main() runs the one chosen with CMD_PARAM_FILTER for every sample */
+
+/* Second order low pass filter 300 Hz */
+const signed int IIR_low_pass_300Hz[6]  = {    13,     13,    13, 
+                                            32767, -31857,  30997 };
+
+/* Second order low pass filter 600 Hz */
+const signed int IIR_low_pass_600Hz[6]  = {    48,     48,    48, 
+                                            32767, -30949, 29322  };
+
+/* Second order low pass filter 1000 Hz */
+const signed int IIR_low_pass_1000Hz[6] = {   128,    128,   128, 
+                                            32767, -29742, 27330  };
+
+/* Second order low pass filter 1200 Hz */
+const signed int IIR_low_pass_1200Hz[6] = {   181,    181,   181, 
+                                            32767, -29096, 26150  };
+
+/* Second order low pass filter 2000 Hz */
+const signed int IIR_low_pass_2000Hz[6] = {    472,    472,   472,
+                                             32767, -26754, 22629  };
+
+/* Second order low pass filter 2400 Hz */
+const signed int IIR_low_pass_2400Hz[6] = {    658,    658,   658,
+                                             32767, -25575, 21015  };
+
+/* Second order low pass filter 4000 Hz */
+const signed int IIR_low_pass_4000Hz[6] = {   1622,   1622,  1622, 
+                                             32767, -20964, 15649  };
+
+/* Second order low pass filter 4800 Hz */
+const signed int IIR_low_pass_4800Hz[6] = {   2210,   2210,  2210, 
+                                             32767, -18726, 13526  };
+
+/* Second order low pass filter 9600 Hz */
+const signed int IIR_low_pass_9600Hz[6] = {   6769,   6769,  6768, 
+                                             32767,  -6053,  6416  };
+
+const signed int * const IIR_low_pass_tables[IIR_LOW_PASS_TABLES] =
+{
+    IIR_low_pass_300Hz,  IIR_low_pass_600Hz,  IIR_low_pass_1000Hz,
+    IIR_low_pass_1200Hz, IIR_low_pass_2000Hz, IIR_low_pass_2400Hz,
+    IIR_low_pass_4000Hz, IIR_low_pass_4800Hz, IIR_low_pass_9600Hz
+};
+
+const unsigned int IIR_low_pass_cutoffs[IIR_LOW_PASS_TABLES] =
+{
+    300, 600, 1000, 1200, 2000, 2400, 4000, 4800, 9600
+};
+
+/*****************************************************************************/
+/* End of IIR_low_pass_filters.c                                             */
+/*****************************************************************************/
@@ -62,13 +62,18 @@
  * 
  * 16-Oct-2010. Added # if defined CHIP_C5505_C5515
  * 
+ * 18-Oct-2026. Other frequencies worked out by pll_solve(). Added
+ * pll_setup_hz().
+ *
  * ============================================================================
  */
 
-#include<stdio.h>
 #include "csl_pll.h"
 #include "csl_general.h"
 #include "csl_pllAux.h"
+#include "log.h"
+#include "pll_solve.h"
+#include "PLL.h"
 
 PLL_Obj pllObj;
 PLL_Config pllCfg1;
@@ -106,18 +111,21 @@ PLL_Config pllCfg_120MHz    = {0x8392, 0xA000, 0x0806, 0x0000};
 #endif
 
 PLL_Config *pConfigInfo;
+PLL_Config pllCfg_solved;
 
 #define CSL_TEST_FAILED         (1)
 #define CSL_TEST_PASSED         (0)
 
-int pll_frequency_setup(unsigned int frequency)
+/* ---- pll_configure( ) ---- Program the PLL and switch to it */
+
+static int pll_configure(PLL_Config *config)
 {
     CSL_Status status;
 
     status = PLL_init(&pllObj, CSL_PLL_INST_0);
     if(CSL_SOK != status)
     {
-       printf("PLL init failed \n");
+       LOG2(LOG_PLL_FAILED, 1, status);
        return (status);
     }
 
@@ -125,92 +133,140 @@ int pll_frequency_setup(unsigned int frequency)
 
 	PLL_reset(hPll);
 
+   status = PLL_config (hPll, config);
+   if(CSL_SOK != status)
+   {
+       LOG2(LOG_PLL_FAILED, 2, status);
+       return(status);
+   }
+
+	status = PLL_getConfig(hPll, &pllCfg1);
+    if(status != CSL_SOK)
+	{
+	    LOG2(LOG_PLL_FAILED, 3, status);
+		return(status);
+	}
+
+    /* Register values against config values. Test Lock Mon in PLL_CNTRL2 */
+    /* will get set after the PLL is up                                    */
+
+    LOG3(LOG_PLL_REGISTER, 1, pllCfg1.PLLCNTL1, hPll->pllConfig->PLLCNTL1);
+    LOG3(LOG_PLL_REGISTER, 2, pllCfg1.PLLCNTL2, hPll->pllConfig->PLLCNTL2);
+    LOG3(LOG_PLL_REGISTER, 3, pllCfg1.PLLINCNTL, hPll->pllConfig->PLLINCNTL);
+    LOG3(LOG_PLL_REGISTER, 4, pllCfg1.PLLOUTCNTL, hPll->pllConfig->PLLOUTCNTL);
+
+   status = PLL_bypass(hPll);
+   if(CSL_SOK != status)
+   {
+       LOG2(LOG_PLL_FAILED, 4, status);
+       return(status);
+   }
+
+   status = PLL_enable(hPll);
+   if(CSL_SOK != status)
+   {
+       LOG2(LOG_PLL_FAILED, 5, status);
+       return(status);
+   }
+
+   return(CSL_TEST_PASSED);
+}
+
+/* ---- pll_solved( ) ---- Registers from pll_solve() into pllCfg_solved. */
+/* Logs 0 Hz set if hz cannot be reached.                                  */
+
+static PLL_Config *pll_solved(unsigned long hz)
+{
+    PLL_SOLUTION solution;
+
+    if (0 == pll_solve(hz, &solution))
+    {
+        LOG3(LOG_PLL_SOLVED, hz, 0, 0);
+        return (0);
+    }
+
+    pllCfg_solved.PLLCNTL1 = solution.cgcr1;
+    pllCfg_solved.PLLINCNTL = solution.cgcr2;
+    pllCfg_solved.PLLCNTL2 = solution.cgcr3;
+    pllCfg_solved.PLLOUTCNTL = solution.cgcr4;
+
+    LOG3(LOG_PLL_SOLVED, hz, solution.hz, solution.cgcr1);
+
+    return (&pllCfg_solved);
+}
+
+int pll_frequency_setup(unsigned int frequency)
+{
+   PLL_Config *solved;
+
    /* Configure the PLL for different frequencies */
 
    if ( frequency == 1)
     {
       pConfigInfo = &pllCfg_1MHz;
-      printf("\nLL frequency 1 MHz\n");
     }
    else if ( frequency == 2)
     {
       pConfigInfo = &pllCfg_2MHz;
-      printf("\nPLL frequency 2 MHz\n");     
     } 
    else if ( frequency == 12)
     {
       pConfigInfo = &pllCfg_12MHz; 
-      printf("\nPLL frequency 12 MHz\n");        
     }
    else if ( frequency == 40)
     {
       pConfigInfo = &pllCfg_40MHz;
-      printf("\nPLL frequency 40 MHz\n");     
     } 
    else if ( frequency == 60)
     {
       pConfigInfo = &pllCfg_60MHz; 
-      printf("\nPLL frequency 60 MHz\n");        
     }
    else if ( frequency == 75)
     {
       pConfigInfo = &pllCfg_75MHz;
-      printf("\nPLL frequency 75 MHz\n");     
     } 
    else if ( frequency == 98)
     {
       pConfigInfo = &pllCfg_98MHz; 
-      printf("\nPLL frequency 98 MHz\n");        
     }  
+   else if ( frequency == 100)
+    {
+      pConfigInfo = &pllCfg_100MHz;
+    }
    else if ( frequency == 120)
    {
       pConfigInfo = &pllCfg_120MHz;
-      printf("\nPLL frequency 120 MHz\n");        
    }
-   else 
+   else if ( (solved = pll_solved(frequency * 1000000UL)) != 0)
    {
-      pConfigInfo = &pllCfg_100MHz;
-      printf("\nPLL frequency 100 MHz\n");        
+      pConfigInfo = solved;
    }
-
-   status = PLL_config (hPll, pConfigInfo);
-   if(CSL_SOK != status)
+   else 
    {
-       printf("PLL config failed\n");
-       return(status);
+      pConfigInfo = &pllCfg_100MHz;
+      frequency = 100;
    }
 
-	status = PLL_getConfig(hPll, &pllCfg1);
-    if(status != CSL_SOK)
-	{
-	    printf("TEST FAILED: PLL get config... Failed.\n");
-		printf ("Reason: PLL_getConfig failed. [status = 0x%x].\n", status);
-		return(status);
-	}
+   LOG1(LOG_PLL_FREQUENCY, frequency);
 
-    printf("REGISTER --- CONFIG VALUES\n");
+   return (pll_configure(pConfigInfo));
+}
 
-    printf("PLL_CNTRL1   %04x --- %04x\n",pllCfg1.PLLCNTL1,hPll->pllConfig->PLLCNTL1);
-    printf("PLL_CNTRL2   %04x --- %04x Test Lock Mon will get set after PLL is up\n",
-                                pllCfg1.PLLCNTL2,hPll->pllConfig->PLLCNTL2);
-    printf("PLL_CNTRL3   %04x --- %04x\n",pllCfg1.PLLINCNTL,hPll->pllConfig->PLLINCNTL);
-    printf("PLL_CNTRL4   %04x --- %04x\n",pllCfg1.PLLOUTCNTL,hPll->pllConfig->PLLOUTCNTL);
+/* ---- pll_setup_hz( ) ---- Any clock pll_solve() can reach, in Hz. Use a */
+/* multiple of PLL_AUDIO_HZ for whole CPU cycles per sample. The PLL is left */
+/* alone if hz cannot be reached.                                            */
 
-   status = PLL_bypass(hPll);
-   if(CSL_SOK != status)
-   {
-       printf("PLL bypass failed:%d\n",CSL_ESYS_BADHANDLE);
-       return(status);
-   }
+int pll_setup_hz(unsigned long hz)
+{
+   PLL_Config *solved;
 
-   status = PLL_enable(hPll);
-   if(CSL_SOK != status)
+   solved = pll_solved(hz);
+   if (0 == solved)
    {
-       printf("PLL enable failed:%d\n",CSL_ESYS_BADHANDLE);
-       return(status);
+       return (CSL_ESYS_INVPARAMS);
    }
 
-   return(CSL_TEST_PASSED);
+   return (pll_configure(solved));
 }
 
 /********************************************************************************************/
@@ -4,14 +4,29 @@
 /*   SweepGenerator.c                                                        */
 /*                                                                           */
 /* DESCRIPTION                                                               */
-/*   Generate frequencies between 20Hz and 20000Hz using a logarithmic       */
-/*   sweep.                                                                  */
+/*   Exponential (logarithmic) sweep generator and swept-sine impulse        */
+/*   response measurement.                                                   */
 /*                                                                           */
-/*   Uses e power x using the expn() function from 55xdsph.lib               */
-/*   This produces a Q4.12 output between 1000h (1.000) to 2B7Dh (2.718 = e) */   
+/*   For an exponential sweep the frequency is multiplied by the same        */
+/*   constant k = (f2 / f1) ^ (1 / length) every sample. The phase increment */
+/*   is therefore updated by a 32 x 32 bit multiplication each sample, with  */
+/*   the remainder carried forward so there is no drift. No per-sample       */
+/*   call to expn() is needed.                                               */
+/*                                                                           */
+/*   The measurement plays a sweep, records the line input, then convolves   */
+/*   the recording with the inverse filter (the sweep reversed in time with  */
+/*   an envelope rising 6 dB per octave). The linear impulse response        */
+/*   appears at the end of the sweep and each harmonic distortion product    */
+/*   appears length * ln(k) / ln(f2 / f1) samples earlier.                   */
+/*                                                                           */
+/*   The convolution sums up to SWEEP_MEASURE_LENGTH products of 2^30 in a   */
+/*   long long, which is 40 bits on the C55x. Products are summed in chunks  */
+/*   of SWEEP_CHUNK, which cannot overflow, and each chunk is scaled down    */
+/*   by enough for the number of chunks before it is added to the total.     */
+/*   Output samples that still clip are counted in sweep_clipped.            */
 /*                                                                           */
 /* REVISION                                                                  */
-/*   Revision: 1.01                                                          */
+/*   Revision: 1.02                                                          */
 /*   Author  : Richard Sikora                                                */
 /*---------------------------------------------------------------------------*/
 /*                                                                           */
@@ -21,150 +36,472 @@
 /*   20th December 2009. Created by Richard Sikora.                          */
 /*   Revision 1.01                                                           */
 /*   14th March 2010. step made static to suppress linker error in main      */
+/*   Revision 1.02                                                           */
+/*   18th October 2026. Continuous sweep using phase increment recurrence    */
+/*   instead of expn() segments. Impulse response measurement added.         */
 /*                                                                           */
 /*****************************************************************************/
 
+#include <math.h>
 #include "tms320.h"
 #include "dsplib.h"
+#include "SweepGenerator.h"
 
 #define SAMPLES_PER_SECOND 48000
 
-#define E__3  0xA0AFUL   // 20.0855 in unsigned Q6:10 format
-#define E__4  0xDA64UL   // 54.5981 in unsigned Q6:10 format
-#define E__5  0x9469UL   // 148.413 in unsigned Q8:8 format
-#define E__6  0xC980UL   // 403.28  in unsigned Q9:7 format
-#define E__7  0x8910UL   // 1096.53 in unsigned Q11:5 format
-#define E__8  0xBA4FUL   // 2980.95 in unsigned Q12:4 format
-#define E__9  0xFD38UL   // 8103.08 in unsigned Q13:3 format
+#define SWEEP_BLOCK_SIZE        32      /* Samples per call to sine()       */
+#define SWEEP_RATE_SCALE        1073741824.0    /* 2^30                     */
+#define SWEEP_DECONVOLVE_SHIFT  25      /* Unity gain system gives peak 0.4 */
+#define SWEEP_ACCUMULATOR_BITS  39      /* 40-bit long long, less the sign  */
+#define SWEEP_PRODUCT_BITS      30      /* -32768 * -32768                  */
+#define SWEEP_CHUNK             ( 1L << ( SWEEP_ACCUMULATOR_BITS - SWEEP_PRODUCT_BITS - 1 ) )
+
+#define SWEEP_RECORD_LENGTH     (SWEEP_MEASURE_LENGTH + SWEEP_MEASURE_TAIL)
+
+DATA sweep_impulse_response[SWEEP_IR_LENGTH];
+DATA sweep_harmonic_response[SWEEP_HARMONICS][SWEEP_HARMONIC_LENGTH];
+unsigned int sweep_clipped;
+
+static DATA angle[SWEEP_BLOCK_SIZE];
+
+/*****************************************************************************/
+/* sweep_step()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* increment = increment * (1 + rate). rate is Q30. The 64-bit product is    */
+/* built from four 16 x 16 bit products.                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+static void sweep_step(SWEEP *sweep)
+{
+ unsigned long a_hi = sweep->increment >> 16;
+ unsigned long a_lo = sweep->increment & 0xFFFF;
+ unsigned long b_hi = sweep->rate >> 16;
+ unsigned long b_lo = sweep->rate & 0xFFFF;
+ unsigned long hi;
+ unsigned long lo;
+ unsigned long mid;
+ unsigned long temp;
+
+ hi = a_hi * b_hi;
+ lo = a_lo * b_lo;
+
+ mid = a_hi * b_lo;
+ temp = lo + (mid << 16);
+ hi += (mid >> 16) + ( temp < lo ? 1 : 0 );
+ lo = temp;
+
+ mid = a_lo * b_hi;
+ temp = lo + (mid << 16);
+ hi += (mid >> 16) + ( temp < lo ? 1 : 0 );
+ lo = temp;
+
+ temp = lo + sweep->fraction;
+ hi += ( temp < lo ? 1 : 0 );
+ lo = temp;
+
+ sweep->increment += (hi << 2) | (lo >> 30);
+ sweep->fraction = lo & 0x3FFFFFFFUL;
+
+ /* Start again at f1. Phase is continuous. */
+
+ if ( ++sweep->count >= sweep->length )
+   {
+    sweep->count = 0;
+    sweep->increment = sweep->start_increment;
+    sweep->fraction = 0;
+   }
+}
+
+/*****************************************************************************/
+/* sweep_init()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* PARAMETER 1: Sweep.                                                       */
+/* PARAMETER 2: Sampling frequency in Hz.                                    */
+/* PARAMETER 3: Start frequency in Hz.                                       */
+/* PARAMETER 4: Stop frequency in Hz. Greater than the start frequency.      */
+/* PARAMETER 5: Number of samples from start to stop frequency.             */
+/* PARAMETER 6: Maximum amplitude between 0 and 32767.                       */
+/*                                                                           */
+/*****************************************************************************/
+
+void sweep_init(SWEEP *sweep, unsigned long SamplingFrequency,
+                unsigned int start_frequency, unsigned int stop_frequency,
+                unsigned long length, signed int amplitude)
+{
+ unsigned long numerator;
+ double x;
+
+ if ( start_frequency < 1 )
+   {
+    start_frequency = 1;
+   }
+
+ if ( stop_frequency <= start_frequency )
+   {
+    stop_frequency = start_frequency + 1;
+   }
+
+ if ( length < 1 )
+   {
+    length = 1;
+   }
+
+ /* Phase increment = f1 * 2^32 / fs */
+
+ numerator = (unsigned long) start_frequency << 16;
+
+ sweep->start_increment = ( numerator / SamplingFrequency ) << 16;
+ sweep->start_increment += ( ( numerator % SamplingFrequency ) << 16 ) / SamplingFrequency;
+
+ /* k - 1 = exp(x) - 1 where x = ln(f2 / f1) / length. Series keeps precision */
+
+ x = log( (double) stop_frequency / (double) start_frequency ) / (double) length;
+
+ sweep->rate = (unsigned long) ( x * ( 1.0 + x / 2.0 * ( 1.0 + x / 3.0 ) ) * SWEEP_RATE_SCALE + 0.5 );
+
+ sweep->increment = sweep->start_increment;
+ sweep->fraction = 0;
+ sweep->phase = 0;
+ sweep->length = length;
+ sweep->count = 0;
+ sweep->amplitude = ( amplitude < 0 ) ? 0 : amplitude;
+ sweep->sampling_frequency = SamplingFrequency;
+}
+
+/*****************************************************************************/
+/* sweep_generate()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Generate nx samples of the sweep. sine() is called once per block.        */
+/*                                                                           */
+/*****************************************************************************/
+
+void sweep_generate(SWEEP *sweep, DATA *output, unsigned int nx)
+{
+ unsigned int n;
+ unsigned int block;
+ unsigned int done;
+
+ for ( done = 0 ; done < nx ; done += block)
+   {
+    block = nx - done;
 
-#define TICKS_1s 	22369   // Scaling factor for ticks for 1 second per scan
-#define TICKS_2_8s 	 7829   // Scaling factor for ticks for 2.8 seconds per scan
+    if ( block > SWEEP_BLOCK_SIZE )
+      {
+       block = SWEEP_BLOCK_SIZE;
+      }
 
-static DATA counter = 0;
-static unsigned long ticks = 0; // May need to exceed 48000
+    for ( n = 0 ; n < block ; n++)
+      {
+       angle[n] = (DATA) ( sweep->phase >> 16 );
+       sweep->phase += sweep->increment;
+       sweep_step(sweep);
+      }
 
-static enum {step_e3, step_e4, step_e5, step_e6, step_e7, step_e8, step_e9 } step = step_e3;
+    sine(angle, &output[done], block);
+
+    for ( n = 0 ; n < block ; n++)
+      {
+       output[done + n] = (DATA) ( ( (long) output[done + n] * sweep->amplitude ) >> 15 );
+      }
+   }
+}
+
+/*****************************************************************************/
+/* sweep_frequency()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Present frequency of the sweep in Hz.                            */
+/*                                                                           */
+/*****************************************************************************/
+
+unsigned int sweep_frequency(SWEEP *sweep)
+{
+ return (unsigned int) ( ( ( sweep->increment >> 16 ) * sweep->sampling_frequency ) >> 16 );
+}
 
 /*****************************************************************************/
 /* SweepGenerator()                                                          */
 /*---------------------------------------------------------------------------*/
 /*                                                                           */
 /* Generate frequencies between 20Hz and 20000Hz on a logarithmic scale.     */
+/* One sweep takes 7 x 2.8 seconds as before, but is now continuous.         */
 /*                                                                           */
-/*                                                                           */
-/* CALLED BY: Called by main() loop once every 1/48000 second.               */ 
+/* CALLED BY: Called by main() loop once every 1/48000 second.               */
 /* RETURNS: Frequency between 20Hz and 20000Hz.                              */
 /*                                                                           */
 /*****************************************************************************/
 
-
 unsigned int SweepGenerator(void)
 {
- DATA exponent;
- unsigned int frequency = 0;	
- long temp;
-
- temp = (ticks * TICKS_2_8s); // Multiply ticks by scaling factor for time.
- temp >>=15;                  // Remove fractional part 
- counter = (DATA) temp;
- ticks++;
- 
- /* Always calculate the exponent */
- expn(&counter, &exponent, 1); // Determine e power x
-  	
- switch (step)
- {
-  case step_e3:
-  default:
-  	temp = ( exponent * E__3);    // Multiply by e power 3
-  	frequency = (unsigned int)(temp >> 23);  // Remove fractional part. Shift before cast.
-
-  	if ( counter >= 32767)
-   	{
-   		ticks = 0;       // Reset counter back to beginning
-   		step = step_e4;    // Go to next step of sweep
-   	} 
-
-  break;
-  
-  case step_e4:
-    temp = (exponent * E__4);
-    frequency = (unsigned int)(temp >> 22); 
-
-   if ( counter >= 32767)
-     {
-      	ticks = 0;
-      	step = step_e5; // Go to next step of sweep.
-     } 
-     
-   break;
-  
-  case step_e5:
-    temp = (exponent * E__5);
-    frequency = (unsigned int)(temp >> 20); 
-  
-    if ( counter >= 32767)
-     {
-      	ticks = 0;
-      	step = step_e6; // Go to next step of sweep.
-     } 
-
-   break;  
-  
-  case step_e6:
-    temp = (exponent * E__6);
-    frequency = (unsigned int)(temp >> 19); 
-  
-   if ( counter >= 32767)
-     {
-      	ticks = 0;
-      	step = step_e7; // Go to next step of sweep.
-     } 
-
-   break; 
-  
-  case step_e7:
-    temp = (exponent * E__7);
-    frequency = (unsigned int)(temp >> 17); 
-  
-    if ( counter >= 32767)
-     {
-      	ticks = 0;
-      	step = step_e8; // Go to next step of sweep.
-     } 
-
-   break; 
-  
-  case step_e8:
-    temp = (exponent * E__8);
-    frequency = (unsigned int)(temp >> 16); 
-  
-    if ( counter >= 32767)
-     {
-      	ticks = 0;
-      	step = step_e9; // Go to next step of sweep.
-     } 
-
-   break; 
-   
-  case step_e9:
-    temp = (exponent * E__9);
-    frequency = (unsigned int)(temp >> 15); 
-  
-    if ( counter >= 32767)
-     {
-      	ticks = 0;
-      	step = step_e3; // Go to next step of sweep.
-     } 
-
-   break;   
- }
+ static SWEEP sweep;
+ static int initialised = 0;
+ unsigned int frequency;
+
+ if ( 0 == initialised )
+   {
+    sweep_init(&sweep, SAMPLES_PER_SECOND, 20, 20000, 940800UL, 0);
+    initialised = 1;
+   }
+
+ frequency = sweep_frequency(&sweep);
+
+ sweep_step(&sweep);
 
  return (frequency);
 }
 
+/*****************************************************************************/
+/* Impulse response measurement                                              */
+/*****************************************************************************/
+
+static SWEEP measure_sweep;
+static SWEEP_STATE measure_state = SWEEP_IDLE;
+static unsigned long measure_count;
+static unsigned long harmonic_offset[SWEEP_HARMONICS];
+
+static DATA sweep_inverse[SWEEP_MEASURE_LENGTH];
+static DATA sweep_record[SWEEP_RECORD_LENGTH];
+static DATA sweep_block[SWEEP_BLOCK_SIZE];
+static unsigned int chunk_shift;        /* Scaling of each chunk sum        */
+static unsigned int sweep_block_index;
+
+/*****************************************************************************/
+/* sweep_measure_start()                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Build the inverse filter, then start playing the sweep and recording.     */
+/* The inverse filter is built before the audio starts so it does not        */
+/* affect real-time operation.                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+void sweep_measure_start(unsigned long SamplingFrequency)
+{
+ unsigned long t;
+ unsigned long stop_increment;
+ unsigned long envelope;
+ unsigned int k;
+ DATA x;
+ DATA y;
+ double log_ratio;
+
+ sweep_init(&measure_sweep, SamplingFrequency, SWEEP_MEASURE_F1,
+            SWEEP_MEASURE_F2, SWEEP_MEASURE_LENGTH, 32767);
+
+ /* Envelope rises 6 dB per octave: f(t) / f2 = increment / stop increment */
+
+ stop_increment = ( ( measure_sweep.start_increment >> 16 ) * SWEEP_MEASURE_F2 ) / SWEEP_MEASURE_F1;
+
+ for ( t = 0 ; t < SWEEP_MEASURE_LENGTH ; t++)
+   {
+    x = (DATA) ( measure_sweep.phase >> 16 );
+    sine(&x, &y, 1);
+
+    envelope = ( ( measure_sweep.increment >> 16 ) << 15 ) / stop_increment;
+
+    if ( envelope > 32767 )
+      {
+       envelope = 32767;
+      }
+
+    sweep_inverse[SWEEP_MEASURE_LENGTH - 1 - t] = (DATA) ( ( (long) y * (long) envelope ) >> 15 );
+
+    measure_sweep.phase += measure_sweep.increment;
+    sweep_step(&measure_sweep);
+   }
+
+ log_ratio = log( (double) SWEEP_MEASURE_F2 / (double) SWEEP_MEASURE_F1 );
+
+ for ( k = 0 ; k < SWEEP_HARMONICS ; k++)
+   {
+    harmonic_offset[k] = (unsigned long) ( SWEEP_MEASURE_LENGTH * log( (double) (k + 2) ) / log_ratio + 0.5 );
+   }
+
+ /* Up to 2^chunk_shift chunks, so the scaled chunk sums add up to less */
+ /* than one chunk sum, and the total fits as well.                     */
+
+ chunk_shift = 0;
+
+ while ( ( ( SWEEP_MEASURE_LENGTH + SWEEP_CHUNK - 1 ) / SWEEP_CHUNK ) >> chunk_shift > 1 )
+   {
+    chunk_shift++;
+   }
+
+ /* Same sweep again for playback */
+
+ sweep_init(&measure_sweep, SamplingFrequency, SWEEP_MEASURE_F1,
+            SWEEP_MEASURE_F2, SWEEP_MEASURE_LENGTH, SWEEP_MEASURE_AMPLITUDE);
+
+ sweep_block_index = SWEEP_BLOCK_SIZE;
+ measure_count = 0;
+ measure_state = SWEEP_RECORDING;
+}
+
+/*****************************************************************************/
+/* sweep_measure_process()                                                   */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* CALLED BY: main() loop once every sample period during measurement.       */
+/* INPUT:     Line input.                                                    */
+/* RETURNS:   Next sample of the sweep to send to the output.                */
+/*                                                                           */
+/*****************************************************************************/
+
+signed int sweep_measure_process(signed int input)
+{
+ signed int output = 0;
+
+ if ( SWEEP_RECORDING != measure_state )
+   {
+    return 0;
+   }
+
+ sweep_record[measure_count] = (DATA) input;
+
+ if ( measure_count < SWEEP_MEASURE_LENGTH )
+   {
+    if ( sweep_block_index >= SWEEP_BLOCK_SIZE )
+      {
+       sweep_generate(&measure_sweep, sweep_block, SWEEP_BLOCK_SIZE);
+       sweep_block_index = 0;
+      }
+
+    output = sweep_block[sweep_block_index++];
+   }
+
+ if ( ++measure_count >= SWEEP_RECORD_LENGTH )
+   {
+    measure_state = SWEEP_COMPLETE;
+   }
+
+ return output;
+}
+
+/*****************************************************************************/
+/* sweep_measure_state()                                                     */
+/*****************************************************************************/
+
+SWEEP_STATE sweep_measure_state(void)
+{
+ return measure_state;
+}
+
+/*****************************************************************************/
+/* deconvolve()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* One output sample of the convolution of the recording with the inverse   */
+/* filter. Index SWEEP_MEASURE_LENGTH - 1 corresponds to zero delay.        */
+/* Saturates at +/- 32767 and counts it in sweep_clipped.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static DATA deconvolve(long m)
+{
+ long j;
+ long first;
+ long last;
+ long end;
+ long long chunk;
+ long long sum = 0;
+
+ first = m - (SWEEP_MEASURE_LENGTH - 1);
+
+ if ( first < 0 )
+   {
+    first = 0;
+   }
+
+ last = m;
+
+ if ( last > SWEEP_RECORD_LENGTH - 1 )
+   {
+    last = SWEEP_RECORD_LENGTH - 1;
+   }
+
+ for ( j = first ; j <= last ; )
+   {
+    end = j + SWEEP_CHUNK - 1;
+
+    if ( end > last )
+      {
+       end = last;
+      }
+
+    chunk = 0;
+
+    for ( ; j <= end ; j++)
+      {
+       chunk += (long) sweep_record[j] * sweep_inverse[m - j];
+      }
+
+    sum += chunk >> chunk_shift;
+   }
+
+ sum >>= SWEEP_DECONVOLVE_SHIFT - chunk_shift;
+
+ if ( sum > 32767 )
+   {
+    sum = 32767;
+    sweep_clipped++;
+   }
+ else if ( sum < -32767 )
+   {
+    sum = -32767;
+    sweep_clipped++;
+   }
+
+ return (DATA) sum;
+}
+
+/*****************************************************************************/
+/* sweep_deconvolve()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Calculate the linear impulse response and the impulse responses of the    */
+/* 2nd, 3rd and 4th harmonic distortion products. Call once the state is     */
+/* SWEEP_COMPLETE. Takes about 7 million multiply-accumulates so real-time   */
+/* audio should be stopped. sweep_clipped is then the samples that clipped.  */
+/*                                                                           */
+/*****************************************************************************/
+
+void sweep_deconvolve(void)
+{
+ unsigned int n;
+ unsigned int k;
+ long start;
+
+ if ( SWEEP_COMPLETE != measure_state )
+   {
+    return;
+   }
+
+ sweep_clipped = 0;
+
+ start = (SWEEP_MEASURE_LENGTH - 1) - SWEEP_IR_PRE;
+
+ for ( n = 0 ; n < SWEEP_IR_LENGTH ; n++)
+   {
+    sweep_impulse_response[n] = deconvolve(start + n);
+   }
+
+ for ( k = 0 ; k < SWEEP_HARMONICS ; k++)
+   {
+    start = (SWEEP_MEASURE_LENGTH - 1) - SWEEP_IR_PRE - (long) harmonic_offset[k];
+
+    for ( n = 0 ; n < SWEEP_HARMONIC_LENGTH ; n++)
+      {
+       sweep_harmonic_response[k][n] = deconvolve(start + n);
+      }
+   }
+
+ measure_state = SWEEP_IDLE;
+}
+
 /******************************************************************************/
 /* End of SweepGenerator.c                                                    */
 /******************************************************************************/
-
-
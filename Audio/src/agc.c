@@ -0,0 +1,266 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 agc.c                                                                   */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Automatic gain control (AGC) of the line input.                         */
+/*                                                                           */
+/*   The power of each block of AGC_BLOCK_SIZE output samples is measured    */
+/*   using power() from 55xdsph.lib and a digital gain is adjusted once per  */
+/*   block. When the digital gain moves more than 6 dB from unity, 6 dB is   */
+/*   transferred to or from the AIC3204 MIC PGA so that the ADC works with   */
+/*   the largest usable signal.                                              */
+/*                                                                           */
+/*   The PGA write is put on the I2C queue, so the audio loop never waits    */
+/*   for the bus. The matching digital compensation is applied once the I2C  */
+/*   interrupt reports that the codec registers have been written.           */
+/*                                                                           */
+/*   Only the filtered output carries the digital gain, so main() runs the   */
+/*   AGC at Step 1 only. At Step 0, or when the supervisor sheds it,         */
+/*   agc_bypass() holds the PGA at its nominal gain.                         */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "hotpath.h"
+
+/* Ahead of agc.h, see hotpath.h */
+
+#if (HOT_SECTIONS)
+#pragma DATA_SECTION(block, ".delay")
+#pragma CODE_SECTION(agc_process, ".text:hot")
+#endif
+
+#include "tms320.h"
+#include "dsplib.h"
+#include "agc.h"
+#include "aic3204.h"
+
+/* Thresholds for the sum of AGC_BLOCK_SIZE squared samples, each scaled    */
+/* by 2^-AGC_POWER_SHIFT. Values are Q31 for a sinewave of the given peak.  */
+
+#define AGC_TARGET_HIGH     67588043L   /*  -9 dBFS. Reduce gain above this */
+#define AGC_TARGET_LOW      16977348L   /* -15 dBFS. Increase gain below this */
+#define AGC_NOISE_FLOOR     2137L       /* -54 dBFS. Hold gain below this   */
+
+#define AGC_ATTACK_SHIFT    4           /* Gain -0.56 dB per block          */
+#define AGC_RELEASE_SHIFT   7           /* Gain +0.07 dB per block          */
+
+volatile Uint16 agc_gain = AGC_UNITY_GAIN;
+volatile Uint16 agc_pga_gain = 0;
+
+static Uint16 agc_pga_nominal = 0;      /* From agc_init()                  */
+
+/* Handshake between audio loop and I2C interrupt. The audio loop sets      */
+/* agc_pga_request and agc_pga_done() clears it and sets agc_pga_applied.   */
+
+static volatile Int16 agc_pga_request = 0;
+static volatile Int16 agc_pga_applied = 0;
+
+static DATA block[AGC_BLOCK_SIZE];
+static unsigned int block_index = 0;
+
+/*****************************************************************************/
+/* agc_init()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUT: ADC gain in dB as passed to set_sampling_frequency_and_gain().     */
+/*                                                                           */
+/*****************************************************************************/
+
+void agc_init(unsigned int ADCgain)
+{
+ if ( ADCgain >= 48)
+   {
+    agc_pga_gain = AGC_PGA_MAX;
+   }
+ else
+   {
+    agc_pga_gain = ADCgain << 1; /* Convert 1 dB steps to 0.5 dB steps */
+   }
+
+ agc_pga_nominal = agc_pga_gain;
+ agc_gain = AGC_UNITY_GAIN;
+ agc_pga_request = 0;
+ agc_pga_applied = 0;
+ block_index = 0;
+}
+
+/*****************************************************************************/
+/* agc_pga_done()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Called from the I2C interrupt when the PGA write has finished, or from    */
+/* agc_update() if the PGA already had the gain. After an error the request  */
+/* is dropped and the AGC asks again.                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static void agc_pga_done(Int16 status, Uint8 *data, Uint16 length,
+                         void *context)
+{
+ Int16 request = agc_pga_request;
+
+ if ( I2C_QUEUE_OK == status )
+   {
+    agc_pga_gain += request;
+    agc_pga_applied = request;
+   }
+
+ agc_pga_request = 0;
+}
+
+/*****************************************************************************/
+/* agc_update()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Once per block. Adjust digital gain and hand large corrections to the     */
+/* codec PGA.                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static void agc_update(void)
+{
+ LDATA block_power;
+ Uint16 gain = agc_gain;
+ Int16 applied;
+
+ /* Background has changed the PGA. Compensate so the level does not jump */
+
+ applied = agc_pga_applied;
+
+ if ( applied > 0 )
+   {
+    gain >>= 1;
+    agc_pga_applied = 0;
+   }
+ else if ( applied < 0 )
+   {
+    gain = ( gain > (AGC_MAX_GAIN >> 1) ) ? AGC_MAX_GAIN : (gain << 1);
+    agc_pga_applied = 0;
+   }
+
+ power(block, &block_power, AGC_BLOCK_SIZE);
+
+ if ( block_power > AGC_TARGET_HIGH )
+   {
+    gain -= gain >> AGC_ATTACK_SHIFT;
+   }
+ else if ( block_power < AGC_TARGET_LOW && block_power > AGC_NOISE_FLOOR )
+   {
+    gain += gain >> AGC_RELEASE_SHIFT;
+   }
+
+ if ( gain > AGC_MAX_GAIN )
+   {
+    gain = AGC_MAX_GAIN;
+   }
+ else if ( gain < AGC_MIN_GAIN )
+   {
+    gain = AGC_MIN_GAIN;
+   }
+
+ /* Large corrections are moved into the codec PGA */
+
+ if ( 0 == agc_pga_request && 0 == agc_pga_applied )
+   {
+    if ( gain > AGC_PGA_UP_GAIN && agc_pga_gain + AGC_PGA_STEP <= AGC_PGA_MAX )
+      {
+       agc_pga_request = AGC_PGA_STEP;
+      }
+    else if ( gain < AGC_PGA_DOWN_GAIN && agc_pga_gain >= AGC_PGA_STEP )
+      {
+       agc_pga_request = -AGC_PGA_STEP;
+      }
+
+    /* Try again next block if the queue is full */
+
+    if ( 0 != agc_pga_request
+         && 0 != aic3204_pga_gain_async(agc_pga_gain + agc_pga_request,
+                                        agc_pga_done, 0) )
+      {
+       agc_pga_request = 0;
+      }
+   }
+
+ agc_gain = gain;
+}
+
+/*****************************************************************************/
+/* agc_process()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUT:   One sample from the line input.                                  */
+/*                                                                           */
+/* RETURNS: Sample multiplied by the current digital gain.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 agc_process(Int16 input)
+{
+ long temp;
+
+ temp = ( (long) input * agc_gain ) >> 12;
+
+ if ( temp > 32767 )
+   {
+    temp = 32767;
+   }
+ else if ( temp < -32767 )
+   {
+    temp = -32767;
+   }
+
+ block[block_index++] = (DATA) ( temp >> AGC_POWER_SHIFT );
+
+ if ( block_index >= AGC_BLOCK_SIZE )
+   {
+    block_index = 0;
+    agc_update();
+   }
+
+ return ( (Int16) temp );
+}
+
+/*****************************************************************************/
+/* agc_bypass()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Called for each sample instead of agc_process() while the AGC is not      */
+/* run. The digital gain no longer makes up for the PGA, so the PGA is put   */
+/* back to the gain given to agc_init() once any write in progress is done.  */
+/* agc_process() then starts again from unity gain.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+void agc_bypass(void)
+{
+ Int16 request;
+
+ agc_gain = AGC_UNITY_GAIN;
+
+ if ( 0 != agc_pga_request )
+   {
+    return;
+   }
+
+ agc_pga_applied = 0;
+ request = (Int16) agc_pga_nominal - (Int16) agc_pga_gain;
+
+ if ( 0 != request )
+   {
+    agc_pga_request = request;
+
+    /* Try again next sample if the queue is full */
+
+    if ( 0 != aic3204_pga_gain_async(agc_pga_nominal, agc_pga_done, 0) )
+      {
+       agc_pga_request = 0;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* End of agc.c                                                              */
+/*****************************************************************************/
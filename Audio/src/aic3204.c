@@ -59,15 +59,215 @@
 #include "aic3204.h"
 #include "usbstk5505_gpio.h"
 #include "usbstk5505_i2c.h"
+#include "i2c_queue.h"
+#include "delay.h"
 
 Int16 counter1; // Counters for monitoring real-time operation.
 Int16 counter2;
 
+AIC3204_STATS aic3204_stats;
+
+/* Shadow of the page 0 and page 1 registers. A register is only compared  */
+/* once it has been written since the last reset, so nothing depends on    */
+/* the reset values in the data sheet.                                     */
+
+static Uint8 shadow[AIC3204_SHADOW_PAGES][128];
+static Uint16 shadow_valid[AIC3204_SHADOW_PAGES][8]; // One bit per register
+
+static Uint16 selected_page = 0;   // Page selected by AIC3204_rset( 0, page )
+static Int16 codec_page = -1;      // Page the codec is on. -1 if not known
+
+/* After a reset the codec is not accessed until reset_wait has expired,   */
+/* so other start up work can run in the meantime.                         */
+
+static DELAY_TIMEOUT reset_wait;
+static Uint16 reset_waiting = 0;   // reset_wait has not been seen to expire
+static Uint16 reset_fresh = 0;     // Hardware reset and nothing written since
+
+/* Caller's callback for a queued write. The queue holds no more than      */
+/* I2C_QUEUE_SIZE transactions, so a slot is free again by the time it is  */
+/* reused.                                                                 */
+
+typedef struct
+{
+    I2C_Callback callback;
+    void *context;
+} AIC3204_ASYNC;
+
+static AIC3204_ASYNC async_slot[I2C_QUEUE_SIZE];
+static AIC3204_ASYNC async_none = { 0, 0 };  // Queued page selects
+static Uint16 async_next = 0;
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_async_done( status, data, length, context )                     *
+ *                                                                          *
+ *      Called from the I2C interrupt when a queued write has finished.     *
+ *      The shadow was updated when the write was queued, so after an       *
+ *      error nothing is known about the codec registers or page.           *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static void aic3204_async_done( Int16 status, Uint8* data, Uint16 length,
+                                void* context )
+{
+    AIC3204_ASYNC* async = (AIC3204_ASYNC*) context;
+
+    if ( status != I2C_QUEUE_OK )
+    {
+        aic3204_shadow_invalidate();
+        codec_page = -1;
+        aic3204_stats.async_errors++;
+    }
+
+    if ( async->callback )
+        async->callback( status, data, length, async->context );
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_i2c_write( cmd, len, async )                                    *
+ *                                                                          *
+ *      Send one write transaction and count it. With async it is put on   *
+ *      the I2C queue, otherwise it waits for the queue to empty and is     *
+ *      sent at once. Waits first if the codec is still coming out of      *
+ *      reset.                                                              *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static Int16 aic3204_i2c_write( Uint8* cmd, Uint16 len, AIC3204_ASYNC* async )
+{
+    if ( reset_waiting )
+    {
+        while ( !delay_timeout_expired( &reset_wait ) )
+        {
+        }
+
+        reset_waiting = 0;
+    }
+
+    reset_fresh = 0;
+
+    aic3204_stats.transactions++;
+    aic3204_stats.bytes += len + 1;   // Slave address byte
+
+    if ( async )
+        return i2c_queue_write( AIC3204_I2C_ADDR, cmd, len,
+                                aic3204_async_done, async );
+
+    i2c_queue_flush( );
+    return USBSTK5505_I2C_write( AIC3204_I2C_ADDR, cmd, len );
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_select_page( page, async )                                      *
+ *                                                                          *
+ *      Put the codec on a page unless it is already there                  *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static Int16 aic3204_select_page( Uint16 page, AIC3204_ASYNC* async )
+{
+    Uint8 cmd[2];
+    Int16 retcode;
+
+    if ( AIC3204_SHADOW && codec_page == (Int16) page )
+    {
+        aic3204_stats.pages_elided++;
+        return 0;
+    }
+
+    cmd[0] = 0;                     // Page select register
+    cmd[1] = page;
+
+    retcode = aic3204_i2c_write( cmd, 2, async ? &async_none : 0 );
+    codec_page = ( retcode == 0 ) ? (Int16) page : -1;
+    aic3204_stats.page_selects++;
+
+    return retcode;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_shadow_invalidate( )                                            *
+ *                                                                          *
+ *      Forget the shadow, for example after the codec has been reset       *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+void aic3204_shadow_invalidate(void)
+{
+    Uint16 i;
+
+    for ( i = 0 ; i < 8 ; i++ )
+    {
+        shadow_valid[0][i] = 0;
+        shadow_valid[1][i] = 0;
+    }
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  _AIC3204_shadow_read( page, regnum, regval )                            *
+ *                                                                          *
+ *      Last value written to a register, without using the I2C bus.        *
+ *      Returns 1 if the value is known, 0 if not.                          *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 AIC3204_shadow_read( Uint16 page, Uint16 regnum, Uint16* regval )
+{
+    regnum &= 0x007F;
+
+    if ( !AIC3204_SHADOW || page >= AIC3204_SHADOW_PAGES )
+        return 0;
+
+    if ( !( shadow_valid[page][regnum >> 4] & ( 1 << ( regnum & 15 ) ) ) )
+        return 0;
+
+    *regval = shadow[page][regnum];
+    return 1;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  shadow_matches( page, regnum, regval )                                  *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static Int16 shadow_matches( Uint16 page, Uint16 regnum, Uint16 regval )
+{
+    Uint16 current;
+
+    if ( !AIC3204_shadow_read( page, regnum, &current ) )
+        return 0;
+
+    return ( current == ( regval & 0xFF ) );
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  shadow_update( page, regnum, regval )                                   *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static void shadow_update( Uint16 page, Uint16 regnum, Uint16 regval )
+{
+    if ( page == 0 && regnum == 1 && ( regval & 1 ) )
+    {
+        /* Software reset. Everything goes back to default on page 0 */
+        aic3204_shadow_invalidate();
+        codec_page = 0;
+        return;
+    }
+
+    if ( page < AIC3204_SHADOW_PAGES )
+    {
+        shadow[page][regnum] = regval & 0xFF;
+        shadow_valid[page][regnum >> 4] |= 1 << ( regnum & 15 );
+    }
+}
+
 /* ------------------------------------------------------------------------ *
  *                                                                          *
  *  _AIC3204_rget( regnum, regval )                                         *
  *                                                                          *
- *      Return value of codec register regnum                               *
+ *      Return value of codec register regnum on the selected page          *
+ *      Reads always go to the codec as some registers are status flags    *
  *                                                                          *
  * ------------------------------------------------------------------------ */
 Int16 AIC3204_rget(  Uint16 regnum, Uint16* regval )
@@ -75,33 +275,237 @@ Int16 AIC3204_rget(  Uint16 regnum, Uint16* regval )
     Int16 retcode = 0;
     Uint8 cmd[2];
 
+    if ( AIC3204_SHADOW )
+        retcode |= aic3204_select_page( selected_page, 0 );
+
     cmd[0] = regnum & 0x007F;       // 7-bit Device Address
     cmd[1] = 0;
 
-    retcode |= USBSTK5505_I2C_write( AIC3204_I2C_ADDR, cmd, 1 );
+    retcode |= aic3204_i2c_write( cmd, 1, 0 );
     retcode |= USBSTK5505_I2C_read( AIC3204_I2C_ADDR, cmd, 1 );
 
     *regval = cmd[0];
-    USBSTK5505_wait( 10 );
     return retcode;
 }
 
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_send( page, regnum, values, count, async )                      *
+ *                                                                          *
+ *      Set count registers starting at regnum in one transaction using     *
+ *      the codec's register address auto-increment. Registers at either    *
+ *      end that already hold the value are left out. Returns 1 if nothing  *
+ *      needed to be sent.                                                  *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static Int16 aic3204_send( Uint16 page, Uint16 regnum, const Uint8* values,
+                           Uint16 count, AIC3204_ASYNC* async )
+{
+    Uint8 cmd[AIC3204_BURST_MAX + 1];
+    Uint16 first;
+    Uint16 last;
+    Uint16 i;
+    Int16 retcode;
+
+    regnum &= 0x007F;
+
+    if ( regnum == 0 || regnum + count > 128 || count > AIC3204_BURST_MAX )
+        return -1;
+
+    /* Reset is self clearing and never in the shadow, so never suppressed */
+    for ( first = 0 ; first < count ; first++ )
+    {
+        if ( !shadow_matches( page, regnum + first, values[first] ) )
+            break;
+    }
+
+    if ( first == count )
+    {
+        aic3204_stats.suppressed += count;
+        return 1;
+    }
+
+    for ( last = count - 1 ; last > first ; last-- )
+    {
+        if ( !shadow_matches( page, regnum + last, values[last] ) )
+            break;
+    }
+
+    aic3204_stats.suppressed += count - ( last - first + 1 );
+
+    retcode = aic3204_select_page( page, async );
+    if ( retcode != 0 )
+        return retcode;
+
+    cmd[0] = regnum + first;
+    for ( i = first ; i <= last ; i++ )
+    {
+        cmd[1 + i - first] = values[i];
+    }
+
+    retcode = aic3204_i2c_write( cmd, last - first + 2, async );
+    if ( retcode == 0 )
+    {
+        for ( i = first ; i <= last ; i++ )
+        {
+            shadow_update( page, regnum + i, values[i] );
+        }
+    }
+
+    return retcode;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  _AIC3204_write( page, regnum, regval )                                  *
+ *                                                                          *
+ *      Set codec register regnum on page to value regval                   *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 AIC3204_write( Uint16 page, Uint16 regnum, Uint16 regval )
+{
+    Uint8 value = regval;
+
+    if ( ( regnum & 0x007F ) == 0 )
+    {
+        return aic3204_select_page( regval, 0 );
+    }
+
+    return ( aic3204_send( page, regnum, &value, 1, 0 ) < 0 ) ? -1 : 0;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  _AIC3204_write_burst( page, regnum, values, count )                     *
+ *                                                                          *
+ *      Set count registers starting at regnum in one transaction           *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 AIC3204_write_burst( Uint16 page, Uint16 regnum,
+                           const Uint8* values, Uint16 count )
+{
+    return ( aic3204_send( page, regnum, values, count, 0 ) < 0 ) ? -1 : 0;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  _AIC3204_write_async( page, regnum, values, count, callback, context )  *
+ *                                                                          *
+ *      As AIC3204_write_burst( ) but the write is put on the I2C queue     *
+ *      and the function returns at once. callback is called from the I2C  *
+ *      interrupt when the registers have been written, or before this     *
+ *      function returns if they already hold the values.                  *
+ *                                                                          *
+ *      Returns:    0: Queued or nothing to send                            *
+ *                 <0: Error. I2C_QUEUE_FULL if there is no room, in which  *
+ *                     case nothing has been queued                         *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 AIC3204_write_async( Uint16 page, Uint16 regnum, const Uint8* values,
+                           Uint16 count, I2C_Callback callback, void* context )
+{
+    AIC3204_ASYNC* async;
+    Int16 retcode;
+
+    /* Room for a page select and the write */
+    if ( I2C_QUEUE_SIZE - i2c_queue_pending( ) < 2 )
+        return I2C_QUEUE_FULL;
+
+    async = &async_slot[async_next++ & ( I2C_QUEUE_SIZE - 1 )];
+    async->callback = callback;
+    async->context = context;
+
+    retcode = aic3204_send( page, regnum, values, count, async );
+
+    if ( retcode == 1 )
+    {
+        if ( callback )
+            callback( I2C_QUEUE_OK, 0, 0, context );
+        return 0;
+    }
+
+    return retcode;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_volume_async( volume, callback, context )                       *
+ *                                                                          *
+ *      DAC digital volume in 0.5 dB steps, -127 (-63.5 dB) to 48 (+24 dB). *
+ *      The right channel follows the left.                                 *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 aic3204_volume_async( Int16 volume, I2C_Callback callback,
+                            void* context )
+{
+    Uint8 value;
+
+    if ( volume > 48 )
+        volume = 48;
+    else if ( volume < -127 )
+        volume = -127;
+
+    value = volume & 0xFF;
+
+    return AIC3204_write_async( 0, 65, &value, 1, callback, context );
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_mute_async( mute, callback, context )                           *
+ *                                                                          *
+ *      Mute or unmute both DAC channels                                    *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 aic3204_mute_async( Uint16 mute, I2C_Callback callback, void* context )
+{
+    Uint8 value = mute ? 0x0E : 0x02;  // Left and right mute, right tracks left
+
+    return AIC3204_write_async( 0, 64, &value, 1, callback, context );
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_pga_gain_async( gain, callback, context )                       *
+ *                                                                          *
+ *      Left and right MIC PGA gain in 0.5 dB steps, 0 to 95                *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 aic3204_pga_gain_async( Uint16 gain, I2C_Callback callback,
+                              void* context )
+{
+    Uint8 values[2];
+
+    if ( gain > 95 )
+        gain = 95;
+
+    values[0] = gain;               // MIC_PGA_L
+    values[1] = gain;               // MIC_PGA_R
+
+    return AIC3204_write_async( 1, 0x3b, values, 2, callback, context );
+}
+
 /* ------------------------------------------------------------------------ *
  *                                                                          *
  *  _AIC3204_rset( regnum, regval )                                         *
  *                                                                          *
  *      Set codec register regnum to value regval                           *
+ *      Register 0 selects the page used by the following writes. It is     *
+ *      only sent to the codec when a write on that page needs it.          *
  *                                                                          *
  * ------------------------------------------------------------------------ */
 Int16 AIC3204_rset( Uint16 regnum, Uint16 regval )
 {
-    Uint8 cmd[2];
-    cmd[0] = regnum & 0x007F;       // 7-bit Device Address
-    cmd[1] = regval;                // 8-bit Register Data
+    if ( ( regnum & 0x007F ) == 0 )
+    {
+        selected_page = regval;
 
-    return USBSTK5505_I2C_write( AIC3204_I2C_ADDR, cmd, 2 );
-}
+        if ( AIC3204_SHADOW )
+            return 0;
+    }
 
+    return AIC3204_write( selected_page, regnum, regval );
+}
 
 /* ------------------------------------------------------------------------ *
  *                                                                          *
@@ -114,9 +518,45 @@ void aic3204_hardware_init(void)
  	SYS_EXBUSSEL |= 0x0020;  // Select A20/GPIO26 as GPIO26
 	USBSTK5505_GPIO_init();
 	USBSTK5505_GPIO_setDirection(GPIO26, GPIO_OUT);
+	USBSTK5505_GPIO_setOutput( GPIO26, 0 );    // Reset, even if still running
+	delay_us( AIC3204_RESET_PULSE_US );
 	USBSTK5505_GPIO_setOutput( GPIO26, 1 );    // Take AIC3204 chip out of reset
 	USBSTK5505_I2C_init( );                    // Initialize I2C
-	USBSTK5505_wait( 100 );  // Wait  
+
+	/* Codec ready after reset. Waited for by the first write, not here */
+	delay_timeout_start( &reset_wait, AIC3204_RESET_WAIT_US );
+	reset_waiting = 1;
+	reset_fresh = 1;
+
+	/* The shadow only holds registers written since the reset, and the */
+	/* page is not trusted until it has been written.                    */
+	aic3204_shadow_invalidate();
+	selected_page = 0;
+	codec_page = -1;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_software_reset( )                                               *
+ *                                                                          *
+ *      Put every register back to its default. Not needed, and not sent,   *
+ *      if nothing has been written since aic3204_hardware_init( ). The     *
+ *      wait after the reset is taken by the next write.                    *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 aic3204_software_reset(void)
+{
+    Int16 retcode;
+
+    if ( reset_fresh )
+        return 0;
+
+    retcode = AIC3204_write( 0, 1, 1 );
+
+    delay_timeout_start( &reset_wait, AIC3204_RESET_WAIT_US );
+    reset_waiting = 1;
+
+    return retcode;
 }
 
 /* ------------------------------------------------------------------------ *
@@ -0,0 +1,536 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 aic3204_biquad.c                                                        */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Biquad filters run by the AIC3204 DAC processing block.                 */
+/*                                                                           */
+/*   The DAC processing block filters every sample on its way to the DAC,    */
+/*   so an equaliser or low pass filter set up here costs no C5505 cycles.   */
+/*   PRB_P1, the default, has biquads A to C on each channel and PRB_P2 has  */
+/*   biquads A to F. Unused biquads are left flat.                           */
+/*                                                                           */
+/*   The coefficients are held twice, in buffer A (pages 44 to 52) and       */
+/*   buffer B (pages 62 to 70). aic3204_configure() turns on adaptive mode,  */
+/*   so while the DAC runs from one buffer the other is written, then the    */
+/*   two are swapped at a sample boundary and the new coefficients are       */
+/*   copied into the buffer just released. A filter never runs with half     */
+/*   its coefficients changed.                                               */
+/*                                                                           */
+/*   Coefficient Cn is at register 8 + 4 * ( n % 30 ) of page                */
+/*   44 + n / 30 in buffer A, most significant byte first. Left biquad A     */
+/*   is C1 to C5 (N0, N1, N2, D1, D2), B is C6 to C10 and so on. Right       */
+/*   biquad A starts at C33.                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "usbstk5505.h"
+#include "aic3204.h"
+#include "aic3204_biquad.h"
+#include "i2c_queue.h"
+#include "delay.h"
+
+#define BUFFER_A            44          /* First page of each buffer        */
+#define BUFFER_B            62
+
+#define ADAPTIVE_REG        1           /* Page 44                          */
+#define ADAPTIVE_ENABLE     0x04
+#define ADAPTIVE_BUFFER     0x02        /* Read only. 1 if DAC uses buffer B */
+#define ADAPTIVE_SWITCH     0x01        /* Self clearing                    */
+
+#define DAC_FLAG_REG        37          /* Page 0                           */
+#define DAC_FLAG_POWERED    0x88        /* Left and right DAC powered up    */
+#define DAC_POWER_REG       63          /* Page 0                           */
+#define DAC_POWER_UP        0xC0
+#define DAC_PRB_REG         60          /* Page 0                           */
+
+#define LEFT_FIRST          1           /* C1, left biquad A N0             */
+#define RIGHT_FIRST         33          /* C33, right biquad A N0           */
+#define BIQUAD_COEFFICIENTS 5
+#define COEFFICIENTS_PER_PAGE 30
+#define COEFFICIENTS_PER_WRITE ( AIC3204_BURST_MAX / 4 )
+#define CHANNEL_BYTES       ( AIC3204_BIQUADS_MAX * BIQUAD_COEFFICIENTS * 4 )
+
+#define SWITCH_TIMEOUT_US   1000        /* Many samples at 6857 Hz          */
+#define POWER_TIMEOUT_US    20000       /* DAC volume soft steps to mute    */
+
+/* How a coefficient run is sent */
+
+#define SEND_COUNT          0           /* Only count the transactions      */
+#define SEND_NOW            1
+#define SEND_QUEUED         2
+
+static Uint16 prb_biquads = 3;          /* Biquads in the processing block  */
+static Uint16 active_buffer = BUFFER_A; /* Buffer the DAC is running from   */
+static Uint16 active_known = 0;         /* 0 if active_buffer is a guess    */
+
+/* Left then right coefficients, 4 bytes each */
+
+static Uint8 coefficient_bytes[2][CHANNEL_BYTES];
+
+/*****************************************************************************/
+/* limit()                                                                   */
+/*****************************************************************************/
+
+static long limit(long value)
+{
+ if ( value > 8388607L )
+   {
+    return 8388607L;
+   }
+ else if ( value < -8388608L )
+   {
+    return -8388608L;
+   }
+
+ return value;
+}
+
+/*****************************************************************************/
+/* aic3204_biquad_flat()                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Pass signal through unchanged. The codec's reset value.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+void aic3204_biquad_flat(AIC3204_BIQUAD *biquad)
+{
+ biquad->n0 = 8388607L;
+ biquad->n1 = 0;
+ biquad->n2 = 0;
+ biquad->d1 = 0;
+ biquad->d2 = 0;
+}
+
+/*****************************************************************************/
+/* aic3204_biquad_from_table()                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  Second order table as in IIR_low_pass_filters.h, that is         */
+/*          { B0, B1/2, B2, A0, A1/2, A2 } in Q15 with A0 = 32767.           */
+/*                                                                           */
+/* The codec adds the feedback terms where the tables subtract them.         */
+/*                                                                           */
+/*****************************************************************************/
+
+void aic3204_biquad_from_table(AIC3204_BIQUAD *biquad,
+                               const signed int *coefficients)
+{
+ biquad->n0 = (long) coefficients[0] << 8;
+ biquad->n1 = (long) coefficients[1] << 8;
+ biquad->n2 = (long) coefficients[2] << 8;
+ biquad->d1 = limit( -( (long) coefficients[4] << 8 ) );
+ biquad->d2 = limit( -( (long) coefficients[5] << 8 ) );
+}
+
+/*****************************************************************************/
+/* to_q23()                                                                  */
+/*****************************************************************************/
+
+static long to_q23(float value)
+{
+ value *= 8388608.0f;
+
+ if ( value >= 8388607.0f )
+   {
+    return 8388607L;
+   }
+ else if ( value <= -8388608.0f )
+   {
+    return -8388608L;
+   }
+
+ return (long) ( value >= 0.0f ? value + 0.5f : value - 0.5f );
+}
+
+/*****************************************************************************/
+/* aic3204_biquad_from_float()                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  H(z) = ( b0 + b1 z^-1 + b2 z^-2 ) / ( 1 + a1 z^-1 + a2 z^-2 ),   */
+/*          as given by a filter designer. Each coefficient sent to the      */
+/*          codec must be within +/- 1, so |b0|, |b1/2|, |b2|, |a1/2| and    */
+/*          |a2| are limited to just under 1.                                */
+/*                                                                           */
+/*****************************************************************************/
+
+void aic3204_biquad_from_float(AIC3204_BIQUAD *biquad, float b0, float b1,
+                               float b2, float a1, float a2)
+{
+ biquad->n0 = to_q23(b0);
+ biquad->n1 = to_q23(b1 * 0.5f);
+ biquad->n2 = to_q23(b2);
+ biquad->d1 = to_q23(a1 * -0.5f);
+ biquad->d2 = to_q23(-a2);
+}
+
+/*****************************************************************************/
+/* aic3204_biquad_reset()                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Called by aic3204_configure() once the codec has been reset and adaptive  */
+/* mode turned on. The DAC starts on buffer A with PRB_P1.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+void aic3204_biquad_reset(void)
+{
+ prb_biquads = 3;
+ active_buffer = BUFFER_A;
+ active_known = 1;
+}
+
+/*****************************************************************************/
+/* encode()                                                                  */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Put count biquads for one channel into 4 byte coefficient registers.      */
+/*                                                                           */
+/*****************************************************************************/
+
+static void encode(Uint8 *bytes, const AIC3204_BIQUAD *biquads, Uint16 count)
+{
+ long value;
+ Uint16 i;
+ Uint16 j;
+
+ for ( i = 0 ; i < count ; i++)
+   {
+    for ( j = 0 ; j < BIQUAD_COEFFICIENTS ; j++)
+      {
+       switch ( j )
+         {
+          case 0:  value = biquads[i].n0; break;
+          case 1:  value = biquads[i].n1; break;
+          case 2:  value = biquads[i].n2; break;
+          case 3:  value = biquads[i].d1; break;
+          default: value = biquads[i].d2; break;
+         }
+
+       bytes[0] = ( value >> 16 ) & 0xFF;
+       bytes[1] = ( value >> 8 ) & 0xFF;
+       bytes[2] = value & 0xFF;
+       bytes[3] = 0;                    /* Not used */
+       bytes += 4;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* biquad_done()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Called from the I2C interrupt. After a failed write the buffers may not   */
+/* match and the swap may not have happened.                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+static void biquad_done(Int16 status, Uint8 *data, Uint16 length,
+                        void *context)
+{
+ if ( I2C_QUEUE_OK != status )
+   {
+    active_known = 0;
+   }
+}
+
+/*****************************************************************************/
+/* send_run()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Write count coefficients from first onwards into the buffer starting at   */
+/* page base, in bursts that do not cross a page.                            */
+/*                                                                           */
+/* RETURNS: With SEND_COUNT, the most transactions needed. Otherwise 0, or   */
+/*          not 0 if a write failed or could not be queued.                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static Int16 send_run(Uint16 base, Uint16 first, const Uint8 *bytes,
+                      Uint16 count, Uint16 mode)
+{
+ Uint16 page;
+ Uint16 last_page = 0xFFFF;
+ Uint16 offset;
+ Uint16 burst;
+ Int16 result = 0;
+
+ while ( count > 0 )
+   {
+    page = base + first / COEFFICIENTS_PER_PAGE;
+    offset = first % COEFFICIENTS_PER_PAGE;
+    burst = COEFFICIENTS_PER_PAGE - offset;
+
+    if ( burst > COEFFICIENTS_PER_WRITE )
+      {
+       burst = COEFFICIENTS_PER_WRITE;
+      }
+
+    if ( burst > count )
+      {
+       burst = count;
+      }
+
+    if ( SEND_COUNT == mode )
+      {
+       result += ( page != last_page ) ? 2 : 1;   /* Page select and write */
+       last_page = page;
+      }
+    else if ( SEND_NOW == mode )
+      {
+       result |= AIC3204_write_burst(page, 8 + 4 * offset, bytes, burst * 4);
+      }
+    else
+      {
+       result |= AIC3204_write_async(page, 8 + 4 * offset, bytes, burst * 4,
+                                     biquad_done, 0);
+      }
+
+    first += burst;
+    bytes += burst * 4;
+    count -= burst;
+   }
+
+ return result;
+}
+
+/*****************************************************************************/
+/* send_buffer()                                                             */
+/*****************************************************************************/
+
+static Int16 send_buffer(Uint16 base, Uint16 count, Uint16 mode)
+{
+ Int16 result;
+
+ result = send_run(base, LEFT_FIRST, coefficient_bytes[0],
+                   count * BIQUAD_COEFFICIENTS, mode);
+
+ if ( SEND_COUNT == mode )
+   {
+    return result + send_run(base, RIGHT_FIRST, coefficient_bytes[1],
+                             count * BIQUAD_COEFFICIENTS, mode);
+   }
+
+ return result | send_run(base, RIGHT_FIRST, coefficient_bytes[1],
+                          count * BIQUAD_COEFFICIENTS, mode);
+}
+
+/*****************************************************************************/
+/* dac_running()                                                             */
+/*****************************************************************************/
+
+static Int16 dac_running(void)
+{
+ Uint16 power;
+
+ if ( !AIC3204_shadow_read(0, DAC_POWER_REG, &power) )
+   {
+    return 1;                           /* Assume so */
+   }
+
+ return ( 0 != ( power & DAC_POWER_UP ) );
+}
+
+/*****************************************************************************/
+/* aic3204_dac_processing_block()                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Select AIC3204_PRB_P1 or AIC3204_PRB_P2. The DAC is powered down while    */
+/* the block is changed, so this clicks and is meant for start up. The       */
+/* coefficients already loaded are kept. Do not call from an interrupt.      */
+/*                                                                           */
+/* RETURNS: 0 if selected, not 0 if the block is not supported or a write    */
+/*          failed.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 aic3204_dac_processing_block(Uint16 prb)
+{
+ DELAY_TIMEOUT timeout;
+ Uint16 power;
+ Uint16 flags;
+ Int16 result = 0;
+
+ if ( AIC3204_PRB_P1 != prb && AIC3204_PRB_P2 != prb )
+   {
+    return -1;
+   }
+
+ if ( !AIC3204_shadow_read(0, DAC_POWER_REG, &power) )
+   {
+    power = 0xD4;                       /* As set by aic3204_configure() */
+   }
+
+ result |= AIC3204_write(0, DAC_POWER_REG, power & ~DAC_POWER_UP);
+
+ /* The DAC volume steps down to mute before the DAC powers off */
+
+ delay_timeout_start(&timeout, POWER_TIMEOUT_US);
+
+ do
+   {
+    AIC3204_rset(0, 0);
+    result |= AIC3204_rget(DAC_FLAG_REG, &flags);
+   }
+ while ( ( flags & DAC_FLAG_POWERED ) && !delay_timeout_expired(&timeout) );
+
+ result |= AIC3204_write(0, DAC_PRB_REG, prb);
+ result |= AIC3204_write(0, DAC_POWER_REG, power);
+
+ prb_biquads = ( AIC3204_PRB_P2 == prb ) ? 6 : 3;
+
+ return result;
+}
+
+/*****************************************************************************/
+/* aic3204_dac_biquads()                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  count biquads for each channel, loaded into biquads A onwards.   */
+/*                                                                           */
+/* Waits for the I2C writes and for the DAC to swap buffers, over 20 ms for */
+/* 3 biquads at the 95 kHz I2C clock. Do not call from an interrupt.         */
+/*                                                                           */
+/* RETURNS: 0 if loaded, not 0 if count is more than the processing block    */
+/*          has or a write failed.                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 aic3204_dac_biquads(const AIC3204_BIQUAD *left,
+                          const AIC3204_BIQUAD *right, Uint16 count)
+{
+ DELAY_TIMEOUT timeout;
+ Uint16 adaptive;
+ Uint16 inactive;
+ Int16 result = 0;
+
+ if ( 0 == count || count > prb_biquads )
+   {
+    return -1;
+   }
+
+ encode(coefficient_bytes[0], left, count);
+ encode(coefficient_bytes[1], right, count);
+
+ AIC3204_rset(0, BUFFER_A);
+ result |= AIC3204_rget(ADAPTIVE_REG, &adaptive);
+ AIC3204_rset(0, 0);
+
+ if ( result || !( adaptive & ADAPTIVE_ENABLE ) )
+   {
+    /* Nothing can be swapped, so write both and hope for the best */
+
+    result |= send_buffer(BUFFER_A, count, SEND_NOW);
+    result |= send_buffer(BUFFER_B, count, SEND_NOW);
+    active_known = 0;
+    return result;
+   }
+
+ active_buffer = ( adaptive & ADAPTIVE_BUFFER ) ? BUFFER_B : BUFFER_A;
+
+ if ( !dac_running() )
+   {
+    /* Nothing is filtering, so both buffers can be written */
+
+    result |= send_buffer(BUFFER_A, count, SEND_NOW);
+    result |= send_buffer(BUFFER_B, count, SEND_NOW);
+    active_known = ( 0 == result );
+    return result;
+   }
+
+ inactive = ( BUFFER_A == active_buffer ) ? BUFFER_B : BUFFER_A;
+
+ result |= send_buffer(inactive, count, SEND_NOW);
+ result |= AIC3204_write(BUFFER_A, ADAPTIVE_REG,
+                         ADAPTIVE_ENABLE | ADAPTIVE_SWITCH);
+
+ delay_timeout_start(&timeout, SWITCH_TIMEOUT_US);
+ AIC3204_rset(0, BUFFER_A);
+
+ do
+   {
+    result |= AIC3204_rget(ADAPTIVE_REG, &adaptive);
+   }
+ while ( ( adaptive & ADAPTIVE_SWITCH ) && !delay_timeout_expired(&timeout) );
+
+ AIC3204_rset(0, 0);
+
+ if ( result || ( adaptive & ADAPTIVE_SWITCH ) )
+   {
+    active_known = 0;
+    return -1;
+   }
+
+ result |= send_buffer(active_buffer, count, SEND_NOW);
+ active_buffer = inactive;
+ active_known = ( 0 == result );
+
+ return result;
+}
+
+/*****************************************************************************/
+/* aic3204_dac_biquads_async()                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* As aic3204_dac_biquads() but the writes, the swap and the copy are all    */
+/* put on the I2C queue and the function returns at once, so it can be       */
+/* called from the audio loop. The DAC swaps at the next sample, long before */
+/* the copy that follows has its page select on the bus.                     */
+/*                                                                           */
+/* Up to 3 biquads fit in an empty queue of 16 transactions.                 */
+/*                                                                           */
+/* RETURNS: 0 if queued. I2C_QUEUE_FULL if there is not yet room, in which   */
+/*          case nothing is queued. -1 if count is wrong or the buffer in    */
+/*          use is not known, after a failed write; call                     */
+/*          aic3204_dac_biquads() to recover.                                */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 aic3204_dac_biquads_async(const AIC3204_BIQUAD *left,
+                                const AIC3204_BIQUAD *right, Uint16 count)
+{
+ static const Uint8 swap = ADAPTIVE_ENABLE | ADAPTIVE_SWITCH;
+ Uint16 inactive;
+ Uint16 needed;
+ Int16 result = 0;
+
+ if ( 0 == count || count > prb_biquads || !active_known )
+   {
+    return -1;
+   }
+
+ /* Both buffers and the swap, with a page select in front of it */
+
+ needed = 2 * send_buffer(BUFFER_A, count, SEND_COUNT) + 2;
+
+ if ( needed > I2C_QUEUE_SIZE - i2c_queue_pending() )
+   {
+    return I2C_QUEUE_FULL;
+   }
+
+ encode(coefficient_bytes[0], left, count);
+ encode(coefficient_bytes[1], right, count);
+
+ inactive = ( BUFFER_A == active_buffer ) ? BUFFER_B : BUFFER_A;
+
+ result |= send_buffer(inactive, count, SEND_QUEUED);
+ result |= AIC3204_write_async(BUFFER_A, ADAPTIVE_REG, &swap, 1,
+                               biquad_done, 0);
+ result |= send_buffer(active_buffer, count, SEND_QUEUED);
+
+ active_buffer = inactive;
+
+ if ( result )
+   {
+    active_known = 0;
+   }
+
+ return result;
+}
+
+/*****************************************************************************/
+/* End of aic3204_biquad.c                                                   */
+/*****************************************************************************/
@@ -22,6 +22,9 @@
 /*                       code. The crystal on the USB board has been changed */
 /*                       from an earlier release and therefore some register */
 /*                       values below also needed to be modified.            */
+/*   Revision 1.01                                                           */
+/*   18th October 2026. Register tables. Sampling frequency and gain changes */
+/*                      only write the registers that differ.                */
 /*                                                                           */
 /*****************************************************************************/
 /*
@@ -62,84 +65,202 @@
 
 #include "usbstk5505.h"
 #include "aic3204.h" 
-#include "stdio.h"        // For printf();          
+#include "aic3204_biquad.h"
+#include "delay.h"
+#include "log.h"
+
+#define AIC3204_PLL_WAIT_US  10000  // For the PLL to lock
 
 /* ------------------------------------------------------------------------ *
  *                                                                          *
- *  AIC3204 Initialisation.                                                 *
- *      Initialise both the registers and I2S                               *
+ *  Register tables. Applied in order by aic3204_apply().                   *
  *                                                                          *
  * ------------------------------------------------------------------------ */
- 
- /* Setup: Line input. Fs = 48000 Hz */
- 
-void aic3204_init(void)
+
+/* Power. Applied straight after a reset */
+static const AIC3204_REG aic3204_power[] =
+{
+    { 1, 1, 8 },                    // Disable crude AVDD generation from DVDD
+    { 1, 2, 1 },                    // Enable Analog Blocks, use LDO power
+};
+
+/* PLL. Register 5 (power, P and R) is written separately */
+static const AIC3204_REG aic3204_pll[] =
+{
+    { 0, 27, 0x1d },                // BCLK and WCLK is set as o/p to AIC3204(Master)
+    { 0, 28, 0x00 },                // Data ofset = 0
+    { 0, 4, 3 },                    // PLL setting: PLLCLK <- MCLK, CODEC_CLKIN <-PLL CLK
+    { 0, 6, 7 },                    // PLL setting: J=7
+    { 0, 7, 0x06 },                 // PLL setting: HI_BYTE(D)
+    { 0, 8, 0x90 },                 // PLL setting: LO_BYTE(D)
+    { 0, 30, 0x88 },                // For 32 bit clocks per frame in Master mode ONLY
+                                    // BCLK=DAC_CLK/N =(12288000/8) = 1.536MHz = 32*fs
+};
+
+/* Clock dividers, powered up */
+static const AIC3204_REG aic3204_clocks_on[] =
+{
+    { 0, 13, 0 },                   // Hi_Byte(DOSR) for DOSR = 128 decimal or 0x0080 DAC oversamppling
+    { 0, 14, 0x80 },                // Lo_Byte(DOSR) for DOSR = 128 decimal or 0x0080
+    { 0, 20, 0x80 },                // AOSR for AOSR = 128 decimal or 0x0080 for decimation filters 1 to 6
+    { 0, 11, 0x87 },                // Power up NDAC and set NDAC value to 7
+    { 0, 12, 0x82 },                // Power up MDAC and set MDAC value to 2
+    { 0, 18, 0x87 },                // Power up NADC and set NADC value to 7
+    { 0, 19, 0x82 },                // Power up MADC and set MADC value to 2
+};
+
+/* Clock dividers powered down while the PLL is changed */
+static const AIC3204_REG aic3204_clocks_off[] =
+{
+    { 0, 19, 0x02 },                // Power down MADC
+    { 0, 18, 0x07 },                // Power down NADC
+    { 0, 12, 0x02 },                // Power down MDAC
+    { 0, 11, 0x07 },                // Power down NDAC
+};
+
+/* DAC routing and power up */
+static const AIC3204_REG aic3204_dac[] =
+{
+    { 1, 0x0c, 8 },                 // LDAC AFIR routed to HPL
+    { 1, 0x0d, 8 },                 // RDAC AFIR routed to HPR
+    { 0, 64, 2 },                   // Left vol=right vol
+    { 0, 65, 0 },                   // Left DAC gain to 0dB VOL; Right tracks Left
+    { 0, 60, 1 },                   // DAC processing block PRB_P1
+    { 44, 1, 4 },                   // Adaptive filter mode. Only while DAC is off
+    { 0, 63, 0xd4 },                // Power up left,right data paths and set channel
+    { 1, 0x10, 10 },                // Unmute HPL , 10dB gain
+    { 1, 0x11, 10 },                // Unmute HPR , 10dB gain
+    { 1, 9, 0x30 },                 // Power up HPL,HPR
+    { AIC3204_DELAY, 0, 13 },       // wait
+};
+
+/* ADC routing, IN2 through 40 kohm. Used by aic3204_init() */
+static const AIC3204_REG aic3204_line_in_40k[] =
+{
+    { 1, 0x34, 0x30 },              // STEREO 1 Jack
+                                    // IN2_L to LADC_P through 40 kohm
+    { 1, 0x37, 0x30 },              // IN2_R to RADC_P through 40 kohmm
+    { 1, 0x36, 3 },                 // CM_1 (common mode) to LADC_M through 40 kohm
+    { 1, 0x39, 0xc0 },              // CM_1 (common mode) to RADC_M through 40 kohm
+};
+
+/* ADC routing, IN2 through 0 kohm. Used by set_sampling_frequency_and_gain() */
+static const AIC3204_REG aic3204_line_in_0k[] =
+{
+    { 1, 0x34, 0x10 },              // STEREO 1 Jack
+                                    // IN2_L to LADC_P through 0 kohm
+    { 1, 0x37, 0x10 },              // IN2_R to RADC_P through 0 kohmm
+    { 1, 0x36, 1 },                 // CM_1 (common mode) to LADC_M through 0 kohm
+    { 1, 0x39, 0x40 },              // CM_1 (common mode) to RADC_M through 0 kohm
+};
+
+/* ADC power up. MIC PGA gain is written before this */
+static const AIC3204_REG aic3204_adc[] =
+{
+    { 0, 0x51, 0xc0 },              // Powerup Left and Right ADC
+    { 0, 0x52, 0 },                 // Unmute Left and Right ADC
+    { AIC3204_DELAY, 0, 13 },       // Wait
+};
+
+/* Sampling frequencies. P divides the PLL output, R = 1 */
+static const struct
+{
+    unsigned long frequency;
+    Uint16 PLLPR;
+} aic3204_rates[] =
+{
+    { 48000, 0x91 },                // 1001 0001b. PLL on. P = 1, R = 1.
+    { 24000, 0xA1 },                // 1010 0001b. PLL on. P = 2, R = 1.
+    { 16000, 0xB1 },                // 1011 0001b. PLL on. P = 3, R = 1.
+    { 12000, 0xC1 },                // 1100 0001b. PLL on. P = 4, R = 1.
+    {  9600, 0xD1 },                // 1101 0001b. PLL on. P = 5, R = 1.
+    {  8000, 0xE1 },                // 1110 0001b. PLL on. P = 6, R = 1.
+    {  6857, 0xF1 },                // 1111 0001b. PLL on. P = 7, R = 1.
+};
+
+#define TABLE_SIZE(table) ( sizeof(table) / sizeof(table[0]) )
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_apply( table, count )                                           *
+ *                                                                          *
+ *      Write a register table. Registers that already hold the value are   *
+ *      skipped by the shadow, and so are delays if nothing was written     *
+ *      since the last one.                                                 *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 aic3204_apply( const AIC3204_REG* table, Uint16 count )
+{
+    Uint16 i;
+    Int16 retcode = 0;
+    Uint32 transactions = aic3204_stats.transactions;
+
+    for ( i = 0 ; i < count ; i++ )
+    {
+        if ( table[i].page == AIC3204_DELAY )
+        {
+            if ( aic3204_stats.transactions != transactions )
+            {
+                delay_us( table[i].value );
+                transactions = aic3204_stats.transactions;
+            }
+        }
+        else
+        {
+            retcode |= AIC3204_write( table[i].page, table[i].regnum, table[i].value );
+        }
+    }
+
+    return retcode;
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  aic3204_configure( PLLPR, routing, gain )                               *
+ *                                                                          *
+ *      Reset the codec and write a complete configuration                  *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static void aic3204_configure( Uint16 PLLPR, const AIC3204_REG* routing,
+                               Uint16 routing_count, Uint16 gain )
 {
-     
     /* Configure Serial Bus */
     SYS_EXBUSSEL |= 0x0100;  // Configure Serial bus 0 for I2S0
- 
-     
+
     /* Configure AIC3204 */
+    aic3204_software_reset( );      // Unless just reset by hardware
+
+    aic3204_apply( aic3204_power, TABLE_SIZE(aic3204_power) );
+    aic3204_apply( aic3204_pll, TABLE_SIZE(aic3204_pll) );
+    AIC3204_write( 0, 5, PLLPR );   // PLL setting: Power up PLL, P and R
+    aic3204_apply( aic3204_clocks_on, TABLE_SIZE(aic3204_clocks_on) );
+    aic3204_apply( aic3204_dac, TABLE_SIZE(aic3204_dac) );
+    aic3204_biquad_reset( );        // DAC biquads flat, buffer A in use
+    aic3204_apply( routing, routing_count );
+    AIC3204_write( 1, 0x3b, gain ); // MIC_PGA_L unmute
+    AIC3204_write( 1, 0x3c, gain ); // MIC_PGA_R unmute
+    aic3204_apply( aic3204_adc, TABLE_SIZE(aic3204_adc) );
+
+    AIC3204_rset( 0, 0 );           // Leave page 0 selected
 
-    AIC3204_rset( 0, 0 );      // Select page 0
-    AIC3204_rset( 1, 1 );      // Reset codec
-    AIC3204_rset( 0, 1 );      // Point to page 1
-    AIC3204_rset( 1, 8 );      // Disable crude AVDD generation from DVDD
-    AIC3204_rset( 2, 1 );      // Enable Analog Blocks, use LDO power
-    AIC3204_rset( 0, 0 );
-    /* PLL and Clocks config and Power Up  */
-    AIC3204_rset( 27, 0x1d );  // BCLK and WCLK is set as o/p to AIC3204(Master)
-    AIC3204_rset( 28, 0x00 );  // Data ofset = 0
-    AIC3204_rset( 4, 3 );      // PLL setting: PLLCLK <- MCLK, CODEC_CLKIN <-PLL CLK
-    AIC3204_rset( 6, 7 );      // PLL setting: J=7
-    AIC3204_rset( 7, 0x06 );   // PLL setting: HI_BYTE(D)
-    AIC3204_rset( 8, 0x90 );   // PLL setting: LO_BYTE(D)
-    AIC3204_rset( 30, 0x88 );  // For 32 bit clocks per frame in Master mode ONLY
-                               // BCLK=DAC_CLK/N =(12288000/8) = 1.536MHz = 32*fs
-    AIC3204_rset( 5, 0x91 );   //PLL setting: Power up PLL, P=1 and R=1
-    AIC3204_rset( 13, 0 );     // Hi_Byte(DOSR) for DOSR = 128 decimal or 0x0080 DAC oversamppling
-    AIC3204_rset( 14, 0x80 );  // Lo_Byte(DOSR) for DOSR = 128 decimal or 0x0080
-    AIC3204_rset( 20, 0x80 );  // AOSR for AOSR = 128 decimal or 0x0080 for decimation filters 1 to 6
-    AIC3204_rset( 11, 0x87 );  // Power up NDAC and set NDAC value to 7
-    AIC3204_rset( 12, 0x82 );  // Power up MDAC and set MDAC value to 2
-    AIC3204_rset( 18, 0x87 );  // Power up NADC and set NADC value to 7
-    AIC3204_rset( 19, 0x82 );  // Power up MADC and set MADC value to 2
-    /* DAC ROUTING and Power Up */
-    AIC3204_rset( 0, 1 );      // Select page 1
-    AIC3204_rset( 0x0c, 8 );   // LDAC AFIR routed to HPL
-    AIC3204_rset( 0x0d, 8 );   // RDAC AFIR routed to HPR
-    AIC3204_rset( 0, 0 );      // Select page 0
-    AIC3204_rset( 64, 2 );     // Left vol=right vol
-    AIC3204_rset( 65, 0 );     // Left DAC gain to 0dB VOL; Right tracks Left
-    AIC3204_rset( 63, 0xd4 );  // Power up left,right data paths and set channel
-    AIC3204_rset( 0, 1 );      // Select page 1
-    AIC3204_rset( 0x10, 10 );  // Unmute HPL , 10dB gain
-    AIC3204_rset( 0x11, 10 );  // Unmute HPR , 10dB gain
-    AIC3204_rset( 9, 0x30 );   // Power up HPL,HPR
-    AIC3204_rset( 0, 0 );      // Select page 0
-    USBSTK5505_wait( 100 );    // wait
-    /* ADC ROUTING and Power Up */
-    AIC3204_rset( 0, 1 );      // Select page 1
-    AIC3204_rset( 0x34, 0x30 );// STEREO 1 Jack
-		                       // IN2_L to LADC_P through 40 kohm
-    AIC3204_rset( 0x37, 0x30 );// IN2_R to RADC_P through 40 kohmm
-    AIC3204_rset( 0x36, 3 );   // CM_1 (common mode) to LADC_M through 40 kohm
-    AIC3204_rset( 0x39, 0xc0 );// CM_1 (common mode) to RADC_M through 40 kohm
-    AIC3204_rset( 0x3b, 0 );   // MIC_PGA_L unmute
-    AIC3204_rset( 0x3c, 0 );   // MIC_PGA_R unmute
-    AIC3204_rset( 0, 0 );      // Select page 0
-    AIC3204_rset( 0x51, 0xc0 );// Powerup Left and Right ADC
-    AIC3204_rset( 0x52, 0 );   // Unmute Left and Right ADC
-    
-    AIC3204_rset( 0, 0 );    
-    USBSTK5505_wait( 100 );  // Wait
-    
     /* I2S settings */
     I2S0_SRGR = 0x0;     
     I2S0_CR = 0x8010;    // 16-bit word, slave, enable I2C
     I2S0_ICMR = 0x3f;    // Enable interrupts
+}
 
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  AIC3204 Initialisation.                                                 *
+ *      Initialise both the registers and I2S                               *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+ 
+ /* Setup: Line input. Fs = 48000 Hz */
+ 
+void aic3204_init(void)
+{
+    aic3204_configure( 0x91, aic3204_line_in_40k, TABLE_SIZE(aic3204_line_in_40k), 0 );
 }
 
 /* ------------------------------------------------------------------------ *
@@ -147,140 +268,67 @@ void aic3204_init(void)
  *  AIC3204 Initialisation of both sampling frequency and gain in dB.       *
  *      Initialise both the registers and I2S                               *
  *                                                                          *
+ *      If the codec has already been configured only the registers that    *
+ *      change are written. The clock dividers are powered down while the   *
+ *      PLL P divider is changed.                                           *
+ *                                                                          *
  * ------------------------------------------------------------------------ */
 
 unsigned long set_sampling_frequency_and_gain(unsigned long SamplingFrequency, unsigned int ADCgain)
 {
     unsigned int PLLPR = 0x91; // Default to 48000 Hz 	
     unsigned int gain;
-    unsigned long output;
+    unsigned long output = 48000;
+    Uint16 current;
+    Uint16 i;
 
     if ( ADCgain >= 48)
      {
       gain = 95;      //  Limit gain to 47.5 dB
-      ADCgain = 48;   // For display using printf()
+      ADCgain = 48;   // For the log
      }
     else 
     {
      gain = (ADCgain << 1); // Convert 1dB steps to 0.5dB steps
     }
-     
-    switch (SamplingFrequency)
+
+    for ( i = 0 ; i < TABLE_SIZE(aic3204_rates) ; i++ )
     {
-     case 48000:
-     	PLLPR = 0x91; // 1001 0001b. PLL on. P = 1, R = 1. 
-     	printf("Sampling frequency 48000 Hz Gain = %2d dB\n", ADCgain);
-     	output = 48000;
-     break;
-     
-     case 24000:
-      	PLLPR = 0xA1; // 1010 0001b. PLL on. P = 2, R = 1.
-      	printf("Sampling frequency 24000 Hz Gain = %2d dB\n", ADCgain);
-      	output = 24000;   
-     break;
-     
-     case 16000:
-     	PLLPR = 0xB1; // 1011 0001b. PLL on. P = 3, R = 1.
-      	printf("Sampling frequency 16000 Hz Gain = %2d dB\n", ADCgain); 
-      	output = 16000;      	
-     break;
-     
-     case 12000:
-        PLLPR = 0xC1; //1100 0001b. PLL on. P = 4, R = 1.
-        printf("Sampling frequency 12000 Hz Gain = %2d dB\n", ADCgain);
-        output = 12000;  
-     break;
-     
-     case 9600:
-     	PLLPR = 0xD1; //1101 0001b. PLL on. P = 5, R = 1.
-       	printf("Sampling frequency 9600 Hz Gain = %2d dB\n", ADCgain); 
-       	output = 9600; 
-     break;
-     
-     case 8000:
-     	PLLPR = 0xE1; //1110 0001b. PLL on. P = 6, R = 1.
-     	printf("Sampling frequency 8000 Hz Gain = %2d dB\n", ADCgain);
-     	output = 8000;  
-     break;   	
-     
-     case 6857:
-     	PLLPR = 0xF1; //1111 0001b. PLL on. P = 7, R = 1.
-     	printf("Sampling frequency 6857 Hz Gain = %2d dB\n", ADCgain);  
-     	output = 6857;    
-     break;
-     
-     default:
-     	PLLPR = 0x91; // 1001 0001b. PLL on. P = 1, R = 1. 
-     	printf("Sampling frequency not recognised. Default to 48000 Hz Gain = %2d dB\n", ADCgain);
-     	output = 48000;  
-     break;
-    } 
- 
+        if ( aic3204_rates[i].frequency == SamplingFrequency )
+            break;
+    }
 
-     
-    /* Configure Serial Bus */
-    SYS_EXBUSSEL |= 0x0100;  // Configure Serial bus 0 for I2S0
- 
-     
-    /* Configure AIC3204 */
+    if ( i < TABLE_SIZE(aic3204_rates) )
+    {
+        PLLPR = aic3204_rates[i].PLLPR;
+        output = aic3204_rates[i].frequency;
+        LOG2(LOG_SAMPLING, output, ADCgain);
+    }
+    else
+    {
+        LOG2(LOG_SAMPLING_DEFAULT, SamplingFrequency, ADCgain);
+    }
 
-    AIC3204_rset( 0, 0 );      // Select page 0
-    AIC3204_rset( 1, 1 );      // Reset codec
-    AIC3204_rset( 0, 1 );      // Point to page 1
-    AIC3204_rset( 1, 8 );      // Disable crude AVDD generation from DVDD
-    AIC3204_rset( 2, 1 );      // Enable Analog Blocks, use LDO power
-    AIC3204_rset( 0, 0 );
-    /* PLL and Clocks config and Power Up  */
-    AIC3204_rset( 27, 0x1d );  // BCLK and WCLK is set as o/p to AIC3204(Master)
-    AIC3204_rset( 28, 0x00 );  // Data ofset = 0
-    AIC3204_rset( 4, 3 );      // PLL setting: PLLCLK <- MCLK, CODEC_CLKIN <-PLL CLK
-    AIC3204_rset( 6, 7 );      // PLL setting: J=7
-    AIC3204_rset( 7, 0x06 );   // PLL setting: HI_BYTE(D)
-    AIC3204_rset( 8, 0x90 );   // PLL setting: LO_BYTE(D)
-    AIC3204_rset( 30, 0x88 );  // For 32 bit clocks per frame in Master mode ONLY
-                               // BCLK=DAC_CLK/N =(12288000/8) = 1.536MHz = 32*fs
-    AIC3204_rset( 5, PLLPR );   //PLL setting: Power up PLL, P=1 and R=1
-    AIC3204_rset( 13, 0 );     // Hi_Byte(DOSR) for DOSR = 128 decimal or 0x0080 DAC oversamppling
-    AIC3204_rset( 14, 0x80 );  // Lo_Byte(DOSR) for DOSR = 128 decimal or 0x0080
-    AIC3204_rset( 20, 0x80 );  // AOSR for AOSR = 128 decimal or 0x0080 for decimation filters 1 to 6
-    AIC3204_rset( 11, 0x87 );  // Power up NDAC and set NDAC value to 7
-    AIC3204_rset( 12, 0x82 );  // Power up MDAC and set MDAC value to 2
-    AIC3204_rset( 18, 0x87 );  // Power up NADC and set NADC value to 7
-    AIC3204_rset( 19, 0x82 );  // Power up MADC and set MADC value to 2
-    /* DAC ROUTING and Power Up */
-    AIC3204_rset( 0, 1 );      // Select page 1
-    AIC3204_rset( 0x0c, 8 );   // LDAC AFIR routed to HPL
-    AIC3204_rset( 0x0d, 8 );   // RDAC AFIR routed to HPR
-    AIC3204_rset( 0, 0 );      // Select page 0
-    AIC3204_rset( 64, 2 );     // Left vol=right vol
-    AIC3204_rset( 65, 0 );     // Left DAC gain to 0dB VOL; Right tracks Left
-    AIC3204_rset( 63, 0xd4 );  // Power up left,right data paths and set channel
-    AIC3204_rset( 0, 1 );      // Select page 1
-    AIC3204_rset( 0x10, 10 );  // Unmute HPL , 10dB gain
-    AIC3204_rset( 0x11, 10 );  // Unmute HPR , 10dB gain
-    AIC3204_rset( 9, 0x30 );   // Power up HPL,HPR
-    AIC3204_rset( 0, 0 );      // Select page 0
-    USBSTK5505_wait( 100 );    // wait
-    /* ADC ROUTING and Power Up */
-    AIC3204_rset( 0, 1 );      // Select page 1
-    AIC3204_rset( 0x34, 0x10 );// STEREO 1 Jack
-		                       // IN2_L to LADC_P through 0 kohm
-    AIC3204_rset( 0x37, 0x10 );// IN2_R to RADC_P through 0 kohmm
-    AIC3204_rset( 0x36, 1 );   // CM_1 (common mode) to LADC_M through 0 kohm
-    AIC3204_rset( 0x39, 0x40 );// CM_1 (common mode) to RADC_M through 0 kohm
-    AIC3204_rset( 0x3b, gain );   // MIC_PGA_L unmute
-    AIC3204_rset( 0x3c, gain );   // MIC_PGA_R unmute
-    AIC3204_rset( 0, 0 );      // Select page 0
-    AIC3204_rset( 0x51, 0xc0 );// Powerup Left and Right ADC
-    AIC3204_rset( 0x52, 0 );   // Unmute Left and Right ADC
-    
-    AIC3204_rset( 0, 0 );    
-    USBSTK5505_wait( 100 );  // Wait
-    
-    /* I2S settings */
-    I2S0_SRGR = 0x0;     
-    I2S0_CR = 0x8010;    // 16-bit word, slave, enable I2C
-    I2S0_ICMR = 0x3f;    // Enable interrupts
+    if ( !AIC3204_shadow_read( 0, 5, &current ) )
+    {
+        /* Not configured since the last reset */
+        aic3204_configure( PLLPR, aic3204_line_in_0k, TABLE_SIZE(aic3204_line_in_0k), gain );
+        return(output);
+    }
+
+    if ( current != PLLPR )
+    {
+        aic3204_apply( aic3204_clocks_off, TABLE_SIZE(aic3204_clocks_off) );
+        AIC3204_write( 0, 5, PLLPR );   // PLL setting: Power up PLL, P and R
+        delay_us( AIC3204_PLL_WAIT_US );
+        aic3204_apply( aic3204_clocks_on, TABLE_SIZE(aic3204_clocks_on) );
+    }
+
+    aic3204_apply( aic3204_line_in_0k, TABLE_SIZE(aic3204_line_in_0k) );
+    AIC3204_write( 1, 0x3b, gain ); // MIC_PGA_L gain
+    AIC3204_write( 1, 0x3c, gain ); // MIC_PGA_R gain
+
+    AIC3204_rset( 0, 0 );           // Leave page 0 selected
 
  	return(output);
 }
@@ -290,8 +338,3 @@ unsigned long set_sampling_frequency_and_gain(unsigned long SamplingFrequency, u
  *  End of aic3204_init.c                                                   *
  *                                                                          *
  * ------------------------------------------------------------------------ */
-
-
-
-
-
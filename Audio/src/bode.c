@@ -0,0 +1,293 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 bode.c                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Stepped-sine frequency response (Bode) measurement.                     */
+/*                                                                           */
+/*   The generator steps through the ISO 1/3 octave frequencies. At each     */
+/*   step the first BODE_SETTLE_SAMPLES are discarded, then the stimulus     */
+/*   and the output of the chain are both correlated with sin and cos over   */
+/*   a whole number of cycles. The frequency response at that point is       */
+/*                                                                           */
+/*   H = (output_real + j.output_imag) / (input_real + j.input_imag)         */
+/*                                                                           */
+/*   In BODE_DIGITAL mode the stimulus goes straight into the chain and the  */
+/*   whole measurement is run by bode_run_digital(). In BODE_ANALOG mode     */
+/*   main() calls bode_process() once per sample with the line input, so     */
+/*   the result includes the DAC, the cable and the ADC. The phase then      */
+/*   includes the delay through the codec.                                   */
+/*                                                                           */
+/*   Only the correlations are accumulated while audio is running.           */
+/*   Magnitude and phase are calculated afterwards by bode_report().         */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include "tms320.h"
+#include "dsplib.h"
+#include "sinewaves.h"
+#include "bode.h"
+
+#define BODE_STIMULUS   0
+#define BODE_SIN        1
+#define BODE_COS        2
+
+const unsigned int bode_frequencies[BODE_POINTS] =
+{
+     20,    25,    31,    40,    50,    63,    80,   100,
+    125,   160,   200,   250,   315,   400,   500,   630,
+    800,  1000,  1250,  1600,  2000,  2500,  3150,  4000,
+   5000,  6300,  8000, 10000, 12500, 16000, 20000
+};
+
+BODE_Point bode_table[BODE_POINTS];
+unsigned int bode_points = 0;
+
+static OSCILLATOR generator[3];     /* Stimulus, sin and cos references     */
+static BODE_Chain bode_chain;
+static BODE_MODE bode_mode = BODE_DIGITAL;
+static BODE_STATE state = BODE_IDLE;
+static unsigned long fs;
+static unsigned int point;
+static unsigned long count;         /* Samples since the start of the step  */
+static unsigned long measure_length;
+
+/*****************************************************************************/
+/* bode_step()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Move all three oscillators to the frequency of the next point. The        */
+/* phases carry on so sin and cos stay in step with the stimulus.            */
+/*                                                                           */
+/*****************************************************************************/
+
+static void bode_step(void)
+{
+ unsigned int i;
+ unsigned int frequency;
+ unsigned long cycles;
+
+ if ( point >= bode_points )
+   {
+    state = BODE_COMPLETE;
+    return;
+   }
+
+ frequency = bode_frequencies[point];
+
+ for ( i = 0 ; i < 3 ; i++)
+   {
+    oscillator_set_frequency(&generator[i], frequency);
+   }
+
+ /* Whole number of cycles lasting at least BODE_MEASURE_SAMPLES */
+
+ cycles = ( (unsigned long) BODE_MEASURE_SAMPLES * frequency + fs - 1 ) / fs;
+ measure_length = ( cycles * fs + (frequency >> 1) ) / frequency;
+
+ bode_table[point].frequency = frequency;
+ bode_table[point].input_real = 0;
+ bode_table[point].input_imag = 0;
+ bode_table[point].output_real = 0;
+ bode_table[point].output_imag = 0;
+ bode_table[point].magnitude = 0;
+ bode_table[point].phase = 0;
+
+ count = 0;
+}
+
+/*****************************************************************************/
+/* bode_init()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: BODE_DIGITAL or BODE_ANALOG.                                      */
+/*         Sampling frequency in Hz.                                         */
+/*         Stimulus amplitude 0 to 32767.                                    */
+/*         Processing chain to measure.                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+void bode_init(BODE_MODE mode, unsigned long SamplingFrequency,
+               signed int amplitude, BODE_Chain chain)
+{
+ fs = SamplingFrequency;
+ bode_mode = mode;
+ bode_chain = chain;
+
+ oscillator_init(&generator[BODE_STIMULUS], fs, bode_frequencies[0], amplitude, 0);
+ oscillator_init(&generator[BODE_SIN], fs, bode_frequencies[0], 32767, 0);
+ oscillator_init(&generator[BODE_COS], fs, bode_frequencies[0], 32767, 16384);
+
+ /* Only the points below half the sampling frequency */
+
+ for ( bode_points = 0 ; bode_points < BODE_POINTS ; bode_points++)
+   {
+    if ( (unsigned long) bode_frequencies[bode_points] >= fs >> 1 )
+      {
+       break;
+      }
+   }
+
+ point = 0;
+ state = BODE_MEASURING;
+
+ bode_step();
+}
+
+/*****************************************************************************/
+/* bode_process()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* CALLED BY: main() loop once per sample in BODE_ANALOG mode.               */
+/* INPUT:     Line input. Ignored in BODE_DIGITAL mode.                      */
+/* RETURNS:   Stimulus for the line output.                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+signed int bode_process(signed int input)
+{
+ DATA stimulus;
+ DATA reference_sin;
+ DATA reference_cos;
+ signed int output;
+ BODE_Point *p;
+
+ if ( BODE_MEASURING != state )
+   {
+    return 0;
+   }
+
+ oscillator_generate(&generator[BODE_STIMULUS], 1, &stimulus, 1, 0);
+ oscillator_generate(&generator[BODE_SIN], 1, &reference_sin, 1, 0);
+ oscillator_generate(&generator[BODE_COS], 1, &reference_cos, 1, 0);
+
+ if ( BODE_DIGITAL == bode_mode )
+   {
+    input = stimulus;
+   }
+
+ output = bode_chain(input);
+
+ if ( ++count > BODE_SETTLE_SAMPLES )
+   {
+    p = &bode_table[point];
+
+    p->input_real  += ( (long) stimulus * reference_sin ) >> 15;
+    p->input_imag  += ( (long) stimulus * reference_cos ) >> 15;
+    p->output_real += ( (long) output * reference_sin ) >> 15;
+    p->output_imag += ( (long) output * reference_cos ) >> 15;
+
+    if ( count >= BODE_SETTLE_SAMPLES + measure_length )
+      {
+       point++;
+       bode_step();
+      }
+   }
+
+ return ( (signed int) stimulus );
+}
+
+/*****************************************************************************/
+/* bode_state()                                                              */
+/*****************************************************************************/
+
+BODE_STATE bode_state(void)
+{
+ return state;
+}
+
+/*****************************************************************************/
+/* bode_run_digital()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Run the whole of a BODE_DIGITAL measurement without the codec.            */
+/*                                                                           */
+/*****************************************************************************/
+
+void bode_run_digital(void)
+{
+ while ( BODE_MEASURING == state )
+   {
+    bode_process(0);
+   }
+}
+
+/*****************************************************************************/
+/* bode_report()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Calculate magnitude in 0.01 dB and phase in 0.1 degree from the           */
+/* correlations. Floating point, so only call once the measurement is        */
+/* complete.                                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+void bode_report(void)
+{
+ unsigned int i;
+ double input_power;
+ double output_power;
+ double real;
+ double imag;
+ double magnitude;
+ double phase;
+ BODE_Point *p;
+
+ for ( i = 0 ; i < bode_points ; i++)
+   {
+    p = &bode_table[i];
+
+    input_power = (double) p->input_real * p->input_real
+                + (double) p->input_imag * p->input_imag;
+
+    if ( input_power <= 0.0 )
+      {
+       continue;
+      }
+
+    /* H = Y / X = Y.conj(X) / |X|^2 */
+
+    real = ( (double) p->output_real * p->input_real
+           + (double) p->output_imag * p->input_imag ) / input_power;
+    imag = ( (double) p->output_imag * p->input_real
+           - (double) p->output_real * p->input_imag ) / input_power;
+
+    output_power = real * real + imag * imag;
+
+    magnitude = ( output_power > 1e-12 ) ? 10.0 * log10(output_power) : -120.0;
+    phase = atan2(imag, real) * 180.0 / 3.14159265358979;
+
+    p->magnitude = (signed int) floor( magnitude * 100.0 + 0.5 );
+    p->phase = (signed int) floor( phase * 10.0 + 0.5 );
+   }
+}
+
+/*****************************************************************************/
+/* bode_print_csv()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Print the table as CSV. For a binary copy save bode_table[] from the      */
+/* memory window, bode_points entries of sizeof(BODE_Point).                 */
+/*                                                                           */
+/*****************************************************************************/
+
+void bode_print_csv(void)
+{
+ unsigned int i;
+
+ printf("frequency_Hz,magnitude_dB,phase_degrees\n");
+
+ for ( i = 0 ; i < bode_points ; i++)
+   {
+    printf("%u,%.2f,%.1f\n", bode_table[i].frequency,
+           bode_table[i].magnitude / 100.0, bode_table[i].phase / 10.0);
+   }
+}
+
+/*****************************************************************************/
+/* End of bode.c                                                             */
+/*****************************************************************************/
@@ -0,0 +1,94 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 boot.c                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Start up timeline.                                                      */
+/*                                                                           */
+/*   main() calls boot_mark() as each start up stage finishes, the last      */
+/*   time when the first sample has gone to the codec. Each mark costs one   */
+/*   timer read, so marks can be left in. boot_report() logs the stages      */
+/*   once audio is running, and boot_timeline[] can be read in a Watch       */
+/*   Window.                                                                 */
+/*                                                                           */
+/*   Times come from delay_now(), so the first mark must be after            */
+/*   delay_init(). Times are from that first mark; the time from reset to    */
+/*   the end of pll_frequency_setup() is not measured.                       */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "usbstk5505.h"
+#include "delay.h"
+#include "boot.h"
+#include "log.h"
+
+BOOT_MARK boot_timeline[BOOT_MARKS];
+Uint16 boot_marks = 0;
+
+/*****************************************************************************/
+/* boot_mark()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  LOG_BOOT_ id of the stage that has just finished.                */
+/*                                                                           */
+/*****************************************************************************/
+
+void boot_mark(Uint16 stage)
+{
+ if ( boot_marks < BOOT_MARKS )
+   {
+    boot_timeline[boot_marks].stage = stage;
+    boot_timeline[boot_marks].ticks = delay_now();
+    boot_marks++;
+   }
+}
+
+/*****************************************************************************/
+/* boot_elapsed_us()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Microseconds since the first mark, or 0 if there is none.        */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint32 boot_elapsed_us(void)
+{
+ if ( 0 == boot_marks )
+   {
+    return 0;
+   }
+
+ return delay_ticks_to_us(delay_now() - boot_timeline[0].ticks);
+}
+
+/*****************************************************************************/
+/* boot_report()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Log each stage with the time it finished and how long it took.            */
+/*                                                                           */
+/*****************************************************************************/
+
+void boot_report(void)
+{
+ Uint16 i;
+
+ if ( 0 == boot_marks )
+   {
+    return;
+   }
+
+ for ( i = 0 ; i < boot_marks ; i++)
+   {
+    LOG2(boot_timeline[i].stage,
+         delay_ticks_to_us(boot_timeline[i].ticks - boot_timeline[0].ticks),
+         i ? delay_ticks_to_us(boot_timeline[i].ticks
+                               - boot_timeline[i - 1].ticks) : 0UL);
+   }
+}
+
+/*****************************************************************************/
+/* End of boot.c                                                             */
+/*****************************************************************************/
@@ -0,0 +1,415 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 command.c                                                               */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Binary command protocol on the UART. See command.h for the frames.      */
+/*                                                                           */
+/*   command_task() is a scheduler task. Each run parses at most             */
+/*   CMD_BYTES_PER_RUN received bytes and carries out at most one command,   */
+/*   so its time is bounded and it never runs in the audio path. With the    */
+/*   task every ms a command is answered within a few ms of its last byte.   */
+/*                                                                           */
+/*   Codec changes are queued on the I2C queue and do not wait for the bus.  */
+/*   A reply is dropped if the UART transmit buffer has no room for it.      */
+/*                                                                           */
+/*   tools/uart_pty.c runs this file on Linux behind a pseudo terminal, and  */
+/*   tools/uart_client.c sends the commands.                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stddef.h>
+#include "csl_intc.h"
+#include "usbstk5505.h"
+#include "aic3204.h"
+#include "agc.h"
+#include "pitch.h"
+#include "i2c_queue.h"
+#include "log.h"
+#include "sched.h"
+#include "timer.h"
+#include "uart.h"
+#include "supervisor.h"
+#include "IIR_low_pass_filters.h"
+#include "command.h"
+
+#define CMD_BYTES_PER_RUN       16
+
+/* Parser states */
+
+#define WAIT_SYNC               0
+#define WAIT_COMMAND            1
+#define WAIT_LENGTH             2
+#define WAIT_PAYLOAD            3
+#define WAIT_CHECKSUM           4
+
+extern char dtmf_key;                   /* main.c */
+extern unsigned int low_pass_filter;    /* main.c */
+
+static Uint16 state = WAIT_SYNC;
+static Uint16 command;
+static Uint16 length;
+static Uint16 received;
+static Uint16 sum;
+static Uint8 payload[CMD_MAX_PAYLOAD];
+
+static Int16 volume = 0;                /* Last set. Codec reset is 0 dB    */
+static Uint16 mute = 0;
+
+/*****************************************************************************/
+/* put16() and put32()                                                       */
+/*****************************************************************************/
+
+static void put16(Uint8 *p, Uint16 value)
+{
+ p[0] = value & 0xFF;
+ p[1] = ( value >> 8 ) & 0xFF;
+}
+
+static void put32(Uint8 *p, Uint32 value)
+{
+ put16(p, value & 0xFFFF);
+ put16(p + 2, value >> 16);
+}
+
+/*****************************************************************************/
+/* reply()                                                                   */
+/*****************************************************************************/
+
+static void reply(Uint16 status, const Uint8 *data, Uint16 count)
+{
+ Uint8 frame[5 + CMD_MAX_PAYLOAD];
+ Uint16 total = 0;
+ Uint16 i;
+ Uint16 n = 0;
+
+ frame[n++] = CMD_SYNC;
+ frame[n++] = ( command | CMD_REPLY ) & 0xFF;
+ frame[n++] = count + 1;
+ frame[n++] = status;
+
+ for ( i = 0 ; i < count ; i++)
+   {
+    frame[n++] = data[i] & 0xFF;
+   }
+
+ for ( i = 1 ; i < n ; i++)
+   {
+    total += frame[i];
+   }
+
+ frame[n++] = ( 0x100 - ( total & 0xFF ) ) & 0xFF;
+
+ (void) uart_write(frame, n);
+}
+
+/*****************************************************************************/
+/* get_parameter() and set_parameter()                                       */
+/*****************************************************************************/
+
+static Int16 get_parameter(Uint16 parameter)
+{
+ switch ( parameter )
+   {
+    case CMD_PARAM_SWITCH_SECS:
+     return switch_secs;
+    case CMD_PARAM_CHANGES:
+     return change_limit;
+    case CMD_PARAM_VOLUME:
+     return volume;
+    case CMD_PARAM_FILTER:
+     return IIR_low_pass_cutoffs[low_pass_filter];
+    default:
+     return mute;
+   }
+}
+
+static Uint16 set_parameter(Uint16 parameter, Int16 value)
+{
+ Uint16 i;
+
+ switch ( parameter )
+   {
+    case CMD_PARAM_SWITCH_SECS:
+
+     if ( value < 1 )
+       {
+        return CMD_BAD_VALUE;
+       }
+
+     switch_secs = value;
+     return CMD_OK;
+
+    case CMD_PARAM_CHANGES:
+
+     if ( value < 0 )
+       {
+        return CMD_BAD_VALUE;
+       }
+
+     change_limit = value;
+     return CMD_OK;
+
+    case CMD_PARAM_VOLUME:
+
+     if ( value < -127 || value > 48 )
+       {
+        return CMD_BAD_VALUE;
+       }
+
+     if ( aic3204_volume_async(value, NULL, NULL) != 0 )
+       {
+        return CMD_BUSY;
+       }
+
+     volume = value;
+     return CMD_OK;
+
+    case CMD_PARAM_FILTER:
+
+     for ( i = 0 ; i < IIR_LOW_PASS_TABLES ; i++ )
+       {
+        if ( IIR_low_pass_cutoffs[i] == (Uint16) value )
+          {
+           low_pass_filter = i;
+           return CMD_OK;
+          }
+       }
+
+     return CMD_BAD_VALUE;
+
+    default:
+
+     if ( aic3204_mute_async(value != 0, NULL, NULL) != 0 )
+       {
+        return CMD_BUSY;
+       }
+
+     mute = ( value != 0 );
+     return CMD_OK;
+   }
+}
+
+/*****************************************************************************/
+/* telemetry()                                                               */
+/*****************************************************************************/
+
+static void telemetry(Uint8 *p)
+{
+ Uint16 task_faults = 0;
+ Uint16 i;
+
+ for ( i = 0 ; i < SCHED_TASKS ; i++)
+   {
+    task_faults += sched_tasks[i].overruns + sched_tasks[i].misses;
+   }
+
+ p[0] = Step;
+ p[1] = auto_switch;
+ put16(&p[2], playnum);
+ put16(&p[4], pitch_estimate.voiced ? pitch_estimate.frequency : 0);
+ put16(&p[6], pitch_estimate.confidence);
+ p[8] = dtmf_key & 0xFF;
+ p[9] = agc_pga_gain;
+ put16(&p[10], agc_gain);
+ put32(&p[12], log_dropped);
+ put32(&p[16], i2c_queue_stats.errors + i2c_queue_stats.timeouts);
+ put16(&p[20], task_faults);
+ put16(&p[22], uart_stats.line_errors + uart_stats.rx_overflows);
+ put32(&p[24], supervisor_stats.late);
+ p[28] = supervisor_stats.level;
+}
+
+/*****************************************************************************/
+/* execute()                                                                 */
+/*****************************************************************************/
+
+static void execute(void)
+{
+ Uint8 data[CMD_TELEMETRY_BYTES];
+ Int16 value;
+ Bool mask;
+
+ switch ( command )
+   {
+    case CMD_PING:
+
+     if ( length != 0 )
+       {
+        break;
+       }
+
+     data[0] = CMD_VERSION;
+     reply(CMD_OK, data, 1);
+     return;
+
+    case CMD_PRESET:
+
+     if ( length != 1 )
+       {
+        break;
+       }
+
+     if ( payload[0] >= CMD_PRESETS )
+       {
+        reply(CMD_BAD_VALUE, NULL, 0);
+        return;
+       }
+
+     /* Stop the timer task changing Step behind this one */
+
+     mask = IRQ_globalDisable();
+     auto_switch = 0;
+     Step = payload[0];
+     IRQ_globalRestore(mask);
+
+     reply(CMD_OK, NULL, 0);
+     return;
+
+    case CMD_AUTO:
+
+     if ( length != 1 )
+       {
+        break;
+       }
+
+     auto_switch = ( payload[0] != 0 );
+     reply(CMD_OK, NULL, 0);
+     return;
+
+    case CMD_SET:
+
+     if ( length != 3 )
+       {
+        break;
+       }
+
+     if ( payload[0] >= CMD_PARAMS )
+       {
+        reply(CMD_BAD_VALUE, NULL, 0);
+        return;
+       }
+
+     value = (Int16) ( payload[1] | ( payload[2] << 8 ) );
+     reply(set_parameter(payload[0], value), NULL, 0);
+     return;
+
+    case CMD_GET:
+
+     if ( length != 1 )
+       {
+        break;
+       }
+
+     if ( payload[0] >= CMD_PARAMS )
+       {
+        reply(CMD_BAD_VALUE, NULL, 0);
+        return;
+       }
+
+     put16(data, get_parameter(payload[0]));
+     reply(CMD_OK, data, 2);
+     return;
+
+    case CMD_TELEMETRY:
+
+     if ( length != 0 )
+       {
+        break;
+       }
+
+     telemetry(data);
+     reply(CMD_OK, data, CMD_TELEMETRY_BYTES);
+     return;
+
+    default:
+     reply(CMD_BAD_COMMAND, NULL, 0);
+     return;
+   }
+
+ reply(CMD_BAD_LENGTH, NULL, 0);
+}
+
+/*****************************************************************************/
+/* command_task()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Scheduler task. A frame may arrive over several runs.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+void command_task(void *context)
+{
+ Uint8 byte;
+ Uint16 count;
+
+ for ( count = 0 ; count < CMD_BYTES_PER_RUN ; count++)
+   {
+    if ( 0 == uart_read(&byte, 1) )
+      {
+       return;
+      }
+
+    byte &= 0xFF;
+
+    if ( WAIT_SYNC != state )
+      {
+       sum += byte;
+      }
+
+    switch ( state )
+      {
+       case WAIT_SYNC:
+
+        if ( CMD_SYNC == byte )
+          {
+           sum = 0;
+           state = WAIT_COMMAND;
+          }
+        break;
+
+       case WAIT_COMMAND:
+        command = byte;
+        state = WAIT_LENGTH;
+        break;
+
+       case WAIT_LENGTH:
+
+        /* Too long to be a frame: look for the next CMD_SYNC */
+
+        length = byte;
+        received = 0;
+        state = ( length > CMD_MAX_PAYLOAD ) ? WAIT_SYNC
+              : ( length ? WAIT_PAYLOAD : WAIT_CHECKSUM );
+        break;
+
+       case WAIT_PAYLOAD:
+        payload[received++] = byte;
+
+        if ( received == length )
+          {
+           state = WAIT_CHECKSUM;
+          }
+        break;
+
+       default:
+        state = WAIT_SYNC;
+
+        if ( sum & 0xFF )
+          {
+           reply(CMD_BAD_CHECKSUM, NULL, 0);
+          }
+        else
+          {
+           execute();
+          }
+        return;                         /* One command per run */
+      }
+   }
+}
+
+/*****************************************************************************/
+/* End of command.c                                                          */
+/*****************************************************************************/
@@ -0,0 +1,224 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 delay.c                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Delays and timeouts measured by general purpose timer 1.                */
+/*                                                                           */
+/*   USBSTK5505_waitusec() counts 8 loops per microsecond whatever the CPU   */
+/*   clock is. Here GPT1 runs freely from the system clock divided by 2 and  */
+/*   the rate is taken from getSysClk(), so a delay is the same length at    */
+/*   any PLL setting. At 100 MHz a tick is 20 ns and the 32-bit count wraps  */
+/*   after 85 s, which is the longest delay or timeout.                      */
+/*                                                                           */
+/*   Call delay_init() after pll_frequency_setup(). Until then delays fall   */
+/*   back to USBSTK5505_waitusec() and timeouts count calls to               */
+/*   delay_timeout_expired(). Call delay_set_clock() when the PLL is         */
+/*   changed; the count carries on, so timestamps stay in order.             */
+/*                                                                           */
+/*   GPT0 is left for the interrupt in timer.c. GPT1 raises no interrupts.   */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_gpt.h"
+#include "usbstk5505.h"
+#include "timer.h"
+#include "delay.h"
+
+#define DELAY_PRESCALE      GPT_PRE_SC_DIV_0    /* System clock / 2 */
+#define DELAY_PRESCALE_DIV  2
+
+Uint32 delay_ticks_per_ms = 0;
+
+static CSL_GptObj delay_gpt_obj;
+static CSL_Handle delay_gpt = 0;
+
+/*****************************************************************************/
+/* delay_init()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Start GPT1 counting down from 0xFFFFFFFF with auto reload.                */
+/*                                                                           */
+/*****************************************************************************/
+
+void delay_init(void)
+{
+ CSL_Status status;
+ CSL_Config config;
+
+ if ( 0 == delay_gpt )
+   {
+    delay_gpt = GPT_open(GPT_1, &delay_gpt_obj, &status);
+
+    if ( CSL_SOK != status )
+      {
+       delay_gpt = 0;
+       return;
+      }
+   }
+
+ GPT_stop(delay_gpt);
+ GPT_reset(delay_gpt);
+
+ config.autoLoad = GPT_AUTO_ENABLE;
+ config.ctrlTim = GPT_TIMER_ENABLE;
+ config.preScaleDiv = DELAY_PRESCALE;
+ config.prdLow = 0xFFFF;
+ config.prdHigh = 0xFFFF;
+
+ GPT_config(delay_gpt, &config);
+ GPT_start(delay_gpt);
+
+ /* getSysClk() is in kHz, so this is ticks per millisecond */
+
+ delay_ticks_per_ms = getSysClk() / DELAY_PRESCALE_DIV;
+}
+
+/*****************************************************************************/
+/* delay_set_clock()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Take the new tick rate after the PLL has been changed. A delay or         */
+/* timeout running across the change is out by the ratio of the clocks.      */
+/*                                                                           */
+/*****************************************************************************/
+
+void delay_set_clock(void)
+{
+ if ( 0 == delay_gpt )
+   {
+    return;
+   }
+
+ delay_ticks_per_ms = getSysClk() / DELAY_PRESCALE_DIV;
+}
+
+/*****************************************************************************/
+/* delay_now()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Ticks since delay_init(), modulo 2^32. 0 before delay_init().    */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint32 delay_now(void)
+{
+ Uint32 count;
+
+ if ( 0 == delay_ticks_per_ms )
+   {
+    return 0;
+   }
+
+ GPT_getCnt(delay_gpt, &count);
+
+ return 0xFFFFFFFFUL - count;
+}
+
+/*****************************************************************************/
+/* delay_us_to_ticks()                                                       */
+/*****************************************************************************/
+
+Uint32 delay_us_to_ticks(Uint32 us)
+{
+ return ( us / 1000 ) * delay_ticks_per_ms
+        + ( ( us % 1000 ) * delay_ticks_per_ms ) / 1000;
+}
+
+/*****************************************************************************/
+/* delay_ticks_to_us()                                                       */
+/*****************************************************************************/
+
+Uint32 delay_ticks_to_us(Uint32 ticks)
+{
+ if ( 0 == delay_ticks_per_ms )
+   {
+    return 0;
+   }
+
+ return ( ticks / delay_ticks_per_ms ) * 1000
+        + ( ( ticks % delay_ticks_per_ms ) * 1000 ) / delay_ticks_per_ms;
+}
+
+/*****************************************************************************/
+/* delay_us()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Wait at least us microseconds, up to 85 s at 100 MHz.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+void delay_us(Uint32 us)
+{
+ Uint32 start;
+ Uint32 ticks;
+
+ if ( 0 == delay_ticks_per_ms )
+   {
+    USBSTK5505_waitusec(us);
+    return;
+   }
+
+ start = delay_now();
+ ticks = delay_us_to_ticks(us) + 1;     /* Part of a tick has gone already */
+
+ while ( delay_now() - start < ticks )
+   {
+   }
+}
+
+/*****************************************************************************/
+/* delay_ms()                                                                */
+/*****************************************************************************/
+
+void delay_ms(Uint32 ms)
+{
+ while ( ms > 1000 )
+   {
+    delay_us(1000000UL);
+    ms -= 1000;
+   }
+
+ delay_us(ms * 1000);
+}
+
+/*****************************************************************************/
+/* delay_timeout_start()                                                     */
+/*****************************************************************************/
+
+void delay_timeout_start(DELAY_TIMEOUT *timeout, Uint32 us)
+{
+ if ( 0 == delay_ticks_per_ms )
+   {
+    timeout->start = 0;
+    timeout->ticks = us * 8;            /* Calls, as USBSTK5505_waitusec() */
+    return;
+   }
+
+ timeout->start = delay_now();
+ timeout->ticks = delay_us_to_ticks(us) + 1;
+}
+
+/*****************************************************************************/
+/* delay_timeout_expired()                                                   */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 1 once the time given to delay_timeout_start() has passed.       */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 delay_timeout_expired(DELAY_TIMEOUT *timeout)
+{
+ if ( 0 == delay_ticks_per_ms )
+   {
+    return ( ++timeout->start > timeout->ticks );
+   }
+
+ return ( delay_now() - timeout->start >= timeout->ticks );
+}
+
+/*****************************************************************************/
+/* End of delay.c                                                            */
+/*****************************************************************************/
@@ -0,0 +1,234 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 dsplib_bench.c                                                          */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Cycles taken by the DSPLIB functions this program calls, wherever the   */
+/*   link put them: sine() (sinewaves.c, goertzel.c, SweepGenerator.c),      */
+/*   power() (agc.c), bexp(), acorr_bias() and acorr_unbias() (pitch.c),     */
+/*   rand16init() and rand16() (noise.c). expn() is only called here, as a   */
+/*   reference.                                                              */
+/*                                                                           */
+/*   Each is called DSPLIB_BENCH_CALLS times on DSPLIB_BENCH_SAMPLES with    */
+/*   interrupts off, timed with GPT1 and turned into CPU cycles as in        */
+/*   hotpath.c. The log records give the addresses of sine(), power() and    */
+/*   acorr_bias(), so they show whether each ran from RAM or from PDROM at   */
+/*   0xff8000. rand16init() is timed after rand16(), so the noise sequence   */
+/*   starts from its seed as after noise_init().                             */
+/*                                                                           */
+/*   The oscillator bank of sinewaves.c is timed the same way, per sample    */
+/*   of one oscillator: in banks of 1 and of DSPLIB_BENCH_OSCILLATORS, a     */
+/*   block of DSPLIB_BENCH_SAMPLES a call, and one sample a call as          */
+/*   generate_sinewave_1() runs it.                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_intc.h"
+#include "usbstk5505.h"
+#include "tms320.h"
+#include "dsplib.h"
+#include "timer.h"
+#include "delay.h"
+#include "log.h"
+#include "sinewaves.h"
+#include "dsplib_bench.h"
+
+typedef ushort (*DSPLIB_Function)(DATA *x, DATA *r, ushort nx);
+
+static DATA input[DSPLIB_BENCH_SAMPLES];
+static DATA output[DSPLIB_BENCH_SAMPLES];
+static LDATA block_power;
+static OSCILLATOR bank[DSPLIB_BENCH_OSCILLATORS];
+
+/*****************************************************************************/
+/* The other DSPLIB functions, called as DSPLIB_Function                     */
+/*****************************************************************************/
+
+static ushort bench_power(DATA *x, DATA *r, ushort nx)
+{
+ return power(x, &block_power, nx);
+}
+
+static ushort bench_bexp(DATA *x, DATA *r, ushort nx)
+{
+ return (ushort) bexp(x, nx);
+}
+
+static ushort bench_acorr_bias(DATA *x, DATA *r, ushort nx)
+{
+ return acorr_bias(x, r, nx, DSPLIB_BENCH_LAGS);
+}
+
+static ushort bench_acorr_unbias(DATA *x, DATA *r, ushort nx)
+{
+ return acorr_unbias(x, r, nx, DSPLIB_BENCH_LAGS);
+}
+
+static ushort bench_rand16(DATA *x, DATA *r, ushort nx)
+{
+ return rand16(r, nx);
+}
+
+static ushort bench_rand16init(DATA *x, DATA *r, ushort nx)
+{
+ rand16init();
+ return 0;
+}
+
+/*****************************************************************************/
+/* to_cycles_per_100()                                                       */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: CPU cycles for 100 samples, from GPT1 ticks for samples.         */
+/*                                                                           */
+/* ticks * getSysClk() passes 32 bits at about 43000 ticks at 100 MHz, so    */
+/* the cycles are worked out in the 40-bit long long. Taking the whole       */
+/* samples and the remainder apart keeps the * 100 inside it as well.        */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint32 to_cycles_per_100(Uint32 ticks, Uint32 samples)
+{
+ long long cycles = (long long) ticks * getSysClk() / delay_ticks_per_ms;
+
+ return ( cycles / samples ) * 100 + ( cycles % samples ) * 100 / samples;
+}
+
+/*****************************************************************************/
+/* bench_ticks()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: GPT1 ticks for DSPLIB_BENCH_CALLS calls, 0 before delay_init().  */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint32 bench_ticks(DSPLIB_Function function)
+{
+ Uint32 from;
+ Uint32 ticks;
+ Uint16 n;
+ Bool mask;
+
+ if ( 0 == delay_ticks_per_ms )
+   {
+    return 0;
+   }
+
+ mask = IRQ_globalDisable();
+
+ from = delay_now();
+
+ for ( n = 0 ; n < DSPLIB_BENCH_CALLS ; n++ )
+   {
+    function(input, output, DSPLIB_BENCH_SAMPLES);
+   }
+
+ ticks = delay_now() - from;
+
+ IRQ_globalRestore(mask);
+
+ return ticks;
+}
+
+/*****************************************************************************/
+/* cycles_per_100() and cycles_per_call()                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: CPU cycles for 100 samples, or for one call, call overhead       */
+/*          included.                                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint32 cycles_per_100(DSPLIB_Function function)
+{
+ return to_cycles_per_100(bench_ticks(function),
+                          (Uint32) DSPLIB_BENCH_SAMPLES * DSPLIB_BENCH_CALLS);
+}
+
+static Uint32 cycles_per_call(DSPLIB_Function function)
+{
+ return to_cycles_per_100(bench_ticks(function), DSPLIB_BENCH_CALLS) / 100;
+}
+
+/*****************************************************************************/
+/* oscillator_cycles_per_100()                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUT:   Oscillators in the bank, and samples per oscillator_generate().  */
+/* RETURNS: CPU cycles for 100 samples of one oscillator.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint32 oscillator_cycles_per_100(Uint16 oscillators, Uint16 nx)
+{
+ Uint32 from;
+ Uint32 ticks;
+ Uint16 n;
+ Uint16 i;
+ Bool mask;
+
+ if ( 0 == delay_ticks_per_ms )
+   {
+    return 0;
+   }
+
+ for ( i = 0 ; i < oscillators ; i++)
+   {
+    oscillator_init(&bank[i], 48000, 440 + 110 * i, 32767 / oscillators, 0);
+   }
+
+ mask = IRQ_globalDisable();
+
+ from = delay_now();
+
+ for ( n = 0 ; n < DSPLIB_BENCH_CALLS * ( DSPLIB_BENCH_SAMPLES / nx ) ; n++ )
+   {
+    oscillator_generate(bank, oscillators, output, nx, 0);
+   }
+
+ ticks = delay_now() - from;
+
+ IRQ_globalRestore(mask);
+
+ return to_cycles_per_100(ticks, (Uint32) DSPLIB_BENCH_SAMPLES
+                                 * DSPLIB_BENCH_CALLS * oscillators);
+}
+
+/*****************************************************************************/
+/* dsplib_bench()                                                            */
+/*****************************************************************************/
+
+void dsplib_bench(void)
+{
+ Uint16 n;
+
+ /* A ramp over the full Q15 range, -1 to 1 */
+
+ for ( n = 0 ; n < DSPLIB_BENCH_SAMPLES ; n++ )
+   {
+    input[n] = (DATA) ( (Int32) n * 65536 / DSPLIB_BENCH_SAMPLES - 32768 );
+   }
+
+ LOG3(LOG_DSPLIB_BENCH, (Uint32) sine, cycles_per_100(sine),
+      cycles_per_100(expn));
+
+ LOG3(LOG_DSPLIB_BENCH_BLOCK, cycles_per_100(bench_power),
+      cycles_per_100(bench_bexp), cycles_per_100(bench_rand16));
+
+ LOG3(LOG_DSPLIB_BENCH_ACORR, DSPLIB_BENCH_LAGS,
+      cycles_per_100(bench_acorr_bias), cycles_per_100(bench_acorr_unbias));
+
+ LOG3(LOG_DSPLIB_BENCH_AT, cycles_per_call(bench_rand16init),
+      (Uint32) power, (Uint32) acorr_bias);
+
+ LOG3(LOG_OSCILLATOR_BENCH,
+      oscillator_cycles_per_100(1, DSPLIB_BENCH_SAMPLES),
+      oscillator_cycles_per_100(DSPLIB_BENCH_OSCILLATORS, DSPLIB_BENCH_SAMPLES),
+      oscillator_cycles_per_100(1, 1));
+}
+
+/*****************************************************************************/
+/* End of dsplib_bench.c                                                     */
+/*****************************************************************************/
@@ -0,0 +1,294 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 dvfs.c                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Governor that runs the CPU at the lowest clock, and core voltage, that  */
+/*   keeps up with the audio.                                                */
+/*                                                                           */
+/*   The audio loop calls dvfs_busy_start() when a sample has arrived and    */
+/*   dvfs_busy_end() before it waits for the next one. Over each window of   */
+/*   DVFS_WINDOW_SAMPLES the highest busy time is taken as a percentage of   */
+/*   the sample period. Taking the busy time as inversely proportional to    */
+/*   the clock, the governor picks the lowest of dvfs_mhz[] at which that    */
+/*   peak would be under DVFS_TARGET_PERCENT. It goes up at once and         */
+/*   comes down only after DVFS_LOWER_WINDOWS windows in a row have wanted   */
+/*   a lower clock, so it does not hunt.                                     */
+/*                                                                           */
+/*   A change waits until the UART has nothing to send and the I2C queue is  */
+/*   empty, then the core voltage is raised first or lowered last, and the   */
+/*   PLL is set up again with pll_frequency_setup(). GPT1 for delays and     */
+/*   timestamps, the GPT0 scheduler tick, the UART baud rate and the         */
+/*   watchdog are then worked out again from getSysClk(). Interrupts are     */
+/*   off from before the relock until the GPT and UART dividers are right    */
+/*   for the new clock, so no I2S, UART or timer interrupt runs at the       */
+/*   wrong rate. The I2C bit rate follows the clock; it is 100 kHz or less   */
+/*   at every level.                                                         */
+/*                                                                           */
+/*   The PLL runs from the 32 kHz clock while it locks, so samples arriving  */
+/*   then are missed. That is why changes are kept rare.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_intc.h"
+#include "soc.h"
+#include "usbstk5505.h"
+#include "PLL.h"
+#include "timer.h"
+#include "delay.h"
+#include "i2c_queue.h"
+#include "log.h"
+#include "uart.h"
+#include "supervisor.h"
+#include "dvfs.h"
+
+const Uint16 dvfs_mhz[DVFS_LEVELS] = { 40, 60, 75, 100 };
+
+volatile DVFS_STATS dvfs_stats;
+
+static Uint32 sample_rate;
+static Uint32 period_ticks;             /* One sample period in GPT1 ticks  */
+static Uint32 busy_from;
+static Uint32 busy_total;
+static Uint32 busy_peak;
+static Uint16 samples;
+static Uint16 lower_windows;            /* Windows in a row wanting less    */
+static Uint16 lower_level;              /* Highest level they wanted        */
+
+/*****************************************************************************/
+/* set_period()                                                              */
+/*****************************************************************************/
+
+static void set_period(void)
+{
+ period_ticks = ( delay_ticks_per_ms * 1000 ) / sample_rate;
+
+ if ( 0 == period_ticks )
+   {
+    period_ticks = 1;
+   }
+}
+
+/*****************************************************************************/
+/* set_core_voltage()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* DSP_LDO at 1.05 V up to DVFS_LOW_VOLTAGE_MHZ, otherwise 1.3 V.            */
+/*                                                                           */
+/*****************************************************************************/
+
+static void set_core_voltage(Uint16 mhz)
+{
+ if ( mhz <= DVFS_LOW_VOLTAGE_MHZ )
+   {
+    CSL_LDO_REGS->LDOCTRL |= CSL_LDO_LDOCTRL_DSPLDOCNTL_MASK;
+   }
+ else
+   {
+    CSL_LDO_REGS->LDOCTRL &= ~CSL_LDO_LDOCTRL_DSPLDOCNTL_MASK;
+   }
+}
+
+/*****************************************************************************/
+/* change_clock()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 1 if the clock was changed, 0 if the buses are not yet idle.     */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint16 change_clock(Uint16 level, Uint16 peak_percent)
+{
+ Uint16 from = dvfs_mhz[dvfs_stats.level];
+ Uint16 to = dvfs_mhz[level];
+ int status;
+ Bool mask;
+
+ if ( !uart_tx_idle() || i2c_queue_pending() != 0 )
+   {
+    dvfs_stats.postponed++;
+    return 0;
+   }
+
+ LOG3(LOG_DVFS_SWITCH, from, to, peak_percent);
+
+ if ( to > DVFS_LOW_VOLTAGE_MHZ && from <= DVFS_LOW_VOLTAGE_MHZ )
+   {
+    set_core_voltage(to);
+    delay_us(DVFS_LDO_SETTLE_US);
+   }
+
+ mask = IRQ_globalDisable();
+
+ status = pll_frequency_setup(to);
+
+ /* Whatever happened, take the clock the PLL is giving now */
+
+ delay_set_clock();
+ timer_set_clock();
+ uart_set_clock();
+ log_init();
+ set_period();
+ supervisor_set_clock();
+
+ IRQ_globalRestore(mask);
+
+ if ( status != 0 )
+   {
+    LOG2(LOG_DVFS_FAILED, to, status);
+    set_core_voltage(dvfs_mhz[DVFS_LEVELS - 1]);
+    return 1;
+   }
+
+ if ( to <= DVFS_LOW_VOLTAGE_MHZ )
+   {
+    set_core_voltage(to);
+   }
+
+ dvfs_stats.level = level;
+ dvfs_stats.mhz = to;
+ dvfs_stats.switches++;
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* end_window()                                                              */
+/*****************************************************************************/
+
+static void end_window(void)
+{
+ Uint32 percent;
+ Uint16 peak_percent;
+ Uint16 level;
+ Uint16 now = dvfs_stats.level;
+
+ /* A stall of more than 10 periods counts as 1000 % */
+
+ percent = ( busy_peak < 10 * period_ticks )
+           ? ( busy_peak * 100 ) / period_ticks : 1000;
+ peak_percent = percent;
+ dvfs_stats.peak_percent = peak_percent;
+ dvfs_stats.average_percent = ( ( busy_total / samples ) * 100 )
+                              / period_ticks;
+
+ if ( peak_percent >= 100 )
+   {
+    dvfs_stats.overloads++;
+   }
+
+ busy_total = 0;
+ busy_peak = 0;
+ samples = 0;
+
+ /* Lowest clock with the peak under DVFS_TARGET_PERCENT */
+
+ for ( level = 0 ; level < DVFS_LEVELS - 1 ; level++)
+   {
+    if ( (Uint32) dvfs_mhz[level] * DVFS_TARGET_PERCENT
+         > (Uint32) dvfs_mhz[now] * peak_percent )
+      {
+       break;
+      }
+   }
+
+ if ( level > now )
+   {
+    lower_windows = 0;
+    (void) change_clock(level, peak_percent);
+   }
+ else if ( level < now )
+   {
+    if ( 0 == lower_windows || level > lower_level )
+      {
+       lower_level = level;
+      }
+
+    if ( ++lower_windows >= DVFS_LOWER_WINDOWS
+         && change_clock(lower_level, peak_percent) )
+      {
+       lower_windows = 0;
+      }
+   }
+ else
+   {
+    lower_windows = 0;
+   }
+}
+
+/*****************************************************************************/
+/* dvfs_init()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  Clock given to pll_frequency_setup() and the sampling            */
+/*          frequency. Call after delay_init() and uart_init().              */
+/*                                                                           */
+/*****************************************************************************/
+
+void dvfs_init(Uint16 mhz, Uint32 rate)
+{
+ Uint16 level;
+
+ for ( level = 0 ; level < DVFS_LEVELS - 1 ; level++)
+   {
+    if ( dvfs_mhz[level] >= mhz )
+      {
+       break;
+      }
+   }
+
+ sample_rate = rate;
+ set_period();
+
+ busy_total = 0;
+ busy_peak = 0;
+ samples = 0;
+ lower_windows = 0;
+
+ dvfs_stats.level = level;
+ dvfs_stats.mhz = dvfs_mhz[level];
+ dvfs_stats.peak_percent = 0;
+ dvfs_stats.average_percent = 0;
+ dvfs_stats.switches = 0;
+ dvfs_stats.postponed = 0;
+ dvfs_stats.overloads = 0;
+
+ set_core_voltage(mhz);
+}
+
+/*****************************************************************************/
+/* dvfs_busy_start() and dvfs_busy_end()                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Around the work done for each sample. dvfs_busy_end() may change the      */
+/* clock at the end of a window.                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+void dvfs_busy_start(void)
+{
+ busy_from = delay_now();
+}
+
+void dvfs_busy_end(void)
+{
+ Uint32 busy = delay_now() - busy_from;
+
+ busy_total += busy;
+
+ if ( busy > busy_peak )
+   {
+    busy_peak = busy;
+   }
+
+ if ( ++samples >= DVFS_WINDOW_SAMPLES )
+   {
+    end_window();
+   }
+}
+
+/*****************************************************************************/
+/* End of dvfs.c                                                             */
+/*****************************************************************************/
@@ -0,0 +1,406 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 goertzel.c                                                              */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Goertzel tone detection bank for DTMF and pilot tones.                  */
+/*                                                                           */
+/*   Each tone in the bank is a second order resonator:                      */
+/*                                                                           */
+/*   s(n) = x(n) + 2cos(w).s(n-1) - s(n-2)                                   */
+/*                                                                           */
+/*   At the end of each block the power at the target frequency is          */
+/*                                                                           */
+/*   P = s(n-1)^2 + s(n-2)^2 - 2cos(w).s(n-1).s(n-2)                         */
+/*                                                                           */
+/*   which costs one multiply-accumulate per sample per tone compared with   */
+/*   a full FFT per frame. The input can be decimated by a simple moving     */
+/*   average before the resonators so that low frequency tones such as DTMF */
+/*   are detected at 8000 Hz while the codec runs at 48000 Hz.               */
+/*                                                                           */
+/*   Changes in detection are reported through an event queue which is      */
+/*   filled by the audio loop and emptied by goertzel_get_event().           */
+/*                                                                           */
+/*   s(n) is kept in a long. goertzel_init() works out from the block        */
+/*   length, the decimation and the tone nearest 0 or fs/2 how many bits     */
+/*   s(n) can need for a full scale input, and shifts the input only if      */
+/*   that is more than GOERTZEL_STATE_BITS. For DTMF it is 27, so the input  */
+/*   keeps every bit and a tone at -40 dBFS is still well above round-off.   */
+/*   tools/goertzel_dtmf.c checks the detection from 0 to -45 dBFS.          */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "hotpath.h"
+
+/* Ahead of goertzel.h, see hotpath.h */
+
+#if (HOT_SECTIONS)
+#pragma CODE_SECTION(goertzel_process, ".text:hot")
+#endif
+
+#include "tms320.h"
+#include "dsplib.h"
+#include "goertzel.h"
+
+#define GOERTZEL_RELATIVE_SHIFT 5 /* Tone must hold about 1/4 of block energy */
+#define GOERTZEL_ENERGY_BITS    31
+
+/* c.s / 2^14 for a Q14 coefficient and a long state, as two 16 x 16 bit     */
+/* multiplies. Exact, and inside a long while s has GOERTZEL_STATE_BITS.     */
+
+#define GOERTZEL_MPY(c, s)  ( (long) (c) * (Int16) ( (s) >> 16 ) * 4 \
+                              + ( (long) (c) * (Uint16) (s) >> 14 ) )
+
+const Uint16 goertzel_dtmf_frequencies[8] =
+{
+  697, 770, 852, 941,       /* Rows    */
+  1209, 1336, 1477, 1633    /* Columns */
+};
+
+static const char dtmf_keys[4][4] =
+{
+  { '1', '2', '3', 'A' },
+  { '4', '5', '6', 'B' },
+  { '7', '8', '9', 'C' },
+  { '*', '0', '#', 'D' }
+};
+
+/*****************************************************************************/
+/* bits()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Bits needed to hold value, so value < 2^bits.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint16 bits(unsigned long value)
+{
+ Uint16 n = 0;
+
+ while ( value )
+   {
+    n++;
+    value >>= 1;
+   }
+
+ return n;
+}
+
+/*****************************************************************************/
+/* goertzel_init()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: Sampling frequency of the audio loop in Hz.                       */
+/*         Table of target frequencies in Hz and the number of tones.        */
+/*         Block length in decimated samples.                                */
+/*         Decimation factor. 1 for no decimation.                           */
+/*         Minimum tone power for a detection, in units of the decimated     */
+/*         sum shifted right by input_shift + output_shift.                  */
+/*                                                                           */
+/* The impulse response of a resonator is sin((n+1)w)/sin(w), so over a      */
+/* block |s(n)| is at most block_length / sin(w) times the largest input,    */
+/* decimation * 2^15. The shifts are worked out from that bound for the      */
+/* smallest sin(w) in the bank.                                              */
+/*                                                                           */
+/*****************************************************************************/
+
+void goertzel_init(GOERTZEL_Bank *bank, unsigned long SamplingFrequency,
+                   const Uint16 *frequencies, Uint16 tones,
+                   Uint16 block_length, Uint16 decimation,
+                   long threshold)
+{
+ Uint16 i;
+ DATA angle;
+ DATA cosine;
+ DATA sin_w;
+ DATA sin_min = 32767;
+ Uint16 state_bits;
+ Uint16 input_bits;
+ Uint16 energy_bits;
+ unsigned long fs;
+
+ if ( tones > GOERTZEL_MAX_TONES)
+   {
+    tones = GOERTZEL_MAX_TONES;
+   }
+
+ if ( 0 == decimation )
+   {
+    decimation = 1;
+   }
+
+ fs = SamplingFrequency / decimation;
+
+ bank->tones = tones;
+ bank->block_length = block_length;
+ bank->decimation = decimation;
+ bank->threshold = threshold;
+ bank->count = 0;
+ bank->phase = 0;
+ bank->sum = 0;
+ bank->energy = 0;
+ bank->blocks = 0;
+ bank->head = 0;
+ bank->tail = 0;
+ bank->overflows = 0;
+
+ for ( i = 0 ; i < tones ; i++)
+   {
+    /* sine() takes angle / pi in Q15. cos(w) = sin(w + pi/2) */
+
+    angle = (DATA) ( ( (unsigned long) frequencies[i] << 16 ) / fs );
+
+    sine(&angle, &sin_w, 1);
+
+    if ( sin_w < 0 )
+      {
+       sin_w = -sin_w;
+      }
+
+    if ( sin_w > 0 && sin_w < sin_min )
+      {
+       sin_min = sin_w;
+      }
+
+    angle += 16384;
+
+    sine(&angle, &cosine, 1);
+
+    bank->tone[i].frequency = frequencies[i];
+    bank->tone[i].coeff = cosine;   /* cos(w) in Q15 is 2cos(w) in Q14 */
+    bank->tone[i].s1 = 0;
+    bank->tone[i].s2 = 0;
+    bank->tone[i].present = 0;
+   }
+
+ /* Bits of the worst case s(n), then of the input, with no shift */
+
+ state_bits = 15 + bits( (unsigned long) decimation * block_length )
+                 + bits( 32767 / sin_min );
+ input_bits = 15 + bits(decimation);
+
+ bank->input_shift = ( state_bits > GOERTZEL_STATE_BITS )
+                     ? state_bits - GOERTZEL_STATE_BITS : 0;
+
+ state_bits -= bank->input_shift;
+ input_bits -= bank->input_shift;
+
+ bank->output_shift = ( state_bits > 15 ) ? state_bits - 15 : 0;
+
+ /* block_length squares of the input, shifted by energy_shift, in a long */
+
+ energy_bits = 2 * input_bits + bits(block_length);
+
+ bank->energy_shift = ( energy_bits > GOERTZEL_ENERGY_BITS )
+                      ? ( energy_bits - GOERTZEL_ENERGY_BITS + 1 ) / 2 : 0;
+}
+
+/*****************************************************************************/
+/* goertzel_post()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Add an event to the queue. Events are dropped if the queue is full.       */
+/*                                                                           */
+/*****************************************************************************/
+
+static void goertzel_post(GOERTZEL_Bank *bank, Uint16 tone, long power)
+{
+ Uint16 head = bank->head;
+ GOERTZEL_Event *event;
+
+ if ( ( (head + 1) & (GOERTZEL_QUEUE_SIZE - 1) ) == bank->tail )
+   {
+    bank->overflows++;
+    return;
+   }
+
+ event = &bank->queue[head];
+ event->tone = tone;
+ event->frequency = bank->tone[tone].frequency;
+ event->present = bank->tone[tone].present;
+ event->power = power;
+ event->block = bank->blocks;
+
+ bank->head = (head + 1) & (GOERTZEL_QUEUE_SIZE - 1);
+}
+
+/*****************************************************************************/
+/* goertzel_block()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* End of block. Calculate the power of each tone and report changes.        */
+/*                                                                           */
+/*****************************************************************************/
+
+static void goertzel_block(GOERTZEL_Bank *bank)
+{
+ Uint16 i;
+ Uint16 detected;
+ long s1;
+ long s2;
+ long power;
+ long energy;
+ long relative;
+ GOERTZEL_Tone *tone;
+
+ /* Block energy in the units of the tone power. The power of a tone that   */
+ /* is all of it is about block_length / 4 times the energy, so it has to be */
+ /* over relative. Multiplied, not divided, to keep weak tones.              */
+
+ if ( bank->output_shift >= bank->energy_shift )
+   {
+    energy = bank->energy >> ( 2 * ( bank->output_shift - bank->energy_shift ) );
+   }
+ else
+   {
+    energy = bank->energy << ( 2 * ( bank->energy_shift - bank->output_shift ) );
+   }
+
+ relative = ( energy * bank->block_length ) >> GOERTZEL_RELATIVE_SHIFT;
+
+ for ( i = 0 ; i < bank->tones ; i++)
+   {
+    tone = &bank->tone[i];
+
+    s1 = tone->s1 >> bank->output_shift;
+    s2 = tone->s2 >> bank->output_shift;
+
+    /* Each term is divided by 4 so the sum cannot overflow */
+
+    power  = ( s1 * s1 ) >> 2;
+    power += ( s2 * s2 ) >> 2;
+    power -= ( ( tone->coeff * s1 ) >> 16 ) * s2;
+
+    detected = ( power > bank->threshold && power > relative ) ? 1 : 0;
+
+    if ( detected != tone->present )
+      {
+       tone->present = detected;
+       goertzel_post(bank, i, power);
+      }
+
+    tone->s1 = 0;
+    tone->s2 = 0;
+   }
+
+ bank->energy = 0;
+ bank->count = 0;
+ bank->blocks++;
+}
+
+/*****************************************************************************/
+/* goertzel_process()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: Frame of nx samples from the audio loop. nx may be 1.             */
+/*                                                                           */
+/*****************************************************************************/
+
+void goertzel_process(GOERTZEL_Bank *bank, const DATA *input, Uint16 nx)
+{
+ Uint16 n;
+ Uint16 i;
+ long x;
+ long temp;
+ GOERTZEL_Tone *tone;
+
+ for ( n = 0 ; n < nx ; n++)
+   {
+    bank->sum += input[n];
+
+    if ( ++bank->phase < bank->decimation )
+      {
+       continue;
+      }
+
+    x = bank->sum >> bank->input_shift;
+    bank->sum = 0;
+    bank->phase = 0;
+
+    temp = x >> bank->energy_shift;
+    bank->energy += temp * temp;
+
+    tone = &bank->tone[0];
+
+    for ( i = 0 ; i < bank->tones ; i++, tone++)
+      {
+       temp = GOERTZEL_MPY(tone->coeff, tone->s1);
+       temp += x - tone->s2;
+
+       tone->s2 = tone->s1;
+       tone->s1 = temp;
+      }
+
+    if ( ++bank->count >= bank->block_length )
+      {
+       goertzel_block(bank);
+      }
+   }
+}
+
+/*****************************************************************************/
+/* goertzel_get_event()                                                      */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 1 if an event has been copied to event, 0 if the queue is empty. */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 goertzel_get_event(GOERTZEL_Bank *bank, GOERTZEL_Event *event)
+{
+ Uint16 tail = bank->tail;
+
+ if ( tail == bank->head )
+   {
+    return 0;
+   }
+
+ *event = bank->queue[tail];
+
+ bank->tail = (tail + 1) & (GOERTZEL_QUEUE_SIZE - 1);
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* goertzel_dtmf_key()                                                       */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: DTMF key for a row and column frequency, or 0 if not valid.      */
+/*                                                                           */
+/*****************************************************************************/
+
+char goertzel_dtmf_key(Uint16 row_frequency, Uint16 column_frequency)
+{
+ Uint16 row;
+ Uint16 column;
+
+ for ( row = 0 ; row < 4 ; row++)
+   {
+    if ( goertzel_dtmf_frequencies[row] == row_frequency )
+      {
+       break;
+      }
+   }
+
+ for ( column = 0 ; column < 4 ; column++)
+   {
+    if ( goertzel_dtmf_frequencies[4 + column] == column_frequency )
+      {
+       break;
+      }
+   }
+
+ if ( row >= 4 || column >= 4 )
+   {
+    return 0;
+   }
+
+ return dtmf_keys[row][column];
+}
+
+/*****************************************************************************/
+/* End of goertzel.c                                                         */
+/*****************************************************************************/
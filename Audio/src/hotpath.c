@@ -0,0 +1,102 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 hotpath.c                                                               */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Cycle count of the signal processing done for each sample.              */
+/*                                                                           */
+/*   The audio loop calls hotpath_start() before stereo_to_mono() and        */
+/*   hotpath_end() once the output sample is ready, so waiting for the codec */
+/*   and the background tasks are left out. The time is taken with GPT1 and  */
+/*   turned into CPU cycles, so the figures can be compared across clocks.   */
+/*   Over each HOTPATH_WINDOW_SAMPLES the mean and worst go in hotpath_stats */
+/*   and are logged. These are the figures to compare between builds with    */
+/*   HOT_SECTIONS set and not. The first window also logs HOT_SECTIONS and   */
+/*   where the filter kernel and its table went, so each log says which      */
+/*   layout its figures are for. README.md has the steps.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "usbstk5505.h"
+#include "timer.h"
+#include "delay.h"
+#include "log.h"
+#include "IIR_filters_fourth_order.h"
+#include "IIR_low_pass_filters.h"
+#include "hotpath.h"
+
+volatile HOTPATH_STATS hotpath_stats;
+
+static Uint32 from;
+static Uint32 total_ticks;
+static Uint32 worst_ticks;
+static Uint16 samples;
+static Uint16 layout_logged = 0;
+
+/*****************************************************************************/
+/* ticks_to_cycles()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* getSysClk() and delay_ticks_per_ms are both per ms.                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint32 ticks_to_cycles(Uint32 ticks)
+{
+ if ( 0 == delay_ticks_per_ms )
+   {
+    return 0;
+   }
+
+ return ( ticks * getSysClk() ) / delay_ticks_per_ms;
+}
+
+/*****************************************************************************/
+/* hotpath_start() and hotpath_end()                                         */
+/*****************************************************************************/
+
+void hotpath_start(void)
+{
+ from = delay_now();
+}
+
+void hotpath_end(void)
+{
+ Uint32 ticks = delay_now() - from;
+
+ total_ticks += ticks;
+
+ if ( ticks > worst_ticks )
+   {
+    worst_ticks = ticks;
+   }
+
+ if ( ++samples < HOTPATH_WINDOW_SAMPLES )
+   {
+    return;
+   }
+
+ hotpath_stats.cycles_mean = ticks_to_cycles(total_ticks / samples);
+ hotpath_stats.cycles_worst = ticks_to_cycles(worst_ticks);
+
+ if ( !layout_logged )
+   {
+    LOG3(LOG_HOTPATH_LAYOUT, HOT_SECTIONS,
+         (Uint32) fourth_order_IIR_direct_form_I,
+         (Uint32) IIR_low_pass_4800Hz);
+    layout_logged = 1;
+   }
+
+ LOG2(LOG_HOTPATH_CYCLES, hotpath_stats.cycles_mean,
+      hotpath_stats.cycles_worst);
+
+ total_ticks = 0;
+ worst_ticks = 0;
+ samples = 0;
+}
+
+/*****************************************************************************/
+/* End of hotpath.c                                                          */
+/*****************************************************************************/
@@ -0,0 +1,391 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 i2c_queue.c                                                             */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Interrupt driven I2C master with a queue of transactions.              */
+/*                                                                           */
+/*   USBSTK5505_I2C_write() and USBSTK5505_I2C_read() poll the status        */
+/*   register and then wait a fixed time, which is several hundred us of     */
+/*   CPU per codec register. Here a transaction is copied into a queue and   */
+/*   the caller returns at once. The I2C interrupt moves each byte and       */
+/*   calls the callback from the interrupt when the STOP has been sent.      */
+/*                                                                           */
+/*   Transactions are sent in the order they were queued. After a NACK,      */
+/*   lost arbitration or a timeout the module is reset if needed, the        */
+/*   transaction is completed with the error and the next one is started,    */
+/*   so one failure never stalls the queue.                                  */
+/*                                                                           */
+/*   Call i2c_queue_init() after CSL_gptIntrTest(), which disables all       */
+/*   interrupts, and call i2c_queue_tick() from the timer interrupt. Do not  */
+/*   call USBSTK5505_I2C_write() or USBSTK5505_I2C_read() while             */
+/*   i2c_queue_pending() is not zero.                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_intc.h"
+#include "usbstk5505.h"
+#include "usbstk5505_i2c.h"
+#include "i2c_queue.h"
+
+/* I2C_IVR interrupt codes */
+
+#define IVR_AL      1
+#define IVR_NACK    2
+#define IVR_RRDY    4
+#define IVR_XRDY    5
+#define IVR_SCD     6
+
+#define QUEUE_MASK  ( I2C_QUEUE_SIZE - 1 )
+
+volatile I2C_QUEUE_STATS i2c_queue_stats;
+
+static I2C_Transaction queue[I2C_QUEUE_SIZE];
+static volatile Uint16 head = 0;        /* Transaction on the bus when busy */
+static volatile Uint16 tail = 0;        /* Next free slot                   */
+static volatile Uint16 busy = 0;
+static volatile Uint16 queue_open = 0;
+static volatile Uint16 byte_index = 0;  /* Next byte of the transaction     */
+static volatile Int16 status = I2C_QUEUE_OK;
+static volatile Uint16 ticks = 0;       /* Ticks since the transaction began */
+
+/*****************************************************************************/
+/* start()                                                                   */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Put the transaction at the head of the queue on the bus. With STP set and */
+/* I2C_CNT loaded the module sends the STOP by itself after the last byte.   */
+/*                                                                           */
+/*****************************************************************************/
+
+static void start(void)
+{
+ I2C_Transaction *t = &queue[head & QUEUE_MASK];
+
+ busy = 1;
+ byte_index = 0;
+ status = I2C_QUEUE_OK;
+ ticks = 0;
+
+ I2C_STR = STR_SCD | STR_NACK | STR_AL;     /* Write 1 to clear */
+ I2C_CNT = t->length;
+ I2C_SAR = t->address;
+ I2C_IER = ( t->read ? STR_RRDY : STR_XRDY ) | STR_SCD | STR_NACK | STR_AL;
+
+ if ( t->read )
+   {
+    I2C_MDR = MDR_STT | MDR_STP | MDR_MST | MDR_IRS | MDR_FREE;
+   }
+ else
+   {
+    I2C_MDR = MDR_STT | MDR_STP | MDR_MST | MDR_TRX | MDR_IRS | MDR_FREE;
+   }
+}
+
+/*****************************************************************************/
+/* finish()                                                                  */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Complete the transaction on the bus and start the next one. Only called   */
+/* with interrupts disabled. The slot is not freed until the callback has    */
+/* returned, so the callback may queue more transactions.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static void finish(Int16 result)
+{
+ I2C_Transaction *t = &queue[head & QUEUE_MASK];
+
+ I2C_IER = 0;
+
+ if ( I2C_QUEUE_OK == result )
+   {
+    i2c_queue_stats.completed++;
+   }
+ else if ( I2C_QUEUE_TIMEOUT == result )
+   {
+    i2c_queue_stats.timeouts++;
+   }
+ else
+   {
+    i2c_queue_stats.errors++;
+   }
+
+ if ( t->callback )
+   {
+    t->callback(result, t->data, byte_index, t->context);
+   }
+
+ head++;
+
+ if ( head != tail )
+   {
+    start();
+   }
+ else
+   {
+    busy = 0;
+   }
+}
+
+/*****************************************************************************/
+/* i2c_queue_init()                                                          */
+/*****************************************************************************/
+
+void i2c_queue_init(void)
+{
+ I2C_IER = 0;
+
+ head = 0;
+ tail = 0;
+ busy = 0;
+
+ i2c_queue_stats.completed = 0;
+ i2c_queue_stats.errors = 0;
+ i2c_queue_stats.timeouts = 0;
+ i2c_queue_stats.overflows = 0;
+
+ IRQ_plug(I2C_EVENT, &i2c_queue_isr);
+ IRQ_enable(I2C_EVENT);
+
+ queue_open = 1;
+}
+
+/*****************************************************************************/
+/* enqueue()                                                                 */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: I2C_QUEUE_OK or I2C_QUEUE_FULL.                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static Int16 enqueue(Uint16 address, Uint16 read, const Uint8 *data,
+                     Uint16 length, I2C_Callback callback, void *context)
+{
+ I2C_Transaction *t;
+ Uint16 i;
+ Bool mask;
+
+ if ( !queue_open || 0 == length || length > I2C_QUEUE_MAX_BYTES )
+   {
+    return I2C_QUEUE_FULL;
+   }
+
+ mask = IRQ_globalDisable();
+
+ if ( (Uint16) ( tail - head ) >= I2C_QUEUE_SIZE )
+   {
+    i2c_queue_stats.overflows++;
+    IRQ_globalRestore(mask);
+    return I2C_QUEUE_FULL;
+   }
+
+ t = &queue[tail & QUEUE_MASK];
+ t->address = address;
+ t->read = read;
+ t->length = length;
+ t->callback = callback;
+ t->context = context;
+
+ for ( i = 0 ; i < length ; i++)
+   {
+    t->data[i] = data ? data[i] : 0;
+   }
+
+ tail++;
+
+ if ( !busy )
+   {
+    start();
+   }
+
+ IRQ_globalRestore(mask);
+
+ return I2C_QUEUE_OK;
+}
+
+/*****************************************************************************/
+/* i2c_queue_write()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  7-bit slave address.                                             */
+/*          1 to I2C_QUEUE_MAX_BYTES bytes, copied so the caller may reuse   */
+/*          the buffer at once.                                              */
+/*          Callback, or NULL, and a pointer passed back to it.              */
+/*                                                                           */
+/* RETURNS: I2C_QUEUE_OK if queued, I2C_QUEUE_FULL if the queue is full,     */
+/*          the length is wrong or i2c_queue_init() has not been called.     */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 i2c_queue_write(Uint16 address, const Uint8 *data, Uint16 length,
+                      I2C_Callback callback, void *context)
+{
+ return enqueue(address, 0, data, length, callback, context);
+}
+
+/*****************************************************************************/
+/* i2c_queue_read()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* As i2c_queue_write(). The bytes read are passed to the callback.          */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 i2c_queue_read(Uint16 address, Uint16 length,
+                     I2C_Callback callback, void *context)
+{
+ return enqueue(address, 1, 0, length, callback, context);
+}
+
+/*****************************************************************************/
+/* i2c_queue_pending()                                                       */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Number of transactions queued or on the bus.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint16 i2c_queue_pending(void)
+{
+ return (Uint16) ( tail - head );
+}
+
+/*****************************************************************************/
+/* i2c_queue_flush()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Wait until every transaction has completed. Needs interrupts enabled.     */
+/*                                                                           */
+/*****************************************************************************/
+
+void i2c_queue_flush(void)
+{
+ while ( tail != head )
+   {
+   }
+}
+
+/*****************************************************************************/
+/* i2c_queue_close()                                                         */
+/*****************************************************************************/
+
+void i2c_queue_close(void)
+{
+ if ( !queue_open )
+   {
+    return;
+   }
+
+ i2c_queue_flush();
+
+ IRQ_disable(I2C_EVENT);
+ I2C_IER = 0;
+ queue_open = 0;
+}
+
+/*****************************************************************************/
+/* i2c_queue_tick()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Called from the timer interrupt. A transaction still on the bus after     */
+/* I2C_QUEUE_TIMEOUT_TICKS calls has a stuck slave or a lost interrupt.      */
+/*                                                                           */
+/*****************************************************************************/
+
+void i2c_queue_tick(void)
+{
+ if ( !busy )
+   {
+    return;
+   }
+
+ if ( ++ticks >= I2C_QUEUE_TIMEOUT_TICKS )
+   {
+    USBSTK5505_I2C_reset();
+    finish(I2C_QUEUE_TIMEOUT);
+   }
+}
+
+/*****************************************************************************/
+/* i2c_queue_isr()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* One event per call. If more are pending the interrupt is taken again.     */
+/*                                                                           */
+/*****************************************************************************/
+
+interrupt void i2c_queue_isr(void)
+{
+ I2C_Transaction *t = &queue[head & QUEUE_MASK];
+
+ switch ( I2C_IVR & 0x0007 )
+   {
+    case IVR_XRDY:
+
+     if ( busy && byte_index < t->length )
+       {
+        I2C_DXR = t->data[byte_index++];
+       }
+
+     if ( !busy || byte_index >= t->length )
+       {
+        I2C_IER &= ~STR_XRDY;           /* Last byte is in, wait for STOP */
+       }
+     break;
+
+    case IVR_RRDY:
+
+     if ( busy && byte_index < t->length )
+       {
+        t->data[byte_index++] = I2C_DRR;
+       }
+     else
+       {
+        (void) I2C_DRR;
+       }
+     break;
+
+    case IVR_NACK:
+
+     /* Release the bus. Completed when the STOP has been sent */
+
+     I2C_MDR |= MDR_STP;
+     I2C_STR = STR_NACK;
+     I2C_IER &= ~( STR_XRDY | STR_RRDY );
+     status = I2C_QUEUE_NACK;
+     break;
+
+    case IVR_AL:
+
+     /* The module has dropped to slave mode and sends no STOP */
+
+     I2C_STR = STR_AL;
+
+     if ( busy )
+       {
+        USBSTK5505_I2C_reset();
+        finish(I2C_QUEUE_ARBITRATION);
+       }
+     break;
+
+    case IVR_SCD:
+
+     I2C_STR = STR_SCD;
+
+     if ( busy )
+       {
+        finish(status);
+       }
+     break;
+
+    default:
+     break;
+   }
+}
+
+/*****************************************************************************/
+/* End of i2c_queue.c                                                        */
+/*****************************************************************************/
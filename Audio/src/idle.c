@@ -0,0 +1,241 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 idle.c                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Wait for each sample with the CPU clock stopped instead of polling.     */
+/*                                                                           */
+/*   aic3204_codec_read() spins on the I2S0 flags for most of every sample   */
+/*   period. Here the I2S0 receive interrupt reads the sample into a         */
+/*   buffer, and idle_codec_read() puts the CPU domain to sleep with the     */
+/*   IDLE instruction until it has. Interrupts are masked from the check of  */
+/*   the buffer to the IDLE, so a sample arriving in between is not slept    */
+/*   through: an interrupt enabled in IER wakes the CPU even with INTM set,  */
+/*   and is taken once INTM is restored. The timer, UART and I2C interrupts  */
+/*   wake it too, and it goes back to sleep after them.                      */
+/*                                                                           */
+/*   The peripherals keep their clocks while the CPU sleeps, so GPT1 still   */
+/*   counts. idle_init() also stops the clocks of the modules that are not   */
+/*   used at all, IDLE_GATED_PCGCR1 and IDLE_GATED_PCGCR2.                   */
+/*                                                                           */
+/*   Over each IDLE_WINDOW_SAMPLES the time asleep and the time from the     */
+/*   last wake up to having the sample are measured with GPT1, put in        */
+/*   idle_stats and logged.                                                  */
+/*                                                                           */
+/*   Call idle_init() after CSL_gptIntrTest(), which disables all            */
+/*   interrupts. aic3204_codec_write() is used as before.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_intc.h"
+#include "soc.h"
+#include "usbstk5505.h"
+#include "delay.h"
+#include "log.h"
+#include "idle.h"
+
+/* Programmable receive interrupt 0 is I2S0 receive while the I2S0 pins are  */
+/* selected instead of MMC/SD0                                               */
+
+#define I2S0_RX_EVENT   PROG1_EVENT
+
+volatile IDLE_STATS idle_stats;
+
+static volatile Int16 sample_left;
+static volatile Int16 sample_right;
+static volatile Uint16 sample_ready = 0;
+
+static Uint32 window_from;
+static Uint32 idle_ticks;
+static Uint32 wake_ticks_total;
+static Uint32 wake_ticks_worst;
+static Uint16 samples;
+
+/*****************************************************************************/
+/* ticks_to_ns()                                                             */
+/*****************************************************************************/
+
+static Uint32 ticks_to_ns(Uint32 ticks)
+{
+ if ( 0 == delay_ticks_per_ms )
+   {
+    return 0;
+   }
+
+ if ( ticks >= 4000 )
+   {
+    return delay_ticks_to_us(ticks) * 1000;
+   }
+
+ return ( ticks * 1000000UL ) / delay_ticks_per_ms;
+}
+
+/*****************************************************************************/
+/* end_window()                                                              */
+/*****************************************************************************/
+
+static void end_window(void)
+{
+ Uint32 now = delay_now();
+ Uint32 total = now - window_from;
+
+ idle_stats.idle_percent = ( total > 0 )
+                           ? ( idle_ticks / ( total / 100 + 1 ) ) : 0;
+ idle_stats.wake_ns_mean = ticks_to_ns(wake_ticks_total / samples);
+ idle_stats.wake_ns_worst = ticks_to_ns(wake_ticks_worst);
+
+ LOG3(LOG_IDLE_WINDOW, idle_stats.idle_percent, idle_stats.wake_ns_mean,
+      idle_stats.wake_ns_worst);
+
+ window_from = now;
+ idle_ticks = 0;
+ wake_ticks_total = 0;
+ wake_ticks_worst = 0;
+ samples = 0;
+}
+
+/*****************************************************************************/
+/* idle_init()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Stop the clocks of the unused modules and start taking samples in the     */
+/* I2S0 receive interrupt.                                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+void idle_init(void)
+{
+ volatile Int16 dummy;
+
+ CSL_SYSCTRL_REGS->PCGCR1 |= IDLE_GATED_PCGCR1;
+ CSL_SYSCTRL_REGS->PCGCR2 |= IDLE_GATED_PCGCR2;
+
+ idle_stats.idle_percent = 0;
+ idle_stats.wake_ns_mean = 0;
+ idle_stats.wake_ns_worst = 0;
+ idle_stats.idles = 0;
+ idle_stats.missed = 0;
+
+ window_from = delay_now();
+ idle_ticks = 0;
+ wake_ticks_total = 0;
+ wake_ticks_worst = 0;
+ samples = 0;
+
+ /* Empty the receive registers so the first interrupt is a new sample */
+
+ dummy = I2S0_W0_MSW_R;
+ dummy = I2S0_W0_LSW_R;
+ dummy = I2S0_W1_MSW_R;
+ dummy = I2S0_W1_LSW_R;
+ sample_ready = 0;
+
+ IRQ_clear(I2S0_RX_EVENT);
+ IRQ_plug(I2S0_RX_EVENT, &idle_i2s_rx_isr);
+ IRQ_enable(I2S0_RX_EVENT);
+}
+
+/*****************************************************************************/
+/* idle_codec_read()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* As aic3204_codec_read(), sleeping until the sample has come.              */
+/*                                                                           */
+/*****************************************************************************/
+
+void idle_codec_read(Int16 *left_input, Int16 *right_input)
+{
+ Uint32 slept;
+ Uint32 woke = 0;
+ Uint32 wake;
+ Bool mask;
+
+ mask = IRQ_globalDisable();
+
+ while ( !sample_ready )
+   {
+    slept = delay_now();
+
+    /* Only the CPU domain. The ports stay up for the peripherals */
+
+    CSL_IDLECTRL_REGS->ICR = CSL_IDLE_ICR_CPUI_MASK;
+    asm(" IDLE");
+
+    woke = delay_now();
+    idle_ticks += woke - slept;
+    idle_stats.idles++;
+
+    /* Take the interrupt that woke the CPU */
+
+    IRQ_globalRestore(mask);
+    mask = IRQ_globalDisable();
+   }
+
+ *left_input = sample_left;
+ *right_input = sample_right;
+ sample_ready = 0;
+
+ IRQ_globalRestore(mask);
+
+ /* Latency of the last wake up. None if the sample was already there */
+
+ if ( woke != 0 )
+   {
+    wake = delay_now() - woke;
+    wake_ticks_total += wake;
+
+    if ( wake > wake_ticks_worst )
+      {
+       wake_ticks_worst = wake;
+      }
+   }
+
+ if ( ++samples >= IDLE_WINDOW_SAMPLES )
+   {
+    end_window();
+   }
+}
+
+/*****************************************************************************/
+/* idle_close()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Back to polling with aic3204_codec_read(). The gated clocks stay off.     */
+/*                                                                           */
+/*****************************************************************************/
+
+void idle_close(void)
+{
+ IRQ_disable(I2S0_RX_EVENT);
+}
+
+/*****************************************************************************/
+/* idle_i2s_rx_isr()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Only the data registers are read. Reading I2S0_IR would clear the         */
+/* transmit flag that aic3204_codec_write() waits for.                       */
+/*                                                                           */
+/*****************************************************************************/
+
+interrupt void idle_i2s_rx_isr(void)
+{
+ volatile Int16 dummy;
+
+ if ( sample_ready )
+   {
+    idle_stats.missed++;                /* Previous one never read          */
+   }
+
+ sample_left = I2S0_W0_MSW_R;
+ dummy = I2S0_W0_LSW_R;
+ sample_right = I2S0_W1_MSW_R;
+ dummy = I2S0_W1_LSW_R;
+ sample_ready = 1;
+}
+
+/*****************************************************************************/
+/* End of idle.c                                                             */
+/*****************************************************************************/
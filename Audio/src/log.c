@@ -0,0 +1,243 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 log.c                                                                   */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Binary log held in a RAM ring buffer.                                   */
+/*                                                                           */
+/*   printf() goes through CIO, which stops the CPU at a breakpoint while    */
+/*   the debugger collects the text, so samples are lost whenever it is      */
+/*   used with audio running. log_write() only copies a message id, three    */
+/*   arguments and a timestamp into the next record, and may be called from  */
+/*   interrupts. The text is put back together on the PC from the ids in     */
+/*   log_formats.h by tools/log_decode.c.                                    */
+/*                                                                           */
+/*   log_drain() is called when there is time, from a scheduler task in      */
+/*   main(), and sends what it can without waiting:                          */
+/*                                                                           */
+/*   LOG_SINK_UART  Frames for log_decode, through uart_write(). Records     */
+/*                  wait until uart_init() has been called.                  */
+/*   LOG_SINK_CIO   printf() of one record per call, for use with the        */
+/*                  debugger when no audio is running.                       */
+/*   LOG_SINK_RAM   Nothing. Save log_buffer[] from the debugger and decode  */
+/*                  it with log_decode -m.                                   */
+/*                                                                           */
+/*   When the buffer is full new records are dropped and counted, and a      */
+/*   LOG_DROPPED record goes in when there is room again.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include "csl_intc.h"
+#include "usbstk5505.h"
+#include "delay.h"
+#include "uart.h"
+#include "log.h"
+
+#define LOG_MASK            ( LOG_RECORDS - 1 )
+
+LOG_RECORD log_buffer[LOG_RECORDS];
+volatile Uint32 log_dropped = 0;
+
+static volatile Uint16 head = 0;        /* Next record to write             */
+static volatile Uint16 tail = 0;        /* Next record to send              */
+static volatile Uint16 unreported = 0;  /* Dropped since last LOG_DROPPED */
+
+#if (LOG_SINK == LOG_SINK_UART)
+
+static Uint8 frame[LOG_FRAME_BYTES];
+static Uint16 frame_length = 0;
+
+#elif (LOG_SINK == LOG_SINK_CIO)
+
+static const char *const formats[LOG_FORMATS] =
+{
+    "",
+#define LOG_FORMAT(id, format)  format,
+#include "log_formats.h"
+#undef LOG_FORMAT
+};
+
+#endif
+
+/*****************************************************************************/
+/* log_init()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Call after delay_init(), and again if the PLL is changed. Records         */
+/* written before then are kept, with a timestamp of 0.                      */
+/* With LOG_SINK_UART, uart_init() is also needed before any are sent.       */
+/*                                                                           */
+/*****************************************************************************/
+
+void log_init(void)
+{
+ LOG1(LOG_CLOCK, delay_ticks_per_ms);
+}
+
+/*****************************************************************************/
+/* log_write()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  Message id from log_formats.h and its arguments. Use the LOG0()  */
+/*          to LOG3() macros.                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static void put(Uint32 ticks, Uint16 id, long a, long b, long c)
+{
+ LOG_RECORD *r = &log_buffer[head & LOG_MASK];
+
+ r->ticks = ticks;
+ r->args[0] = a;
+ r->args[1] = b;
+ r->args[2] = c;
+ r->id = id;
+
+ head++;
+}
+
+void log_write(Uint16 id, long a, long b, long c)
+{
+ Uint32 ticks = delay_now();
+ Bool mask;
+
+ mask = IRQ_globalDisable();
+
+ if ( unreported && (Uint16) ( head - tail ) <= LOG_RECORDS - 2 )
+   {
+    put(ticks, LOG_DROPPED, unreported, 0, 0);
+    unreported = 0;
+   }
+
+ if ( unreported || (Uint16) ( head - tail ) >= LOG_RECORDS )
+   {
+    log_dropped++;
+    unreported++;
+   }
+ else
+   {
+    put(ticks, id, a, b, c);
+   }
+
+ IRQ_globalRestore(mask);
+}
+
+#if (LOG_SINK == LOG_SINK_UART)
+
+/*****************************************************************************/
+/* make_frame()                                                              */
+/*****************************************************************************/
+
+static void add_bytes(Uint32 value, Uint16 count, Uint16 *sum)
+{
+ while ( count-- > 0 )
+   {
+    frame[frame_length] = value & 0xFF;
+    *sum += frame[frame_length++];
+    value >>= 8;
+   }
+}
+
+static void make_frame(const LOG_RECORD *r)
+{
+ Uint16 sum = 0;
+ Uint16 i;
+
+ frame_length = 0;
+ frame[frame_length++] = LOG_SYNC;
+
+ add_bytes(r->id, 2, &sum);
+ add_bytes(r->ticks, 4, &sum);
+
+ for ( i = 0 ; i < LOG_ARGS ; i++)
+   {
+    add_bytes((Uint32) r->args[i], 4, &sum);
+   }
+
+ frame[frame_length++] = ( 0x100 - ( sum & 0xFF ) ) & 0xFF;
+}
+
+#endif
+
+/*****************************************************************************/
+/* log_drain()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Send what can be sent without waiting, with LOG_SINK_UART one record.     */
+/* Not reentrant: call from one place outside interrupts.                    */
+/*                                                                           */
+/* RETURNS: Records still to be sent, plus 1 while the UART is still         */
+/*          sending. 0 if nothing can be sent: with LOG_SINK_RAM, or before  */
+/*          uart_init().                                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint16 log_drain(void)
+{
+#if (LOG_SINK == LOG_SINK_UART)
+
+ /* One frame per call keeps each call short. 115200 baud takes under 600 */
+ /* frames a second                                                       */
+
+ if ( tail != head && uart_tx_room() >= LOG_FRAME_BYTES )
+   {
+    make_frame(&log_buffer[tail & LOG_MASK]);
+
+    if ( uart_write(frame, frame_length) != 0 )
+      {
+       return 0;                        /* UART not open yet */
+      }
+
+    tail++;
+   }
+
+ return (Uint16) ( head - tail ) + ( uart_tx_pending() > 0 );
+
+#elif (LOG_SINK == LOG_SINK_CIO)
+ LOG_RECORD *r;
+
+ if ( tail == head )
+   {
+    return 0;
+   }
+
+ r = &log_buffer[tail & LOG_MASK];
+
+ printf("%10lu us  ", delay_ticks_to_us(r->ticks));
+
+ if ( r->id < LOG_FORMATS )
+   {
+    printf(formats[r->id], r->args[0], r->args[1], r->args[2]);
+   }
+
+ printf("\n");
+ tail++;
+
+ return (Uint16) ( head - tail );
+
+#else
+ return 0;
+#endif
+}
+
+/*****************************************************************************/
+/* log_flush()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Wait until everything has been sent, for example before exit.             */
+/*                                                                           */
+/*****************************************************************************/
+
+void log_flush(void)
+{
+ while ( log_drain() > 0 )
+   {
+   }
+}
+
+/*****************************************************************************/
+/* End of log.c                                                              */
+/*****************************************************************************/
@@ -62,6 +62,7 @@
 #include <stdio.h>
 #include "usbstk5505.h"
 #include "aic3204.h"
+#include "aic3204_biquad.h"
 #include "PLL.h"
 #include "stereo.h"
 #include "IIR_band_pass_filters.h"
@@ -71,18 +72,148 @@
 #include "IIR_high_pass_filters.h"
 #include "SweepGenerator.h"
 #include "timer.h"
+#include "agc.h"
+#include "goertzel.h"
+#include "pitch.h"
+#include "bode.h"
+#include "delay.h"
+#include "boot.h"
+#include "log.h"
+#include "sched.h"
+#include "uart.h"
+#include "command.h"
+#include "dvfs.h"
+#include "idle.h"
+#include "supervisor.h"
+#include "hotpath.h"
+#include "memuse.h"
+#include "dsplib_bench.h"
 
 #define SAMPLES_PER_SECOND 48000
+#define CPU_MHZ 100                 // Starting clock. See dvfs.h
 #define GAIN_IN_dB  10
 
+/* Set to 1 to measure the impulse response of the line out to line in path */
+/* before the main loop. Results in sweep_impulse_response[] and           */
+/* sweep_harmonic_response[][]                                              */
+#define IMPULSE_RESPONSE_MEASUREMENT 0
+
+/* Set to 1 to measure the frequency response of filter_chain() with a     */
+/* digital loopback, or 2 through line out to line in. Results printed as  */
+/* CSV and left in bode_table[]                                             */
+#define FREQUENCY_RESPONSE_MEASUREMENT 0
+
+/* Set to 1 to run the Step 1 low pass filter in the AIC3204 DAC biquads   */
+/* instead of on the C5505. The filter is then on both channels at Step 1  */
+/* and the inputs are passed straight through at Step 0                    */
+#define CODEC_FILTERS 0
+
+/* Stages shed by the supervisor. Always all of them without it */
+#if (SUPERVISOR)
+#define SHED_LEVEL supervisor_stats.level
+#else
+#define SHED_LEVEL SUPERVISOR_FULL
+#endif
+
 Int16 left_input;
 Int16 right_input;
 Int16 left_output;
 Int16 right_output;
 Int16 mono_input;
 
-extern unsigned int Step;
-extern unsigned int playnum;
+#if (HOT_SECTIONS)
+#pragma DATA_SECTION(dtmf_bank, ".delay")
+#endif
+GOERTZEL_Bank dtmf_bank;                // Goertzel state, run every sample
+GOERTZEL_Event tone_event;
+Uint16 dtmf_row = 0;
+Uint16 dtmf_column = 0;
+char dtmf_key = 0;   // Last DTMF key detected. View in Watch Window.
+
+unsigned int low_pass_filter = IIR_LOW_PASS_4800HZ; // Step 1, CMD_PARAM_FILTER
+
+Uint16 audio_started = 0;   // Set when the first sample has gone out
+
+#if (CODEC_FILTERS)
+AIC3204_BIQUAD codec_flat[2];
+AIC3204_BIQUAD codec_low_pass[2];       // Fourth order, as Step 1 on the C5505
+unsigned int codec_step = 0;            // Step the codec biquads are set for
+unsigned int codec_filter = IIR_LOW_PASS_4800HZ;    // and the low pass filter
+#endif
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  filter_chain( )                                                         *
+ *                                                                          *
+ *  Processing measured by FREQUENCY_RESPONSE_MEASUREMENT.                  *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+signed int filter_chain( signed int input )
+{
+    return fourth_order_IIR_direct_form_I ( IIR_low_pass_tables[low_pass_filter], input);
+}
+
+#if (CODEC_FILTERS)
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  codec_filter_task( )                                                    *
+ *                                                                          *
+ *  Loads the codec biquads for a new Step or low pass filter. Scheduled     *
+ *  every 10 ms.                                                            *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static void codec_filter_task( void *context )
+{
+    if ( Step != codec_step || ( Step && low_pass_filter != codec_filter ) )
+    {
+        const AIC3204_BIQUAD* biquads = Step ? codec_low_pass : codec_flat;
+        unsigned int filter = low_pass_filter;
+        Int16 result;
+
+        if ( filter != codec_filter )
+        {
+            aic3204_biquad_from_table(&codec_low_pass[0], IIR_low_pass_tables[filter]);
+            aic3204_biquad_from_table(&codec_low_pass[1], IIR_low_pass_tables[filter]);
+            codec_filter = filter;
+        }
+
+        /* Queued, so no samples are lost. Tried again until there is room */
+        result = aic3204_dac_biquads_async( biquads, biquads, 2 );
+
+        /* After an I2C error. Waits, so a few ms of samples are lost */
+        if ( result != 0 && result != I2C_QUEUE_FULL )
+            result = aic3204_dac_biquads( biquads, biquads, 2 );
+
+        if ( result == 0 )
+            codec_step = Step;
+    }
+}
+#endif
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  log_task( )                                                             *
+ *                                                                          *
+ *  Sends log messages. Scheduled every ms, after everything else.          *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static void log_task( void *context )
+{
+    log_drain();
+}
+
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  log_banner( )                                                           *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+static void log_banner( void )
+{
+    LOG0(LOG_BANNER);
+    LOG0(LOG_LOOPBACK);
+    LOG1(LOG_SWITCH_PERIOD, SWITCH_SECS);
+    LOG1(LOG_CHANGES, AUDIOBACK_COUNT);
+}
 
 /* ------------------------------------------------------------------------ *
  *                                                                          *
@@ -91,35 +222,187 @@ extern unsigned int playnum;
  * ------------------------------------------------------------------------ */
 void main( void )
 {
+#if (MEMUSE)
+    /* Before anything else goes on the stacks or the heap */
+    memuse_paint( );
+#endif
+
     /* Initialize BSL */
     USBSTK5505_init( );
 
     /* Initialize the Phase Locked Loop in EEPROM */
-    pll_frequency_setup(100);
+    pll_frequency_setup(CPU_MHZ);
+
+    /* Delays and timeouts from here on are timed by GPT1 */
+    delay_init();
+    boot_mark(LOG_BOOT_PLL);
 
-    /* Initialise hardware interface and I2C for code */
+    /* Messages from here on are timestamped. Sent by log_task() */
+    log_init();
+
+#if (DSPLIB_BENCH)
+    /* DSPLIB cycles, from RAM or from the ROM with DSPLIB_ROM */
+    dsplib_bench();
+#endif
+
+    /* Reset the codec and initialise I2C. The codec is not ready for 1 ms */
     aic3204_hardware_init();
+    boot_mark(LOG_BOOT_CODEC_RESET);
+
+    /* Automatic gain control starts from the same ADC gain */
+    agc_init(GAIN_IN_dB);
 
+    /* DTMF detector on the mono input */
+    goertzel_init(&dtmf_bank, SAMPLES_PER_SECOND, goertzel_dtmf_frequencies, 8,
+                  GOERTZEL_DTMF_BLOCK_LENGTH, GOERTZEL_DTMF_DECIMATION,
+                  GOERTZEL_DTMF_THRESHOLD);
+
+    /* Fundamental frequency tracker. Result in pitch_estimate */
+    pitch_init(PITCH_UNBIASED);
+
+#if (CODEC_FILTERS)
+    /* The codec biquads are flat after the reset, as at Step 0 */
+    aic3204_biquad_flat(&codec_flat[0]);
+    aic3204_biquad_flat(&codec_flat[1]);
+    aic3204_biquad_from_table(&codec_low_pass[0], IIR_low_pass_tables[codec_filter]);
+    aic3204_biquad_from_table(&codec_low_pass[1], IIR_low_pass_tables[codec_filter]);
+#endif
+    boot_mark(LOG_BOOT_DSP);
+
+#if !(BOOT_FAST)
     /* Initialise the AIC3204 codec */
     aic3204_init();
+    boot_mark(LOG_BOOT_AIC3204_INIT);
+#endif
 
-    printf("\n\nRunning IIR Filters Project using main.c\n");
-    printf( "<-> Audio Loopback from Stereo Line IN --> to HP/Lineout\n\n" );
+    log_banner();
 
     /* Set sampling frequency in Hz and ADC gain in dB */
     set_sampling_frequency_and_gain(SAMPLES_PER_SECOND, GAIN_IN_dB);
+    boot_mark(LOG_BOOT_SAMPLING);
+
+#if (IMPULSE_RESPONSE_MEASUREMENT)
+    sweep_measure_start(SAMPLES_PER_SECOND);
+
+    while ( SWEEP_RECORDING == sweep_measure_state() )
+    {
+        aic3204_codec_read(&left_input, &right_input);
+
+        left_output = sweep_measure_process(left_input); // Record left, play sweep
+
+        aic3204_codec_write(left_output, left_output);
+    }
+
+    sweep_deconvolve();
+
+    if ( sweep_clipped )
+        LOG1(LOG_SWEEP_CLIPPED, sweep_clipped);
+#endif
+
+#if (FREQUENCY_RESPONSE_MEASUREMENT == 1)
+    bode_init(BODE_DIGITAL, SAMPLES_PER_SECOND, BODE_AMPLITUDE, filter_chain);
+    bode_run_digital();
+    bode_report();
+    bode_print_csv();
+#elif (FREQUENCY_RESPONSE_MEASUREMENT == 2)
+    bode_init(BODE_ANALOG, SAMPLES_PER_SECOND, BODE_AMPLITUDE, filter_chain);
+
+    while ( BODE_MEASURING == bode_state() )
+    {
+        aic3204_codec_read(&left_input, &right_input);
+
+        left_output = bode_process(left_input); // Measure left, play stimulus
+
+        aic3204_codec_write(left_output, left_output);
+    }
 
-    puts("Changes configuration once every 15 seconds");
-    printf("The program will end after %d changes\n", AUDIOBACK_COUNT);
+    bode_report();
+    bode_print_csv();
+#endif
 
     CSL_gptIntrTest();
-    while(playnum < AUDIOBACK_COUNT)
+
+    /* Codec register changes from here on are queued, not waited for */
+    i2c_queue_init();
+
+    /* Log frames out and commands in, through the UART interrupt */
+    uart_init();
+
+    /* Background work, run between samples by sched_run() */
+    sched_periodic(command_task, NULL, SCHED_PRIORITY_HIGH, 1, 0);
+    sched_periodic(pitch_task, NULL, SCHED_PRIORITY_HIGH, 1, 0);
+#if (CODEC_FILTERS)
+    sched_periodic(codec_filter_task, NULL, SCHED_PRIORITY_HIGH, 10, 0);
+#endif
+    sched_periodic(log_task, NULL, SCHED_PRIORITY_LOW, 1, 0);
+#if (MEMUSE)
+    sched_periodic(memuse_task, NULL, SCHED_PRIORITY_LOW, MEMUSE_PERIOD_MS, 0);
+#endif
+    boot_mark(LOG_BOOT_TIMER);
+
+#if (DVFS_GOVERNOR)
+    /* From here on the clock follows the load of the loop below */
+    dvfs_init(CPU_MHZ, SAMPLES_PER_SECOND);
+#endif
+
+#if (IDLE_WAIT)
+    /* Samples from the I2S0 interrupt, with the CPU asleep in between */
+    idle_init();
+#endif
+
+#if (SUPERVISOR)
+    /* Late samples shed stages. The watchdog resets if the loop stops */
+    supervisor_init(SAMPLES_PER_SECOND);
+#endif
+
+    while(playnum < change_limit)
     {
 
+#if (IDLE_WAIT)
+        idle_codec_read(&left_input, &right_input);
+#else
         aic3204_codec_read(&left_input, &right_input); // Configured for one interrupt per two channels.
+#endif
+
+#if (DVFS_GOVERNOR)
+        dvfs_busy_start();
+#endif
+#if (SUPERVISOR)
+        supervisor_frame_start();
+#endif
+
+        /* Cycles from here to the output are logged once a second */
+        hotpath_start();
 
         mono_input = stereo_to_mono(left_input, right_input); // Generate mono signal
 
+        /* Stages shed, last first, while samples are late */
+        /* The AGC only runs for Step 1. At Step 0 the inputs go straight   */
+        /* out, so its PGA steps would be heard without the digital gain    */
+        if ( Step != 0 && SHED_LEVEL < SUPERVISOR_SHED_AGC )
+            mono_input = agc_process(mono_input); // Automatic gain control
+        else
+            agc_bypass(); // PGA back to nominal, as nothing makes up for it now
+
+        if ( SHED_LEVEL < SUPERVISOR_SHED_DTMF )
+            goertzel_process(&dtmf_bank, &mono_input, 1); // DTMF tone detection
+
+        if ( SHED_LEVEL < SUPERVISOR_SHED_PITCH )
+            pitch_process(mono_input); // Pitch estimate every 10 ms, by pitch_task()
+
+        while ( goertzel_get_event(&dtmf_bank, &tone_event) )
+        {
+            if ( tone_event.present )
+            {
+                if ( tone_event.tone < 4 )
+                    dtmf_row = tone_event.frequency;
+                else
+                    dtmf_column = tone_event.frequency;
+
+                dtmf_key = goertzel_dtmf_key(dtmf_row, dtmf_column);
+            }
+        }
+
         if ( Step == 0 )
         {
             left_output = left_input;      // Directly connect inputs to outputs for reference.
@@ -127,15 +410,51 @@ void main( void )
         }
         else if ( Step == 1 )
         {
-            /* Low pass filter 4800 Hz */
-            left_output = fourth_order_IIR_direct_form_I ( &IIR_low_pass_4800Hz[0], mono_input);
+#if (CODEC_FILTERS)
+            left_output = mono_input;      // Filtered by the codec
+            right_output = mono_input;
+#else
+            /* Low pass filter chosen with CMD_PARAM_FILTER, 4800 Hz at reset */
+            left_output = fourth_order_IIR_direct_form_I ( IIR_low_pass_tables[low_pass_filter], mono_input);
             /* High pass filter 4800 Hz */
-            right_output = fourth_order_IIR_direct_form_I ( &IIR_low_pass_4800Hz[0], mono_input);
+            right_output = fourth_order_IIR_direct_form_I ( IIR_low_pass_tables[low_pass_filter], mono_input);
+#endif
         }
 
+        hotpath_end();
+
         aic3204_codec_write(left_output, right_output);
+
+        if ( !audio_started )
+        {
+            audio_started = 1;
+            boot_mark(LOG_BOOT_FIRST_AUDIO);
+            boot_report();
+        }
+
+        /* At most one background task while waiting for the next sample */
+        sched_run();
+
+#if (DVFS_GOVERNOR)
+        /* May change the clock once every window */
+        dvfs_busy_end();
+#endif
+#if (SUPERVISOR)
+        supervisor_frame_end();
+#endif
     }
 
+#if (SUPERVISOR)
+    supervisor_close();
+#endif
+#if (IDLE_WAIT)
+    idle_close();
+#endif
+    /* Send any queued codec register changes */
+    i2c_queue_close();
+    /* Send the rest of the log */
+    log_flush();
+    uart_close();
     /* Disable I2S and put codec into reset */
     aic3204_disable();
     /* Disable all interrupts and put timer into reset */
@@ -0,0 +1,289 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 memuse.c                                                                */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   High water marks of the stacks and the heap set up by lnkx.cmd.         */
+/*                                                                           */
+/*   Both stacks grow down from the top, so the peak is from the lowest word */
+/*   no longer painted to the top. malloc() takes the lowest free block that */
+/*   fits, so the heap peak is from the bottom to the highest word no longer */
+/*   painted. The RTS sets the heap up on the first malloc(), which is after */
+/*   memuse_paint(), so the heap is painted whole.                           */
+/*                                                                           */
+/*   memuse_task() is a scheduler task. It checks MEMUSE_WORDS_PER_RUN words */
+/*   each run, a region at a time, keeps the peaks in memuse_stats and logs  */
+/*   them when one goes up. With 4096, 2048 and 4096 words a pass takes      */
+/*   80 runs, 0.8 s.                                                         */
+/*                                                                           */
+/*   memuse_query() scans everything at once and also measures how broken    */
+/*   up the free heap is, by taking the largest block malloc() will give     */
+/*   until there is none left. That takes ms: call it with the audio         */
+/*   stopped, not from a task.                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdlib.h>
+#include "usbstk5505.h"
+#include "log.h"
+#include "memuse.h"
+
+#define REGIONS                 3
+
+/* Made by the linker for -stack, -sysstack and -heap. Sizes in bytes */
+
+extern Uint16 _stack[];
+extern Uint16 _sysstack[];
+extern Uint16 _sys_memory[];
+extern int _STACK_SIZE;
+extern int _SYSSTACK_SIZE;
+extern int _SYSMEM_SIZE;
+
+typedef struct
+{
+    Uint16 *base;
+    Uint16 words;
+    Uint16 grows_down;
+    Uint16 peak;
+} REGION;
+
+volatile MEMUSE_STATS memuse_stats;
+
+static REGION regions[REGIONS];
+static Uint16 region = 0;               /* Being checked by memuse_task()   */
+static Uint16 offset = 0;               /* Words of it checked so far       */
+static Uint16 raised = 0;               /* A peak went up this pass         */
+
+/*****************************************************************************/
+/* paint()                                                                   */
+/*****************************************************************************/
+
+static void paint(Uint16 *from, Uint32 words)
+{
+ while ( words-- )
+   {
+    *from++ = MEMUSE_PAINT;
+   }
+}
+
+/*****************************************************************************/
+/* used()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Words used if the word at offset, counted from the unused end,   */
+/*          is no longer painted, otherwise 0.                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint16 used(const REGION *r, Uint16 at)
+{
+ if ( r->grows_down )
+   {
+    return ( MEMUSE_PAINT != r->base[at] ) ? r->words - at : 0;
+   }
+
+ return ( MEMUSE_PAINT != r->base[r->words - 1 - at] ) ? r->words - at : 0;
+}
+
+/*****************************************************************************/
+/* publish()                                                                 */
+/*****************************************************************************/
+
+static void publish(void)
+{
+ memuse_stats.stack_words = regions[0].words;
+ memuse_stats.stack_peak = regions[0].peak;
+ memuse_stats.system_stack_words = regions[1].words;
+ memuse_stats.system_stack_peak = regions[1].peak;
+ memuse_stats.heap_words = regions[2].words;
+ memuse_stats.heap_peak = regions[2].peak;
+}
+
+/*****************************************************************************/
+/* memuse_paint()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* First thing in main(), with interrupts still off. The stack is painted up */
+/* to MEMUSE_PAINT_MARGIN words under this function's own frame, the system  */
+/* stack up to MEMUSE_PAINT_MARGIN words under its top, which leaves what    */
+/* c_int00() and main() have on them.                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+void memuse_paint(void)
+{
+ volatile Uint16 here;
+
+ regions[0].base = _stack;
+ regions[0].words = (Uint32) &_STACK_SIZE / 2;
+ regions[0].grows_down = 1;
+ regions[1].base = _sysstack;
+ regions[1].words = (Uint32) &_SYSSTACK_SIZE / 2;
+ regions[1].grows_down = 1;
+ regions[2].base = _sys_memory;
+ regions[2].words = (Uint32) &_SYSMEM_SIZE / 2;
+ regions[2].grows_down = 0;
+
+ paint(_stack, (Uint16 *) &here - MEMUSE_PAINT_MARGIN - _stack);
+ paint(_sysstack, regions[1].words - MEMUSE_PAINT_MARGIN);
+ paint(_sys_memory, regions[2].words);
+
+ publish();
+}
+
+/*****************************************************************************/
+/* memuse_task()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Each region is checked from its unused end, so the first word found used  */
+/* gives its peak. A peak never goes down.                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+void memuse_task(void *context)
+{
+ REGION *r = &regions[region];
+ Uint16 count;
+ Uint16 words;
+
+ for ( count = 0 ; count < MEMUSE_WORDS_PER_RUN ; count++ )
+   {
+    words = ( offset < r->words ) ? used(r, offset) : 0;
+
+    if ( words == 0 && offset < r->words )
+      {
+       offset++;
+       continue;
+      }
+
+    /* Used word found, or none at all in the region */
+
+    if ( words > r->peak )
+      {
+       r->peak = words;
+       raised = 1;
+      }
+
+    offset = 0;
+
+    if ( ++region < REGIONS )
+      {
+       return;
+      }
+
+    region = 0;
+    publish();
+
+    if ( raised )
+      {
+       LOG3(LOG_MEMUSE_PEAK, regions[0].peak, regions[1].peak,
+            regions[2].peak);
+       raised = 0;
+      }
+
+    return;
+   }
+}
+
+/*****************************************************************************/
+/* largest_block()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: The most words malloc() will give now, found by halving.         */
+/*                                                                           */
+/*****************************************************************************/
+
+static size_t largest_block(size_t most)
+{
+ size_t low = 0;
+ size_t middle;
+ void *block;
+
+ while ( low < most )
+   {
+    middle = ( low + most + 1 ) / 2;
+    block = malloc(middle);
+
+    if ( block )
+      {
+       free(block);
+       low = middle;
+      }
+    else
+      {
+       most = middle - 1;
+      }
+   }
+
+ return low;
+}
+
+/*****************************************************************************/
+/* memuse_query()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The free blocks are held, largest first, until malloc() has nothing left, */
+/* then painted and freed, so the heap is as it was and the heap peak still  */
+/* shows only real use.                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+void memuse_query(MEMUSE_STATS *stats)
+{
+ void *held[MEMUSE_PROBE_BLOCKS];
+ size_t sizes[MEMUSE_PROBE_BLOCKS];
+ Uint16 blocks;
+ Uint16 n;
+ Uint16 at;
+ Uint32 free_words = 0;
+ REGION *r;
+
+ for ( n = 0 ; n < REGIONS ; n++ )
+   {
+    r = &regions[n];
+
+    for ( at = 0 ; at < r->words && 0 == used(r, at) ; at++ )
+      {
+      }
+
+    if ( at < r->words && used(r, at) > r->peak )
+      {
+       r->peak = used(r, at);
+      }
+   }
+
+ publish();
+
+ for ( blocks = 0 ; blocks < MEMUSE_PROBE_BLOCKS ; blocks++ )
+   {
+    sizes[blocks] = largest_block(regions[2].words);
+    held[blocks] = sizes[blocks] ? malloc(sizes[blocks]) : 0;
+
+    if ( 0 == held[blocks] )
+      {
+       break;
+      }
+
+    free_words += sizes[blocks];
+   }
+
+ for ( n = 0 ; n < blocks ; n++ )
+   {
+    paint((Uint16 *) held[n], sizes[n]);
+    free(held[n]);
+   }
+
+ *stats = memuse_stats;
+ stats->heap_free = free_words;
+ stats->heap_largest = blocks ? sizes[0] : 0;
+ stats->heap_blocks = blocks;
+ stats->heap_fragmentation = free_words
+                             ? 100 - ( 100 * stats->heap_largest ) / free_words
+                             : 0;
+}
+
+/*****************************************************************************/
+/* End of memuse.c                                                           */
+/*****************************************************************************/
@@ -0,0 +1,331 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 mls.c                                                                   */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Maximum length sequence (MLS) generator and fast Hadamard transform     */
+/*   impulse response extraction.                                            */
+/*                                                                           */
+/*   The sequence comes from a Galois shift register of order N. Each        */
+/*   sample the bottom bit is the output and the register takes every        */
+/*   non-zero value once per period of L = 2^N - 1 samples.                  */
+/*                                                                           */
+/*   The impulse response is the circular cross-correlation of the           */
+/*   recording with the sequence. Because the output k samples later is a    */
+/*   linear function of the register, the correlation is a Walsh-Hadamard    */
+/*   transform of the recording placed at the register values:               */
+/*                                                                           */
+/*   work[state(n)] += y(n)         as each sample is recorded               */
+/*   W = Hadamard(work)             N passes of additions, no multiplies     */
+/*   h(k) = W[w(L - k)] - W[0]      w(j) maps the register to the output     */
+/*                                  j samples later                          */
+/*                                                                           */
+/*   The off-peak correlation of an MLS is -1 rather than 0, which leaves    */
+/*   every lag short by the sum of h(k) over the period. W[0] is the sum of  */
+/*   the recording, which is that same amount, so it is taken off.           */
+/*                                                                           */
+/*   Recording costs one addition per sample, so several periods can be      */
+/*   averaged while the sequence plays. The first period is discarded so     */
+/*   the system under test is in steady state.                               */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "tms320.h"
+#include "dsplib.h"
+#include "mls.h"
+
+/* Galois feedback masks for maximal length, orders 0 to 15 */
+
+static const ushort mls_taps[MLS_MAX_ORDER + 1] =
+{
+  0x0000, 0x0000, 0x0003, 0x0006, 0x000C, 0x0014, 0x0030, 0x0060,
+  0x00B8, 0x0110, 0x0240, 0x0500, 0x0829, 0x100D, 0x2015, 0x6000
+};
+
+/*****************************************************************************/
+/* mls_step()                                                                */
+/*****************************************************************************/
+
+static ushort mls_step(ushort state, ushort taps)
+{
+ if ( state & 1 )
+   {
+    return ( state >> 1 ) ^ taps;
+   }
+
+ return state >> 1;
+}
+
+/*****************************************************************************/
+/* mls_divide()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Divide by a positive divisor, rounded to the nearest.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+static long mls_divide(long value, long divisor)
+{
+ if ( value < 0 )
+   {
+    return -( ( divisor / 2 - value ) / divisor );
+   }
+
+ return ( value + divisor / 2 ) / divisor;
+}
+
+/*****************************************************************************/
+/* mls_init()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: Order 2 to 15.                                                    */
+/*         Peak value 0 to 32767.                                            */
+/*         Work buffer of 2^order longs for mls_record(). NULL if the        */
+/*         sequence is only to be generated.                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+void mls_init(MLS *mls, ushort order, signed int amplitude, long *work)
+{
+ ushort i;
+
+ if ( order < MLS_MIN_ORDER )
+   {
+    order = MLS_MIN_ORDER;
+   }
+ else if ( order > MLS_MAX_ORDER )
+   {
+    order = MLS_MAX_ORDER;
+   }
+
+ mls->order = order;
+ mls->length = ( 1u << order ) - 1;
+ mls->taps = mls_taps[order];
+ mls->generate_state = 1;
+ mls->record_state = 1;
+ mls->recorded = 0;
+ mls->skip = mls->length;
+ mls->limit = ( 65535ul / mls->length ) * mls->length;
+ mls->amplitude = ( amplitude < 0 ) ? 0 : amplitude;
+ mls->work = work;
+
+ if ( work )
+   {
+    for ( i = 0 ; i <= mls->length ; i++)
+      {
+       work[i] = 0;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* mls_generate()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Next nx samples of the sequence. 0 gives +amplitude, 1 gives -amplitude.  */
+/*                                                                           */
+/*****************************************************************************/
+
+void mls_generate(MLS *mls, DATA *output, ushort nx)
+{
+ ushort n;
+ ushort state = mls->generate_state;
+ ushort taps = mls->taps;
+ DATA amplitude = (DATA) mls->amplitude;
+
+ for ( n = 0 ; n < nx ; n++)
+   {
+    output[n] = ( state & 1 ) ? -amplitude : amplitude;
+    state = mls_step(state, taps);
+   }
+
+ mls->generate_state = state;
+}
+
+/*****************************************************************************/
+/* mls_set_periods()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: Periods to average, after the one discarded. Samples recorded     */
+/*         after these are ignored, so a recording made in blocks that do    */
+/*         not divide the period still holds only whole periods. Without     */
+/*         this call recording goes on until the transform could overflow.   */
+/*                                                                           */
+/*****************************************************************************/
+
+void mls_set_periods(MLS *mls, ushort periods)
+{
+ unsigned long limit = (unsigned long) periods * mls->length;
+
+ if ( limit < mls->limit )
+   {
+    mls->limit = limit;
+   }
+}
+
+/*****************************************************************************/
+/* mls_record()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: nx samples of the response, in step with mls_generate().          */
+/*                                                                           */
+/* Periods are added together until the limit set by mls_set_periods(), or   */
+/* until the transform could overflow 32 bits, which is about 65536          */
+/* samples. Later samples are ignored.                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+void mls_record(MLS *mls, const DATA *input, ushort nx)
+{
+ ushort n;
+ ushort state = mls->record_state;
+ ushort taps = mls->taps;
+ long *work = mls->work;
+ unsigned long limit = mls->limit;
+
+ for ( n = 0 ; n < nx ; n++)
+   {
+    if ( mls->skip )
+      {
+       mls->skip--;
+      }
+    else if ( mls->recorded < limit )
+      {
+       work[state] += input[n];
+       mls->recorded++;
+      }
+
+    state = mls_step(state, taps);
+   }
+
+ mls->record_state = state;
+}
+
+/*****************************************************************************/
+/* mls_periods()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Number of whole periods recorded so far.                         */
+/*                                                                           */
+/*****************************************************************************/
+
+ushort mls_periods(MLS *mls)
+{
+ return (ushort) ( mls->recorded / mls->length );
+}
+
+/*****************************************************************************/
+/* mls_extract()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  Buffer for nx samples of impulse response, nx up to 2^order - 1. */
+/* OUTPUTS: Impulse response in Q15 where 32767 is unity gain.               */
+/*                                                                           */
+/* The recording is averaged over whole periods, so call after at least one  */
+/* period has been recorded. work[] is transformed in place.                 */
+/*                                                                           */
+/*****************************************************************************/
+
+void mls_extract(MLS *mls, DATA *impulse_response, ushort nx)
+{
+ ushort i;
+ ushort j;
+ ushort k;
+ ushort half;
+ ushort size = mls->length + 1;
+ ushort state[MLS_MAX_ORDER];
+ ushort output_map;
+ ushort periods = mls_periods(mls);
+ long *work = mls->work;
+ long a;
+ long b;
+ long divisor;
+ long offset;
+ long value;
+
+ for ( k = 0 ; k < nx ; k++)
+   {
+    impulse_response[k] = 0;
+   }
+
+ if ( 0 == periods || 0 == mls->amplitude )
+   {
+    return;
+   }
+
+ if ( nx > mls->length )
+   {
+    nx = mls->length;
+   }
+
+ /* Fast Walsh-Hadamard transform. Register value 0 never occurs */
+
+ work[0] = 0;
+
+ for ( half = 1 ; half < size ; half <<= 1)
+   {
+    for ( i = 0 ; i < size ; i += half << 1)
+      {
+       for ( j = i ; j < i + half ; j++)
+         {
+          a = work[j];
+          b = work[j + half];
+          work[j] = a + b;
+          work[j + half] = a - b;
+         }
+      }
+   }
+
+ /* Bit i of w(j) is the output j samples after starting from 1 << i.  */
+ /* Run one register per bit and pick out the lags that are wanted.    */
+
+ for ( i = 0 ; i < mls->order ; i++)
+   {
+    state[i] = 1u << i;
+   }
+
+ divisor = (long) size * periods;
+ offset = mls_divide(work[0], divisor);
+
+ for ( j = 0 ; j < mls->length ; j++)
+   {
+    k = ( 0 == j ) ? 0 : mls->length - j;
+
+    if ( k < nx )
+      {
+       output_map = 0;
+
+       for ( i = 0 ; i < mls->order ; i++)
+         {
+          output_map |= ( state[i] & 1 ) << i;
+         }
+
+       /* Mean over the periods is amplitude * h(k). Scale to Q15 */
+
+       value = mls_divide(work[output_map], divisor) - offset;
+       value = mls_divide(value << 15, mls->amplitude);
+
+       if ( value > 32767 )
+         {
+          value = 32767;
+         }
+       else if ( value < -32767 )
+         {
+          value = -32767;
+         }
+
+       impulse_response[k] = (DATA) value;
+      }
+
+    for ( i = 0 ; i < mls->order ; i++)
+      {
+       state[i] = mls_step(state[i], mls->taps);
+      }
+   }
+}
+
+/*****************************************************************************/
+/* End of mls.c                                                              */
+/*****************************************************************************/
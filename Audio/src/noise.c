@@ -0,0 +1,152 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 noise.c                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Block white and pink noise generators.                                  */
+/*                                                                           */
+/*   White noise is a block from rand16() in 55xdsph.lib, scaled to the      */
+/*   required amplitude.                                                     */
+/*                                                                           */
+/*   Pink noise uses the Voss-McCartney algorithm. Row r of NOISE_PINK_ROWS  */
+/*   is given a new random value every 2^(r+1) samples, chosen by the number */
+/*   of trailing zeros in a counter, so only one row changes per sample. The */
+/*   sum of the rows plus one white source falls at 3 dB per octave from    */
+/*   fs / 2 down to fs / 2^(NOISE_PINK_ROWS + 1), which is about 0.7 Hz at   */
+/*   48000 Hz. The cost is two random numbers and a few additions per        */
+/*   sample, whatever the number of rows.                                    */
+/*                                                                           */
+/*   The output never exceeds the amplitude. The RMS level of pink noise is  */
+/*   about 17 dB below it.                                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "tms320.h"
+#include "dsplib.h"
+#include "noise.h"
+
+static DATA random_values[2 * NOISE_BLOCK_SIZE];
+
+/*****************************************************************************/
+/* noise_init()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Seed the random number generator. Call once before any noise.             */
+/*                                                                           */
+/*****************************************************************************/
+
+void noise_init(void)
+{
+ rand16init();
+}
+
+/*****************************************************************************/
+/* white_noise_generate()                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: Output buffer of nx samples.                                      */
+/*         Peak value 0 to 32767.                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+void white_noise_generate(DATA *output, ushort nx, signed int amplitude)
+{
+ ushort n;
+
+ rand16(output, nx);
+
+ if ( amplitude >= 32767 )
+   {
+    return;
+   }
+
+ for ( n = 0 ; n < nx ; n++)
+   {
+    output[n] = (DATA) ( ( (long) output[n] * amplitude ) >> 15 );
+   }
+}
+
+/*****************************************************************************/
+/* pink_noise_init()                                                         */
+/*****************************************************************************/
+
+void pink_noise_init(PINK_NOISE *pink, signed int amplitude)
+{
+ ushort i;
+
+ for ( i = 0 ; i < NOISE_PINK_ROWS ; i++)
+   {
+    pink->rows[i] = 0;
+   }
+
+ pink->sum = 0;
+ pink->counter = 0;
+ pink->amplitude = ( amplitude < 0 ) ? 0 : amplitude;
+}
+
+/*****************************************************************************/
+/* pink_noise_generate()                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS: Pink noise generator.                                             */
+/*         Output buffer of nx samples.                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+void pink_noise_generate(PINK_NOISE *pink, DATA *output, ushort nx)
+{
+ ushort n;
+ ushort done;
+ ushort block;
+ ushort row;
+ unsigned int counter;
+ DATA value;
+ long sum;
+
+ for ( done = 0 ; done < nx ; done += block)
+   {
+    block = nx - done;
+
+    if ( block > NOISE_BLOCK_SIZE )
+      {
+       block = NOISE_BLOCK_SIZE;
+      }
+
+    /* One random number for the row and one for the white source */
+
+    rand16(random_values, 2 * block);
+
+    for ( n = 0 ; n < block ; n++)
+      {
+       counter = ++pink->counter;
+
+       if ( 0 != counter )
+         {
+          row = 0;
+
+          while ( 0 == ( counter & 1 ) )
+            {
+             counter >>= 1;
+             row++;
+            }
+
+          if ( row < NOISE_PINK_ROWS )
+            {
+             value = random_values[2 * n] >> NOISE_PINK_SHIFT;
+             pink->sum += value - pink->rows[row];
+             pink->rows[row] = value;
+            }
+         }
+
+       sum = pink->sum + ( random_values[2 * n + 1] >> NOISE_PINK_SHIFT );
+
+       output[done + n] = (DATA) ( ( sum * pink->amplitude ) >> 15 );
+      }
+   }
+}
+
+/*****************************************************************************/
+/* End of noise.c                                                            */
+/*****************************************************************************/
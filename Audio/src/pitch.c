@@ -0,0 +1,374 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pitch.c                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Autocorrelation based pitch (fundamental frequency) tracker.            */
+/*                                                                           */
+/*   The mono input is decimated from 48000 Hz to 2000 Hz by a moving        */
+/*   average. Every 10 ms the last 32 ms are normalised using bexp() and     */
+/*   the autocorrelation is found using acorr_bias() or acorr_unbias() from  */
+/*   55xdsph.lib. The first strong peak gives the period, refined by         */
+/*   parabolic interpolation, and its height relative to lag 0 gives the     */
+/*   confidence.                                                             */
+/*                                                                           */
+/*   Window and lag range are fixed at compile time so every estimate costs  */
+/*   the same number of cycles: about 1600 multiply-accumulates in acorr,    */
+/*   more than the audio loop can spare in one sample period at 48000 Hz     */
+/*   with the CPU at 100 MHz. pitch_process() therefore only decimates, and  */
+/*   at the end of each hop asks for an estimate. pitch_task(), run by       */
+/*   sched_run() once a millisecond, then does one stage per run: copy the   */
+/*   window, normalise it, correlate, and pick the peak. The estimate is     */
+/*   ready 4 ms after the hop, and the longest stage is the acorr call. The  */
+/*   cycles of each stage show in sched_tasks[] worst_us, and a stage over   */
+/*   SCHED_BUDGET_US is logged. tools/pitch_check.c runs this file on a PC.  */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "hotpath.h"
+
+/* Ahead of pitch.h, see hotpath.h */
+
+#if (HOT_SECTIONS)
+#pragma DATA_SECTION(history, ".delay")
+#pragma CODE_SECTION(pitch_process, ".text:hot")
+#endif
+
+#include "tms320.h"
+#include "dsplib.h"
+#include "pitch.h"
+
+#define PITCH_LAGS              (PITCH_MAX_LAG + 2) /* Room for interpolation */
+#define PITCH_DECIMATION_SHIFT  5       /* Sum of 24 samples divided by 32  */
+#define PITCH_SILENCE_EXPONENT  10      /* Below about -60 dBFS is silence  */
+#define PITCH_VOICED_THRESHOLD  16384   /* 0.5 in Q15                       */
+#define PITCH_PEAK_FRACTION     22938   /* 0.7 in Q15                       */
+
+volatile PITCH_Estimate pitch_estimate;
+
+static Uint16 acorr_mode = PITCH_UNBIASED;
+
+static DATA history[PITCH_WINDOW];          /* Circular buffer at 2000 Hz   */
+static DATA frame[PITCH_WINDOW];            /* Normalised copy for acorr    */
+static DATA r[PITCH_LAGS];                  /* Autocorrelation              */
+
+static Uint16 write_index = 0;
+static Uint16 hop_count = 0;
+static Uint16 phase = 0;
+static long sum = 0;
+static Uint16 stage = PITCH_IDLE;           /* Next stage for pitch_task()  */
+static Int16 exponent;
+
+/*****************************************************************************/
+/* pitch_init()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUT: PITCH_BIASED or PITCH_UNBIASED autocorrelation.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+void pitch_init(Uint16 mode)
+{
+ Uint16 i;
+
+ acorr_mode = mode;
+
+ for ( i = 0 ; i < PITCH_WINDOW ; i++)
+   {
+    history[i] = 0;
+   }
+
+ write_index = 0;
+ hop_count = 0;
+ phase = 0;
+ sum = 0;
+ stage = PITCH_IDLE;
+
+ pitch_estimate.frequency = 0;
+ pitch_estimate.confidence = 0;
+ pitch_estimate.voiced = 0;
+ pitch_estimate.frame = 0;
+ pitch_estimate.late = 0;
+}
+
+/*****************************************************************************/
+/* pitch_unvoiced()                                                          */
+/*****************************************************************************/
+
+static void pitch_unvoiced(void)
+{
+ pitch_estimate.voiced = 0;
+ pitch_estimate.frequency = 0;
+ pitch_estimate.confidence = 0;
+}
+
+/*****************************************************************************/
+/* pitch_copy()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The last PITCH_WINDOW decimated samples, oldest first. pitch_process()    */
+/* does not run during it, so the window is whole.                           */
+/*                                                                           */
+/*****************************************************************************/
+
+static void pitch_copy(void)
+{
+ Uint16 i;
+ Uint16 j;
+
+ j = write_index;
+
+ for ( i = 0 ; i < PITCH_WINDOW ; i++)
+   {
+    frame[i] = history[j];
+
+    if ( ++j >= PITCH_WINDOW )
+      {
+       j = 0;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* pitch_normalise()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 0 if the window is silence, so there is nothing to correlate.    */
+/*                                                                           */
+/*****************************************************************************/
+
+static Int16 pitch_normalise(void)
+{
+ Uint16 i;
+
+ exponent = bexp(frame, PITCH_WINDOW);
+
+ if ( exponent > PITCH_SILENCE_EXPONENT )
+   {
+    pitch_unvoiced();
+    return 0;
+   }
+
+ for ( i = 0 ; i < PITCH_WINDOW ; i++)
+   {
+    frame[i] <<= exponent;
+   }
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* pitch_correlate()                                                         */
+/*****************************************************************************/
+
+static void pitch_correlate(void)
+{
+ if ( PITCH_BIASED == acorr_mode )
+   {
+    acorr_bias(frame, r, PITCH_WINDOW, PITCH_LAGS);
+   }
+ else
+   {
+    acorr_unbias(frame, r, PITCH_WINDOW, PITCH_LAGS);
+   }
+}
+
+/*****************************************************************************/
+/* pitch_pick()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The fundamental from the autocorrelation in r[].                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static void pitch_pick(void)
+{
+ Uint16 i;
+ Uint16 lag;
+ DATA peak;
+ DATA threshold;
+ long a, b, c;
+ long denominator;
+ long lag_q4;
+ long temp;
+
+ if ( r[0] <= 0 )
+   {
+    pitch_estimate.voiced = 0;
+    return;
+   }
+
+ /* Find the largest peak, then take the first peak close to it so that */
+ /* a multiple of the period is not chosen.                             */
+
+ peak = 0;
+
+ for ( i = PITCH_MIN_LAG ; i <= PITCH_MAX_LAG ; i++)
+   {
+    if ( r[i] > peak )
+      {
+       peak = r[i];
+      }
+   }
+
+ threshold = (DATA) ( ( (long) peak * PITCH_PEAK_FRACTION ) >> 15 );
+
+ lag = 0;
+
+ for ( i = PITCH_MIN_LAG ; i <= PITCH_MAX_LAG ; i++)
+   {
+    if ( r[i] >= threshold && r[i] >= r[i - 1] && r[i] >= r[i + 1] )
+      {
+       lag = i;
+       break;
+      }
+   }
+
+ if ( 0 == lag )
+   {
+    pitch_unvoiced();
+    return;
+   }
+
+ /* Confidence is r[lag] / r[0] in Q15 */
+
+ temp = ( (long) r[lag] << 15 ) / r[0];
+
+ if ( temp > 32767 )
+   {
+    temp = 32767;
+   }
+
+ pitch_estimate.confidence = (Int16) temp;
+
+ /* Parabolic interpolation of the peak. Offset in 1/16 of a lag */
+
+ a = r[lag - 1];
+ b = r[lag];
+ c = r[lag + 1];
+ denominator = a - 2 * b + c;
+
+ lag_q4 = (long) lag << 4;
+
+ if ( denominator < 0 )
+   {
+    temp = ( 8 * (a - c) ) / denominator;
+
+    if ( temp > 8 )
+      {
+       temp = 8;
+      }
+    else if ( temp < -8 )
+      {
+       temp = -8;
+      }
+
+    lag_q4 += temp;
+   }
+
+ /* Frequency in Q12.4 is 16 * fs / lag = 256 * fs / lag_q4 */
+
+ pitch_estimate.frequency = (Uint16) ( ( (long) PITCH_SAMPLE_RATE << 8 ) / lag_q4 );
+ pitch_estimate.voiced = ( pitch_estimate.confidence > PITCH_VOICED_THRESHOLD ) ? 1 : 0;
+}
+
+/*****************************************************************************/
+/* pitch_task()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* CALLED BY: sched_run(), once every millisecond.                           */
+/*                                                                           */
+/* One stage of the estimate pitch_process() asked for, if any. The frame    */
+/* count goes up once the estimate is in pitch_estimate.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+void pitch_task(void *context)
+{
+ switch ( stage )
+   {
+    case PITCH_COPY:
+       pitch_copy();
+       stage = PITCH_NORMALISE;
+       break;
+
+    case PITCH_NORMALISE:
+       if ( pitch_normalise() )
+         {
+          stage = PITCH_CORRELATE;
+         }
+       else
+         {
+          pitch_estimate.frame++;
+          stage = PITCH_IDLE;
+         }
+       break;
+
+    case PITCH_CORRELATE:
+       pitch_correlate();
+       stage = PITCH_PICK;
+       break;
+
+    case PITCH_PICK:
+       pitch_pick();
+       pitch_estimate.frame++;
+       stage = PITCH_IDLE;
+       break;
+
+    default:
+       break;
+   }
+}
+
+/*****************************************************************************/
+/* pitch_process()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* CALLED BY: main() loop once every 1/48000 second.                         */
+/* RETURNS:   1 when an estimate is asked of pitch_task(), every 10 ms.      */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 pitch_process(Int16 input)
+{
+ sum += input;
+
+ if ( ++phase < PITCH_DECIMATION )
+   {
+    return 0;
+   }
+
+ history[write_index] = (DATA) ( sum >> PITCH_DECIMATION_SHIFT );
+
+ if ( ++write_index >= PITCH_WINDOW )
+   {
+    write_index = 0;
+   }
+
+ phase = 0;
+ sum = 0;
+
+ if ( ++hop_count < PITCH_HOP )
+   {
+    return 0;
+   }
+
+ hop_count = 0;
+
+ /* The one before had 10 ms for its 4 runs of pitch_task() */
+
+ if ( PITCH_IDLE != stage )
+   {
+    pitch_estimate.late++;
+   }
+
+ stage = PITCH_COPY;
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* End of pitch.c                                                            */
+/*****************************************************************************/
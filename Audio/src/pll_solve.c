@@ -0,0 +1,161 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pll_solve.c                                                             */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Work out the PLL registers for any CPU clock instead of looking them    */
+/*   up in a table.                                                          */
+/*                                                                           */
+/*   The PLL multiplies the 32.768 kHz input by M + 4 in the VCO and the     */
+/*   output divider then divides by OD + 1:                                  */
+/*                                                                           */
+/*      clock = 32768 * ( M + 4 ) / ( OD + 1 )                               */
+/*                                                                           */
+/*   The reference divider is always bypassed. The phase detector needs      */
+/*   30 kHz to 170 kHz, and the smallest division, 4, would take the         */
+/*   32.768 kHz input well under that.                                       */
+/*                                                                           */
+/*   pll_solve() tries each output divider that keeps the VCO between        */
+/*   PLL_VCO_MIN_HZ and PLL_VCO_MAX_HZ, rounds the multiplier for it and     */
+/*   keeps the one closest to the clock asked for, the smallest divider on   */
+/*   a tie. Just above PLL_VCO_MIN_HZ the nearest multiplier may be out of   */
+/*   range for every divider, and the nearest one in range is taken.         */
+/*                                                                           */
+/*   Any multiple of PLL_AUDIO_HZ, and any such clock divided down, is 32768 */
+/*   times a whole number and so comes out exact.                            */
+/*                                                                           */
+/*   pll_clock_hz() decodes the registers the same way. getSysClk() uses it, */
+/*   and tools/pll_check.c checks one against the other on the PC.           */
+/*                                                                           */
+/*   Nothing here touches the hardware.                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "usbstk5505.h"
+#include "pll_solve.h"
+
+/*****************************************************************************/
+/* pll_clock_hz()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  CGCR1, CGCR2 and CGCR4. CGCR3 does not change the clock.         */
+/*                                                                           */
+/* RETURNS: The PLL output in Hz, rounded down.                              */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint32 pll_clock_hz(Uint16 cgcr1, Uint16 cgcr2, Uint16 cgcr4)
+{
+ Uint32 multiplier;
+ Uint32 divider = 1;
+
+ multiplier = (Uint32) ( cgcr1 & PLL_CGCR1_M_MASK ) + 4;
+
+ if ( 0 == ( cgcr2 & PLL_CGCR2_RDBYPASS ) )
+   {
+    divider = (Uint32) ( cgcr2 & PLL_CGCR2_RDRATIO_MASK ) + 4;
+   }
+
+ if ( cgcr4 & PLL_CGCR4_OUTDIVEN )
+   {
+    divider *= (Uint32) ( cgcr4 & PLL_CGCR4_ODRATIO_MASK ) + 1;
+   }
+
+ return ( PLL_CLOCKIN_HZ * multiplier ) / divider;
+}
+
+/*****************************************************************************/
+/* pll_solve()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  Clock wanted in Hz and where to put the registers for it.        */
+/*                                                                           */
+/* RETURNS: The clock the registers give, or 0 if hz cannot be reached with  */
+/*          the VCO in range. solution is left alone then.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint32 pll_solve(Uint32 hz, PLL_SOLUTION *solution)
+{
+ Uint32 divider;
+ Uint32 vco;
+ Uint32 multiplier;
+ Uint32 error;
+ Uint32 best_error = 0;
+ Uint32 best_divider = 0;
+ Uint32 best_multiplier = 0;
+
+ if ( 0 == hz || hz > PLL_VCO_MAX_HZ )
+   {
+    return 0;
+   }
+
+ for ( divider = 1 ; divider <= PLL_OUTDIV_MAX ; divider++ )
+   {
+    vco = hz * divider;
+
+    if ( vco > PLL_VCO_MAX_HZ + PLL_CLOCKIN_HZ )
+      {
+       break;
+      }
+
+    /* Nearest multiplier, or the next one in if that takes the VCO out */
+
+    multiplier = ( vco + PLL_CLOCKIN_HZ / 2 ) / PLL_CLOCKIN_HZ;
+
+    if ( multiplier * PLL_CLOCKIN_HZ > PLL_VCO_MAX_HZ )
+      {
+       multiplier--;
+      }
+    else if ( multiplier * PLL_CLOCKIN_HZ < PLL_VCO_MIN_HZ )
+      {
+       multiplier++;
+      }
+
+    if ( multiplier * PLL_CLOCKIN_HZ < PLL_VCO_MIN_HZ
+         || multiplier * PLL_CLOCKIN_HZ > PLL_VCO_MAX_HZ
+         || multiplier < 4 || multiplier > PLL_M_MAX + 4 )
+      {
+       continue;
+      }
+
+    /* The error is this over divider. Compare across dividers as fractions */
+
+    error = ( multiplier * PLL_CLOCKIN_HZ > vco )
+            ? multiplier * PLL_CLOCKIN_HZ - vco
+            : vco - multiplier * PLL_CLOCKIN_HZ;
+
+    if ( 0 == best_divider || error * best_divider < best_error * divider )
+      {
+       best_error = error;
+       best_divider = divider;
+       best_multiplier = multiplier;
+      }
+
+    if ( 0 == error )
+      {
+       break;
+      }
+   }
+
+ if ( 0 == best_divider )
+   {
+    return 0;
+   }
+
+ solution->cgcr1 = PLL_CGCR1_RSVD | (Uint16) ( best_multiplier - 4 );
+ solution->cgcr2 = PLL_CGCR2_RDBYPASS;
+ solution->cgcr3 = PLL_CGCR3_INIT;
+ solution->cgcr4 = ( best_divider > 1 )
+                   ? PLL_CGCR4_OUTDIVEN | (Uint16) ( best_divider - 1 ) : 0;
+ solution->hz = pll_clock_hz(solution->cgcr1, solution->cgcr2,
+                             solution->cgcr4);
+
+ return solution->hz;
+}
+
+/*****************************************************************************/
+/* End of pll_solve.c                                                        */
+/*****************************************************************************/
@@ -0,0 +1,196 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pool.c                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Pools of fixed size blocks, for frames, FFT buffers, log and command    */
+/*   buffers that are not needed for the whole run.                          */
+/*                                                                           */
+/*   malloc() searches its free list and splits and joins blocks, so how     */
+/*   long it takes and whether it succeeds depend on what went before. A     */
+/*   pool instead keeps its free blocks on a list threaded through the       */
+/*   blocks themselves: pool_alloc() takes the first and pool_free() puts    */
+/*   one back first, the same few instructions every time.                   */
+/*                                                                           */
+/*   Both may be called from the audio loop, a task or an interrupt. The     */
+/*   list is changed with interrupts off, for a few cycles.                  */
+/*                                                                           */
+/*   pool_free() only takes back the start of a block of that pool that is   */
+/*   in use, so a block freed twice cannot get on the list twice.            */
+/*                                                                           */
+/*   tools/pool_stress.c runs this file on a PC, with a signal as the        */
+/*   interrupt.                                                              */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stddef.h>
+#include "csl_intc.h"
+#include "usbstk5505.h"
+#include "pool.h"
+
+/*****************************************************************************/
+/* pool_init()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  memory must hold POOL_WORDS(block_words, blocks) and start on a  */
+/*          multiple of POOL_ALIGN_WORDS, and block_words be a multiple of   */
+/*          it.                                                              */
+/*                                                                           */
+/* RETURNS: POOL_OK, or POOL_BAD_SIZE and the pool is left empty.            */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 pool_init(POOL *pool, void *memory, Uint16 block_words, Uint16 blocks)
+{
+ void *block;
+ Uint16 n;
+
+ pool->memory = (Uint16 *) memory;
+ pool->block_words = block_words;
+ pool->blocks = 0;
+ pool->free = NULL;
+
+ for ( n = 0 ; n < POOL_MAX_BLOCKS / 16 ; n++ )
+   {
+    pool->in_use[n] = 0;
+   }
+
+ pool->stats.used = 0;
+ pool->stats.peak = 0;
+ pool->stats.allocs = 0;
+ pool->stats.failures = 0;
+ pool->stats.bad_frees = 0;
+
+ if ( NULL == memory || 0 == block_words || 0 == blocks
+      || blocks > POOL_MAX_BLOCKS || block_words % POOL_ALIGN_WORDS
+      || (size_t) memory % sizeof(void *) )
+   {
+    return POOL_BAD_SIZE;
+   }
+
+ /* Last block first, so the list is in address order */
+
+ for ( n = blocks ; n > 0 ; n-- )
+   {
+    block = pool->memory + POOL_WORDS(block_words, n - 1);
+    *(void **) block = pool->free;
+    pool->free = block;
+   }
+
+ pool->blocks = blocks;
+
+ return POOL_OK;
+}
+
+/*****************************************************************************/
+/* pool_alloc()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: A block of block_words, or NULL if all are in use.               */
+/*                                                                           */
+/*****************************************************************************/
+
+void *pool_alloc(POOL *pool)
+{
+ void *block;
+ Uint16 index;
+ Bool mask;
+
+ mask = IRQ_globalDisable();
+
+ block = pool->free;
+
+ if ( NULL == block )
+   {
+    pool->stats.failures++;
+    IRQ_globalRestore(mask);
+    return NULL;
+   }
+
+ pool->free = *(void **) block;
+
+ index = ( (Uint16 *) block - pool->memory ) / pool->block_words;
+ pool->in_use[index >> 4] |= 1U << ( index & 15 );
+
+ pool->stats.allocs++;
+
+ if ( ++pool->stats.used > pool->stats.peak )
+   {
+    pool->stats.peak = pool->stats.used;
+   }
+
+ IRQ_globalRestore(mask);
+
+ return block;
+}
+
+/*****************************************************************************/
+/* pool_free()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: POOL_OK, or POOL_BAD_BLOCK or POOL_NOT_IN_USE and nothing is     */
+/*          changed but stats.bad_frees.                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 pool_free(POOL *pool, void *block)
+{
+ Int16 status = POOL_BAD_BLOCK;
+ Uint32 offset;
+ Uint16 index = 0;
+ Uint16 bit;
+ Bool mask;
+
+ if ( (Uint16 *) block >= pool->memory )
+   {
+    offset = (Uint16 *) block - pool->memory;
+
+    if ( offset < POOL_WORDS(pool->block_words, pool->blocks)
+         && 0 == offset % pool->block_words )
+      {
+       index = offset / pool->block_words;
+       status = POOL_OK;
+      }
+   }
+
+ bit = 1U << ( index & 15 );
+
+ mask = IRQ_globalDisable();
+
+ if ( POOL_OK == status && 0 == ( pool->in_use[index >> 4] & bit ) )
+   {
+    status = POOL_NOT_IN_USE;
+   }
+
+ if ( POOL_OK == status )
+   {
+    pool->in_use[index >> 4] &= ~bit;
+
+    *(void **) block = pool->free;
+    pool->free = block;
+    pool->stats.used--;
+   }
+ else
+   {
+    pool->stats.bad_frees++;
+   }
+
+ IRQ_globalRestore(mask);
+
+ return status;
+}
+
+/*****************************************************************************/
+/* pool_available()                                                          */
+/*****************************************************************************/
+
+Uint16 pool_available(const POOL *pool)
+{
+ return pool->blocks - pool->stats.used;
+}
+
+/*****************************************************************************/
+/* End of pool.c                                                             */
+/*****************************************************************************/
@@ -0,0 +1,315 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 sched.c                                                                 */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Periodic and one-shot tasks released by the GPT0 tick.                  */
+/*                                                                           */
+/*   The audio loop in main() polls the codec, so anything that holds the    */
+/*   CPU for more than a sample period loses a sample. Work that is not      */
+/*   needed every sample is put in tasks instead:                            */
+/*                                                                           */
+/*   sched_tick() is called from the timer interrupt once per ms. It         */
+/*   releases the tasks that are due, and runs SCHED_PRIORITY_TICK tasks     */
+/*   there and then.                                                         */
+/*                                                                           */
+/*   sched_run() is called by the audio loop after each sample. It runs the  */
+/*   one ready task with the lowest priority number, oldest release first,   */
+/*   to completion. A task must therefore finish in SCHED_BUDGET_US and      */
+/*   split longer work over several releases.                                */
+/*                                                                           */
+/*   Each task counts a release while the previous one has not run yet as    */
+/*   an overrun, a finish more than its deadline after its release as a      */
+/*   miss, and a run longer than SCHED_BUDGET_US as over budget. The first   */
+/*   of each is logged; the counts are in sched_tasks[].                     */
+/*                                                                           */
+/*   tools/sched_sim.c runs this file on a PC against a simulated timer.     */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_intc.h"
+#include "usbstk5505.h"
+#include "delay.h"
+#include "log.h"
+#include "sched.h"
+
+SCHED_TASK sched_tasks[SCHED_TASKS];
+volatile Uint16 sched_now = 0;          /* Ticks since sched_init()         */
+
+/* Tick a is at or after tick b. Times less than 32768 ticks apart */
+
+#define AT_OR_AFTER(a, b)   ( (Int16) ( (a) - (b) ) >= 0 )
+
+/*****************************************************************************/
+/* sched_init()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Remove all tasks. Call before the timer is started.                       */
+/*                                                                           */
+/*****************************************************************************/
+
+void sched_init(void)
+{
+ Uint16 i;
+
+ for ( i = 0 ; i < SCHED_TASKS ; i++)
+   {
+    sched_tasks[i].armed = 0;
+    sched_tasks[i].ready = 0;
+   }
+
+ sched_now = 0;
+}
+
+/*****************************************************************************/
+/* add()                                                                     */
+/*****************************************************************************/
+
+static Int16 add(SCHED_Function function, void *context, Uint16 priority,
+                 Uint16 period, Uint16 delay, Uint16 deadline)
+{
+ SCHED_TASK *t;
+ Int16 i;
+ Bool mask;
+
+ mask = IRQ_globalDisable();
+
+ for ( i = 0 ; i < SCHED_TASKS ; i++)
+   {
+    if ( !sched_tasks[i].armed && !sched_tasks[i].ready )
+      {
+       break;
+      }
+   }
+
+ if ( i == SCHED_TASKS )
+   {
+    IRQ_globalRestore(mask);
+    return SCHED_FULL;
+   }
+
+ t = &sched_tasks[i];
+ t->function = function;
+ t->context = context;
+ t->priority = priority;
+ t->period = period;
+ t->deadline = deadline ? deadline : period;
+ t->release = sched_now + delay;
+ t->runs = 0;
+ t->overruns = 0;
+ t->misses = 0;
+ t->over_budget = 0;
+ t->worst_us = 0;
+ t->armed = 1;
+
+ IRQ_globalRestore(mask);
+
+ return i;
+}
+
+/*****************************************************************************/
+/* sched_periodic()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  Function and the context it is called with, priority, period in  */
+/*          ticks and deadline in ticks from each release. A deadline of 0   */
+/*          is the period. The first release is one period from now.         */
+/*                                                                           */
+/* RETURNS: Task number for sched_cancel(), or SCHED_FULL.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 sched_periodic(SCHED_Function function, void *context, Uint16 priority,
+                     Uint16 period, Uint16 deadline)
+{
+ if ( 0 == period )
+   {
+    period = 1;
+   }
+
+ return add(function, context, priority, period, period, deadline);
+}
+
+/*****************************************************************************/
+/* sched_one_shot()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  As sched_periodic(), but released once, delay ticks from now. A  */
+/*          deadline of 0 is none. The slot is free again after the run.     */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 sched_one_shot(SCHED_Function function, void *context, Uint16 priority,
+                     Uint16 delay, Uint16 deadline)
+{
+ return add(function, context, priority, 0, delay, deadline);
+}
+
+/*****************************************************************************/
+/* sched_cancel()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* A release that is ready is dropped. Does not wait for a run in progress.  */
+/*                                                                           */
+/*****************************************************************************/
+
+void sched_cancel(Int16 task)
+{
+ Bool mask;
+
+ if ( task < 0 || task >= SCHED_TASKS )
+   {
+    return;
+   }
+
+ mask = IRQ_globalDisable();
+ sched_tasks[task].armed = 0;
+ sched_tasks[task].ready = 0;
+ IRQ_globalRestore(mask);
+}
+
+/*****************************************************************************/
+/* sched_tick()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Called from the timer interrupt, SCHED_TICK_HZ times a second.            */
+/*                                                                           */
+/*****************************************************************************/
+
+void sched_tick(void)
+{
+ SCHED_TASK *t;
+ Uint16 now;
+ Uint16 i;
+
+ now = ++sched_now;
+
+ for ( i = 0 ; i < SCHED_TASKS ; i++)
+   {
+    t = &sched_tasks[i];
+
+    if ( !t->armed || !AT_OR_AFTER(now, t->release) )
+      {
+       continue;
+      }
+
+    if ( SCHED_PRIORITY_TICK == t->priority )
+      {
+       t->function(t->context);
+       t->runs++;
+      }
+    else if ( t->ready )
+      {
+       if ( 1 == ++t->overruns )
+         {
+          LOG2(LOG_SCHED_OVERRUN, i, t->period);
+         }
+      }
+    else
+      {
+       t->released_at = now;
+       t->ready = 1;
+      }
+
+    if ( t->period )
+      {
+       t->release += t->period;
+      }
+    else
+      {
+       t->armed = 0;                    /* Slot kept until the run is done */
+      }
+   }
+}
+
+/*****************************************************************************/
+/* sched_run()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Run the most urgent ready task, if any. Call from one place, outside      */
+/* interrupts.                                                               */
+/*                                                                           */
+/* RETURNS: The task that was run, or -1 if none was ready.                  */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 sched_run(void)
+{
+ SCHED_TASK *t;
+ SCHED_Function function;
+ void *context;
+ Uint16 released_at;
+ Uint16 late;
+ Uint32 start;
+ Uint32 us;
+ Int16 best = -1;
+ Int16 i;
+ Bool mask;
+
+ mask = IRQ_globalDisable();
+
+ for ( i = 0 ; i < SCHED_TASKS ; i++)
+   {
+    t = &sched_tasks[i];
+
+    if ( !t->ready )
+      {
+       continue;
+      }
+
+    if ( best < 0 || t->priority < sched_tasks[best].priority
+         || ( t->priority == sched_tasks[best].priority
+              && !AT_OR_AFTER(t->released_at,
+                              sched_tasks[best].released_at) ) )
+      {
+       best = i;
+      }
+   }
+
+ if ( best < 0 )
+   {
+    IRQ_globalRestore(mask);
+    return -1;
+   }
+
+ t = &sched_tasks[best];
+ function = t->function;
+ context = t->context;
+ released_at = t->released_at;
+ t->ready = 0;
+
+ IRQ_globalRestore(mask);
+
+ start = delay_now();
+ function(context);
+ us = delay_ticks_to_us(delay_now() - start);
+
+ /* Ticks from the release to the end of the run */
+
+ late = sched_now - released_at;
+
+ t->runs++;
+
+ if ( us > t->worst_us )
+   {
+    t->worst_us = us;
+   }
+
+ if ( us > SCHED_BUDGET_US && 1 == ++t->over_budget )
+   {
+    LOG3(LOG_SCHED_BUDGET, best, us, SCHED_BUDGET_US);
+   }
+
+ if ( t->deadline && late > t->deadline && 1 == ++t->misses )
+   {
+    LOG3(LOG_SCHED_DEADLINE, best, late, t->deadline);
+   }
+
+ return best;
+}
+
+/*****************************************************************************/
+/* End of sched.c                                                            */
+/*****************************************************************************/
@@ -6,10 +6,14 @@
 /* DESCRIPTION                                                               */
 /*   Sinewave generation for the TMS320VC5505 USB Stick.                     */
 /*                                                                           */
-/*   Generates two sinewaves of adjustable frequency using sine() function   */
+/*   Generates sinewaves of adjustable frequency using sine() function       */
 /*   in 55xdsph.lib                                                          */
 /*                                                                           */
-/*   The frequency of range of the sine wave is 10 Hz to 8000 Hz.            */
+/*   Each oscillator has a 32-bit phase accumulator, so the phase step has   */
+/*   a resolution of fs / 2^32 (0.00001 Hz at 48000 Hz) for any sampling     */
+/*   rate below 2^23 Hz. oscillator_set_frequency() takes whole Hz and       */
+/*   oscillator_set_frequency_q16() takes Hz in Q16, to 1/65536 Hz.          */
+/*   A block of phases is built first and sine() is called once per block.  */
 /*                                                                           */
 /* REVISION                                                                  */
 /*   Revision: 1.00                                                          */
@@ -22,6 +26,9 @@
 /*   20th December 2009. Created by Richard Sikora from TMS320C5510 code.    */
 /*   Revision 1.01                                                           */
 /*   16th June 2010. Sine wave generation added for 8000 Hz sampling.        */
+/*   Revision 1.02                                                           */
+/*   18th October 2026. Oscillator bank with 32-bit phase accumulators.      */
+/*   generate_sinewave_1/2/3 now use the oscillator bank.                    */
 /*                                                                           */
 /*****************************************************************************/
 /*
@@ -61,62 +68,218 @@
 
 #include "tms320.h"
 #include "dsplib.h"
+#include "sinewaves.h"
 
-#define SCALING_FACTOR_48000HZ 22368L
-#define SCALING_FACTOR_8000HZ 16776L
+#define SAMPLES_PER_SECOND_1  48000 /* Sampling rate of generate_sinewave_1 and 2 */
+#define SAMPLES_PER_SECOND_3  8000  /* Sampling rate of generate_sinewave_3       */
+
+static DATA angle[OSCILLATOR_BLOCK_SIZE]; /* Phases in Q15, 32767 = pi */
+static DATA sinusoid[OSCILLATOR_BLOCK_SIZE];
 
 /*****************************************************************************/
-/* generate_sinewave_1()                                                     */
+/* oscillator_set_frequency_q16()                                            */
 /*---------------------------------------------------------------------------*/
 /*                                                                           */
-/* Generate a sinewave. Based on sampling rate of 48000 Hz.                  */
+/* INPUT: Frequency in Hz in Q16, 440.5 Hz is 440.5 * 65536.                 */
 /*                                                                           */
-/*                                                                           */
-/* PARAMETER 1: The frequency of the sinewave between 10 Hz and 16000 Hz.    */ 
-/* PARAMETER 2: The maximum amplitude of the sinewave between 1 to 32767.    */
+/* Phase increment = frequency * 2^16 / sampling frequency. Calculated in    */
+/* two halves. The remainder is below fs, so shifted 16 bits it fits in the  */
+/* 40-bit long long for fs below 2^23 Hz.                                    */
 /*                                                                           */
 /*****************************************************************************/
 
-signed int generate_sinewave_1( signed short int frequency, 
-                                signed short int amplitude)
+void oscillator_set_frequency_q16(OSCILLATOR *oscillator,
+                                  unsigned long frequency)
 {
- short int sinusoid;
- signed long result;
- static short int count = 0;
- 
- /* Multiply frequency by scaling factor of 2* 32767 / 48000 */
- 
- result = ( frequency * SCALING_FACTOR_48000HZ ) >> 14 ;
- 
- if ( result > 32767)
+ unsigned long fs = oscillator->sampling_frequency;
+
+ /* Limit to Nyquist. Above 131070 Hz every Q16 frequency is below it */
+
+ if ( ( fs >> 1 ) <= 0xFFFFUL && frequency > ( fs >> 1 ) << 16 )
    {
-     result = 32767; /* Maximum value for highest frequency */
+    frequency = ( fs >> 1 ) << 16;
    }
- else if ( 0 == result)  
+
+ oscillator->increment = ( frequency / fs ) << 16;
+ oscillator->increment += (unsigned long)
+                          ( ( (long long) ( frequency % fs ) << 16 ) / fs );
+ oscillator->frequency = (unsigned int) ( frequency >> 16 );
+}
+
+/*****************************************************************************/
+/* oscillator_set_frequency()                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUT: Frequency in whole Hz.                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+void oscillator_set_frequency(OSCILLATOR *oscillator, unsigned int frequency)
+{
+ oscillator_set_frequency_q16(oscillator, (unsigned long) frequency << 16);
+}
+
+/*****************************************************************************/
+/* oscillator_init()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* PARAMETER 1: Oscillator.                                                  */
+/* PARAMETER 2: Sampling frequency in Hz.                                    */
+/* PARAMETER 3: Frequency in Hz between 0 and half the sampling frequency.  */
+/* PARAMETER 4: Maximum amplitude between 0 and 32767.                       */
+/* PARAMETER 5: Starting phase. 0 to 65535 represents 0 to 2 pi.             */
+/*                                                                           */
+/*****************************************************************************/
+
+void oscillator_init(OSCILLATOR *oscillator, unsigned long SamplingFrequency,
+                     unsigned int frequency, signed int amplitude,
+                     unsigned int phase)
+{
+ oscillator->sampling_frequency = SamplingFrequency;
+ oscillator->phase = (unsigned long) phase << 16;
+ oscillator_set_amplitude(oscillator, amplitude);
+ oscillator_set_frequency(oscillator, frequency);
+}
+
+/*****************************************************************************/
+/* oscillator_set_amplitude()                                                */
+/*****************************************************************************/
+
+void oscillator_set_amplitude(OSCILLATOR *oscillator, signed int amplitude)
+{
+ if ( amplitude < 0 )
    {
-     result = 1;     /* Minimum value for lowest fequency */
+    amplitude = 0;
    }
- else if ( result < -32767)
+
+ oscillator->amplitude = amplitude;
+}
+
+/*****************************************************************************/
+/* oscillator_generate()                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Generate nx samples of each oscillator in the bank and add them together. */
+/* If add is 0 the output is overwritten, otherwise the bank is added to     */
+/* what is already there. Output saturates at +/- 32767.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+void oscillator_generate(OSCILLATOR *bank, unsigned int oscillators,
+                         DATA *output, unsigned int nx, unsigned int add)
+{
+ unsigned int i;
+ unsigned int n;
+ unsigned int block;
+ unsigned int done;
+ unsigned long phase;
+ unsigned long increment;
+ long temp;
+ signed int amplitude;
+
+ for ( done = 0 ; done < nx ; done += block)
    {
-     result = -32767;
-   }  
- 
- count += (short int) result; 
- 
- /* Obtain sine of input */
+    block = nx - done;
+
+    if ( block > OSCILLATOR_BLOCK_SIZE )
+      {
+       block = OSCILLATOR_BLOCK_SIZE;
+      }
+
+    for ( i = 0 ; i < oscillators ; i++)
+      {
+       phase = bank[i].phase;
+       increment = bank[i].increment;
+       amplitude = bank[i].amplitude;
+
+       /* Top 16 bits of the accumulator are the angle for sine() */
 
- sine ( &count, &sinusoid, 1);
+       for ( n = 0 ; n < block ; n++)
+         {
+          angle[n] = (DATA) ( phase >> 16 );
+          phase += increment;
+         }
 
- if ( amplitude > 32767 )
+       bank[i].phase = phase;
+
+       sine(angle, sinusoid, block);
+
+       for ( n = 0 ; n < block ; n++)
+         {
+          temp = ( (long) sinusoid[n] * amplitude ) >> 15;
+
+          if ( 0 != i || 0 != add )
+            {
+             temp += output[done + n];
+            }
+
+          if ( temp > 32767 )
+            {
+             temp = 32767;
+            }
+          else if ( temp < -32767 )
+            {
+             temp = -32767;
+            }
+
+          output[done + n] = (DATA) temp;
+         }
+      }
+   }
+}
+
+/*****************************************************************************/
+/* generate_sinewave()                                                       */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* One sample from an oscillator whose frequency may change every sample.   */
+/* The phase increment is only recalculated when the frequency changes.     */
+/*                                                                           */
+/*****************************************************************************/
+
+static signed int generate_sinewave( OSCILLATOR *oscillator,
+                                     signed short int frequency,
+                                     signed short int amplitude)
+{
+ DATA output;
+
+ if ( frequency < 1 )
    {
-     amplitude = 32767; /* Range limit amplitude */
-   } 
+    frequency = 1;     /* Minimum value for lowest frequency */
+   }
+
+ if ( (unsigned int) frequency != oscillator->frequency )
+   {
+    oscillator_set_frequency(oscillator, (unsigned int) frequency);
+   }
 
- /* Scale sine wave to have maximum value set by amplitude */
+ oscillator->amplitude = ( amplitude < 0 ) ? 0 : amplitude;
+
+ oscillator_generate(oscillator, 1, &output, 1, 0);
+
+ return ( (signed int) output );
+}
+
+static OSCILLATOR sinewave_1 = { 0, 0, 0, 0, SAMPLES_PER_SECOND_1 };
+static OSCILLATOR sinewave_2 = { 0, 0, 0, 0, SAMPLES_PER_SECOND_1 };
+static OSCILLATOR sinewave_3 = { 0, 0, 0, 0, SAMPLES_PER_SECOND_3 };
+
+/*****************************************************************************/
+/* generate_sinewave_1()                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Generate a sinewave. Based on sampling rate of 48000 Hz.                  */
+/*                                                                           */
+/*                                                                           */
+/* PARAMETER 1: The frequency of the sinewave between 10 Hz and 16000 Hz.    */ 
+/* PARAMETER 2: The maximum amplitude of the sinewave between 1 to 32767.    */
+/*                                                                           */
+/*****************************************************************************/
 
- result =  ( (long) sinusoid * amplitude ) >> 15;
- 
- return ( (signed int ) result );
+signed int generate_sinewave_1( signed short int frequency, 
+                                signed short int amplitude)
+{
+ return generate_sinewave(&sinewave_1, frequency, amplitude);
 }
 
 /*****************************************************************************/
@@ -134,43 +297,7 @@ signed int generate_sinewave_1( signed short int frequency,
 signed int generate_sinewave_2( signed short int frequency, 
                                 signed short int amplitude)
 {
- short int sinusoid;
- signed long result;
- static short int count = 0;
- 
- /* Multiply frequency by scaling factor of ratio 2 * 32767 / 48000 */
- 
- result = ( frequency * SCALING_FACTOR_48000HZ ) >> 14 ;
- 
- if ( result > 32767)
-   {
-     result = 32767; /* Maximum value for highest frequency */
-   }
- else if ( 0 == result)  
-   {
-     result = 1;     /* Minimum value for lowest fequency */
-   }
- else if ( result < -32767)
-   {
-     result = -32767;
-   }  
- 
- count += (signed int) result; 
- 
- /* Obtain sine of input */
-
- sine ( &count, &sinusoid, 1);
-
- if ( amplitude > 32767 )
-   {
-     amplitude = 32767; /* Range limit amplitude */
-   } 
-
- /* Scale sine wave to have maximum value set by amplitude */
-
- result =  ( (long) sinusoid * amplitude ) >> 15;
- 
- return ( (signed int ) result );
+ return generate_sinewave(&sinewave_2, frequency, amplitude);
 }
 
 /*****************************************************************************/
@@ -188,46 +315,9 @@ signed int generate_sinewave_2( signed short int frequency,
 signed int generate_sinewave_3( signed short int frequency, 
                                 signed short int amplitude)
 {
- short int sinusoid;
- signed long result;
- static short int count = 0;
- 
- /* Multiply frequency by scaling factor of ratio 2* 32767 / 8000 */
- 
- result = ( (long) frequency * SCALING_FACTOR_8000HZ ) >> 11 ;
- 
- if ( result > 32767)
-   {
-     result = 32767; /* Maximum value for highest frequency */
-   }
- else if ( 0 == result)  
-   {
-     result = 1;     /* Minimum value for lowest fequency */
-   }
- else if ( result < -32767)
-   {
-     result = -32767;
-   }  
- 
- count += (signed int) result; 
- 
- /* Obtain sine of input */
-
- sine ( &count, &sinusoid, 1);
-
- if ( amplitude > 32767 )
-   {
-     amplitude = 32767; /* Range limit amplitude */
-   } 
-
- /* Scale sine wave to have maximum value set by amplitude */
-
- result =  ( (long) sinusoid * amplitude ) >> 15;
- 
- return ( (signed int ) result );
+ return generate_sinewave(&sinewave_3, frequency, amplitude);
 }
 
 /******************************************************************************/
 /* End of sinewaves.c                                                         */
 /******************************************************************************/
-
@@ -51,6 +51,11 @@
  *
 */
 
+#include "hotpath.h"
+
+#if (HOT_SECTIONS)
+#pragma CODE_SECTION(stereo_to_mono, ".text:hot")
+#endif
 
 /*****************************************************************************/
 /* stereo_to_mono()                                                          */
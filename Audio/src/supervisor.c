@@ -0,0 +1,241 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 supervisor.c                                                            */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Deadline supervisor for the audio loop, backed by the watchdog timer.   */
+/*                                                                           */
+/*   The codec has room for one sample each way. If the work for a sample    */
+/*   takes longer than the sample period the next one is late, and if that   */
+/*   goes on samples are repeated or lost without any sign. The audio loop   */
+/*   calls supervisor_frame_start() when a sample has arrived and            */
+/*   supervisor_frame_end() when it has finished with it, and each sample    */
+/*   that took longer than the period is counted as late.                    */
+/*                                                                           */
+/*   Overload is dealt with in steps. When a window of SUPERVISOR_WINDOW     */
+/*   samples has SUPERVISOR_SHED_LATE or more late, supervisor_stats.level   */
+/*   goes up one and main() skips the stages that level sheds. After         */
+/*   SUPERVISOR_CALM_WINDOWS windows with none late it comes down one.       */
+/*   The filters themselves are never shed.                                  */
+/*                                                                           */
+/*   The watchdog is serviced at the end of each window, from the audio      */
+/*   loop and not from an interrupt, so it resets the C5505 if the loop      */
+/*   stops for SUPERVISOR_WDT_MS even while the interrupts carry on.         */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_wdt.h"
+#include "usbstk5505.h"
+#include "timer.h"
+#include "delay.h"
+#include "log.h"
+#include "supervisor.h"
+
+/* Initialised, as .bss is not cleared under the -c ROM model and main()   */
+/* reads the level even when supervisor_init() is never called             */
+
+volatile SUPERVISOR_STATS supervisor_stats = { SUPERVISOR_FULL };
+
+static CSL_WdtObj wdt_obj;
+static CSL_WdtHandle wdt = 0;
+
+static Uint32 sample_rate;
+static Uint32 period_ticks;
+static Uint32 frame_from;
+static Uint32 worst_ticks;
+static Uint16 samples;
+static Uint16 late;                     /* In this window                   */
+static Uint16 calm_windows;
+
+/*****************************************************************************/
+/* configure_watchdog()                                                      */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The watchdog counts the system clock divided by SUPERVISOR_WDT_PRESCALE   */
+/* plus 1, so its count is worked out again when the clock changes.          */
+/*                                                                           */
+/*****************************************************************************/
+
+static void configure_watchdog(void)
+{
+ WDTIM_Config config;
+ Uint32 counts;
+
+ counts = ( getSysClk() * SUPERVISOR_WDT_MS )
+          / ( (Uint32) SUPERVISOR_WDT_PRESCALE + 1 );
+
+ config.counter = ( counts > 0xFFFF ) ? 0xFFFF : (Uint16) counts;
+ config.prescale = SUPERVISOR_WDT_PRESCALE;
+
+ WDTIM_config(wdt, &config);
+ WDTIM_service(wdt);
+}
+
+/*****************************************************************************/
+/* set_period()                                                              */
+/*****************************************************************************/
+
+static void set_period(void)
+{
+ period_ticks = ( delay_ticks_per_ms * 1000 ) / sample_rate;
+}
+
+/*****************************************************************************/
+/* end_window()                                                              */
+/*****************************************************************************/
+
+static void end_window(void)
+{
+ if ( late >= SUPERVISOR_SHED_LATE )
+   {
+    supervisor_stats.overloaded_windows++;
+    calm_windows = 0;
+
+    if ( supervisor_stats.level < SUPERVISOR_LEVELS - 1 )
+      {
+       supervisor_stats.level++;
+       supervisor_stats.sheds++;
+       LOG3(LOG_SUPERVISOR_SHED, late, SUPERVISOR_WINDOW,
+            supervisor_stats.level);
+      }
+   }
+ else if ( late > 0 )
+   {
+    calm_windows = 0;
+   }
+ else if ( supervisor_stats.level > SUPERVISOR_FULL
+           && ++calm_windows >= SUPERVISOR_CALM_WINDOWS )
+   {
+    calm_windows = 0;
+    supervisor_stats.level--;
+    LOG1(LOG_SUPERVISOR_RESTORE, supervisor_stats.level);
+   }
+
+ supervisor_stats.worst_us = delay_ticks_to_us(worst_ticks);
+
+ samples = 0;
+ late = 0;
+
+ if ( wdt )
+   {
+    WDTIM_service(wdt);
+   }
+}
+
+/*****************************************************************************/
+/* supervisor_init()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INPUTS:  Sampling frequency. Call just before the audio loop, after       */
+/*          delay_init(). From here on the loop must call                    */
+/*          supervisor_frame_end() at least every SUPERVISOR_WDT_MS.         */
+/*                                                                           */
+/*****************************************************************************/
+
+void supervisor_init(Uint32 rate)
+{
+ CSL_Status status;
+
+ sample_rate = rate;
+ set_period();
+
+ frame_from = delay_now();
+ worst_ticks = 0;
+ samples = 0;
+ late = 0;
+ calm_windows = 0;
+
+ supervisor_stats.level = SUPERVISOR_FULL;
+ supervisor_stats.late = 0;
+ supervisor_stats.overloaded_windows = 0;
+ supervisor_stats.sheds = 0;
+ supervisor_stats.worst_us = 0;
+
+ wdt = WDTIM_open(WDT_INST_0, &wdt_obj, &status);
+
+ if ( CSL_SOK != status )
+   {
+    wdt = 0;
+    return;
+   }
+
+ configure_watchdog();
+ WDTIM_start(wdt);
+}
+
+/*****************************************************************************/
+/* supervisor_set_clock()                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Call after the PLL has been changed and delay_set_clock() called.         */
+/*                                                                           */
+/*****************************************************************************/
+
+void supervisor_set_clock(void)
+{
+ if ( 0 == sample_rate )
+   {
+    return;
+   }
+
+ set_period();
+
+ if ( wdt )
+   {
+    configure_watchdog();
+   }
+}
+
+/*****************************************************************************/
+/* supervisor_frame_start() and supervisor_frame_end()                       */
+/*****************************************************************************/
+
+void supervisor_frame_start(void)
+{
+ frame_from = delay_now();
+}
+
+void supervisor_frame_end(void)
+{
+ Uint32 took = delay_now() - frame_from;
+
+ if ( took > period_ticks )
+   {
+    late++;
+    supervisor_stats.late++;
+   }
+
+ if ( took > worst_ticks )
+   {
+    worst_ticks = took;
+   }
+
+ if ( ++samples >= SUPERVISOR_WINDOW )
+   {
+    end_window();
+   }
+}
+
+/*****************************************************************************/
+/* supervisor_close()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Stop the watchdog before the slow shut down after the audio loop.         */
+/*                                                                           */
+/*****************************************************************************/
+
+void supervisor_close(void)
+{
+ if ( wdt )
+   {
+    WDTIM_stop(wdt);
+    WDTIM_close(wdt);
+    wdt = 0;
+   }
+}
+
+/*****************************************************************************/
+/* End of supervisor.c                                                       */
+/*****************************************************************************/
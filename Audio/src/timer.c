@@ -5,11 +5,16 @@
  *      Author: 78450
  */
 
-#include <stdio.h>
 #include "csl_gpt.h"
 #include "csl_intc.h"
 #include <csl_general.h>
 #include "timer.h"
+#include "i2c_queue.h"
+#include "log.h"
+#include "sched.h"
+#include "pll_solve.h"
+
+#define I2C_TICK_MS        (10)   /* Period of i2c_queue_tick() */
 
 CSL_Handle    hGpt;
 Uint32        sysClk;
@@ -19,6 +24,31 @@ unsigned long int i = 0;
 unsigned int Step = 0;
 unsigned int playnum = 0;
 
+/* Changed by command_task() */
+volatile unsigned int auto_switch = 1;
+volatile unsigned int switch_secs = SWITCH_SECS;
+volatile unsigned int change_limit = AUDIOBACK_COUNT;
+
+/* Once a second, in the timer interrupt */
+static void count_seconds(void *context)
+{
+    if(!auto_switch)
+        return;
+
+    i++;
+    if(i >= switch_secs)
+    {
+        i = 0;
+        Step = ++playnum % 2;
+    }
+}
+
+/* Time out an I2C transaction that has stopped */
+static void i2c_tick(void *context)
+{
+    i2c_queue_tick();
+}
+
 void CSL_gptIntrTest(void)
 {
     CSL_Status    status;
@@ -31,8 +61,8 @@ void CSL_gptIntrTest(void)
     /* Get the System clock value at which CPU is currently running */
     sysClk = getSysClk();
 
-    printf("\nCPU clock is running at %ldKHz\n", sysClk);
-    printf("Timer Prescaler Divide Value is Set to Divide by 4\n");
+    LOG1(LOG_CPU_CLOCK, sysClk);
+    LOG1(LOG_TIMER_PRESCALE, 4);
 
     /* Open the CSL GPT module */
     hGpt = GPT_open (GPT_0, &gptObj, &status);
@@ -46,11 +76,17 @@ void CSL_gptIntrTest(void)
     /* Disable all the interrupts */
     IRQ_disableAll();
 
+    /* Tasks released by the timer. More may be added once it is running */
+    sched_init();
+    sched_periodic(count_seconds, NULL, SCHED_PRIORITY_TICK, SCHED_TICK_HZ, 0);
+    sched_periodic(i2c_tick, NULL, SCHED_PRIORITY_TICK, I2C_TICK_MS, 0);
+
     IRQ_setVecs((Uint32)(&VECSTART));
     IRQ_plug(TINT_EVENT, &gpt0Isr);
     IRQ_enable(TINT_EVENT);
 
-    TIMPRD = sysClk*1000/4;
+    /* One tick of the scheduler */
+    TIMPRD = sysClk*1000/4/SCHED_TICK_HZ;
     hwConfig.autoLoad    = GPT_AUTO_ENABLE;
     hwConfig.ctrlTim     = GPT_TIMER_ENABLE;
     hwConfig.preScaleDiv = GPT_PRE_SC_DIV_1;
@@ -67,6 +103,36 @@ void CSL_gptIntrTest(void)
     GPT_start(hGpt);
 }
 
+/**
+ *  \brief  Keep the scheduler tick at SCHED_TICK_HZ after the PLL has
+ *          been changed
+ *
+ *  \param  none
+ *
+ *  \return none
+ */
+void timer_set_clock(void)
+{
+    CSL_Config    hwConfig;
+    Uint32        TIMPRD;
+
+    sysClk = getSysClk();
+
+    LOG1(LOG_CPU_CLOCK, sysClk);
+
+    /* The count restarts, so the tick in progress is a little long */
+    TIMPRD = sysClk*1000/4/SCHED_TICK_HZ;
+    hwConfig.autoLoad    = GPT_AUTO_ENABLE;
+    hwConfig.ctrlTim     = GPT_TIMER_ENABLE;
+    hwConfig.preScaleDiv = GPT_PRE_SC_DIV_1;
+    hwConfig.prdLow      = (TIMPRD)%65536;
+    hwConfig.prdHigh     = (TIMPRD)/65536;
+
+    GPT_stop(hGpt);
+    GPT_config(hGpt, &hwConfig);
+    GPT_start(hGpt);
+}
+
 /**
  *  \brief  GPT Interrupt Service Routine
  *
@@ -76,12 +142,8 @@ void CSL_gptIntrTest(void)
  */
 interrupt void gpt0Isr(void)
 {
-    i++;
-    if(i == SWITCH_SECS)
-    {
-        i = 0;
-        Step = ++playnum % 2;
-    }
+    /* Release the tasks that are due */
+    sched_tick();
     IRQ_clear(TINT_EVENT);
     /* Clear Timer Interrupt Aggregation Flag Register (TIAFR) */
     CSL_SYSCTRL_REGS->TIAFR = 0x01;
@@ -94,7 +156,23 @@ interrupt void gpt0Isr(void)
  *
  *  \return   System clock value in KHz
  */
-#if (defined(CHIP_C5505_C5515) || defined(CHIP_C5504_C5514) || defined(CHIP_C5535) || defined(CHIP_C5545))
+#if (defined(CHIP_C5505_C5515))
+
+/* M + 4, RD + 4 and OD + 1, as the PLL.c table and the C5505 data sheet    */
+/* have them. Decoded by pll_clock_hz(), which pll_solve() is checked with. */
+
+Uint32 getSysClk(void)
+{
+    Uint32    pllClk;
+
+    pllClk = pll_clock_hz(CSL_SYSCTRL_REGS->CGCR1, CSL_SYSCTRL_REGS->CGCR2,
+                          CSL_SYSCTRL_REGS->CGCR4);
+
+    /* Return the value of system clock in KHz */
+    return(pllClk/1000);
+}
+
+#elif (defined(CHIP_C5504_C5514) || defined(CHIP_C5535) || defined(CHIP_C5545))
 
 Uint32 getSysClk(void)
 {
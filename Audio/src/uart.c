@@ -0,0 +1,317 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 uart.c                                                                  */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   TMS320C5505 USB Stick.                                                  */
+/*   Interrupt driven UART with receive and transmit buffers in RAM.         */
+/*                                                                           */
+/*   The UART interrupt moves received bytes from the FIFO into a ring       */
+/*   buffer and refills the transmit FIFO, 16 bytes at a time, from another. */
+/*   uart_write() and uart_read() only copy to and from the buffers, so      */
+/*   neither ever waits for the line.                                        */
+/*                                                                           */
+/*   uart_write() takes all of the bytes or none, so that the binary log     */
+/*   frames and the command replies that share the line are never mixed.     */
+/*                                                                           */
+/*   Call uart_init() after CSL_gptIntrTest(), which disables all            */
+/*   interrupts, and uart_set_clock() after the PLL has been changed.        */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "csl_intc.h"
+#include "csl_uart.h"
+#include "usbstk5505.h"
+#include "timer.h"
+#include "uart.h"
+
+#define RX_MASK         ( UART_RX_BYTES - 1 )
+#define TX_MASK         ( UART_TX_BYTES - 1 )
+#define FIFO_BYTES      16
+
+/* Read only registers at the same addresses as THR and FCR */
+
+#define UART_RBR        ( CSL_UART_REGS->THR )
+#define UART_IIR        ( CSL_UART_REGS->FCR )
+
+volatile UART_STATS uart_stats;
+
+static CSL_UartObj uart_obj;
+static Uint8 rx_buffer[UART_RX_BYTES];
+static Uint8 tx_buffer[UART_TX_BYTES];
+static volatile Uint16 rx_head = 0;     /* Next byte to write               */
+static volatile Uint16 rx_tail = 0;     /* Next byte to read                */
+static volatile Uint16 tx_head = 0;
+static volatile Uint16 tx_tail = 0;
+static volatile Uint16 uart_open = 0;
+
+/*****************************************************************************/
+/* uart_init()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* UART_BAUD, 8 data bits, no parity, one stop bit, from the clock set by    */
+/* pll_frequency_setup().                                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+void uart_init(void)
+{
+ CSL_UartSetup setup;
+
+ /* Parallel port mode 1 puts the UART on the pins to the USB serial port */
+
+ SYS_EXBUSSEL = ( SYS_EXBUSSEL & ~0x7000 ) | 0x1000;
+
+ setup.clkInput = getSysClk() * 1000;
+ setup.baud = UART_BAUD;
+ setup.wordLength = CSL_UART_WORD8;
+ setup.stopBits = 0;
+ setup.parity = CSL_UART_DISABLE_PARITY;
+ setup.fifoControl = CSL_UART_FIFO_DMA1_ENABLE_TRIG04;
+ setup.loopBackEnable = CSL_UART_NO_LOOPBACK;
+ setup.afeEnable = CSL_UART_NO_AFE;
+ setup.rtsEnable = CSL_UART_NO_RTS;
+
+ if ( CSL_SOK != UART_init(&uart_obj, CSL_UART_INST_0, UART_INTERRUPT)
+      || CSL_SOK != UART_setup(&uart_obj, &setup) )
+   {
+    return;
+   }
+
+ rx_head = 0;
+ rx_tail = 0;
+ tx_head = 0;
+ tx_tail = 0;
+
+ uart_stats.rx_bytes = 0;
+ uart_stats.tx_bytes = 0;
+ uart_stats.rx_overflows = 0;
+ uart_stats.line_errors = 0;
+
+ /* Receive data, receive timeout and line status. Transmit when needed */
+
+ CSL_UART_REGS->IER = CSL_UART_IER_ERBI_MASK | CSL_UART_IER_ELSI_MASK;
+
+ IRQ_plug(UART_EVENT, &uart_isr);
+ IRQ_enable(UART_EVENT);
+
+ uart_open = 1;
+}
+
+/*****************************************************************************/
+/* uart_set_clock()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Keep UART_BAUD after the system clock has changed. The buffers and the    */
+/* interrupt are left as they are. A byte on the line while the clock        */
+/* changes is lost, so wait for uart_tx_idle() first.                        */
+/*                                                                           */
+/*****************************************************************************/
+
+void uart_set_clock(void)
+{
+ Uint32 divisor;
+ Bool mask;
+
+ if ( !uart_open )
+   {
+    return;
+   }
+
+ /* 16 clocks per bit, rounded to the nearest */
+
+ divisor = ( getSysClk() * 1000 + 8L * UART_BAUD ) / ( 16L * UART_BAUD );
+
+ mask = IRQ_globalDisable();
+ CSL_UART_REGS->DLL = divisor & 0xFF;
+ CSL_UART_REGS->DLH = ( divisor >> 8 ) & 0xFF;
+ IRQ_globalRestore(mask);
+}
+
+/*****************************************************************************/
+/* uart_write()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 0, or UART_FULL if there is not room for all of the bytes or     */
+/*          the UART is not open. Nothing is written then.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 uart_write(const Uint8 *data, Uint16 length)
+{
+ Uint16 i;
+ Bool mask;
+
+ if ( !uart_open || length > uart_tx_room() )
+   {
+    return UART_FULL;
+   }
+
+ /* Only the caller adds bytes, so the room can only grow from here */
+
+ for ( i = 0 ; i < length ; i++)
+   {
+    tx_buffer[( tx_head + i ) & TX_MASK] = data[i] & 0xFF;
+   }
+
+ mask = IRQ_globalDisable();
+ tx_head += length;
+ CSL_UART_REGS->IER |= CSL_UART_IER_ETBEI_MASK;
+ IRQ_globalRestore(mask);
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* uart_read()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Number of bytes copied to data, up to length.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint16 uart_read(Uint8 *data, Uint16 length)
+{
+ Uint16 count = 0;
+
+ while ( count < length && rx_tail != rx_head )
+   {
+    data[count++] = rx_buffer[rx_tail & RX_MASK];
+    rx_tail++;
+   }
+
+ return count;
+}
+
+/*****************************************************************************/
+/* uart_tx_room() and uart_tx_pending()                                      */
+/*****************************************************************************/
+
+Uint16 uart_tx_room(void)
+{
+ return UART_TX_BYTES - (Uint16) ( tx_head - tx_tail );
+}
+
+Uint16 uart_tx_pending(void)
+{
+ return (Uint16) ( tx_head - tx_tail );
+}
+
+/*****************************************************************************/
+/* uart_tx_idle()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 1 if the buffer, the FIFO and the shift register are all empty.  */
+/*                                                                           */
+/*****************************************************************************/
+
+Uint16 uart_tx_idle(void)
+{
+ if ( !uart_open )
+   {
+    return 1;
+   }
+
+ return ( 0 == uart_tx_pending()
+          && ( CSL_UART_REGS->LSR & CSL_UART_LSR_TEMT_MASK ) );
+}
+
+/*****************************************************************************/
+/* uart_close()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Wait until everything written has gone to the FIFO, then stop the         */
+/* interrupt.                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+void uart_close(void)
+{
+ if ( !uart_open )
+   {
+    return;
+   }
+
+ while ( uart_tx_pending() > 0 )
+   {
+   }
+
+ IRQ_disable(UART_EVENT);
+ CSL_UART_REGS->IER = 0;
+ uart_open = 0;
+}
+
+/*****************************************************************************/
+/* uart_isr()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Handles every pending source before returning.                            */
+/*                                                                           */
+/*****************************************************************************/
+
+interrupt void uart_isr(void)
+{
+ Uint16 iir;
+ Uint16 lsr;
+ Uint16 room;
+
+ while ( !( ( iir = UART_IIR ) & CSL_UART_IIR_IPEND_MASK ) )
+   {
+    switch ( ( iir & CSL_UART_IIR_INTID_MASK ) >> CSL_UART_IIR_INTID_SHIFT )
+      {
+       case CSL_UART_IIR_INTID_RLS:
+       case CSL_UART_IIR_INTID_RDA:
+       case CSL_UART_IIR_INTID_CTI:
+
+        /* Reading LSR clears a line status interrupt */
+
+        while ( ( lsr = CSL_UART_REGS->LSR ) & CSL_UART_LSR_DR_MASK )
+          {
+           if ( lsr & ( CSL_UART_LSR_OE_MASK | CSL_UART_LSR_PE_MASK
+                        | CSL_UART_LSR_FE_MASK | CSL_UART_LSR_BI_MASK ) )
+             {
+              uart_stats.line_errors++;
+             }
+
+           if ( (Uint16) ( rx_head - rx_tail ) < UART_RX_BYTES )
+             {
+              rx_buffer[rx_head & RX_MASK] = UART_RBR & 0xFF;
+              rx_head++;
+              uart_stats.rx_bytes++;
+             }
+           else
+             {
+              (void) UART_RBR;
+              uart_stats.rx_overflows++;
+             }
+          }
+        break;
+
+       case CSL_UART_IIR_INTID_THRE:
+
+        /* The FIFO is empty */
+
+        for ( room = FIFO_BYTES ; room > 0 && tx_tail != tx_head ; room--)
+          {
+           CSL_UART_REGS->THR = tx_buffer[tx_tail & TX_MASK];
+           tx_tail++;
+           uart_stats.tx_bytes++;
+          }
+
+        if ( tx_tail == tx_head )
+          {
+           CSL_UART_REGS->IER &= ~CSL_UART_IER_ETBEI_MASK;
+          }
+        break;
+
+       default:
+        (void) CSL_UART_REGS->LSR;
+        break;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* End of uart.c                                                             */
+/*****************************************************************************/
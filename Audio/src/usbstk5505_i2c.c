@@ -52,8 +52,9 @@
  *
  */
 #include "usbstk5505_i2c.h"
+#include "delay.h"
 
-static Int32 i2c_timeout = 0x7fff;
+#define I2C_TIMEOUT_US  1000            // Per byte. A byte takes about 100 us
 
 /* ------------------------------------------------------------------------ *
  *                                                                          *
@@ -98,6 +99,36 @@ Int16 USBSTK5505_I2C_reset( )
     return 0;
 }
 
+/* ------------------------------------------------------------------------ *
+ *                                                                          *
+ *  _I2C_waitStop( )                                                        *
+ *                                                                          *
+ *      Wait for the STOP to go out. The module clears STP once it has      *
+ *      been sent, so the next START can follow at once instead of after   *
+ *      a fixed delay.                                                      *
+ *                                                                          *
+ *      Returns:    0: PASS                                                 *
+ *                 -1: FAIL Timeout                                         *
+ *                                                                          *
+ * ------------------------------------------------------------------------ */
+Int16 USBSTK5505_I2C_waitStop( )
+{
+    DELAY_TIMEOUT timeout;
+
+    delay_timeout_start( &timeout, I2C_TIMEOUT_US );
+
+    while ( I2C_MDR & MDR_STP )
+    {
+        if ( delay_timeout_expired( &timeout ) )
+        {
+            USBSTK5505_I2C_reset( );
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 /* ------------------------------------------------------------------------ *
  *                                                                          *
  *  _I2C_write( i2c_addr, data, len )                                       *
@@ -111,7 +142,8 @@ Int16 USBSTK5505_I2C_reset( )
  * ------------------------------------------------------------------------ */
 Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len )
 {
-    Int32 timeout, i;
+    DELAY_TIMEOUT timeout;
+    Uint16 i;
 
 		//I2C_IER = 0x0000;
         I2C_CNT = len;                    // Set length
@@ -122,16 +154,16 @@ Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len )
                   | MDR_IRS
                   | MDR_FREE;
 
-        USBSTK5505_wait(10);              // Short delay
+        delay_us( 1 );                    // Short delay
 
         for ( i = 0 ; i < len ; i++ )
         {
             I2C_DXR = data[i];            // Write
 
-            timeout = i2c_timeout;
+            delay_timeout_start( &timeout, I2C_TIMEOUT_US );
             do
             {
-                if ( timeout-- < 0  )
+                if ( delay_timeout_expired( &timeout ) )
                 {
                     USBSTK5505_I2C_reset( );
                     return -1;
@@ -141,10 +173,7 @@ Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len )
 
         I2C_MDR |= MDR_STP;             // Generate STOP
 
-		USBSTK5505_waitusec(100);
-
-        return 0;
-
+        return USBSTK5505_I2C_waitStop( );
 }
 
 /* ------------------------------------------------------------------------ *
@@ -163,7 +192,8 @@ Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len )
  * ------------------------------------------------------------------------ */
 Int16 USBSTK5505_I2C_read( Uint16 i2c_addr, Uint8* data, Uint16 len )
 {
-    Int32 timeout, i;
+    DELAY_TIMEOUT timeout;
+    Uint16 i;
 
     I2C_CNT = len;                    // Set length
     I2C_SAR = i2c_addr;               // Set I2C slave address
@@ -172,16 +202,14 @@ Int16 USBSTK5505_I2C_read( Uint16 i2c_addr, Uint8* data, Uint16 len )
               | MDR_IRS
               | MDR_FREE;
 
-    USBSTK5505_wait( 10 );            // Short delay
-
     for ( i = 0 ; i < len ; i++ )
     {
-        timeout = i2c_timeout;
+        delay_timeout_start( &timeout, I2C_TIMEOUT_US );
 
         //Wait for Rx Ready 
         do
         {
-            if ( timeout-- < 0 )
+            if ( delay_timeout_expired( &timeout ) )
             {
                 USBSTK5505_I2C_reset( );
                 return -1;
@@ -193,8 +221,7 @@ Int16 USBSTK5505_I2C_read( Uint16 i2c_addr, Uint8* data, Uint16 len )
 
     I2C_MDR |= MDR_STP;               // Generate STOP
 
-	USBSTK5505_waitusec(10);
-    return 0;
+    return USBSTK5505_I2C_waitStop( );
 }
 
 /* ------------------------------------------------------------------------ *
@@ -0,0 +1,703 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 aic3204_i2c_log.c                                                       */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick AIC3204 driver.              */
+/*                                                                           */
+/*   Runs aic3204.c and aic3204_init.c on a PC against a stand-in I2C bus    */
+/*   that records every transaction and models the AIC3204 registers,       */
+/*   including the page register and address auto-increment. It then        */
+/*   reports the number of transactions, bytes and the time spent on the     */
+/*   bus and in delays.                                                      */
+/*                                                                           */
+/*   The time model follows usbstk5505_i2c.c: 1 us after the START of a     */
+/*   write, then 9 bit times per byte plus START and STOP. The driver waits  */
+/*   for the STOP and no longer. Calls to delay_us() are added as they are.  */
+/*   I2C_BIT_US is for the 95 kHz clock given by PSC = 20, CLKL = CLKH = 20  */
+/*   with the CPU at 100 MHz.                                                */
+/*                                                                           */
+/*   Build twice from the Audio directory to compare:                        */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o i2c_log tools/aic3204_i2c_log.c               */
+/*       src/aic3204.c src/aic3204_init.c src/aic3204_biquad.c               */
+/*       src/IIR_low_pass_filters.c -lm                                      */
+/*   gcc -DAIC3204_SHADOW=0 -Itools/host -Iinc -o i2c_log_direct ...         */
+/*                                                                           */
+/*   i2c_log        Summary.                                                 */
+/*   i2c_log -v     Every transaction as it is sent.                         */
+/*   i2c_log -r     Final page 0 and page 1 register contents, so that the   */
+/*                  two builds can be checked for the same codec state.      */
+/*   i2c_log -s     Switch through all seven sampling frequencies and check  */
+/*                  that each switch leaves the codec in the same state as   */
+/*                  a full reset and configuration at that frequency.        */
+/*   i2c_log -f     Start up as main() does with BOOT_FAST, without          */
+/*                  aic3204_init().                                          */
+/*   i2c_log -b     Load DAC biquads, waiting and queued, and check both     */
+/*                  coefficient buffers, the response they give and that     */
+/*                  the buffer in use was never written. Add                 */
+/*                  src/aic3204_biquad.c to the build.                       */
+/*                                                                           */
+/*   The model swaps the adaptive filter buffers as soon as asked and, like  */
+/*   the codec, ignores writes to the buffer the running DAC is using.       */
+/*   Queued writes are sent at once.                                         */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "usbstk5505.h"
+#include "aic3204.h"
+#include "aic3204_biquad.h"
+#include "delay.h"
+#include "log.h"
+#include "IIR_low_pass_filters.h"
+#include "usbstk5505_gpio.h"
+#include "usbstk5505_i2c.h"
+
+#define I2C_BIT_US      10.5
+
+volatile Uint16 host_ioport[0x10000];
+
+static int verbose = 0;
+static double time_us = 0.0;
+static double bus_us = 0.0;
+static double delay_total_us = 0.0;
+static unsigned long reads = 0;
+static unsigned long ignored = 0;   /* Writes to the coefficients in use    */
+static int queue_now = 0;           /* Send queued writes instead of refusing */
+
+static Uint8 codec[256][128];       /* Page, register                       */
+static Uint16 codec_page = 0;
+static Uint16 codec_pointer = 0;
+
+/*****************************************************************************/
+/* Stand-ins for the board support library                                   */
+/*****************************************************************************/
+
+void delay_us( Uint32 us )
+{
+ time_us += us;
+ delay_total_us += us;
+}
+
+/* Timeouts are in microseconds of modelled time. Each call that finds   */
+/* the time not yet up spins for 1 us.                                     */
+
+void delay_timeout_start( DELAY_TIMEOUT *timeout, Uint32 us )
+{
+ timeout->start = (Uint32) time_us;
+ timeout->ticks = us;
+}
+
+Int16 delay_timeout_expired( DELAY_TIMEOUT *timeout )
+{
+ if ( time_us - timeout->start >= timeout->ticks )
+   {
+    return 1;
+   }
+
+ time_us += 1;
+ delay_total_us += 1;
+ return 0;
+}
+
+Int16 USBSTK5505_GPIO_init( ) { return 0; }
+Int16 USBSTK5505_GPIO_setDirection( Uint16 number, Uint16 direction ) { return 0; }
+Int16 USBSTK5505_GPIO_setOutput( Uint16 number, Uint16 output ) { return 0; }
+Int16 USBSTK5505_I2C_init( ) { return 0; }
+
+/* set_sampling_frequency_and_gain() logs the rate it set */
+
+void log_write( Uint16 id, long a, long b, long c )
+{
+ if ( verbose )
+   {
+    printf("    log %2u: %ld %ld %ld\n", id, a, b, c);
+   }
+}
+
+/* Writes are not queued here, so the queue is always empty. With         */
+/* queue_now they are sent at once and completed.                          */
+
+Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len );
+
+Int16 i2c_queue_write(Uint16 address, const Uint8 *data, Uint16 length,
+                      I2C_Callback callback, void *context)
+{
+ Uint8 copy[I2C_QUEUE_MAX_BYTES];
+
+ if ( !queue_now )
+   {
+    return I2C_QUEUE_FULL;
+   }
+
+ memcpy(copy, data, length);
+ USBSTK5505_I2C_write(address, copy, length);
+
+ if ( callback )
+   {
+    callback(I2C_QUEUE_OK, copy, length, context);
+   }
+
+ return I2C_QUEUE_OK;
+}
+
+Uint16 i2c_queue_pending(void) { return 0; }
+void i2c_queue_flush(void) { }
+
+/*****************************************************************************/
+/* bus_time()                                                                */
+/*****************************************************************************/
+
+static void bus_time( Uint16 len, Uint32 start_usec )
+{
+ double t = ( 2 + 9 * ( len + 1 ) ) * I2C_BIT_US;
+
+ time_us += start_usec;
+ time_us += t;
+ bus_us += t;
+}
+
+/*****************************************************************************/
+/* dac_running()                                                             */
+/*****************************************************************************/
+
+static int dac_running( void )
+{
+ return ( 0 != ( codec[0][63] & 0xC0 ) );
+}
+
+/*****************************************************************************/
+/* coefficients_in_use()                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 1 if a register is in the coefficient buffer the running DAC is  */
+/*          using in adaptive mode.                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static int coefficients_in_use( Uint16 page, Uint16 reg )
+{
+ Uint16 in_use = ( codec[44][1] & 0x02 ) ? 62 : 44;
+
+ if ( !( codec[44][1] & 0x04 ) || !dac_running() || reg < 8 )
+   {
+    return 0;
+   }
+
+ return ( page >= in_use && page <= in_use + 8 );
+}
+
+/*****************************************************************************/
+/* USBSTK5505_I2C_write()                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* First byte is the register address, the rest are data for that register  */
+/* and the ones after it. Register 0 on any page is the page select.         */
+/*                                                                           */
+/*****************************************************************************/
+
+Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len )
+{
+ Uint16 i;
+
+ if ( verbose )
+   {
+    printf("%10.1f us  W %02X:", time_us, i2c_addr);
+
+    for ( i = 0 ; i < len ; i++)
+      {
+       printf(" %02X", data[i]);
+      }
+
+    printf("\n");
+   }
+
+ codec_pointer = data[0] & 0x7F;
+
+ for ( i = 1 ; i < len ; i++)
+   {
+    if ( 0 == codec_pointer )
+      {
+       codec_page = data[i];
+      }
+    else if ( 0 == codec_page && 1 == codec_pointer && ( data[i] & 1 ) )
+      {
+       memset(codec, 0, sizeof(codec));   /* Software reset */
+       codec_page = 0;
+      }
+    else if ( 44 == codec_page && 1 == codec_pointer )
+      {
+       /* Adaptive filter control. Bit 1 is read only, bit 0 swaps */
+       Uint8 value = ( codec[44][1] & 0x02 ) | ( data[i] & 0x04 );
+
+       if ( ( data[i] & 0x01 ) && ( data[i] & 0x04 ) )
+         {
+          value ^= 0x02;
+         }
+
+       codec[44][1] = value;
+      }
+    else if ( coefficients_in_use(codec_page, codec_pointer) )
+      {
+       ignored++;
+      }
+    else
+      {
+       codec[codec_page & 0xFF][codec_pointer] = data[i];
+      }
+
+    codec_pointer = ( codec_pointer + 1 ) & 0x7F;
+   }
+
+ bus_time( len, 1 );
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* USBSTK5505_I2C_read()                                                     */
+/*****************************************************************************/
+
+Int16 USBSTK5505_I2C_read( Uint16 i2c_addr, Uint8* data, Uint16 len )
+{
+ Uint16 i;
+
+ for ( i = 0 ; i < len ; i++)
+   {
+    if ( 0 == codec_page && 37 == codec_pointer )
+      {
+       /* DAC flags. Left and right powered as soon as asked */
+       data[i] = ( ( codec[0][63] & 0x80 ) ? 0x80 : 0 )
+                 | ( ( codec[0][63] & 0x40 ) ? 0x08 : 0 );
+      }
+    else
+      {
+       data[i] = codec[codec_page & 0xFF][codec_pointer];
+      }
+
+    codec_pointer = ( codec_pointer + 1 ) & 0x7F;
+   }
+
+ if ( verbose )
+   {
+    printf("%10.1f us  R %02X: %d bytes\n", time_us, i2c_addr, len);
+   }
+
+ reads++;
+ bus_time( len, 0 );
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* agc_gain_changes()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* PGA gain changes as the AGC makes them, with some repeated values.        */
+/*                                                                           */
+/*****************************************************************************/
+
+static void agc_gain_changes( void )
+{
+ static const Uint16 gains[8] = { 20, 20, 32, 32, 32, 20, 8, 8 };
+ Uint16 i;
+
+ for ( i = 0 ; i < 8 ; i++)
+   {
+    AIC3204_rset( 0, 1 );
+    AIC3204_rset( 0x3b, gains[i] );
+    AIC3204_rset( 0x3c, gains[i] );
+    AIC3204_rset( 0, 0 );
+   }
+}
+
+/*****************************************************************************/
+/* codec_power_on()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Model a codec that has just been powered and a board that has just been  */
+/* initialised.                                                              */
+/*                                                                           */
+/*****************************************************************************/
+
+static void codec_power_on( void )
+{
+ memset(codec, 0, sizeof(codec));
+ codec_page = 0;
+ codec_pointer = 0;
+
+ aic3204_hardware_init();
+}
+
+/*****************************************************************************/
+/* switch_rates()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Number of sampling frequencies that did not match.               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int switch_rates( void )
+{
+ static const unsigned long rates[7] = { 48000, 24000, 16000, 12000,
+                                         9600, 8000, 6857 };
+ static Uint8 reference[7][2][128];
+ unsigned long transactions;
+ double start;
+ int failures = 0;
+ int different;
+ int i;
+
+ /* Full configuration at each rate. Gain changes with the rate too */
+
+ for ( i = 0 ; i < 7 ; i++)
+   {
+    codec_power_on();
+    set_sampling_frequency_and_gain(rates[i], 6 + i);
+    memcpy(reference[i], codec, sizeof(reference[i]));
+   }
+
+ codec_power_on();
+ set_sampling_frequency_and_gain(48000, 0);
+
+ for ( i = 0 ; i < 7 ; i++)
+   {
+    transactions = aic3204_stats.transactions;
+    start = time_us;
+
+    set_sampling_frequency_and_gain(rates[i], 6 + i);
+
+    different = memcmp(reference[i], codec, sizeof(reference[i]));
+
+    if ( different )
+      {
+       failures++;
+      }
+
+    printf("%5lu Hz %3lu writes %9.1f us %s\n", rates[i],
+           aic3204_stats.transactions - transactions, time_us - start,
+           different ? "FAIL" : "PASS");
+   }
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* codec_coefficient()                                                       */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Coefficient n of the buffer starting at page base, sign         */
+/*          extended.                                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static long codec_coefficient( Uint16 base, Uint16 n )
+{
+ Uint8 *r = &codec[base + n / 30][8 + 4 * ( n % 30 )];
+ long value = ( (long) r[0] << 16 ) | ( (long) r[1] << 8 ) | r[2];
+
+ return ( value & 0x800000L ) ? value - 0x1000000L : value;
+}
+
+/*****************************************************************************/
+/* check_buffers()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Number of coefficients in either buffer, for count biquads on    */
+/*          each channel, that are not what was asked for.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+static int check_buffers( const AIC3204_BIQUAD *left,
+                          const AIC3204_BIQUAD *right, Uint16 count )
+{
+ static const Uint16 bases[2] = { 44, 62 };
+ const AIC3204_BIQUAD *biquad;
+ long expected[5];
+ int errors = 0;
+ Uint16 b;
+ Uint16 i;
+ Uint16 j;
+
+ for ( b = 0 ; b < 2 ; b++)
+   {
+    for ( i = 0 ; i < 2 * count ; i++)
+      {
+       biquad = ( i < count ) ? &left[i] : &right[i - count];
+       expected[0] = biquad->n0;
+       expected[1] = biquad->n1;
+       expected[2] = biquad->n2;
+       expected[3] = biquad->d1;
+       expected[4] = biquad->d2;
+
+       for ( j = 0 ; j < 5 ; j++)
+         {
+          Uint16 n = ( i < count ? 1 + 5 * i : 33 + 5 * ( i - count ) ) + j;
+
+          if ( codec_coefficient(bases[b], n) != expected[j] )
+            {
+             errors++;
+            }
+         }
+      }
+   }
+
+ return errors;
+}
+
+/*****************************************************************************/
+/* response_error()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Largest difference in dB, 100 Hz to 20 kHz at 48 kHz, between    */
+/*          left biquad A as loaded in buffer A and the Q15 table as the     */
+/*          C5505 runs it.                                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+static double magnitude( double b0, double b1, double b2, double a1,
+                         double a2, double w )
+{
+ double nr = b0 + b1 * cos(w) + b2 * cos(2 * w);
+ double ni = -b1 * sin(w) - b2 * sin(2 * w);
+ double dr = 1 + a1 * cos(w) + a2 * cos(2 * w);
+ double di = -a1 * sin(w) - a2 * sin(2 * w);
+
+ return 20 * log10(sqrt(( nr * nr + ni * ni ) / ( dr * dr + di * di )));
+}
+
+static double response_error( const signed int *table )
+{
+ double q23 = 8388608.0;
+ double worst = 0.0;
+ double error;
+ double w;
+ double f;
+
+ for ( f = 100.0 ; f <= 20000.0 ; f += 100.0 )
+   {
+    w = 2 * M_PI * f / 48000.0;
+
+    error = magnitude(codec_coefficient(44, 1) / q23,
+                      2 * codec_coefficient(44, 2) / q23,
+                      codec_coefficient(44, 3) / q23,
+                      -2 * codec_coefficient(44, 4) / q23,
+                      -codec_coefficient(44, 5) / q23, w)
+            - magnitude(table[0] / 32768.0, 2 * table[1] / 32768.0,
+                        table[2] / 32768.0, 2 * table[4] / 32768.0,
+                        table[5] / 32768.0, w);
+
+    if ( fabs(error) > worst )
+      {
+       worst = fabs(error);
+      }
+   }
+
+ return worst;
+}
+
+/*****************************************************************************/
+/* biquad_test()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Number of checks that failed.                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static int check( const char *name, int ok )
+{
+ printf("%-48s %s\n", name, ok ? "PASS" : "FAIL");
+ return ok ? 0 : 1;
+}
+
+static int biquad_test( void )
+{
+ AIC3204_BIQUAD low_pass[AIC3204_BIQUADS_MAX];
+ AIC3204_BIQUAD flat[AIC3204_BIQUADS_MAX];
+ AIC3204_BIQUAD designed;
+ unsigned long transactions;
+ double start;
+ int failures = 0;
+ int i;
+
+ for ( i = 0 ; i < AIC3204_BIQUADS_MAX ; i++)
+   {
+    aic3204_biquad_from_table(&low_pass[i], IIR_low_pass_4800Hz);
+    aic3204_biquad_flat(&flat[i]);
+   }
+
+ aic3204_biquad_from_float(&designed, IIR_low_pass_4800Hz[0] / 32768.0f,
+                           2 * IIR_low_pass_4800Hz[1] / 32768.0f,
+                           IIR_low_pass_4800Hz[2] / 32768.0f,
+                           2 * IIR_low_pass_4800Hz[4] / 32768.0f,
+                           IIR_low_pass_4800Hz[5] / 32768.0f);
+
+ failures += check("Designer and table coefficients agree",
+                   0 == memcmp(&designed, &low_pass[0], sizeof(designed)));
+
+ codec_power_on();
+ aic3204_init();
+ set_sampling_frequency_and_gain(48000, 10);
+
+ failures += check("Adaptive mode on after configuration",
+                   0x04 == codec[44][1]);
+
+ /* Waiting, while the DAC runs */
+
+ transactions = aic3204_stats.transactions;
+ start = time_us;
+
+ failures += check("aic3204_dac_biquads() low pass",
+                   0 == aic3204_dac_biquads(low_pass, low_pass, 2));
+
+ printf("%lu writes %.1f us\n", aic3204_stats.transactions - transactions,
+        time_us - start);
+
+ failures += check("Both buffers hold the low pass",
+                   0 == check_buffers(low_pass, low_pass, 2));
+ failures += check("Buffers swapped, DAC on buffer B", 0x06 == codec[44][1]);
+ failures += check("Response within 0.01 dB of the C5505 filter",
+                   response_error(IIR_low_pass_4800Hz) < 0.01);
+
+ /* Queued, from the audio loop */
+
+ queue_now = 1;
+ transactions = aic3204_stats.transactions;
+ start = time_us;
+
+ failures += check("aic3204_dac_biquads_async() flat",
+                   0 == aic3204_dac_biquads_async(flat, flat, 3));
+
+ printf("%lu writes %.1f us\n", aic3204_stats.transactions - transactions,
+        time_us - start);
+
+ failures += check("Queued writes fit in the I2C queue",
+                   aic3204_stats.transactions - transactions
+                   <= I2C_QUEUE_SIZE);
+ failures += check("Both buffers flat", 0 == check_buffers(flat, flat, 3));
+ failures += check("Buffers swapped, DAC on buffer A", 0x04 == codec[44][1]);
+ queue_now = 0;
+
+ /* Six biquads need PRB_P2 */
+
+ failures += check("6 biquads refused by PRB_P1",
+                   0 != aic3204_dac_biquads(low_pass, low_pass, 6));
+ failures += check("aic3204_dac_processing_block(AIC3204_PRB_P2)",
+                   0 == aic3204_dac_processing_block(AIC3204_PRB_P2)
+                   && 2 == codec[0][60] && 0xD4 == codec[0][63]);
+ failures += check("aic3204_dac_biquads() 6 low pass",
+                   0 == aic3204_dac_biquads(low_pass, flat, 6)
+                   && 0 == check_buffers(low_pass, flat, 6));
+
+ queue_now = 1;
+ failures += check("6 queued biquads too many for the I2C queue",
+                   I2C_QUEUE_FULL == aic3204_dac_biquads_async(flat, flat, 6));
+ queue_now = 0;
+
+ failures += check("Buffer in use never written", 0 == ignored);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* report()                                                                  */
+/*****************************************************************************/
+
+static void report( const char *stage )
+{
+ printf("%-32s %6lu writes %6lu bytes %5lu page %5lu elided %5lu suppressed"
+        " %9.1f us bus %9.1f us delay %9.1f us total\n", stage,
+        aic3204_stats.transactions, aic3204_stats.bytes,
+        aic3204_stats.page_selects, aic3204_stats.pages_elided,
+        aic3204_stats.suppressed, bus_us, delay_total_us, time_us);
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main( int argc, char *argv[] )
+{
+ int registers = 0;
+ int rates = 0;
+ int biquads = 0;
+ int fast = 0;
+ int i;
+ Uint16 page;
+ Uint16 reg;
+
+ for ( i = 1 ; i < argc ; i++)
+   {
+    if ( 0 == strcmp(argv[i], "-v") )
+      {
+       verbose = 1;
+      }
+    else if ( 0 == strcmp(argv[i], "-r") )
+      {
+       registers = 1;
+      }
+    else if ( 0 == strcmp(argv[i], "-s") )
+      {
+       rates = 1;
+      }
+    else if ( 0 == strcmp(argv[i], "-b") )
+      {
+       biquads = 1;
+      }
+    else if ( 0 == strcmp(argv[i], "-f") )
+      {
+       fast = 1;
+      }
+   }
+
+ printf("AIC3204_SHADOW = %d\n", AIC3204_SHADOW);
+
+ if ( rates )
+   {
+    return switch_rates() ? 1 : 0;
+   }
+
+ if ( biquads )
+   {
+    return biquad_test() ? 1 : 0;
+   }
+
+ aic3204_hardware_init();
+ report("aic3204_hardware_init()");
+
+ if ( !fast )
+   {
+    aic3204_init();
+    report("+ aic3204_init()");
+   }
+
+ set_sampling_frequency_and_gain(48000, 10);
+ report("+ set_sampling_frequency_and_gain");
+
+ agc_gain_changes();
+ report("+ 8 AGC gain changes");
+
+ if ( registers )
+   {
+    for ( page = 0 ; page < 2 ; page++)
+      {
+       for ( reg = 1 ; reg < 128 ; reg++)
+         {
+          if ( codec[page][reg] )
+            {
+             printf("P%u R%3u = 0x%02X\n", page, reg, codec[page][reg]);
+            }
+         }
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* End of aic3204_i2c_log.c                                                  */
+/*****************************************************************************/
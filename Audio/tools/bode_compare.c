@@ -0,0 +1,494 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 bode_compare.c                                                          */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick IIR filter tables.           */
+/*                                                                           */
+/*   Runs the BODE_DIGITAL measurement from bode.c on a PC for every second  */
+/*   order table in IIR_*_filters.h, through the same fixed point            */
+/*   fourth_order_IIR_direct_form_I() used by main.c, and compares the       */
+/*   result with the ideal response of the design the table names, worked    */
+/*   out in double precision from its type and frequencies:                  */
+/*                                                                           */
+/*   - low, high, band pass and band stop: second order Butterworth by the   */
+/*     BLT at 48000 Hz, with the cutoff or band edges prewarped.             */
+/*   - r_ band pass: poles at radius r and the named frequency, zeros at     */
+/*     z = 1 and z = -1. The scale is a free choice, so the table's B0 is    */
+/*     taken for it.                                                         */
+/*   - notch: zeros on the unit circle and poles at radius r, both at the    */
+/*     named frequency.                                                      */
+/*                                                                           */
+/*   Both sections of the cascade are the design section. The deviation      */
+/*   from the design is the quantisation of the coefficients and the 16-bit  */
+/*   arithmetic together. The deviation from the table's own coefficients    */
+/*   in double precision is the arithmetic alone, so the difference of the   */
+/*   two is the coefficient error. The Chassaing band stop names no design   */
+/*   that its coefficients fit, so only the second is given for it.          */
+/*                                                                           */
+/*   Points where the design response is below BODE_COMPARE_FLOOR dB are     */
+/*   not compared, as the fixed point output is then mostly round-off.       */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o bode_compare tools/bode_compare.c             */
+/*       src/bode.c                                                          */
+/*       src/sinewaves.c src/IIR_filters_fourth_order.c                      */
+/*       src/IIR_low_pass_filters.c -lm                                      */
+/*                                                                           */
+/*   bode_compare          Summary of every table.                           */
+/*   bode_compare name     CSV of measured, design and own coefficient       */
+/*                         response for one table.                           */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "tms320.h"
+#include "bode.h"
+#include "IIR_filters_fourth_order.h"
+#include "IIR_low_pass_filters.h"
+#include "IIR_high_pass_filters.h"
+#include "IIR_band_pass_filters.h"
+#include "IIR_band_stop_filters.h"
+
+#define SAMPLES_PER_SECOND  48000
+#define BODE_COMPARE_FLOOR  -40.0
+#define PI                  3.14159265358979
+
+#define LOW_PASS(x, f)       { #x, x, DESIGN_LOW_PASS, f, 0, 0.0 }
+#define HIGH_PASS(x, f)      { #x, x, DESIGN_HIGH_PASS, f, 0, 0.0 }
+#define BAND_PASS(x, f1, f2) { #x, x, DESIGN_BAND_PASS, f1, f2, 0.0 }
+#define BAND_STOP(x, f1, f2) { #x, x, DESIGN_BAND_STOP, f1, f2, 0.0 }
+#define RESONATOR(x, f, r)   { #x, x, DESIGN_RESONATOR, f, 0, r }
+#define NOTCH(x, f, r)       { #x, x, DESIGN_NOTCH, f, 0, r }
+#define OWN(x)               { #x, x, DESIGN_NONE, 0, 0, 0.0 }
+
+typedef enum
+{
+    DESIGN_NONE,                /* Only the table's own coefficients        */
+    DESIGN_LOW_PASS,
+    DESIGN_HIGH_PASS,
+    DESIGN_BAND_PASS,
+    DESIGN_BAND_STOP,
+    DESIGN_RESONATOR,
+    DESIGN_NOTCH
+} DESIGN;
+
+typedef struct
+{
+    const char *name;
+    const signed int *coefficients;
+    DESIGN design;
+    unsigned int f1;            /* Cutoff, centre or lower band edge, Hz    */
+    unsigned int f2;            /* Upper band edge, Hz                      */
+    double r;                   /* Pole radius                              */
+} FILTER_TABLE;
+
+typedef struct
+{
+    double b0, b1, b2, a1, a2;  /* Full values, A0 is 1                     */
+} SECTION;
+
+static const FILTER_TABLE tables[] =
+{
+  LOW_PASS(IIR_low_pass_300Hz, 300),   LOW_PASS(IIR_low_pass_600Hz, 600),
+  LOW_PASS(IIR_low_pass_1000Hz, 1000), LOW_PASS(IIR_low_pass_1200Hz, 1200),
+  LOW_PASS(IIR_low_pass_2000Hz, 2000), LOW_PASS(IIR_low_pass_2400Hz, 2400),
+  LOW_PASS(IIR_low_pass_4000Hz, 4000), LOW_PASS(IIR_low_pass_4800Hz, 4800),
+  LOW_PASS(IIR_low_pass_9600Hz, 9600),
+  HIGH_PASS(IIR_high_pass_300Hz, 300),   HIGH_PASS(IIR_high_pass_600Hz, 600),
+  HIGH_PASS(IIR_high_pass_1000Hz, 1000), HIGH_PASS(IIR_high_pass_1200Hz, 1200),
+  HIGH_PASS(IIR_high_pass_2000Hz, 2000), HIGH_PASS(IIR_high_pass_2400Hz, 2400),
+  HIGH_PASS(IIR_high_pass_4000Hz, 4000), HIGH_PASS(IIR_high_pass_4800Hz, 4800),
+  HIGH_PASS(IIR_high_pass_9600Hz, 9600),
+  BAND_PASS(IIR_band_pass_2000Hz_to_2800Hz, 2000, 2800),
+  BAND_PASS(IIR_band_pass_600Hz_to_1200Hz, 600, 1200),
+  BAND_PASS(IIR_band_pass_1200Hz_to_2400Hz, 1200, 2400),
+  BAND_PASS(IIR_band_pass_2400Hz_to_4800Hz, 2400, 4800),
+  BAND_PASS(IIR_band_pass_4800Hz_to_9600Hz, 4800, 9600),
+  BAND_PASS(IIR_band_pass_600Hz_to_2400Hz, 600, 2400),
+  BAND_PASS(IIR_band_pass_1200Hz_to_4800Hz, 1200, 4800),
+  BAND_PASS(IIR_band_pass_2400Hz_to_9600Hz, 2400, 9600),
+  RESONATOR(IIR_band_pass_300Hz_r_9372, 300, 0.9372),
+  RESONATOR(IIR_band_pass_600Hz_r_9372, 600, 0.9372),
+  RESONATOR(IIR_band_pass_1200Hz_r_9372, 1200, 0.9372),
+  RESONATOR(IIR_band_pass_2400Hz_r_9372, 2400, 0.9372),
+  RESONATOR(IIR_band_pass_4800Hz_r_9372, 4800, 0.9372),
+  RESONATOR(IIR_band_pass_9600Hz_r_9372, 9600, 0.9372),
+  RESONATOR(IIR_band_pass_2400Hz_1_r_00, 2400, 1.00),
+  RESONATOR(IIR_band_pass_2400Hz_r_97, 2400, 0.97),
+  RESONATOR(IIR_band_pass_2400Hz_r_95, 2400, 0.95),
+  RESONATOR(IIR_band_pass_2400Hz_r_90, 2400, 0.90),
+  RESONATOR(IIR_band_pass_2400Hz_r_85, 2400, 0.85),
+  RESONATOR(IIR_band_pass_2400Hz_r_80, 2400, 0.80),
+  RESONATOR(IIR_band_pass_2400Hz_r_75, 2400, 0.75),
+  OWN(IIR_band_stop_9500Hz_to_10500Hz),
+  BAND_STOP(IIR_band_stop_2000Hz_to_2800Hz, 2000, 2800),
+  BAND_STOP(IIR_band_stop_600Hz_to_1200Hz, 600, 1200),
+  BAND_STOP(IIR_band_stop_1200Hz_to_2400Hz, 1200, 2400),
+  BAND_STOP(IIR_band_stop_2400Hz_to_4800Hz, 2400, 4800),
+  BAND_STOP(IIR_band_stop_4800Hz_to_9600Hz, 4800, 9600),
+  BAND_STOP(IIR_band_stop_600Hz_to_2400Hz, 600, 2400),
+  BAND_STOP(IIR_band_stop_1200Hz_to_4800Hz, 1200, 4800),
+  BAND_STOP(IIR_band_stop_2400Hz_to_9600Hz, 2400, 9600),
+  NOTCH(IIR_notch_300Hz_r_9372, 300, 0.9372),
+  NOTCH(IIR_notch_600Hz_r_9372, 600, 0.9372),
+  NOTCH(IIR_notch_1200Hz_r_9372, 1200, 0.9372),
+  NOTCH(IIR_notch_2400Hz_r_9372, 2400, 0.9372),
+  NOTCH(IIR_notch_4800Hz_r_9372, 4800, 0.9372),
+  NOTCH(IIR_notch_9600Hz_r_9372, 9600, 0.9372),
+  NOTCH(IIR_notch_2400Hz_r_100, 2400, 1.00),
+  NOTCH(IIR_notch_2400Hz_r_97, 2400, 0.97),
+  NOTCH(IIR_notch_2400Hz_r_95, 2400, 0.95),
+  NOTCH(IIR_notch_2400Hz_r_90, 2400, 0.90),
+  NOTCH(IIR_notch_2400Hz_r_85, 2400, 0.85),
+  NOTCH(IIR_notch_2400Hz_r_80, 2400, 0.80),
+  NOTCH(IIR_notch_2400Hz_r_75, 2400, 0.75)
+};
+
+/* first_order_* tables hold { b0, b1, a0, a1 } and are not used by        */
+/* fourth_order_IIR_direct_form_I(), so they are not in the list.          */
+
+#define TABLES ( sizeof(tables) / sizeof(tables[0]) )
+
+static const signed int *filter;
+
+/*****************************************************************************/
+/* sine()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Host replacement for sine() in 55xdsph.lib. Angle / pi in Q15.            */
+/*                                                                           */
+/*****************************************************************************/
+
+ushort sine(DATA *x, DATA *r, ushort nx)
+{
+ ushort i;
+ double value;
+
+ for ( i = 0 ; i < nx ; i++)
+   {
+    value = sin( x[i] * PI / 32768.0 ) * 32768.0;
+
+    if ( value > 32767.0 )
+      {
+       value = 32767.0;
+      }
+
+    r[i] = (DATA) floor( value + 0.5 );
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* chain()                                                                   */
+/*****************************************************************************/
+
+static signed int chain(signed int input)
+{
+ return fourth_order_IIR_direct_form_I(filter, input);
+}
+
+/*****************************************************************************/
+/* own_section()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The table's coefficients in double precision. B1 and A1 are stored        */
+/* halved. A0 is taken as 1.000.                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static SECTION own_section(const signed int *c)
+{
+ SECTION s;
+
+ s.b0 = c[0] / 32768.0;
+ s.b1 = 2.0 * c[1] / 32768.0;
+ s.b2 = c[2] / 32768.0;
+ s.a1 = 2.0 * c[4] / 32768.0;
+ s.a2 = c[5] / 32768.0;
+
+ return s;
+}
+
+/*****************************************************************************/
+/* design_section()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The section the table names, from its type and frequencies. The BLT       */
+/* designs use the prewarped analog frequencies W = tan(pi f / fs).          */
+/*                                                                           */
+/*****************************************************************************/
+
+static SECTION design_section(const FILTER_TABLE *table)
+{
+ SECTION s;
+ double k = tan(PI * table->f1 / SAMPLES_PER_SECOND);
+ double k2 = tan(PI * table->f2 / SAMPLES_PER_SECOND);
+ double w = 2.0 * PI * table->f1 / SAMPLES_PER_SECOND;
+ double w0, bw, d;
+
+ switch ( table->design )
+   {
+    case DESIGN_LOW_PASS:
+    case DESIGN_HIGH_PASS:
+     d = 1.0 + sqrt(2.0) * k + k * k;
+     s.a1 = 2.0 * ( k * k - 1.0 ) / d;
+     s.a2 = ( 1.0 - sqrt(2.0) * k + k * k ) / d;
+
+     if ( DESIGN_LOW_PASS == table->design )
+       {
+        s.b0 = k * k / d;
+        s.b1 = 2.0 * s.b0;
+       }
+     else
+       {
+        s.b0 = 1.0 / d;
+        s.b1 = -2.0 * s.b0;
+       }
+
+     s.b2 = s.b0;
+     break;
+
+    case DESIGN_BAND_PASS:
+    case DESIGN_BAND_STOP:
+     w0 = k * k2;                       /* Centre squared                   */
+     bw = k2 - k;
+     d = 1.0 + bw + w0;
+     s.a1 = 2.0 * ( w0 - 1.0 ) / d;
+     s.a2 = ( 1.0 - bw + w0 ) / d;
+
+     if ( DESIGN_BAND_PASS == table->design )
+       {
+        s.b0 = bw / d;
+        s.b1 = 0.0;
+        s.b2 = -s.b0;
+       }
+     else
+       {
+        s.b0 = ( 1.0 + w0 ) / d;
+        s.b1 = s.a1;
+        s.b2 = s.b0;
+       }
+     break;
+
+    case DESIGN_RESONATOR:
+     s.b0 = table->coefficients[0] / 32768.0;
+     s.b1 = 0.0;
+     s.b2 = -s.b0;
+     s.a1 = -2.0 * table->r * cos(w);
+     s.a2 = table->r * table->r;
+     break;
+
+    case DESIGN_NOTCH:
+     s.b0 = 1.0;
+     s.b1 = -2.0 * cos(w);
+     s.b2 = 1.0;
+     s.a1 = -2.0 * table->r * cos(w);
+     s.a2 = table->r * table->r;
+     break;
+
+    default:
+     s = own_section(table->coefficients);
+     break;
+   }
+
+ return s;
+}
+
+/*****************************************************************************/
+/* response()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Two cascaded copies of the section, as in                                 */
+/* fourth_order_IIR_direct_form_I().                                         */
+/*                                                                           */
+/*****************************************************************************/
+
+static void response(const SECTION *s, unsigned int frequency,
+                     double *magnitude, double *phase)
+{
+ double w = 2.0 * PI * frequency / SAMPLES_PER_SECOND;
+ double nr, ni, dr, di, hr, hi, d, power;
+
+ nr = s->b0 + s->b1 * cos(w) + s->b2 * cos(2.0 * w);
+ ni = -s->b1 * sin(w) - s->b2 * sin(2.0 * w);
+ dr = 1.0 + s->a1 * cos(w) + s->a2 * cos(2.0 * w);
+ di = -s->a1 * sin(w) - s->a2 * sin(2.0 * w);
+
+ d = dr * dr + di * di;
+ hr = ( nr * dr + ni * di ) / d;
+ hi = ( ni * dr - nr * di ) / d;
+
+ /* Square for the two stages */
+
+ power = hr * hr + hi * hi;
+ *magnitude = ( power > 1e-24 ) ? 20.0 * log10(power) : -240.0;
+ *phase = 2.0 * atan2(hi, hr) * 180.0 / PI;
+
+ while ( *phase > 180.0 )
+   {
+    *phase -= 360.0;
+   }
+
+ while ( *phase <= -180.0 )
+   {
+    *phase += 360.0;
+   }
+}
+
+/*****************************************************************************/
+/* phase_error()                                                             */
+/*****************************************************************************/
+
+static double phase_error(double measured, double reference)
+{
+ double error = measured - reference;
+
+ if ( error > 180.0 )
+   {
+    error -= 360.0;
+   }
+ else if ( error < -180.0 )
+   {
+    error += 360.0;
+   }
+
+ return error;
+}
+
+/*****************************************************************************/
+/* measure()                                                                 */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Measure one table and find the largest deviations from its design and     */
+/* from its own coefficients.                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static void measure(const FILTER_TABLE *table, int csv)
+{
+ SECTION design = design_section(table);
+ SECTION own = own_section(table->coefficients);
+ unsigned int i;
+ unsigned int worst_frequency = 0;
+ double magnitude, phase;
+ double own_magnitude, own_phase;
+ double measured;
+ double error;
+ double worst_magnitude = 0.0;
+ double worst_phase = 0.0;
+ double worst_own = 0.0;
+
+ filter = table->coefficients;
+
+ bode_init(BODE_DIGITAL, SAMPLES_PER_SECOND, BODE_AMPLITUDE, chain);
+ bode_run_digital();
+ bode_report();
+
+ if ( csv )
+   {
+    printf("frequency_Hz,magnitude_dB,phase_degrees,"
+           "design_magnitude_dB,design_phase_degrees,"
+           "own_magnitude_dB,own_phase_degrees\n");
+   }
+
+ for ( i = 0 ; i < bode_points ; i++)
+   {
+    response(&design, bode_table[i].frequency, &magnitude, &phase);
+    response(&own, bode_table[i].frequency, &own_magnitude, &own_phase);
+    measured = bode_table[i].magnitude / 100.0;
+
+    if ( csv )
+      {
+       printf("%u,%.2f,%.1f,%.2f,%.1f,%.2f,%.1f\n", bode_table[i].frequency,
+              measured, bode_table[i].phase / 10.0, magnitude, phase,
+              own_magnitude, own_phase);
+      }
+
+    if ( magnitude < BODE_COMPARE_FLOOR )
+      {
+       continue;
+      }
+
+    error = measured - magnitude;
+
+    if ( fabs(error) > fabs(worst_magnitude) )
+      {
+       worst_magnitude = error;
+       worst_frequency = bode_table[i].frequency;
+      }
+
+    error = phase_error(bode_table[i].phase / 10.0, phase);
+
+    if ( fabs(error) > fabs(worst_phase) )
+      {
+       worst_phase = error;
+      }
+
+    error = measured - own_magnitude;
+
+    if ( fabs(error) > fabs(worst_own) )
+      {
+       worst_own = error;
+      }
+   }
+
+ if ( csv )
+   {
+    return;
+   }
+
+ if ( DESIGN_NONE == table->design )
+   {
+    printf("%-34s %32s %8.2f dB\n", table->name, "no design", worst_own);
+   }
+ else
+   {
+    printf("%-34s %8.2f dB at %5u Hz %8.1f deg %8.2f dB\n", table->name,
+           worst_magnitude, worst_frequency, worst_phase, worst_own);
+   }
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ unsigned int i;
+
+ if ( argc > 1 )
+   {
+    for ( i = 0 ; i < TABLES ; i++)
+      {
+       if ( 0 == strcmp(argv[1], tables[i].name) )
+         {
+          measure(&tables[i], 1);
+          return 0;
+         }
+      }
+
+    fprintf(stderr, "Unknown table %s\n", argv[1]);
+    return 1;
+   }
+
+ printf("Largest deviation of fixed point above %.0f dB, from the design and"
+        " from the\ntable's own coefficients\n", BODE_COMPARE_FLOOR);
+ printf("%-34s %32s %11s\n", "", "design", "own");
+
+ for ( i = 0 ; i < TABLES ; i++)
+   {
+    measure(&tables[i], 0);
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* End of bode_compare.c                                                     */
+/*****************************************************************************/
@@ -0,0 +1,566 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 goertzel_dtmf.c                                                         */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick DTMF detector.               */
+/*                                                                           */
+/*   Runs goertzel.c on a PC with the settings main.c uses, one 48 kHz       */
+/*   sample at a time as the audio loop does, and decodes keys from the      */
+/*   events the same way.                                                    */
+/*                                                                           */
+/*   With no file it makes its own vectors: all 16 keys, 100 ms on and       */
+/*   100 ms off, each tone from -7 to -45 dBFS over noise at -70 dBFS. Every */
+/*   key must be found once and nothing else. Noise alone and each tone on   */
+/*   its own must give no key. A full scale tone and square wave at the      */
+/*   lowest row must keep every resonator state under GOERTZEL_STATE_BITS.   */
+/*   It then prints the time per input sample, from running the detector     */
+/*   over all the vectors again.                                             */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o goertzel_dtmf tools/goertzel_dtmf.c           */
+/*       src/goertzel.c tools/host/dsplib.c -lm                              */
+/*                                                                           */
+/*   goertzel_dtmf             Run the tests. Exit status is the failures.   */
+/*   goertzel_dtmf -w out.wav  Also write the vectors as a 48 kHz WAV file.  */
+/*   goertzel_dtmf in.wav      Print the keys in a 16-bit 48 kHz WAV file.   */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "tms320.h"
+#include "goertzel.h"
+
+#define SAMPLES_PER_SECOND  48000
+#define TONE_SAMPLES        4800        /* 100 ms                           */
+#define GAP_SAMPLES         4800
+#define NOISE_DBFS          -70.0
+#define KEYS                "123A456B789C*0#D"
+#define KEY_COUNT           16
+#define MAX_SAMPLES         ( KEY_COUNT * ( TONE_SAMPLES + GAP_SAMPLES ) )
+#define BENCH_REPEATS       20
+#define PI                  3.14159265358979
+
+static const double levels[] = { -7.0, -10.0, -20.0, -30.0, -40.0, -45.0 };
+
+#define LEVELS ( sizeof(levels) / sizeof(levels[0]) )
+
+static DATA samples[MAX_SAMPLES];
+static GOERTZEL_Bank bank;
+static unsigned long noise_seed = 1;
+static long state_peak;
+static int failures = 0;
+
+/*****************************************************************************/
+/* fail()                                                                    */
+/*****************************************************************************/
+
+static void fail(const char *what, double level)
+{
+ printf("FAIL %s at %.0f dBFS\n", what, level);
+ failures++;
+}
+
+/*****************************************************************************/
+/* noise()                                                                   */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Uniform noise from -1 to 1, RMS 1/sqrt(3).                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static double noise(void)
+{
+ noise_seed = ( noise_seed * 1103515245UL + 12345UL ) & 0x7FFFFFFFUL;
+ return ( noise_seed / 1073741824.0 ) - 1.0;
+}
+
+/*****************************************************************************/
+/* put()                                                                     */
+/*****************************************************************************/
+
+static void put(long at, double value)
+{
+ value = floor(value + 0.5);
+
+ if ( value > 32767.0 )
+   {
+    value = 32767.0;
+   }
+ else if ( value < -32768.0 )
+   {
+    value = -32768.0;
+   }
+
+ samples[at] = (DATA) value;
+}
+
+/*****************************************************************************/
+/* make_keys()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The keys of KEYS in turn, each tone at level dBFS, over the noise.        */
+/*                                                                           */
+/*****************************************************************************/
+
+static long make_keys(const char *keys, double level, int rows, int columns)
+{
+ double amplitude = 32768.0 * pow(10.0, level / 20.0);
+ double noise_amplitude = 32768.0 * pow(10.0, NOISE_DBFS / 20.0) * sqrt(3.0);
+ long at = 0;
+ long n;
+ double value;
+ const char *key;
+ int row;
+ int column;
+
+ for ( ; *keys ; keys++ )
+   {
+    key = strchr(KEYS, *keys);
+    row = (int) ( key - KEYS ) / 4;
+    column = (int) ( key - KEYS ) % 4;
+
+    for ( n = 0 ; n < TONE_SAMPLES + GAP_SAMPLES ; n++, at++ )
+      {
+       value = noise_amplitude * noise();
+
+       if ( n < TONE_SAMPLES && rows )
+         {
+          value += amplitude * sin( 2.0 * PI * n
+                                    * goertzel_dtmf_frequencies[row]
+                                    / SAMPLES_PER_SECOND );
+         }
+
+       if ( n < TONE_SAMPLES && columns )
+         {
+          value += amplitude * sin( 2.0 * PI * n
+                                    * goertzel_dtmf_frequencies[4 + column]
+                                    / SAMPLES_PER_SECOND );
+         }
+
+       put(at, value);
+      }
+   }
+
+ return at;
+}
+
+/*****************************************************************************/
+/* decode()                                                                  */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* As in main.c, one sample at a time. A key is counted when one row and one */
+/* column are present after none were. Keys found are put in found, with     */
+/* the time of each when times is set.                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static void decode(long count, char *found, int times)
+{
+ GOERTZEL_Event event;
+ Uint16 present[8] = { 0 };
+ int rows;
+ int columns;
+ int row = 0;
+ int column = 0;
+ int held = 0;
+ int length = 0;
+ long n;
+ Uint16 i;
+
+ goertzel_init(&bank, SAMPLES_PER_SECOND, goertzel_dtmf_frequencies, 8,
+               GOERTZEL_DTMF_BLOCK_LENGTH, GOERTZEL_DTMF_DECIMATION,
+               GOERTZEL_DTMF_THRESHOLD);
+
+ for ( n = 0 ; n < count ; n++ )
+   {
+    goertzel_process(&bank, &samples[n], 1);
+
+    for ( i = 0 ; i < bank.tones ; i++ )
+      {
+       if ( labs(bank.tone[i].s1) > state_peak )
+         {
+          state_peak = labs(bank.tone[i].s1);
+         }
+      }
+
+    while ( goertzel_get_event(&bank, &event) )
+      {
+       present[event.tone] = event.present;
+      }
+
+    rows = columns = 0;
+
+    for ( i = 0 ; i < 8 ; i++ )
+      {
+       if ( present[i] && i < 4 )
+         {
+          rows++;
+          row = i;
+         }
+       else if ( present[i] )
+         {
+          columns++;
+          column = i;
+         }
+      }
+
+    if ( 1 == rows && 1 == columns && !held )
+      {
+       found[length++] = goertzel_dtmf_key(goertzel_dtmf_frequencies[row],
+                                           goertzel_dtmf_frequencies[column]);
+       held = 1;
+
+       if ( times )
+         {
+          printf("%8.3f s  %c\n", (double) n / SAMPLES_PER_SECOND,
+                 found[length - 1]);
+         }
+      }
+    else if ( 0 == rows && 0 == columns )
+      {
+       held = 0;
+      }
+   }
+
+ found[length] = 0;
+}
+
+/*****************************************************************************/
+/* test_levels()                                                             */
+/*****************************************************************************/
+
+static void test_levels(void)
+{
+ char found[KEY_COUNT * 4];
+ long count;
+ int n;
+
+ for ( n = 0 ; n < (int) LEVELS ; n++ )
+   {
+    count = make_keys(KEYS, levels[n], 1, 1);
+    decode(count, found, 0);
+
+    printf("%4.0f dBFS  %-16s", levels[n], found);
+
+    if ( strcmp(found, KEYS) )
+      {
+       printf("\n");
+       fail("keys wrong", levels[n]);
+      }
+    else
+      {
+       printf("  ok\n");
+      }
+   }
+}
+
+/*****************************************************************************/
+/* test_false()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Noise alone, then a row tone alone and a column tone alone at each level. */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_false(void)
+{
+ char found[KEY_COUNT * 4];
+ long count;
+ int n;
+
+ count = make_keys(KEYS, 0.0, 0, 0);
+ decode(count, found, 0);
+
+ if ( found[0] )
+   {
+    fail("key in noise", NOISE_DBFS);
+   }
+
+ for ( n = 0 ; n < (int) LEVELS ; n++ )
+   {
+    count = make_keys("147*", levels[n], 1, 0);
+    decode(count, found, 0);
+
+    if ( found[0] )
+      {
+       fail("key from a row tone alone", levels[n]);
+      }
+
+    count = make_keys("123A", levels[n], 0, 1);
+    decode(count, found, 0);
+
+    if ( found[0] )
+      {
+       fail("key from a column tone alone", levels[n]);
+      }
+   }
+}
+
+/*****************************************************************************/
+/* test_headroom()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The lowest row is the tone with the smallest sin(w), so it is the one     */
+/* the state grows most for. Full scale sine, then square wave.              */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_headroom(void)
+{
+ char found[KEY_COUNT * 4];
+ double phase;
+ long n;
+
+ state_peak = 0;
+
+ for ( n = 0 ; n < MAX_SAMPLES ; n++ )
+   {
+    phase = 2.0 * PI * n * goertzel_dtmf_frequencies[0] / SAMPLES_PER_SECOND;
+    put(n, 32767.0 * sin(phase));
+   }
+
+ decode(MAX_SAMPLES, found, 0);
+
+ for ( n = 0 ; n < MAX_SAMPLES ; n++ )
+   {
+    phase = 2.0 * PI * n * goertzel_dtmf_frequencies[0] / SAMPLES_PER_SECOND;
+    samples[n] = ( sin(phase) >= 0.0 ) ? 32767 : -32768;
+   }
+
+ decode(MAX_SAMPLES, found, 0);
+
+ printf("Shifts: input %u, output %u, energy %u. Largest state %ld, "
+        "2^%.1f of 2^%d\n", bank.input_shift, bank.output_shift,
+        bank.energy_shift, state_peak, log((double) state_peak) / log(2.0),
+        GOERTZEL_STATE_BITS);
+
+ if ( state_peak >= ( 1L << GOERTZEL_STATE_BITS ) )
+   {
+    fail("state over GOERTZEL_STATE_BITS", 0.0);
+   }
+}
+
+/*****************************************************************************/
+/* bench()                                                                   */
+/*****************************************************************************/
+
+static void bench(void)
+{
+ char found[KEY_COUNT * 4];
+ long count;
+ long total = 0;
+ clock_t start;
+ double seconds;
+ int n;
+
+ count = make_keys(KEYS, -20.0, 1, 1);
+ start = clock();
+
+ for ( n = 0 ; n < BENCH_REPEATS ; n++ )
+   {
+    decode(count, found, 0);
+    total += count;
+   }
+
+ seconds = (double) ( clock() - start ) / CLOCKS_PER_SEC;
+
+ printf("%ld samples in %.3f s: %.1f ns per input sample, %.0f times real "
+        "time on this PC\n", total, seconds, 1e9 * seconds / total,
+        total / seconds / SAMPLES_PER_SECOND);
+ printf("Per input sample: 1 add, and every %d samples %d resonators of two "
+        "16 x 16 multiplies\n", GOERTZEL_DTMF_DECIMATION, 8);
+}
+
+/*****************************************************************************/
+/* write_u16() and write_u32()                                               */
+/*****************************************************************************/
+
+static void write_u16(FILE *out, unsigned value)
+{
+ fputc(value & 0xFF, out);
+ fputc(( value >> 8 ) & 0xFF, out);
+}
+
+static void write_u32(FILE *out, unsigned long value)
+{
+ write_u16(out, (unsigned) ( value & 0xFFFF ));
+ write_u16(out, (unsigned) ( value >> 16 ));
+}
+
+/*****************************************************************************/
+/* write_wav()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* All 16 keys at each level in turn, mono, 16-bit, 48 kHz.                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static void write_wav(const char *file)
+{
+ FILE *out = fopen(file, "wb");
+ unsigned long bytes = 2UL * LEVELS * MAX_SAMPLES;
+ long count;
+ long n;
+ int level;
+
+ if ( 0 == out )
+   {
+    printf("FAIL cannot write %s\n", file);
+    failures++;
+    return;
+   }
+
+ fwrite("RIFF", 1, 4, out);
+ write_u32(out, 36 + bytes);
+ fwrite("WAVEfmt ", 1, 8, out);
+ write_u32(out, 16);
+ write_u16(out, 1);                     /* PCM                              */
+ write_u16(out, 1);
+ write_u32(out, SAMPLES_PER_SECOND);
+ write_u32(out, 2UL * SAMPLES_PER_SECOND);
+ write_u16(out, 2);
+ write_u16(out, 16);
+ fwrite("data", 1, 4, out);
+ write_u32(out, bytes);
+
+ for ( level = 0 ; level < (int) LEVELS ; level++ )
+   {
+    count = make_keys(KEYS, levels[level], 1, 1);
+
+    for ( n = 0 ; n < count ; n++ )
+      {
+       write_u16(out, (unsigned) samples[n] & 0xFFFF);
+      }
+   }
+
+ fclose(out);
+ printf("Wrote %s\n", file);
+}
+
+/*****************************************************************************/
+/* read_wav()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* 16-bit PCM at 48 kHz. Stereo is made mono as stereo_to_mono() does.       */
+/*                                                                           */
+/* RETURNS: Samples read into samples[], at most MAX_SAMPLES, or -1.         */
+/*                                                                           */
+/*****************************************************************************/
+
+static long read_wav(const char *file)
+{
+ FILE *in = fopen(file, "rb");
+ unsigned char header[44];
+ unsigned char chunk[8];
+ unsigned char frame[4];
+ unsigned long size;
+ unsigned channels = 0;
+ unsigned long rate = 0;
+ unsigned bits_per_sample = 0;
+ long count = 0;
+ int left;
+ int right;
+
+ if ( 0 == in || 12 != fread(header, 1, 12, in)
+      || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4) )
+   {
+    printf("FAIL %s is not a WAV file\n", file);
+    return -1;
+   }
+
+ while ( 8 == fread(chunk, 1, 8, in) )
+   {
+    size = chunk[4] | ( chunk[5] << 8 ) | ( (unsigned long) chunk[6] << 16 )
+           | ( (unsigned long) chunk[7] << 24 );
+
+    if ( 0 == memcmp(chunk, "fmt ", 4) && size >= 16 && size <= 40 )
+      {
+       fread(header, 1, size, in);
+       channels = header[2] | ( header[3] << 8 );
+       rate = header[4] | ( header[5] << 8 ) | ( (unsigned long) header[6] << 16 );
+       bits_per_sample = header[14] | ( header[15] << 8 );
+
+       if ( 1 != ( header[0] | ( header[1] << 8 ) ) || 16 != bits_per_sample
+            || SAMPLES_PER_SECOND != rate || channels < 1 || channels > 2 )
+         {
+          printf("FAIL %s is not 16-bit PCM at 48 kHz\n", file);
+          fclose(in);
+          return -1;
+         }
+      }
+    else if ( 0 == memcmp(chunk, "data", 4) && channels )
+      {
+       while ( count < MAX_SAMPLES * (long) LEVELS / 2 && count < MAX_SAMPLES
+               && channels == fread(frame, 2, channels, in) )
+         {
+          left = (short) ( frame[0] | ( frame[1] << 8 ) );
+          right = ( 2 == channels ) ? (short) ( frame[2] | ( frame[3] << 8 ) )
+                                    : left;
+          samples[count++] = (DATA) ( ( left + right ) / 2 );
+         }
+
+       break;
+      }
+    else
+      {
+       fseek(in, size + ( size & 1 ), SEEK_CUR);
+      }
+   }
+
+ fclose(in);
+ return count;
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ char found[MAX_SAMPLES / TONE_SAMPLES + 1];
+ long count;
+
+ if ( 2 == argc && '-' != argv[1][0] )
+   {
+    count = read_wav(argv[1]);
+
+    if ( count < 0 )
+      {
+       return 1;
+      }
+
+    decode(count, found, 1);
+    printf("%ld samples, keys %s\n", count, found);
+    return 0;
+   }
+
+ if ( 3 == argc && 0 == strcmp(argv[1], "-w") )
+   {
+    write_wav(argv[2]);
+   }
+ else if ( 1 != argc )
+   {
+    printf("Usage: goertzel_dtmf [-w out.wav | in.wav]\n");
+    return 1;
+   }
+
+ test_levels();
+ test_false();
+ test_headroom();
+ bench();
+
+ printf("%d failures\n", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of goertzel_dtmf.c                                                    */
+/*****************************************************************************/
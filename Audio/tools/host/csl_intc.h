@@ -0,0 +1,36 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 csl_intc.h                                                              */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host stand-in for inc/csl_intc.h. Only the calls used by driver code    */
+/*   that runs on a PC are declared. The host program defines them.          */
+/*                                                                           */
+/*   Put tools/host before inc in the include path.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef _CSL_INTC_H_
+#define _CSL_INTC_H_
+
+#include "usbstk5505.h"
+
+#define Bool    unsigned short
+
+#define TINT_EVENT   4
+#define I2C_EVENT    23
+
+typedef void (*IRQ_IsrPtr)(void);
+
+int  IRQ_plug(Uint16 EventId, IRQ_IsrPtr funcAddr);
+int  IRQ_enable(Uint16 EventId);
+int  IRQ_disable(Uint16 EventId);
+Bool IRQ_globalDisable();
+void IRQ_globalRestore(Bool val);
+
+#endif
+
+/*****************************************************************************/
+/* End of csl_intc.h                                                         */
+/*****************************************************************************/
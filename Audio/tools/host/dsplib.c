@@ -0,0 +1,188 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 dsplib.c                                                                */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host versions of the 55xdsph.lib functions the board code calls, so     */
+/*   that it can be run on a PC. Each gives the result DSPLIB describes, in  */
+/*   the same Q format, rounded the same way where DSPLIB says how.          */
+/*                                                                           */
+/*   Link with -lm.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <math.h>
+#include "dsplib.h"
+
+#define PI          3.14159265358979
+
+unsigned long dsplib_host_macs = 0;
+
+/*****************************************************************************/
+/* saturate()                                                                */
+/*****************************************************************************/
+
+static DATA saturate(double value)
+{
+ value = floor(value + 0.5);
+
+ if ( value > 32767.0 )
+   {
+    return 32767;
+   }
+
+ if ( value < -32768.0 )
+   {
+    return -32768;
+   }
+
+ return (DATA) value;
+}
+
+/*****************************************************************************/
+/* sine()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Angle / pi in Q15 in, sine in Q15 out.                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+ushort sine(DATA *x, DATA *r, ushort nx)
+{
+ ushort i;
+
+ for ( i = 0 ; i < nx ; i++)
+   {
+    r[i] = saturate( sin( x[i] * PI / 32768.0 ) * 32768.0 );
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* bexp()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: The left shift that brings the largest magnitude in x to the     */
+/*          top without overflow: 0 for 0x4000, 14 for 1. 15 if all are 0.   */
+/*                                                                           */
+/*****************************************************************************/
+
+short bexp(DATA *x, ushort nx)
+{
+ long largest = 0;
+ long magnitude;
+ short exponent;
+ ushort i;
+
+ for ( i = 0 ; i < nx ; i++)
+   {
+    magnitude = ( x[i] < 0 ) ? -1L - x[i] : x[i];
+
+    if ( magnitude > largest )
+      {
+       largest = magnitude;
+      }
+   }
+
+ for ( exponent = 0 ; exponent < 15 && largest < 0x4000 ; exponent++)
+   {
+    largest <<= 1;
+
+    if ( 0 == largest )
+      {
+       return 15;
+      }
+   }
+
+ return exponent;
+}
+
+/*****************************************************************************/
+/* autocorrelate()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Lags 0 to nr - 1 of x, Q15, divided by nx when bias is set and by nx - j  */
+/* for lag j when it is not.                                                 */
+/*                                                                           */
+/* RETURNS: 1 if a lag saturated, as the DSPLIB overflow flag.               */
+/*                                                                           */
+/*****************************************************************************/
+
+static ushort autocorrelate(DATA *x, DATA *r, ushort nx, ushort nr, int bias)
+{
+ ushort overflow = 0;
+ double sum;
+ ushort i;
+ ushort j;
+
+ for ( j = 0 ; j < nr ; j++)
+   {
+    sum = 0.0;
+
+    for ( i = 0 ; i + j < nx ; i++)
+      {
+       sum += (double) x[i] * x[i + j];
+      }
+
+    dsplib_host_macs += nx - j;
+    sum = sum / 32768.0 / ( bias ? nx : nx - j );
+    r[j] = saturate(sum);
+
+    if ( sum > 32767.0 || sum < -32768.0 )
+      {
+       overflow = 1;
+      }
+   }
+
+ return overflow;
+}
+
+/*****************************************************************************/
+/* acorr_bias() and acorr_unbias()                                           */
+/*****************************************************************************/
+
+ushort acorr_bias(DATA *x, DATA *r, ushort nx, ushort nr)
+{
+ return autocorrelate(x, r, nx, nr, 1);
+}
+
+ushort acorr_unbias(DATA *x, DATA *r, ushort nx, ushort nr)
+{
+ return autocorrelate(x, r, nx, nr, 0);
+}
+
+/*****************************************************************************/
+/* rand16init() and rand16()                                                 */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The linear congruential generator of DSPLIB, seed = 31821 * seed + 13849  */
+/* modulo 2^16 from a seed of 21845, so the host gives the same sequence as  */
+/* the board. Each output is the new seed as a signed Q15 value.             */
+/*                                                                           */
+/*****************************************************************************/
+
+static unsigned int rand16_seed = 21845;
+
+void rand16init(void)
+{
+ rand16_seed = 21845;
+}
+
+ushort rand16(DATA *r, ushort nr)
+{
+ ushort i;
+
+ for ( i = 0 ; i < nr ; i++)
+   {
+    rand16_seed = ( rand16_seed * 31821u + 13849u ) & 0xFFFF;
+    r[i] = (DATA) (short) rand16_seed;
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* End of dsplib.c                                                           */
+/*****************************************************************************/
@@ -0,0 +1,24 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 dsplib.h                                                                */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host stand-in for inc/Dsplib.h. The prototypes are the same. The        */
+/*   functions the board code calls are in tools/host/dsplib.c, written in   */
+/*   C from the DSPLIB descriptions, as 55xdsph.lib only runs on the C55x.   */
+/*                                                                           */
+/*   Put tools/host before inc in the include path.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "../../inc/Dsplib.h"
+
+/* Multiply-accumulates done by the functions in tools/host/dsplib.c, for    */
+/* tools that check a cycle budget.                                          */
+
+extern unsigned long dsplib_host_macs;
+
+/*****************************************************************************/
+/* End of dsplib.h                                                           */
+/*****************************************************************************/
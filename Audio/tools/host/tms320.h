@@ -0,0 +1,18 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 tms320.h                                                                */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host stand-in for inc/TMS320.H. The sources include it in lower case,   */
+/*   which only finds it on a file system that ignores case.                 */
+/*                                                                           */
+/*   Put tools/host before inc in the include path.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#include "../../inc/TMS320.H"
+
+/*****************************************************************************/
+/* End of tms320.h                                                           */
+/*****************************************************************************/
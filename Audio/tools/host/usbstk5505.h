@@ -0,0 +1,96 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 usbstk5505.h                                                            */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host stand-in for inc/usbstk5505.h so that board code can be compiled   */
+/*   and run on a PC. Peripheral registers are ordinary variables in         */
+/*   host_ioport[], indexed by their I/O address.                            */
+/*                                                                           */
+/*   Put tools/host before inc in the include path.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef STK5505_
+#define STK5505_
+
+/* ------------------------------------------------------------------------ *
+ *  Variable types                                                          *
+ * ------------------------------------------------------------------------ */
+
+#define Uint32  unsigned long
+#define Uint16  unsigned short
+#define Uint8   unsigned char
+#define Int32   int
+#define Int16   short
+#define Int8    char
+
+#define SW_BREAKPOINT      while(1);
+
+#define ioport
+#define interrupt
+
+extern volatile Uint16 host_ioport[0x10000];
+
+/* ------------------------------------------------------------------------ *
+ *  System Module                                                           *
+ * ------------------------------------------------------------------------ */
+#define SYS_EXBUSSEL       host_ioport[0x1c00]
+#define SYS_PCGCR1         host_ioport[0x1c02]
+#define SYS_PCGCR2         host_ioport[0x1c03]
+#define SYS_PRCNTR         host_ioport[0x1c04]
+#define SYS_PRCNTRLR       host_ioport[0x1c05]
+#define SYS_GPIO_DIR0      host_ioport[0x1c06]
+#define SYS_GPIO_DIR1      host_ioport[0x1c07]
+#define SYS_GPIO_DATAIN0   host_ioport[0x1c08]
+#define SYS_GPIO_DATAIN1   host_ioport[0x1c09]
+#define SYS_GPIO_DATAOUT0  host_ioport[0x1c0a]
+#define SYS_GPIO_DATAOUT1  host_ioport[0x1c0b]
+#define SYS_OUTDRSTR       host_ioport[0x1c16]
+#define SYS_SPPDIR         host_ioport[0x1c17]
+
+/* ------------------------------------------------------------------------ *
+ *  I2C Module                                                              *
+ * ------------------------------------------------------------------------ */
+#define I2C_IER            host_ioport[0x1A04]
+#define I2C_STR            host_ioport[0x1A08]
+#define I2C_CLKL           host_ioport[0x1A0C]
+#define I2C_CLKH           host_ioport[0x1A10]
+#define I2C_CNT            host_ioport[0x1A14]
+#define I2C_DRR            host_ioport[0x1A18]
+#define I2C_SAR            host_ioport[0x1A1C]
+#define I2C_DXR            host_ioport[0x1A20]
+#define I2C_MDR            host_ioport[0x1A24]
+#define I2C_IVR            host_ioport[0x1A28]
+#define I2C_EDR            host_ioport[0x1A2C]
+#define I2C_PSC            host_ioport[0x1A30]
+
+/* ------------------------------------------------------------------------ *
+ *  I2S Module                                                              *
+ * ------------------------------------------------------------------------ */
+#define I2S0_CR            host_ioport[0x2800]
+#define I2S0_SRGR          host_ioport[0x2804]
+#define I2S0_W0_LSW_W      host_ioport[0x2808]
+#define I2S0_W0_MSW_W      host_ioport[0x2809]
+#define I2S0_W1_LSW_W      host_ioport[0x280C]
+#define I2S0_W1_MSW_W      host_ioport[0x280D]
+#define I2S0_IR            host_ioport[0x2810]
+#define I2S0_ICMR          host_ioport[0x2814]
+#define I2S0_W0_LSW_R      host_ioport[0x2828]
+#define I2S0_W0_MSW_R      host_ioport[0x2829]
+#define I2S0_W1_LSW_R      host_ioport[0x282C]
+#define I2S0_W1_MSW_R      host_ioport[0x282D]
+
+/* Board Initialization */
+Int16 USBSTK5505_init( );
+
+/* Wait Functions */
+void USBSTK5505_wait( Uint32 delay );
+void USBSTK5505_waitusec( Uint32 usec );
+
+#endif
+
+/*****************************************************************************/
+/* End of usbstk5505.h                                                       */
+/*****************************************************************************/
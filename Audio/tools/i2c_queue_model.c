@@ -0,0 +1,753 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 i2c_queue_model.c                                                       */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick I2C transaction queue.       */
+/*                                                                           */
+/*   Runs i2c_queue.c and aic3204.c on a PC against a model of the I2C       */
+/*   module and the bus. The model watches I2C_MDR for a START, then raises  */
+/*   the XRDY, RRDY, NACK, AL and SCD events in the order the module would,  */
+/*   setting I2C_IVR and calling i2c_queue_isr() for each one that is        */
+/*   enabled in I2C_IER. Slaves are register files with an address pointer  */
+/*   and, at 0x18, a page register like the AIC3204.                         */
+/*                                                                           */
+/*   A fault can be put on the next transaction: no acknowledge of the       */
+/*   address or of a data byte, lost arbitration, or a bus that stops so    */
+/*   only the timer tick can end the transaction.                            */
+/*                                                                           */
+/*   The tests check that callbacks come in the order transactions were      */
+/*   queued, that a full queue rejects transactions without losing any,     */
+/*   that every fault is reported and the next transaction still goes       */
+/*   through, and that queued AIC3204 writes use the shadow and forget it    */
+/*   after an error.                                                          */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o i2c_queue_model tools/i2c_queue_model.c       */
+/*       src/i2c_queue.c src/aic3204.c                                       */
+/*                                                                           */
+/*   i2c_queue_model       Run the tests. Exit status is the failure count. */
+/*   i2c_queue_model -v    Also list every bus transaction.                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "usbstk5505.h"
+#include "usbstk5505_i2c.h"
+#include "csl_intc.h"
+#include "i2c_queue.h"
+#include "aic3204.h"
+#include "delay.h"
+
+#define CODEC_ADDRESS   0x18
+#define EEPROM_ADDRESS  0x50
+#define ABSENT_ADDRESS  0x33
+
+#define LOG_SIZE        64
+
+volatile Uint16 host_ioport[0x10000];
+
+typedef enum
+{
+    FAULT_NONE,
+    FAULT_NACK_ADDRESS,
+    FAULT_NACK_DATA,                /* Second byte is not acknowledged      */
+    FAULT_ARBITRATION,
+    FAULT_STUCK
+} FAULT;
+
+typedef struct
+{
+    Uint16 address;
+    Uint16 page;
+    Uint16 pointer;
+    Uint8 registers[4][128];
+} SLAVE;
+
+typedef struct
+{
+    int id;
+    Int16 status;
+    Uint16 length;
+    Uint8 data[I2C_QUEUE_MAX_BYTES];
+} COMPLETION;
+
+static int verbose = 0;
+static int failures = 0;
+
+static IRQ_IsrPtr i2c_isr = 0;
+static int i2c_enabled = 0;
+static Bool global_disabled = 0;
+
+static SLAVE slaves[2];
+static FAULT fault_next = FAULT_NONE;
+static unsigned long resets = 0;
+static unsigned long bus_transactions = 0;
+
+static COMPLETION log_entries[LOG_SIZE];
+static int log_count = 0;
+
+/*****************************************************************************/
+/* Stand-ins for the chip support and board support libraries                */
+/*****************************************************************************/
+
+int IRQ_plug(Uint16 EventId, IRQ_IsrPtr funcAddr)
+{
+ if ( I2C_EVENT == EventId )
+   {
+    i2c_isr = funcAddr;
+   }
+ return 0;
+}
+
+int IRQ_enable(Uint16 EventId)
+{
+ if ( I2C_EVENT == EventId )
+   {
+    i2c_enabled = 1;
+   }
+ return 0;
+}
+
+int IRQ_disable(Uint16 EventId)
+{
+ if ( I2C_EVENT == EventId )
+   {
+    i2c_enabled = 0;
+   }
+ return 0;
+}
+
+Bool IRQ_globalDisable()
+{
+ Bool old = global_disabled;
+
+ global_disabled = 1;
+ return old;
+}
+
+void IRQ_globalRestore(Bool val)
+{
+ global_disabled = val;
+}
+
+void delay_us( Uint32 us ) { }
+
+/* As delay.c before delay_init(): a timeout counts the calls to           */
+/* delay_timeout_expired(), 8 per us.                                      */
+
+void delay_timeout_start( DELAY_TIMEOUT *timeout, Uint32 us )
+{
+ timeout->start = 0;
+ timeout->ticks = us * 8;
+}
+
+Int16 delay_timeout_expired( DELAY_TIMEOUT *timeout )
+{
+ return ( ++timeout->start > timeout->ticks );
+}
+
+Int16 USBSTK5505_GPIO_init( ) { return 0; }
+Int16 USBSTK5505_GPIO_setDirection( Uint16 number, Uint16 direction ) { return 0; }
+Int16 USBSTK5505_GPIO_setOutput( Uint16 number, Uint16 output ) { return 0; }
+Int16 USBSTK5505_I2C_write( Uint16 i2c_addr, Uint8* data, Uint16 len ) { return 0; }
+Int16 USBSTK5505_I2C_read( Uint16 i2c_addr, Uint8* data, Uint16 len ) { return 0; }
+
+Int16 USBSTK5505_I2C_init( )
+{
+ I2C_MDR = 0x0420;
+ return 0;
+}
+
+Int16 USBSTK5505_I2C_close( )
+{
+ I2C_MDR = 0;
+ return 0;
+}
+
+Int16 USBSTK5505_I2C_reset( )
+{
+ resets++;
+ USBSTK5505_I2C_close( );
+ USBSTK5505_I2C_init( );
+ return 0;
+}
+
+/*****************************************************************************/
+/* raise()                                                                   */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 1 if the event was enabled and the interrupt was taken.          */
+/*                                                                           */
+/*****************************************************************************/
+
+static int raise( Uint16 code, Uint16 flag )
+{
+ I2C_STR |= flag;
+
+ if ( !( I2C_IER & flag ) || !i2c_enabled || global_disabled || !i2c_isr )
+   {
+    return 0;
+   }
+
+ I2C_IVR = code;
+ i2c_isr();
+ I2C_IVR = 0;
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* find_slave()                                                              */
+/*****************************************************************************/
+
+static SLAVE *find_slave( Uint16 address )
+{
+ int i;
+
+ for ( i = 0 ; i < 2 ; i++)
+   {
+    if ( slaves[i].address == address )
+      {
+       return &slaves[i];
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* slave_write()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* First byte sets the address pointer, the rest are written from there.     */
+/* Register 0 of the codec is the page select.                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static void slave_write( SLAVE *slave, Uint16 n, Uint8 byte )
+{
+ if ( 0 == n )
+   {
+    slave->pointer = byte & 0x7F;
+    return;
+   }
+
+ if ( CODEC_ADDRESS == slave->address && 0 == slave->pointer )
+   {
+    slave->page = byte & 3;
+   }
+ else
+   {
+    slave->registers[slave->page][slave->pointer] = byte;
+   }
+
+ slave->pointer = ( slave->pointer + 1 ) & 0x7F;
+}
+
+/*****************************************************************************/
+/* bus_transaction()                                                         */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* One transaction from the START set by start() in i2c_queue.c to the STOP. */
+/*                                                                           */
+/*****************************************************************************/
+
+static void bus_transaction( void )
+{
+ FAULT fault = fault_next;
+ SLAVE *slave = find_slave( I2C_SAR );
+ Uint16 count = I2C_CNT;
+ Uint16 transmit = I2C_MDR & MDR_TRX;
+ Uint16 n;
+ Uint16 nack = 0;
+ Uint8 bytes[I2C_QUEUE_MAX_BYTES];
+
+ fault_next = FAULT_NONE;
+ I2C_MDR &= ~MDR_STT;               /* START has been sent */
+ I2C_STR = 0;                       /* Host cannot model write 1 to clear */
+ bus_transactions++;
+
+ if ( FAULT_STUCK == fault )
+   {
+    if ( verbose )
+      {
+       printf("  bus %02X: stuck\n", I2C_SAR);
+      }
+    return;
+   }
+
+ if ( FAULT_ARBITRATION == fault )
+   {
+    if ( verbose )
+      {
+       printf("  bus %02X: arbitration lost\n", I2C_SAR);
+      }
+    I2C_MDR &= ~MDR_MST;
+    raise( 1, STR_AL );
+    return;
+   }
+
+ n = 0;
+
+ if ( !slave || FAULT_NACK_ADDRESS == fault )
+   {
+    nack = 1;
+    raise( 2, STR_NACK );
+   }
+ else
+   {
+    for ( n = 0 ; n < count ; n++)
+      {
+       if ( transmit )
+         {
+          if ( !raise( 5, STR_XRDY ) )
+            {
+             break;
+            }
+          bytes[n] = I2C_DXR;
+          I2C_STR &= ~STR_XRDY;
+
+          if ( FAULT_NACK_DATA == fault && 1 == n )
+            {
+             n++;
+             nack = 1;
+             raise( 2, STR_NACK );
+             break;
+            }
+
+          slave_write( slave, n, bytes[n] );
+         }
+       else
+         {
+          bytes[n] = slave->registers[slave->page][slave->pointer];
+          slave->pointer = ( slave->pointer + 1 ) & 0x7F;
+          I2C_DRR = bytes[n];
+
+          if ( !raise( 4, STR_RRDY ) )
+            {
+             break;
+            }
+          I2C_STR &= ~STR_RRDY;
+         }
+      }
+   }
+
+ if ( verbose )
+   {
+    Uint16 i;
+
+    printf("  bus %02X %c:", I2C_SAR, transmit ? 'W' : 'R');
+    for ( i = 0 ; i < n ; i++)
+      {
+       printf(" %02X", bytes[i]);
+      }
+    printf("%s\n", nack ? " NACK" : "");
+   }
+
+ /* After a NACK the driver must ask for the STOP itself */
+
+ if ( nack && !( I2C_MDR & MDR_STP ) )
+   {
+    printf("FAIL: no STOP requested after NACK\n");
+    failures++;
+    return;
+   }
+
+ I2C_MDR &= ~( MDR_STP | MDR_MST );
+ raise( 6, STR_SCD );
+}
+
+/*****************************************************************************/
+/* bus_run()                                                                 */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Carry out transactions until the queue is empty. A transaction that does  */
+/* not finish is left to the timer tick.                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+static void bus_run( void )
+{
+ int idle = 0;
+
+ while ( i2c_queue_pending( ) && idle < 100 )
+   {
+    if ( I2C_MDR & MDR_STT )
+      {
+       bus_transaction( );
+       idle = 0;
+      }
+    else
+      {
+       i2c_queue_tick( );
+       idle++;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* record()                                                                  */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Callback for the tests. The context is the transaction number.            */
+/*                                                                           */
+/*****************************************************************************/
+
+static void record( Int16 status, Uint8 *data, Uint16 length, void *context )
+{
+ COMPLETION *c;
+
+ if ( log_count >= LOG_SIZE )
+   {
+    return;
+   }
+
+ c = &log_entries[log_count++];
+ c->id = (int) (long) context;
+ c->status = status;
+ c->length = length;
+
+ if ( data )
+   {
+    memcpy(c->data, data, length);
+   }
+}
+
+/*****************************************************************************/
+/* check()                                                                   */
+/*****************************************************************************/
+
+static void check( int condition, const char *test, const char *what )
+{
+ if ( !condition )
+   {
+    printf("FAIL: %s: %s\n", test, what);
+    failures++;
+   }
+}
+
+/*****************************************************************************/
+/* reset_model()                                                             */
+/*****************************************************************************/
+
+static void reset_model( void )
+{
+ memset(slaves, 0, sizeof(slaves));
+ slaves[0].address = CODEC_ADDRESS;
+ slaves[1].address = EEPROM_ADDRESS;
+
+ memset((void *) host_ioport, 0, sizeof(host_ioport));
+ fault_next = FAULT_NONE;
+ resets = 0;
+ bus_transactions = 0;
+ log_count = 0;
+
+ USBSTK5505_I2C_init( );
+ i2c_queue_init( );
+}
+
+/*****************************************************************************/
+/* test_order()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Writes and reads to two slaves come back in the order they were queued,   */
+/* and the reads see the writes before them.                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_order( void )
+{
+ const char *test = "order";
+ Uint8 cmd[4];
+ int i;
+ int in_order = 1;
+
+ reset_model( );
+
+ for ( i = 0 ; i < 6 ; i++)
+   {
+    cmd[0] = 0x10 + i;
+    cmd[1] = 0xA0 + i;
+    i2c_queue_write(( i & 1 ) ? EEPROM_ADDRESS : CODEC_ADDRESS, cmd, 2,
+                    record, (void *) (long) i);
+   }
+
+ cmd[0] = 0x10;
+ i2c_queue_write(CODEC_ADDRESS, cmd, 1, record, (void *) 6L);
+ i2c_queue_read(CODEC_ADDRESS, 5, record, (void *) 7L);
+
+ bus_run( );
+
+ check(8 == log_count, test, "8 callbacks");
+
+ for ( i = 0 ; i < log_count ; i++)
+   {
+    in_order &= ( log_entries[i].id == i );
+    in_order &= ( I2C_QUEUE_OK == log_entries[i].status );
+   }
+
+ check(in_order, test, "callbacks in queued order with no error");
+ check(5 == log_entries[7].length, test, "5 bytes read");
+ check(0xA0 == log_entries[7].data[0] && 0xA2 == log_entries[7].data[2]
+       && 0xA4 == log_entries[7].data[4], test, "read data");
+ check(0xA1 == slaves[1].registers[0][0x11], test, "second slave written");
+ check(8 == i2c_queue_stats.completed, test, "completed count");
+ check(0 == I2C_IER, test, "interrupts off when idle");
+}
+
+/*****************************************************************************/
+/* test_full()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* With the bus held, only I2C_QUEUE_SIZE transactions fit. None of those    */
+/* accepted is lost and the queue takes more once it has drained.            */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_full( void )
+{
+ const char *test = "full";
+ Uint8 cmd[2] = { 0x20, 0x55 };
+ int accepted = 0;
+ int rejected = 0;
+ int i;
+ int in_order = 1;
+
+ reset_model( );
+
+ for ( i = 0 ; i < I2C_QUEUE_SIZE + 3 ; i++)
+   {
+    if ( I2C_QUEUE_OK == i2c_queue_write(CODEC_ADDRESS, cmd, 2, record,
+                                         (void *) (long) accepted) )
+      {
+       accepted++;
+      }
+    else
+      {
+       rejected++;
+      }
+   }
+
+ check(I2C_QUEUE_SIZE == accepted, test, "I2C_QUEUE_SIZE accepted");
+ check(3 == rejected && 3 == i2c_queue_stats.overflows, test, "3 rejected");
+ check(I2C_QUEUE_FULL == i2c_queue_write(CODEC_ADDRESS, cmd,
+                                         I2C_QUEUE_MAX_BYTES + 1, 0, 0),
+       test, "too long rejected");
+
+ bus_run( );
+
+ for ( i = 0 ; i < log_count ; i++)
+   {
+    in_order &= ( log_entries[i].id == i );
+   }
+
+ check(I2C_QUEUE_SIZE == log_count && in_order, test, "all completed in order");
+ check(I2C_QUEUE_OK == i2c_queue_write(CODEC_ADDRESS, cmd, 2, 0, 0),
+       test, "accepts again after draining");
+ bus_run( );
+}
+
+/*****************************************************************************/
+/* test_recovery()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Each fault is reported on its own transaction and the one after it still */
+/* reaches the slave.                                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_recovery( void )
+{
+ static const FAULT faults[5] = { FAULT_NACK_ADDRESS, FAULT_NACK_DATA,
+                                  FAULT_ARBITRATION, FAULT_STUCK,
+                                  FAULT_NONE };
+ static const Int16 expected[5] = { I2C_QUEUE_NACK, I2C_QUEUE_NACK,
+                                    I2C_QUEUE_ARBITRATION, I2C_QUEUE_TIMEOUT,
+                                    I2C_QUEUE_NACK };
+ const char *test = "recovery";
+ char what[64];
+ Uint8 cmd[3];
+ int i;
+
+ for ( i = 0 ; i < 5 ; i++)
+   {
+    reset_model( );
+
+    cmd[0] = 0x30;
+    cmd[1] = 0x11;
+    cmd[2] = 0x22;
+    i2c_queue_write(CODEC_ADDRESS, cmd, 3, record, (void *) 0L);
+
+    /* The last case writes to a slave that is not there */
+
+    i2c_queue_write(( FAULT_NONE == faults[i] ) ? ABSENT_ADDRESS
+                    : CODEC_ADDRESS, cmd, 3, record, (void *) 1L);
+
+    cmd[0] = 0x40;
+    cmd[1] = 0x33 + i;
+    i2c_queue_write(CODEC_ADDRESS, cmd, 2, record, (void *) 2L);
+
+    /* The first transaction is already on the bus, so the fault must */
+    /* wait for the second one                                        */
+
+    fault_next = FAULT_NONE;
+    bus_transaction( );
+    fault_next = faults[i];
+    bus_run( );
+
+    sprintf(what, "case %d: 3 callbacks in order", i);
+    check(3 == log_count && 0 == log_entries[0].id && 1 == log_entries[1].id
+          && 2 == log_entries[2].id, test, what);
+
+    sprintf(what, "case %d: status %d", i, log_entries[1].status);
+    check(I2C_QUEUE_OK == log_entries[0].status
+          && expected[i] == log_entries[1].status
+          && I2C_QUEUE_OK == log_entries[2].status, test, what);
+
+    sprintf(what, "case %d: write after the fault", i);
+    check(0x33 + i == slaves[0].registers[0][0x40], test, what);
+
+    sprintf(what, "case %d: module reset", i);
+    check(resets == ( FAULT_ARBITRATION == faults[i]
+                      || FAULT_STUCK == faults[i] ), test, what);
+
+    sprintf(what, "case %d: error counted", i);
+    check(1 == i2c_queue_stats.errors + i2c_queue_stats.timeouts
+          && 2 == i2c_queue_stats.completed, test, what);
+   }
+}
+
+/*****************************************************************************/
+/* chain()                                                                   */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Callback that queues another write until the context reaches zero.        */
+/*                                                                           */
+/*****************************************************************************/
+
+static void chain( Int16 status, Uint8 *data, Uint16 length, void *context )
+{
+ long remaining = (long) context;
+ Uint8 cmd[2];
+
+ record(status, data, length, context);
+
+ if ( remaining > 0 )
+   {
+    cmd[0] = 0x50 + remaining;
+    cmd[1] = remaining;
+    i2c_queue_write(CODEC_ADDRESS, cmd, 2, chain, (void *) ( remaining - 1 ));
+   }
+}
+
+/*****************************************************************************/
+/* test_chain()                                                              */
+/*****************************************************************************/
+
+static void test_chain( void )
+{
+ const char *test = "chain";
+ Uint8 cmd[2] = { 0x50, 0 };
+ Uint8 other[2] = { 0x60, 0x77 };
+
+ reset_model( );
+
+ i2c_queue_write(CODEC_ADDRESS, cmd, 2, chain, (void *) 3L);
+ i2c_queue_write(CODEC_ADDRESS, other, 2, record, (void *) 99L);
+ bus_run( );
+
+ check(5 == log_count, test, "5 callbacks");
+ check(3 == log_entries[0].id && 99 == log_entries[1].id
+       && 2 == log_entries[2].id && 0 == log_entries[4].id, test,
+       "queued from callback goes after what was already queued");
+ check(1 == slaves[0].registers[0][0x51] && 3 == slaves[0].registers[0][0x53],
+       test, "chained writes reached the slave");
+}
+
+/*****************************************************************************/
+/* test_aic3204()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Queued codec writes select the page only when it changes, leave out       */
+/* writes the codec already has, and send everything again after an error.  */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_aic3204( void )
+{
+ const char *test = "aic3204";
+ unsigned long before;
+
+ reset_model( );
+ aic3204_hardware_init( );
+ memset(&aic3204_stats, 0, sizeof(aic3204_stats));
+
+ aic3204_pga_gain_async(40, record, (void *) 0L);
+ aic3204_volume_async(-12, record, (void *) 1L);
+ aic3204_mute_async(1, record, (void *) 2L);
+ bus_run( );
+
+ check(3 == log_count && 2 == log_entries[2].id, test, "3 callbacks");
+ check(40 == slaves[0].registers[1][0x3b] && 40 == slaves[0].registers[1][0x3c],
+       test, "PGA gain on page 1");
+ check(0xF4 == slaves[0].registers[0][65], test, "DAC volume on page 0");
+ check(0x0E == slaves[0].registers[0][64], test, "DAC muted");
+ check(5 == bus_transactions, test, "two page selects and three writes");
+
+ /* Already in the codec. Callback before the call returns */
+
+ before = bus_transactions;
+ aic3204_pga_gain_async(40, record, (void *) 3L);
+ check(4 == log_count && I2C_QUEUE_OK == log_entries[3].status
+       && 0 == i2c_queue_pending( ), test, "repeated gain not sent");
+ bus_run( );
+ check(before == bus_transactions, test, "no bus traffic");
+
+ /* An error makes the driver forget the shadow and the page */
+
+ fault_next = FAULT_NACK_DATA;
+ aic3204_volume_async(-20, record, (void *) 4L);
+ bus_run( );
+ check(5 == log_count && I2C_QUEUE_NACK == log_entries[4].status
+       && 1 == aic3204_stats.async_errors, test, "error reported");
+
+ before = bus_transactions;
+ aic3204_pga_gain_async(40, record, (void *) 5L);
+ bus_run( );
+ check(before + 2 == bus_transactions, test, "gain sent again after error");
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main( int argc, char *argv[] )
+{
+ if ( argc > 1 && 0 == strcmp(argv[1], "-v") )
+   {
+    verbose = 1;
+   }
+
+ if ( verbose ) printf("order\n");
+ test_order( );
+ if ( verbose ) printf("full\n");
+ test_full( );
+ if ( verbose ) printf("recovery\n");
+ test_recovery( );
+ if ( verbose ) printf("chain\n");
+ test_chain( );
+ if ( verbose ) printf("aic3204\n");
+ test_aic3204( );
+
+ printf("%s: %d failures\n", failures ? "FAIL" : "PASS", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of i2c_queue_model.c                                                  */
+/*****************************************************************************/
@@ -0,0 +1,347 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 log_decode.c                                                            */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick binary log.                  */
+/*                                                                           */
+/*   Turns the records written by log_write() back into text, using the      */
+/*   formats in log_formats.h, with the time of each in ms. Build from the   */
+/*   same log_formats.h as the program that wrote the log.                   */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o log_decode tools/log_decode.c                 */
+/*                                                                           */
+/*   log_decode file       Raw bytes from the UART, LOG_SINK_UART. For       */
+/*                         example saved by a terminal program or with       */
+/*                         cat /dev/ttyUSB0 > file on Linux.                 */
+/*   log_decode -m file    log_buffer[] saved from the debugger with Save    */
+/*                         Memory in TI Data format, LOG_SINK_RAM.           */
+/*                                                                           */
+/*   Times are worked out from the LOG_CLOCK record that log_init() writes.  */
+/*   Records before it, or without it, are shown in timer ticks. A later     */
+/*   LOG_CLOCK, after the clock has been changed, applies from its own time  */
+/*   on. The 32-bit timer wraps after about 86 s at 100 MHz; the wrap is     */
+/*   taken out as long as records are less than that apart.                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log.h"
+
+#define MEMORY_RECORD_WORDS 10  /* sizeof(LOG_RECORD) on the C55x           */
+
+static const char *const formats[LOG_FORMATS] =
+{
+    "",
+#define LOG_FORMAT(id, format)  format,
+#include "log_formats.h"
+#undef LOG_FORMAT
+};
+
+static unsigned long ticks_per_ms = 0;
+static unsigned long last_ticks = 0;
+static double wraps = 0.0;              /* Ticks added for timer wrap       */
+static double base_ticks = 0.0;         /* Time of the last LOG_CLOCK       */
+static double base_ms = 0.0;
+static unsigned long records = 0;
+static unsigned long bad_frames = 0;
+
+/*****************************************************************************/
+/* argument_is_signed()                                                      */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The C55x long is 32 bits. The host long may be wider, so each argument    */
+/* is sign extended only if its conversion in the format is %ld or %li.      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int argument_is_signed(const char *format, int argument)
+{
+ const char *p = format;
+
+ while ( ( p = strchr(p, '%') ) != NULL )
+   {
+    p++;
+
+    if ( '%' == *p )
+      {
+       p++;
+       continue;
+      }
+
+    p += strcspn(p, "diouxXcs");
+
+    if ( 0 == argument-- )
+      {
+       return ( 'd' == *p || 'i' == *p );
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* print_record()                                                            */
+/*****************************************************************************/
+
+static void print_record(unsigned int id, unsigned long ticks,
+                         const unsigned long args[LOG_ARGS])
+{
+ long values[LOG_ARGS];
+ double t;
+ int i;
+
+ if ( 0 == ticks )
+   {
+    if ( LOG_CLOCK == id && args[0] != 0 )
+      {
+       ticks_per_ms = args[0];
+      }
+
+    printf("%14s  ", "-");              /* Before delay_init()              */
+   }
+ else
+   {
+    if ( ticks < last_ticks )
+      {
+       wraps += 4294967296.0;
+      }
+
+    last_ticks = ticks;
+    t = wraps + ticks;
+
+    if ( LOG_CLOCK == id && args[0] != 0 )
+      {
+       if ( ticks_per_ms )
+         {
+          base_ms += ( t - base_ticks ) / ticks_per_ms;
+         }
+       else
+         {
+          base_ms = t / args[0];
+         }
+
+       base_ticks = t;
+       ticks_per_ms = args[0];
+      }
+
+    if ( ticks_per_ms )
+      {
+       printf("%11.3f ms  ", base_ms + ( t - base_ticks ) / ticks_per_ms);
+      }
+    else
+      {
+       printf("%8.0f ticks  ", t);
+      }
+   }
+
+ if ( id >= LOG_FORMATS || LOG_EMPTY == id )
+   {
+    printf("Unknown message %u: %08lx %08lx %08lx\n", id, args[0], args[1],
+           args[2]);
+    return;
+   }
+
+ for ( i = 0 ; i < LOG_ARGS ; i++)
+   {
+    if ( argument_is_signed(formats[id], i) && ( args[i] & 0x80000000UL ) )
+      {
+       values[i] = -(long) ( 0x100000000ULL - args[i] );
+      }
+    else
+      {
+       values[i] = (long) args[i];
+      }
+   }
+
+ printf(formats[id], values[0], values[1], values[2]);
+ printf("\n");
+ records++;
+}
+
+/*****************************************************************************/
+/* little_endian()                                                           */
+/*****************************************************************************/
+
+static unsigned long little_endian(const unsigned char *bytes, int count)
+{
+ unsigned long value = 0;
+
+ while ( count-- > 0 )
+   {
+    value = ( value << 8 ) | bytes[count];
+   }
+
+ return value;
+}
+
+/*****************************************************************************/
+/* decode_uart()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Frames as made by log_drain(). After a bad checksum the next LOG_SYNC     */
+/* byte is tried, so a capture started part way through a frame decodes.     */
+/*                                                                           */
+/*****************************************************************************/
+
+static void decode_uart(FILE *f)
+{
+ unsigned char frame[LOG_FRAME_BYTES];
+ unsigned long args[LOG_ARGS];
+ unsigned int sum;
+ size_t have = 0;
+ int i;
+
+ for (;;)
+   {
+    have += fread(frame + have, 1, LOG_FRAME_BYTES - have, f);
+
+    if ( have < LOG_FRAME_BYTES )
+      {
+       break;
+      }
+
+    for ( sum = 0, i = 1 ; i < LOG_FRAME_BYTES ; i++)
+      {
+       sum += frame[i];
+      }
+
+    if ( LOG_SYNC != frame[0] || ( sum & 0xFF ) != 0 )
+      {
+       if ( LOG_SYNC == frame[0] )
+         {
+          bad_frames++;
+         }
+
+       /* Move on to the next LOG_SYNC byte */
+
+       for ( i = 1 ; i < LOG_FRAME_BYTES && LOG_SYNC != frame[i] ; i++)
+         {
+         }
+
+       have = LOG_FRAME_BYTES - i;
+       memmove(frame, frame + i, have);
+       continue;
+      }
+
+    for ( i = 0 ; i < LOG_ARGS ; i++)
+      {
+       args[i] = little_endian(&frame[7 + 4 * i], 4);
+      }
+
+    print_record(little_endian(&frame[1], 2), little_endian(&frame[3], 4),
+                 args);
+    have = 0;
+   }
+}
+
+/*****************************************************************************/
+/* decode_memory()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* TI Data format: a header line starting 1651, then one word per line as    */
+/* 0x1234. Each 32-bit value is most significant word first. Records run     */
+/* from log_buffer[0] until the first one never written.                     */
+/*                                                                           */
+/*****************************************************************************/
+
+static void decode_memory(FILE *f)
+{
+ unsigned long words[MEMORY_RECORD_WORDS];
+ unsigned long args[LOG_ARGS];
+ char line[80];
+ int count = 0;
+ int i;
+
+ while ( fgets(line, sizeof(line), f) )
+   {
+    if ( 0 == strncmp(line, "1651", 4) )
+      {
+       continue;
+      }
+
+    words[count++] = strtoul(line, NULL, 16) & 0xFFFF;
+
+    if ( count < MEMORY_RECORD_WORDS )
+      {
+       continue;
+      }
+
+    count = 0;
+
+    if ( LOG_EMPTY == words[2 + 2 * LOG_ARGS] )
+      {
+       break;
+      }
+
+    for ( i = 0 ; i < LOG_ARGS ; i++)
+      {
+       args[i] = ( words[2 + 2 * i] << 16 ) | words[3 + 2 * i];
+      }
+
+    print_record(words[2 + 2 * LOG_ARGS], ( words[0] << 16 ) | words[1],
+                 args);
+   }
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ int memory = 0;
+ FILE *f;
+
+ if ( argc > 1 && 0 == strcmp(argv[1], "-m") )
+   {
+    memory = 1;
+    argc--;
+    argv++;
+   }
+
+ if ( argc != 2 )
+   {
+    fprintf(stderr, "Usage: log_decode [-m] file\n");
+    return 2;
+   }
+
+ f = fopen(argv[1], memory ? "r" : "rb");
+
+ if ( NULL == f )
+   {
+    perror(argv[1]);
+    return 1;
+   }
+
+ if ( memory )
+   {
+    decode_memory(f);
+   }
+ else
+   {
+    decode_uart(f);
+   }
+
+ fclose(f);
+
+ fprintf(stderr, "%lu records", records);
+
+ if ( bad_frames )
+   {
+    fprintf(stderr, ", %lu bad frames", bad_frames);
+   }
+
+ fprintf(stderr, "\n");
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* End of log_decode.c                                                       */
+/*****************************************************************************/
@@ -0,0 +1,463 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 map_check.c                                                             */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick link map.                    */
+/*                                                                           */
+/*   Reads the section allocation map of Audio.map and checks the sections   */
+/*   of hotpath.h: .text:hot, .coeffs and .delay must each be in DARAM, in   */
+/*   8 KB blocks that no other output section uses, and must hold the code   */
+/*   or data of each object listed for them below. An object missing means   */
+/*   a pragma was lost and that code or data has gone back to .text, .bss    */
+/*   or .const.                                                              */
+/*                                                                           */
+/*   Not run by the project build. To have the build fail when the layout    */
+/*   is wrong, build this and add it as a post build step, see README.md.    */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -o tools/map_check tools/map_check.c                                */
+/*                                                                           */
+/*   map_check Debug/Audio.map      Exit status is the failure count.        */
+/*   map_check -v Debug/Audio.map   Also list each block and what is in it.  */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LINE_LENGTH     512
+#define MAX_SECTIONS    128
+#define MAX_OBJECTS     48
+#define NAME_LENGTH     64
+
+#define BLOCK_BYTES     0x2000UL        /* DARAM and SARAM block size       */
+#define DARAM_END       0x010000UL      /* Blocks 0 to 7                    */
+#define SARAM_END       0x050000UL      /* Blocks 8 to 39                   */
+#define BLOCKS          ( SARAM_END / BLOCK_BYTES )
+
+typedef struct
+{
+    char name[NAME_LENGTH];
+    unsigned long origin;               /* Bytes                            */
+    unsigned long length;               /* Bytes                            */
+    char objects[MAX_OBJECTS][NAME_LENGTH];
+    int object_count;
+} SECTION;
+
+typedef struct
+{
+    const char *name;
+    const char *objects[6];
+} HOT_RULE;
+
+/* Objects with a pragma for each section. Keep in step with the sources */
+
+static const HOT_RULE rules[] =
+{
+    { ".text:hot", { "stereo.obj", "agc.obj", "goertzel.obj", "pitch.obj",
+                     "IIR_filters_fourth_order.obj", 0 } },
+    { ".coeffs",   { "IIR_low_pass_filters.obj", 0 } },
+    { ".delay",    { "IIR_filters_fourth_order.obj", "agc.obj", "pitch.obj",
+                     "main.obj", 0 } }
+};
+
+#define RULES   ( sizeof(rules) / sizeof(rules[0]) )
+
+static SECTION sections[MAX_SECTIONS];
+static int section_count = 0;
+static int failures = 0;
+
+/*****************************************************************************/
+/* is_hex()                                                                  */
+/*****************************************************************************/
+
+static int is_hex(const char *token)
+{
+ if ( 0 == *token )
+   {
+    return 0;
+   }
+
+ for ( ; *token ; token++ )
+   {
+    if ( !strchr("0123456789abcdefABCDEF+", *token) )
+      {
+       return 0;
+      }
+   }
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* add_object()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Note each object, xxx.obj, named on an input section line.                */
+/*                                                                           */
+/*****************************************************************************/
+
+static void add_object(SECTION *section, const char *line)
+{
+ char token[NAME_LENGTH];
+ const char *p = line;
+ int length;
+ int n;
+
+ while ( 1 == sscanf(p, "%63s%n", token, &length) )
+   {
+    p += length;
+    n = strlen(token);
+
+    if ( n < 4 || strcmp(token + n - 4, ".obj") != 0 )
+      {
+       continue;
+      }
+
+    for ( n = 0 ; n < section->object_count ; n++ )
+      {
+       if ( 0 == strcmp(section->objects[n], token) )
+         {
+          break;
+         }
+      }
+
+    if ( n == section->object_count && n < MAX_OBJECTS )
+      {
+       strcpy(section->objects[n], token);
+       section->object_count++;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* parse_output()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Fields after the name and page. Data is "[ bytes ] words * length in      */
+/* words", code is "bytes [ words ] length in bytes *".                      */
+/*                                                                           */
+/* RETURNS: 1 if the origin and length were found.                           */
+/*                                                                           */
+/*****************************************************************************/
+
+static int parse_output(SECTION *section, char *fields)
+{
+ char *token[8];
+ int tokens = 0;
+ char *p;
+
+ for ( p = strtok(fields, " \t\r\n") ; p && tokens < 8 ;
+       p = strtok(0, " \t\r\n") )
+   {
+    token[tokens++] = p;
+   }
+
+ if ( tokens >= 7 && 0 == strcmp(token[1], "[") )
+   {
+    section->origin = strtoul(token[2], 0, 16);
+    section->length = is_hex(token[6]) ? 2 * strtoul(token[6], 0, 16) : 0;
+    return 1;
+   }
+
+ if ( tokens >= 6 && 0 == strcmp(token[2], "[") )
+   {
+    section->origin = strtoul(token[1], 0, 16);
+    section->length = strtoul(token[5], 0, 16);
+    return 1;
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* read_map()                                                                */
+/*****************************************************************************/
+
+static int read_map(const char *file)
+{
+ FILE *map;
+ char line[LINE_LENGTH];
+ char name[NAME_LENGTH];
+ int in_map = 0;
+ int pending = 0;
+ SECTION *section = 0;
+ int length;
+
+ map = fopen(file, "r");
+
+ if ( 0 == map )
+   {
+    printf("FAIL cannot open %s\n", file);
+    return 0;
+   }
+
+ while ( fgets(line, sizeof(line), map) )
+   {
+    if ( !in_map )
+      {
+       in_map = ( 0 == strncmp(line, "SECTION ALLOCATION MAP", 22) );
+       continue;
+      }
+
+    if ( 0 == strncmp(line, "GLOBAL SYMBOLS", 14) )
+      {
+       break;
+      }
+
+    /* A long name is alone on its line, the fields follow after a '*' */
+
+    if ( pending && '*' == line[0] )
+      {
+       pending = 0;
+
+       if ( !parse_output(section, line + 1) )
+         {
+          section_count--;
+          section = 0;
+         }
+
+       continue;
+      }
+
+    if ( line[0] == '.' || ( line[0] >= 'a' && line[0] <= 'z' ) )
+      {
+       if ( section_count >= MAX_SECTIONS
+            || 1 != sscanf(line, "%63s%n", name, &length) )
+         {
+          section = 0;
+          continue;
+         }
+
+       section = &sections[section_count++];
+       memset(section, 0, sizeof(*section));
+       strcpy(section->name, name);
+
+       if ( strspn(line + length, " \t\r\n") == strlen(line + length) )
+         {
+          pending = 1;
+         }
+       else if ( !parse_output(section, line + length) )
+         {
+          section_count--;
+          section = 0;
+         }
+
+       continue;
+      }
+
+    if ( section && ( ' ' == line[0] ) )
+      {
+       add_object(section, line);
+      }
+   }
+
+ fclose(map);
+
+ if ( !in_map )
+   {
+    printf("FAIL no section allocation map in %s\n", file);
+    return 0;
+   }
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* find_section()                                                            */
+/*****************************************************************************/
+
+static SECTION *find_section(const char *name)
+{
+ int n;
+
+ for ( n = 0 ; n < section_count ; n++ )
+   {
+    if ( 0 == strcmp(sections[n].name, name) )
+      {
+       return &sections[n];
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* has_object()                                                              */
+/*****************************************************************************/
+
+static int has_object(const SECTION *section, const char *object)
+{
+ int n;
+
+ for ( n = 0 ; n < section->object_count ; n++ )
+   {
+    if ( 0 == strcmp(section->objects[n], object) )
+      {
+       return 1;
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* shares_block()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Another output section in any block hot is in, or 0.             */
+/*                                                                           */
+/*****************************************************************************/
+
+static const SECTION *shares_block(const SECTION *hot)
+{
+ unsigned long first = hot->origin / BLOCK_BYTES;
+ unsigned long last = ( hot->origin + hot->length - 1 ) / BLOCK_BYTES;
+ const SECTION *other;
+ int n;
+
+ for ( n = 0 ; n < section_count ; n++ )
+   {
+    other = &sections[n];
+
+    if ( other == hot || 0 == other->length )
+      {
+       continue;
+      }
+
+    if ( other->origin / BLOCK_BYTES <= last
+         && ( other->origin + other->length - 1 ) / BLOCK_BYTES >= first )
+      {
+       return other;
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* check_rule()                                                              */
+/*****************************************************************************/
+
+static void check_rule(const HOT_RULE *rule)
+{
+ const SECTION *section = find_section(rule->name);
+ const SECTION *other;
+ int n;
+
+ if ( 0 == section || 0 == section->length )
+   {
+    printf("FAIL %s missing or empty\n", rule->name);
+    failures++;
+    return;
+   }
+
+ if ( section->origin + section->length > DARAM_END )
+   {
+    printf("FAIL %s at %06lx is not in DARAM\n", rule->name,
+           section->origin);
+    failures++;
+   }
+
+ other = shares_block(section);
+
+ if ( other )
+   {
+    printf("FAIL %s shares a block with %s at %06lx\n", rule->name,
+           other->name, other->origin);
+    failures++;
+   }
+
+ for ( n = 0 ; rule->objects[n] ; n++ )
+   {
+    if ( !has_object(section, rule->objects[n]) )
+      {
+       printf("FAIL %s has nothing from %s\n", rule->name,
+              rule->objects[n]);
+       failures++;
+      }
+   }
+}
+
+/*****************************************************************************/
+/* list_blocks()                                                             */
+/*****************************************************************************/
+
+static void list_blocks(void)
+{
+ unsigned long block;
+ unsigned long from;
+ unsigned long to;
+ int n;
+
+ for ( block = 0 ; block < BLOCKS ; block++ )
+   {
+    from = block * BLOCK_BYTES;
+    to = from + BLOCK_BYTES - 1;
+
+    printf("%s block %-2lu %06lx ", ( from < DARAM_END ) ? "DARAM" : "SARAM",
+           ( from < DARAM_END ) ? block : block - DARAM_END / BLOCK_BYTES,
+           from);
+
+    for ( n = 0 ; n < section_count ; n++ )
+      {
+       if ( sections[n].length > 0 && sections[n].origin <= to
+            && sections[n].origin + sections[n].length - 1 >= from )
+         {
+          printf(" %s", sections[n].name);
+         }
+      }
+
+    printf("\n");
+   }
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ int verbose = 0;
+ unsigned int n;
+
+ if ( argc > 1 && 0 == strcmp(argv[1], "-v") )
+   {
+    verbose = 1;
+    argc--;
+    argv++;
+   }
+
+ if ( argc != 2 )
+   {
+    printf("Usage: map_check [-v] map_file\n");
+    return 1;
+   }
+
+ if ( !read_map(argv[1]) )
+   {
+    return 1;
+   }
+
+ if ( verbose )
+   {
+    list_blocks();
+   }
+
+ for ( n = 0 ; n < RULES ; n++ )
+   {
+    check_rule(&rules[n]);
+   }
+
+ printf("%s: %d failures\n", argv[1], failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of map_check.c                                                        */
+/*****************************************************************************/
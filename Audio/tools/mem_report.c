@@ -0,0 +1,1198 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 mem_report.c                                                            */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick memory budget.               */
+/*                                                                           */
+/*   Reads Audio_linkInfo.xml, written by the linker for --xml_link_info,    */
+/*   and lists for each object or library the bytes of code, constants,      */
+/*   .cinit tables and data it brings in, then for each memory area of       */
+/*   lnkx.cmd the bytes used, free and the largest free gap.                 */
+/*                                                                           */
+/*   Given the .asm files the compiler keeps with --keep_asm (-k), it also   */
+/*   builds the call graph from the CALL instructions and takes the frame    */
+/*   of each function from the header the compiler puts on it: "Total Frame  */
+/*   Size" on the stack and "Min System Stack" on the system stack. The      */
+/*   worst path from main() plus the worst interrupt, which runs with INTM   */
+/*   set and so cannot be interrupted again, is checked against the .stack   */
+/*   and .sysstack sizes in the link, set by -stack and -sysstack. An        */
+/*   indirect call, a task run by the scheduler for one, is taken to reach   */
+/*   the worst function that nothing calls by name. Functions with no .asm,  */
+/*   those of the libraries, are listed and counted as no stack at all.      */
+/*                                                                           */
+/*   -w writes the totals to a baseline file and -b compares against one,    */
+/*   so growth shows up in the commit that causes it. tools/mem_baseline.txt */
+/*   is the baseline to keep in step with the tree. It is not committed      */
+/*   yet: write it with -w from a CCS build of the tree with the DARAM       */
+/*   blocks of lnkx.cmd, commit it, and rewrite it in any commit that means  */
+/*   to use more memory. A baseline from another layout misreports.          */
+/*                                                                           */
+/*   All sizes are in bytes, as in the XML. Stack depths are in words.       */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -o tools/mem_report tools/mem_report.c                              */
+/*                                                                           */
+/*   mem_report Debug/Audio_linkInfo.xml Debug/src/(*).asm                   */
+/*   mem_report -b tools/mem_baseline.txt Debug/Audio_linkInfo.xml ...       */
+/*   mem_report -w tools/mem_baseline.txt Debug/Audio_linkInfo.xml ...       */
+/*                                                                           */
+/*   -v lists the worst call paths. -g bytes lets an area or a stack grow    */
+/*   by that much before it counts as a failure. Exit status is the failure  */
+/*   count.                                                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define LINE_LENGTH     512
+#define NAME_LENGTH     64
+#define ID_LENGTH       16
+#define MAX_FILES       256
+#define MAX_MODULES     256
+#define MAX_AREAS       32
+#define MAX_FUNCTIONS   512
+#define MAX_CALLS       16384
+#define MAX_BASELINE    512
+
+/* Words the CPU saves on each stack itself when it takes an interrupt */
+
+#define INTERRUPT_CONTEXT_WORDS 2
+
+typedef struct
+{
+    char id[ID_LENGTH];
+    char module[NAME_LENGTH];
+} INPUT_FILE;
+
+typedef struct
+{
+    char name[NAME_LENGTH];
+    unsigned long code;                 /* .text and vectors                */
+    unsigned long constant;             /* .const, .switch and .coeffs      */
+    unsigned long init;                 /* .cinit and .pinit tables         */
+    unsigned long data;                 /* .bss, .data, .delay and the rest */
+} MODULE;
+
+typedef struct
+{
+    char name[NAME_LENGTH];
+    unsigned long origin;
+    unsigned long length;
+    unsigned long used;
+    unsigned long largest_gap;
+} AREA;
+
+typedef struct
+{
+    char name[NAME_LENGTH];
+    int has_asm;
+    int is_interrupt;
+    int calls_indirect;
+    int called;                         /* By name, from anywhere           */
+    unsigned long frame;                /* Words on the stack               */
+    unsigned long system_frame;         /* Words on the system stack        */
+    int state;                          /* 0 new, 1 on the path, 2 done     */
+    unsigned long depth;
+    unsigned long system_depth;
+    int worst;                          /* Callee on the worst path, or -1  */
+} FUNCTION;
+
+typedef struct
+{
+    int from;
+    int to;
+} CALL;
+
+typedef struct
+{
+    char key[2 * NAME_LENGTH];
+    unsigned long value;
+    int seen;
+} BASELINE_ENTRY;
+
+enum { IN_NONE, IN_FILE, IN_COMPONENT, IN_GROUP, IN_AREA };
+
+static INPUT_FILE files[MAX_FILES];
+static int file_count = 0;
+static MODULE modules[MAX_MODULES];
+static int module_count = 0;
+static AREA areas[MAX_AREAS];
+static int area_count = 0;
+static FUNCTION functions[MAX_FUNCTIONS];
+static int function_count = 0;
+static CALL calls[MAX_CALLS];
+static int call_count = 0;
+static BASELINE_ENTRY baseline[MAX_BASELINE];
+static int baseline_count = 0;
+
+static unsigned long stack_bytes = 0;   /* .stack and .sysstack in the link */
+static unsigned long system_stack_bytes = 0;
+static unsigned long heap_bytes = 0;
+static unsigned long stack_words = 0;   /* Worst case found                 */
+static unsigned long system_stack_words = 0;
+
+static int verbose = 0;
+static unsigned long allowance = 0;
+static int failures = 0;
+
+/*****************************************************************************/
+/* tag_text()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The text of <tag>text</tag> when the element is all on the line.          */
+/*                                                                           */
+/* RETURNS: 1 if found.                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int tag_text(const char *line, const char *tag, char *text)
+{
+ char open[NAME_LENGTH];
+ const char *from;
+ const char *to;
+ size_t length;
+
+ sprintf(open, "<%s>", tag);
+ from = strstr(line, open);
+
+ if ( 0 == from )
+   {
+    return 0;
+   }
+
+ from += strlen(open);
+ to = strchr(from, '<');
+
+ if ( 0 == to )
+   {
+    return 0;
+   }
+
+ length = to - from;
+
+ if ( length >= NAME_LENGTH )
+   {
+    length = NAME_LENGTH - 1;
+   }
+
+ memcpy(text, from, length);
+ text[length] = 0;
+ return 1;
+}
+
+/*****************************************************************************/
+/* tag_number()                                                              */
+/*****************************************************************************/
+
+static int tag_number(const char *line, const char *tag, unsigned long *value)
+{
+ char text[NAME_LENGTH];
+
+ if ( !tag_text(line, tag, text) )
+   {
+    return 0;
+   }
+
+ *value = strtoul(text, 0, 0);
+ return 1;
+}
+
+/*****************************************************************************/
+/* attribute()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The value of name="value" on the line, as for id and idref.               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int attribute(const char *line, const char *name, char *value)
+{
+ char pattern[NAME_LENGTH];
+ const char *from;
+ const char *to;
+ size_t length;
+
+ sprintf(pattern, " %s=\"", name);
+ from = strstr(line, pattern);
+
+ if ( 0 == from )
+   {
+    return 0;
+   }
+
+ from += strlen(pattern);
+ to = strchr(from, '"');
+
+ if ( 0 == to || (size_t) ( to - from ) >= ID_LENGTH )
+   {
+    return 0;
+   }
+
+ length = to - from;
+ memcpy(value, from, length);
+ value[length] = 0;
+ return 1;
+}
+
+/*****************************************************************************/
+/* find_module()                                                             */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: The module of that name, added if new.                           */
+/*                                                                           */
+/*****************************************************************************/
+
+static MODULE *find_module(const char *name)
+{
+ int n;
+
+ for ( n = 0 ; n < module_count ; n++ )
+   {
+    if ( 0 == strcmp(modules[n].name, name) )
+      {
+       return &modules[n];
+      }
+   }
+
+ if ( module_count >= MAX_MODULES )
+   {
+    return &modules[MAX_MODULES - 1];
+   }
+
+ memset(&modules[module_count], 0, sizeof(MODULE));
+ strcpy(modules[module_count].name, name);
+ return &modules[module_count++];
+}
+
+/*****************************************************************************/
+/* add_component()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Count an input section against its module. Debug sections are not loaded  */
+/* and the stacks and heap are reported from their groups instead.           */
+/*                                                                           */
+/*****************************************************************************/
+
+static void add_component(const char *section, unsigned long size,
+                          const char *file_id)
+{
+ const char *name = "(linker)";
+ MODULE *module;
+ int n;
+
+ if ( 0 == size || 0 == strncmp(section, ".debug", 6)
+      || 0 == strcmp(section, ".stack") || 0 == strcmp(section, ".sysstack")
+      || 0 == strcmp(section, ".sysmem") )
+   {
+    return;
+   }
+
+ for ( n = 0 ; n < file_count ; n++ )
+   {
+    if ( 0 == strcmp(files[n].id, file_id) )
+      {
+       name = files[n].module;
+       break;
+      }
+   }
+
+ module = find_module(name);
+
+ if ( 0 == strncmp(section, ".text", 5) || 0 == strcmp(section, "vectors") )
+   {
+    module->code += size;
+   }
+ else if ( 0 == strncmp(section, ".const", 6)
+           || 0 == strcmp(section, ".switch")
+           || 0 == strcmp(section, ".coeffs") )
+   {
+    module->constant += size;
+   }
+ else if ( 0 == strcmp(section, ".cinit") || 0 == strcmp(section, ".pinit") )
+   {
+    module->init += size;
+   }
+ else
+   {
+    module->data += size;
+   }
+}
+
+/*****************************************************************************/
+/* read_link_info()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* One pass over the XML, a line at a time, as the linker writes one element */
+/* per line. The input files all come before the components that use them.   */
+/*                                                                           */
+/*****************************************************************************/
+
+static int read_link_info(const char *name)
+{
+ FILE *xml;
+ char line[LINE_LENGTH];
+ char text[NAME_LENGTH];
+ char kind[NAME_LENGTH] = "";
+ char file[NAME_LENGTH] = "";
+ char member[NAME_LENGTH] = "";
+ char section[NAME_LENGTH] = "";
+ char file_id[ID_LENGTH] = "";
+ unsigned long size = 0;
+ unsigned long value;
+ int in = IN_NONE;
+ int in_gap = 0;
+ AREA *area = 0;
+
+ xml = fopen(name, "r");
+
+ if ( 0 == xml )
+   {
+    printf("FAIL cannot open %s\n", name);
+    return 0;
+   }
+
+ while ( fgets(line, sizeof(line), xml) )
+   {
+    if ( strstr(line, "<input_file id=") && file_count < MAX_FILES )
+      {
+       in = IN_FILE;
+       attribute(line, "id", files[file_count].id);
+       kind[0] = file[0] = member[0] = 0;
+      }
+    else if ( strstr(line, "<object_component id=") )
+      {
+       in = IN_COMPONENT;
+       section[0] = file_id[0] = 0;
+       size = 0;
+      }
+    else if ( strstr(line, "<logical_group id=") )
+      {
+       in = IN_GROUP;
+       section[0] = 0;
+      }
+    else if ( strstr(line, "<memory_area>") && area_count < MAX_AREAS )
+      {
+       in = IN_AREA;
+       area = &areas[area_count++];
+       memset(area, 0, sizeof(*area));
+      }
+
+    switch ( in )
+      {
+       case IN_FILE:
+         tag_text(line, "kind", kind);
+         tag_text(line, "file", file);
+         tag_text(line, "name", member);
+
+         if ( strstr(line, "</input_file>") )
+           {
+            /* Libraries as a whole */
+
+            strcpy(files[file_count].module,
+                   ( 0 == strcmp(kind, "archive") ) ? file : member);
+
+            file_count++;
+            in = IN_NONE;
+           }
+         break;
+
+       case IN_COMPONENT:
+         if ( 0 == section[0] )
+           {
+            tag_text(line, "name", section);
+           }
+
+         tag_number(line, "size", &size);
+
+         if ( strstr(line, "<input_file_ref") )
+           {
+            attribute(line, "idref", file_id);
+           }
+
+         if ( strstr(line, "</object_component>") )
+           {
+            add_component(section, size, file_id);
+            in = IN_NONE;
+           }
+         break;
+
+       case IN_GROUP:
+         if ( 0 == section[0] )
+           {
+            tag_text(line, "name", section);
+           }
+
+         if ( tag_number(line, "size", &value) )
+           {
+            if ( 0 == strcmp(section, ".stack") )
+              {
+               stack_bytes = value;
+              }
+            else if ( 0 == strcmp(section, ".sysstack") )
+              {
+               system_stack_bytes = value;
+              }
+            else if ( 0 == strcmp(section, ".sysmem") )
+              {
+               heap_bytes = value;
+              }
+
+            in = IN_NONE;
+           }
+         break;
+
+       case IN_AREA:
+         if ( 0 == area->name[0] && tag_text(line, "name", text) )
+           {
+            strcpy(area->name, text);
+           }
+
+         tag_number(line, "origin", &area->origin);
+         tag_number(line, "length", &area->length);
+         tag_number(line, "used_space", &area->used);
+
+         if ( strstr(line, "<available_space>") )
+           {
+            in_gap = 1;
+           }
+
+         if ( in_gap && tag_number(line, "size", &value) )
+           {
+            if ( value > area->largest_gap )
+              {
+               area->largest_gap = value;
+              }
+
+            in_gap = 0;
+           }
+
+         if ( strstr(line, "</memory_area>") )
+           {
+            in = IN_NONE;
+           }
+         break;
+      }
+   }
+
+ fclose(xml);
+
+ if ( 0 == area_count )
+   {
+    printf("FAIL no placement map in %s\n", name);
+    return 0;
+   }
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* find_function()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Names are kept as in C, without the leading '_' of the assembler symbol.  */
+/*                                                                           */
+/* RETURNS: The index of the function, added if new.                         */
+/*                                                                           */
+/*****************************************************************************/
+
+static int find_function(const char *name)
+{
+ int n;
+
+ if ( '_' == name[0] )
+   {
+    name++;
+   }
+
+ for ( n = 0 ; n < function_count ; n++ )
+   {
+    if ( 0 == strcmp(functions[n].name, name) )
+      {
+       return n;
+      }
+   }
+
+ if ( function_count >= MAX_FUNCTIONS )
+   {
+    return MAX_FUNCTIONS - 1;
+   }
+
+ memset(&functions[function_count], 0, sizeof(FUNCTION));
+ strncpy(functions[function_count].name, name, NAME_LENGTH - 1);
+ functions[function_count].worst = -1;
+ return function_count++;
+}
+
+/*****************************************************************************/
+/* header_number()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The number after the ':' of a function header line such as                */
+/* ";*   Total Frame Size   : 2 words".                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int header_number(const char *line, const char *field,
+                         unsigned long *value)
+{
+ const char *p = strstr(line, field);
+
+ if ( 0 == p )
+   {
+    return 0;
+   }
+
+ p = strchr(p, ':');
+
+ if ( 0 == p )
+   {
+    return 0;
+   }
+
+ *value = strtoul(p + 1, 0, 10);
+ return 1;
+}
+
+/*****************************************************************************/
+/* read_instruction()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Note a call, or a branch to another function, which the compiler uses     */
+/* for a tail call. Both the mnemonic and the algebraic syntax are taken:    */
+/* CALL #_f, call #_f, CALLCC #_f, TC1 and if (TC1) call #_f. An interrupt   */
+/* function returns with RETI, return_int in algebraic.                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static void read_instruction(int current, char *text)
+{
+ char *token;
+ char *previous = 0;
+ int is_call;
+ int is_branch;
+
+ for ( token = strtok(text, " \t\r\n(),") ; token ;
+       token = strtok(0, " \t\r\n(),") )
+   {
+    if ( 0 == strcmp(token, "RETI") || 0 == strcmp(token, "reti")
+         || 0 == strcmp(token, "return_int") )
+      {
+       functions[current].is_interrupt = 1;
+      }
+
+    if ( previous )
+      {
+       is_call = ( 0 == strncmp(previous, "CALL", 4)
+                   || 0 == strncmp(previous, "call", 4) );
+       is_branch = ( 0 == strcmp(previous, "B")
+                     || 0 == strcmp(previous, "goto") );
+
+       if ( '#' == token[0] && '_' == token[1] && ( is_call || is_branch )
+            && call_count < MAX_CALLS )
+         {
+          calls[call_count].from = current;
+          calls[call_count].to = find_function(token + 1);
+          call_count++;
+         }
+       else if ( is_call && '#' != token[0] )
+         {
+          functions[current].calls_indirect = 1;
+         }
+      }
+
+    previous = token;
+   }
+}
+
+/*****************************************************************************/
+/* read_asm()                                                                */
+/*****************************************************************************/
+
+static int read_asm(const char *name)
+{
+ FILE *asm_file;
+ char line[LINE_LENGTH];
+ char function[NAME_LENGTH];
+ char *p;
+ int current = -1;
+
+ asm_file = fopen(name, "r");
+
+ if ( 0 == asm_file )
+   {
+    printf("FAIL cannot open %s\n", name);
+    failures++;
+    return 0;
+   }
+
+ while ( fgets(line, sizeof(line), asm_file) )
+   {
+    if ( 0 == strncmp(line, ";* FUNCTION NAME:", 17)
+         && 1 == sscanf(line + 17, "%63s", function) )
+      {
+       current = find_function(function);
+       functions[current].has_asm = 1;
+       continue;
+      }
+
+    if ( current < 0 )
+      {
+       continue;
+      }
+
+    if ( ';' == line[0] )
+      {
+       header_number(line, "Total Frame Size", &functions[current].frame);
+       header_number(line, "Min System Stack",
+                     &functions[current].system_frame);
+       continue;
+      }
+
+    /* Drop the comment, and any label in the first column */
+
+    p = strchr(line, ';');
+
+    if ( p )
+      {
+       *p = 0;
+      }
+
+    p = line;
+
+    if ( !isspace((unsigned char) line[0]) )
+      {
+       p += strcspn(line, " \t\r\n");
+      }
+
+    read_instruction(current, p);
+   }
+
+ fclose(asm_file);
+ return 1;
+}
+
+/*****************************************************************************/
+/* deepest_root()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* What an indirect call may reach: any function with code that nothing      */
+/* calls by name, other than main() and the interrupts.                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static void walk(int n);
+
+static int deepest_root(int caller)
+{
+ int worst = -1;
+ int n;
+
+ for ( n = 0 ; n < function_count ; n++ )
+   {
+    if ( n == caller || !functions[n].has_asm || functions[n].called
+         || functions[n].is_interrupt || 0 == strcmp(functions[n].name, "main")
+         || 1 == functions[n].state )
+      {
+       continue;
+      }
+
+    walk(n);
+
+    if ( worst < 0 || functions[n].depth > functions[worst].depth )
+      {
+       worst = n;
+      }
+   }
+
+ return worst;
+}
+
+/*****************************************************************************/
+/* walk()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Depth first. A function met again on its own path is recursion, which     */
+/* has no bound here: it is reported and that call is left out.              */
+/*                                                                           */
+/*****************************************************************************/
+
+static void walk(int n)
+{
+ FUNCTION *function = &functions[n];
+ unsigned long deepest = 0;
+ unsigned long system_deepest = 0;
+ int callee;
+ int c;
+
+ if ( 2 == function->state )
+   {
+    return;
+   }
+
+ function->state = 1;
+
+ for ( c = 0 ; c <= call_count ; c++ )
+   {
+    if ( c < call_count )
+      {
+       if ( calls[c].from != n )
+         {
+          continue;
+         }
+
+       callee = calls[c].to;
+      }
+    else if ( function->calls_indirect )
+      {
+       callee = deepest_root(n);
+      }
+    else
+      {
+       break;
+      }
+
+    if ( callee < 0 )
+      {
+       continue;
+      }
+
+    if ( 1 == functions[callee].state )
+      {
+       printf("FAIL %s recurses through %s\n", function->name,
+              functions[callee].name);
+       failures++;
+       continue;
+      }
+
+    walk(callee);
+
+    if ( functions[callee].depth > deepest )
+      {
+       deepest = functions[callee].depth;
+       function->worst = callee;
+      }
+
+    if ( functions[callee].system_depth > system_deepest )
+      {
+       system_deepest = functions[callee].system_depth;
+      }
+   }
+
+ function->depth = function->frame + deepest;
+ function->system_depth = function->system_frame + system_deepest;
+ function->state = 2;
+}
+
+/*****************************************************************************/
+/* print_path()                                                              */
+/*****************************************************************************/
+
+static void print_path(int n)
+{
+ printf("   ");
+
+ for ( ; n >= 0 ; n = functions[n].worst )
+   {
+    printf(" %s(%lu)", functions[n].name, functions[n].frame);
+   }
+
+ printf("\n");
+}
+
+/*****************************************************************************/
+/* check_stacks()                                                            */
+/*****************************************************************************/
+
+static void check_stacks(void)
+{
+ int main_function = find_function("main");
+ int worst_interrupt = -1;
+ int n;
+ int c;
+
+ for ( c = 0 ; c < call_count ; c++ )
+   {
+    functions[calls[c].to].called = 1;
+   }
+
+ walk(main_function);
+
+ for ( n = 0 ; n < function_count ; n++ )
+   {
+    if ( functions[n].is_interrupt )
+      {
+       walk(n);
+
+       if ( worst_interrupt < 0
+            || functions[n].depth > functions[worst_interrupt].depth )
+         {
+          worst_interrupt = n;
+         }
+      }
+   }
+
+ stack_words = functions[main_function].depth;
+ system_stack_words = functions[main_function].system_depth;
+
+ if ( worst_interrupt >= 0 )
+   {
+    stack_words += functions[worst_interrupt].depth
+                   + INTERRUPT_CONTEXT_WORDS;
+    system_stack_words += functions[worst_interrupt].system_depth
+                          + INTERRUPT_CONTEXT_WORDS;
+   }
+
+ printf("\nStack          words  budget   free\n");
+ printf(".stack        %6lu  %6lu  %5ld\n", stack_words, stack_bytes / 2,
+        (long) ( stack_bytes / 2 ) - (long) stack_words);
+ printf(".sysstack     %6lu  %6lu  %5ld\n", system_stack_words,
+        system_stack_bytes / 2,
+        (long) ( system_stack_bytes / 2 ) - (long) system_stack_words);
+
+ if ( stack_words > stack_bytes / 2 )
+   {
+    printf("FAIL .stack needs %lu words, has %lu\n", stack_words,
+           stack_bytes / 2);
+    failures++;
+   }
+
+ if ( system_stack_words > system_stack_bytes / 2 )
+   {
+    printf("FAIL .sysstack needs %lu words, has %lu\n", system_stack_words,
+           system_stack_bytes / 2);
+    failures++;
+   }
+
+ if ( verbose )
+   {
+    printf("Worst path from main, frames in words:\n");
+    print_path(main_function);
+
+    if ( worst_interrupt >= 0 )
+      {
+       printf("Worst interrupt:\n");
+       print_path(worst_interrupt);
+      }
+   }
+
+ printf("No stack information, counted as 0:");
+
+ for ( n = 0 ; n < function_count ; n++ )
+   {
+    if ( !functions[n].has_asm )
+      {
+       printf(" %s", functions[n].name);
+      }
+   }
+
+ printf("\n");
+}
+
+/*****************************************************************************/
+/* print_modules() and print_areas()                                         */
+/*****************************************************************************/
+
+static void print_modules(void)
+{
+ MODULE total;
+ int n;
+
+ memset(&total, 0, sizeof(total));
+
+ printf("Module                           code  const  cinit   data\n");
+
+ for ( n = 0 ; n < module_count ; n++ )
+   {
+    printf("%-30s %6lu %6lu %6lu %6lu\n", modules[n].name, modules[n].code,
+           modules[n].constant, modules[n].init, modules[n].data);
+
+    total.code += modules[n].code;
+    total.constant += modules[n].constant;
+    total.init += modules[n].init;
+    total.data += modules[n].data;
+   }
+
+ printf("%-30s %6lu %6lu %6lu %6lu\n", "Total", total.code, total.constant,
+        total.init, total.data);
+ printf("%-30s %6lu stack, %lu system stack, %lu heap\n", "Reserved",
+        stack_bytes, system_stack_bytes, heap_bytes);
+}
+
+static void print_areas(void)
+{
+ int n;
+
+ printf("\nMemory area   origin  length    used    free  largest gap\n");
+
+ for ( n = 0 ; n < area_count ; n++ )
+   {
+    if ( 0 == areas[n].length )
+      {
+       continue;
+      }
+
+    printf("%-10s  %06lx  %6lu  %6lu  %6lu  %6lu\n", areas[n].name,
+           areas[n].origin, areas[n].length, areas[n].used,
+           areas[n].length - areas[n].used, areas[n].largest_gap);
+   }
+}
+
+/*****************************************************************************/
+/* write_baseline()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* One "key value" line each. The stacks are left out when no .asm was       */
+/* given, as 0 would only look like a gain.                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static int write_baseline(const char *name, const char *link_info,
+                          int with_stacks)
+{
+ FILE *out = fopen(name, "w");
+ int n;
+
+ if ( 0 == out )
+   {
+    printf("FAIL cannot write %s\n", name);
+    return 0;
+   }
+
+ fprintf(out, "# mem_report totals in bytes, stacks in words, from %s\n",
+         link_info);
+
+ for ( n = 0 ; n < area_count ; n++ )
+   {
+    if ( areas[n].length )
+      {
+       fprintf(out, "area.%s %lu\n", areas[n].name, areas[n].used);
+      }
+   }
+
+ for ( n = 0 ; n < module_count ; n++ )
+   {
+    fprintf(out, "module.%s %lu\n", modules[n].name,
+            modules[n].code + modules[n].constant + modules[n].init
+            + modules[n].data);
+   }
+
+ if ( with_stacks )
+   {
+    fprintf(out, "stack.stack %lu\n", stack_words);
+    fprintf(out, "stack.sysstack %lu\n", system_stack_words);
+   }
+
+ fclose(out);
+ return 1;
+}
+
+/*****************************************************************************/
+/* read_baseline()                                                           */
+/*****************************************************************************/
+
+static int read_baseline(const char *name)
+{
+ FILE *in = fopen(name, "r");
+ char line[LINE_LENGTH];
+
+ if ( 0 == in )
+   {
+    printf("FAIL cannot open %s\n", name);
+    return 0;
+   }
+
+ while ( fgets(line, sizeof(line), in) && baseline_count < MAX_BASELINE )
+   {
+    if ( '#' != line[0]
+         && 2 == sscanf(line, "%127s %lu", baseline[baseline_count].key,
+                        &baseline[baseline_count].value) )
+      {
+       baseline[baseline_count].seen = 0;
+       baseline_count++;
+      }
+   }
+
+ fclose(in);
+ return 1;
+}
+
+/*****************************************************************************/
+/* compare()                                                                 */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Print any change from the baseline. Growth of an area or a stack by more  */
+/* than the allowance is a failure; modules are there to show where it came  */
+/* from.                                                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+static void compare(const char *key, unsigned long value)
+{
+ int n;
+ long change;
+
+ for ( n = 0 ; n < baseline_count ; n++ )
+   {
+    if ( 0 == strcmp(baseline[n].key, key) )
+      {
+       break;
+      }
+   }
+
+ if ( n == baseline_count )
+   {
+    printf("new      %-36s %6lu\n", key, value);
+    return;
+   }
+
+ baseline[n].seen = 1;
+ change = (long) value - (long) baseline[n].value;
+
+ if ( 0 == change )
+   {
+    return;
+   }
+
+ if ( change > (long) allowance && 0 != strncmp(key, "module.", 7) )
+   {
+    printf("FAIL     %-36s %6lu  %+ld\n", key, value, change);
+    failures++;
+   }
+ else
+   {
+    printf("changed  %-36s %6lu  %+ld\n", key, value, change);
+   }
+}
+
+static void compare_baseline(int with_stacks)
+{
+ char key[2 * NAME_LENGTH];
+ int n;
+
+ printf("\nAgainst the baseline:\n");
+
+ for ( n = 0 ; n < area_count ; n++ )
+   {
+    if ( areas[n].length )
+      {
+       sprintf(key, "area.%s", areas[n].name);
+       compare(key, areas[n].used);
+      }
+   }
+
+ for ( n = 0 ; n < module_count ; n++ )
+   {
+    sprintf(key, "module.%s", modules[n].name);
+    compare(key, modules[n].code + modules[n].constant + modules[n].init
+                 + modules[n].data);
+   }
+
+ if ( with_stacks )
+   {
+    compare("stack.stack", stack_words);
+    compare("stack.sysstack", system_stack_words);
+   }
+
+ for ( n = 0 ; n < baseline_count ; n++ )
+   {
+    if ( !baseline[n].seen && ( with_stacks
+                                || 0 != strncmp(baseline[n].key, "stack.", 6) ) )
+      {
+       printf("gone     %-36s %6lu\n", baseline[n].key, baseline[n].value);
+      }
+   }
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ const char *base_in = 0;
+ const char *base_out = 0;
+ const char *link_info;
+ int with_stacks;
+ int n;
+
+ for ( n = 1 ; n < argc && '-' == argv[n][0] ; n++ )
+   {
+    if ( 0 == strcmp(argv[n], "-v") )
+      {
+       verbose = 1;
+      }
+    else if ( 0 == strcmp(argv[n], "-b") && n + 1 < argc )
+      {
+       base_in = argv[++n];
+      }
+    else if ( 0 == strcmp(argv[n], "-w") && n + 1 < argc )
+      {
+       base_out = argv[++n];
+      }
+    else if ( 0 == strcmp(argv[n], "-g") && n + 1 < argc )
+      {
+       allowance = strtoul(argv[++n], 0, 0);
+      }
+    else
+      {
+       break;
+      }
+   }
+
+ if ( n >= argc )
+   {
+    printf("Usage: mem_report [-v] [-b baseline] [-w baseline] [-g bytes] "
+           "link_info.xml [file.asm ...]\n");
+    return 1;
+   }
+
+ link_info = argv[n++];
+
+ if ( !read_link_info(link_info) )
+   {
+    return 1;
+   }
+
+ print_modules();
+ print_areas();
+
+ with_stacks = ( n < argc );
+
+ for ( ; n < argc ; n++ )
+   {
+    read_asm(argv[n]);
+   }
+
+ if ( with_stacks )
+   {
+    check_stacks();
+   }
+
+ if ( base_in && read_baseline(base_in) )
+   {
+    compare_baseline(with_stacks);
+   }
+ else if ( base_in )
+   {
+    failures++;
+   }
+
+ if ( base_out && !write_baseline(base_out, link_info, with_stacks) )
+   {
+    failures++;
+   }
+
+ printf("%s: %d failures\n", link_info, failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of mem_report.c                                                       */
+/*****************************************************************************/
@@ -0,0 +1,472 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 noise_check.c                                                           */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick noise and MLS generators.    */
+/*                                                                           */
+/*   Runs noise.c and mls.c on a PC, in blocks of 48 samples as main.c does, */
+/*   with rand16() from tools/host/dsplib.c.                                 */
+/*                                                                           */
+/*   For each order from 2 to 15 the MLS must have a period of exactly       */
+/*   2^N - 1, with one more -amplitude than +amplitude, and its circular     */
+/*   autocorrelation must be L at lag 0 and -1 at every other lag. A         */
+/*   recording through a short known FIR filter must give the filter back    */
+/*   from mls_extract() to within 2 LSB.                                     */
+/*                                                                           */
+/*   White noise must have a mean within 1% of the amplitude, a variance     */
+/*   within 3% of amplitude^2 / 3 and neighbouring samples must not be       */
+/*   correlated. Pink noise must fall by 3 dB per octave, within 1 dB, from  */
+/*   94 Hz to 12 kHz at 48 kHz, and its RMS must be 14 to 20 dB below the    */
+/*   amplitude. Neither may go past the amplitude.                           */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o noise_check tools/noise_check.c src/noise.c   */
+/*       src/mls.c tools/host/dsplib.c -lm                                   */
+/*                                                                           */
+/*   noise_check               Run the tests. Exit status is the failures.   */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "tms320.h"
+#include "dsplib.h"
+#include "noise.h"
+#include "mls.h"
+
+#define SAMPLES_PER_SECOND  48000
+#define BLOCK               48          /* Samples per call, as main.c      */
+#define NOISE_SAMPLES       ( 64L * FFT_SIZE )
+#define FFT_SIZE            4096
+#define FIRST_OCTAVE        3           /* Bins 8 to 15, about 94 Hz        */
+#define LAST_OCTAVE         9           /* Bins 512 to 1023, about 12 kHz   */
+#define EXTRACT_ORDER       12
+#define EXTRACT_TAPS        16
+#define PI                  3.14159265358979
+
+/* Impulse response in Q15 for the MLS recording */
+
+static const DATA response[] = { 16384, 8192, -4096, 0, 2048, -1024, 512 };
+
+#define RESPONSE_TAPS       ( sizeof(response) / sizeof(response[0]) )
+
+static DATA sequence[1L << MLS_MAX_ORDER];
+static DATA noise[NOISE_SAMPLES];
+static long work[1L << EXTRACT_ORDER];
+static double re[FFT_SIZE];
+static double im[FFT_SIZE];
+static int failures = 0;
+
+/*****************************************************************************/
+/* fail()                                                                    */
+/*****************************************************************************/
+
+static void fail(const char *what, double value)
+{
+ printf("FAIL %s: %g\n", what, value);
+ failures++;
+}
+
+/*****************************************************************************/
+/* test_mls_sequence()                                                       */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The register must come back to its first value after L samples and not    */
+/* before, so the period is L.                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_mls_sequence(void)
+{
+ MLS mls;
+ ushort order;
+ long length;
+ long n;
+ long k;
+ long lag;
+ long sum;
+ long first_return;
+
+ for ( order = MLS_MIN_ORDER ; order <= MLS_MAX_ORDER ; order++)
+   {
+    mls_init(&mls, order, 1, NULL);
+    length = mls.length;
+    first_return = 0;
+    sum = 0;
+
+    if ( length != ( 1L << order ) - 1 )
+      {
+       fail("MLS length", length);
+       continue;
+      }
+
+    for ( n = 0 ; n < length ; n++)
+      {
+       mls_generate(&mls, &sequence[n], 1);
+       sum += sequence[n];
+
+       if ( 0 == first_return && 1 == mls.generate_state )
+         {
+          first_return = n + 1;
+         }
+      }
+
+    if ( first_return != length )
+      {
+       fail("MLS period", first_return);
+      }
+
+    if ( -1 != sum )
+      {
+       fail("MLS balance", sum);
+      }
+
+    for ( lag = 0 ; lag < length ; lag++)
+      {
+       sum = 0;
+
+       for ( n = 0, k = lag ; n < length ; n++)
+         {
+          sum += sequence[n] * sequence[k];
+
+          if ( ++k == length )
+            {
+             k = 0;
+            }
+         }
+
+       if ( sum != ( ( 0 == lag ) ? length : -1 ) )
+         {
+          printf("Order %u lag %ld: ", order, lag);
+          fail("MLS autocorrelation", sum);
+          break;
+         }
+      }
+
+    printf("MLS order %2u  period %5ld  ok\n", order, first_return);
+   }
+}
+
+/*****************************************************************************/
+/* test_mls_extract()                                                        */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Plays three periods and a part through response[], recording as it goes   */
+/* in blocks that do not divide the period. The first period is discarded    */
+/* and mls_set_periods() keeps the next two, so the part is ignored.         */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_mls_extract(void)
+{
+ MLS mls;
+ DATA output[BLOCK];
+ DATA input[BLOCK];
+ DATA history[RESPONSE_TAPS] = { 0 };
+ DATA impulse_response[EXTRACT_TAPS];
+ long n;
+ long total;
+ ushort i;
+ ushort k;
+ long sum;
+ long error;
+ long worst = 0;
+
+ mls_init(&mls, EXTRACT_ORDER, 16384, work);
+ mls_set_periods(&mls, 2);
+ total = 3L * mls.length + BLOCK;
+
+ for ( n = 0 ; n < total ; n += BLOCK)
+   {
+    mls_generate(&mls, output, BLOCK);
+
+    for ( i = 0 ; i < BLOCK ; i++)
+      {
+       for ( k = RESPONSE_TAPS - 1 ; k > 0 ; k--)
+         {
+          history[k] = history[k - 1];
+         }
+
+       history[0] = output[i];
+       sum = 0;
+
+       for ( k = 0 ; k < RESPONSE_TAPS ; k++)
+         {
+          sum += (long) history[k] * response[k];
+         }
+
+       input[i] = (DATA) ( ( sum + 16384 ) >> 15 );
+      }
+
+    mls_record(&mls, input, BLOCK);
+   }
+
+ if ( mls_periods(&mls) != 2 )
+   {
+    fail("MLS periods recorded", mls_periods(&mls));
+   }
+
+ mls_extract(&mls, impulse_response, EXTRACT_TAPS);
+
+ for ( k = 0 ; k < EXTRACT_TAPS ; k++)
+   {
+    error = impulse_response[k] - ( ( k < RESPONSE_TAPS ) ? response[k] : 0 );
+
+    if ( labs(error) > labs(worst) )
+      {
+       worst = error;
+      }
+   }
+
+ if ( labs(worst) > 2 )
+   {
+    fail("MLS impulse response error in LSB", worst);
+   }
+ else
+   {
+    printf("MLS impulse response of %u taps, worst error %ld LSB  ok\n",
+           EXTRACT_TAPS, worst);
+   }
+}
+
+/*****************************************************************************/
+/* test_white()                                                              */
+/*****************************************************************************/
+
+static void test_white(signed int amplitude)
+{
+ long n;
+ double mean = 0.0;
+ double variance = 0.0;
+ double lag_one = 0.0;
+ double expected = (double) amplitude * amplitude / 3.0;
+ long peak = 0;
+
+ noise_init();
+
+ for ( n = 0 ; n < NOISE_SAMPLES ; n += BLOCK)
+   {
+    white_noise_generate(&noise[n], BLOCK, amplitude);
+   }
+
+ for ( n = 0 ; n < NOISE_SAMPLES ; n++)
+   {
+    mean += noise[n];
+
+    if ( labs(noise[n]) > peak )
+      {
+       peak = labs(noise[n]);
+      }
+   }
+
+ mean /= NOISE_SAMPLES;
+
+ for ( n = 0 ; n < NOISE_SAMPLES ; n++)
+   {
+    variance += ( noise[n] - mean ) * ( noise[n] - mean );
+
+    if ( n > 0 )
+      {
+       lag_one += ( noise[n] - mean ) * ( noise[n - 1] - mean );
+      }
+   }
+
+ variance /= NOISE_SAMPLES;
+ lag_one /= variance * ( NOISE_SAMPLES - 1 );
+
+ printf("White %5d  mean %7.1f  RMS %7.1f  lag 1 %6.3f  peak %5ld\n",
+        amplitude, mean, sqrt(variance), lag_one, peak);
+
+ if ( fabs(mean) > 0.01 * amplitude )
+   {
+    fail("white noise mean", mean);
+   }
+
+ if ( fabs(variance / expected - 1.0) > 0.03 )
+   {
+    fail("white noise variance / expected", variance / expected);
+   }
+
+ if ( fabs(lag_one) > 0.01 )
+   {
+    fail("white noise lag 1 correlation", lag_one);
+   }
+
+ if ( peak > amplitude + 1 )
+   {
+    fail("white noise peak", peak);
+   }
+}
+
+/*****************************************************************************/
+/* fft()                                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* In place radix 2 FFT of re[] and im[], FFT_SIZE points.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+static void fft(void)
+{
+ long i;
+ long j;
+ long k;
+ long size;
+ double angle;
+ double wr;
+ double wi;
+ double tr;
+ double ti;
+
+ for ( i = 1, j = 0 ; i < FFT_SIZE ; i++)
+   {
+    for ( k = FFT_SIZE >> 1 ; j & k ; k >>= 1)
+      {
+       j ^= k;
+      }
+
+    j |= k;
+
+    if ( i < j )
+      {
+       tr = re[i]; re[i] = re[j]; re[j] = tr;
+       ti = im[i]; im[i] = im[j]; im[j] = ti;
+      }
+   }
+
+ for ( size = 2 ; size <= FFT_SIZE ; size <<= 1)
+   {
+    for ( k = 0 ; k < size / 2 ; k++)
+      {
+       angle = -2.0 * PI * k / size;
+       wr = cos(angle);
+       wi = sin(angle);
+
+       for ( i = k ; i < FFT_SIZE ; i += size)
+         {
+          j = i + size / 2;
+          tr = re[j] * wr - im[j] * wi;
+          ti = re[j] * wi + im[j] * wr;
+          re[j] = re[i] - tr;
+          im[j] = im[i] - ti;
+          re[i] += tr;
+          im[i] += ti;
+         }
+      }
+   }
+}
+
+/*****************************************************************************/
+/* test_pink()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Averages Hann windowed spectra of FFT_SIZE samples, then the mean power   */
+/* in each octave of bins 2^m to 2^(m+1) - 1.                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_pink(signed int amplitude)
+{
+ PINK_NOISE pink;
+ double octave[LAST_OCTAVE + 1] = { 0.0 };
+ double power = 0.0;
+ double step;
+ double rms_db;
+ long n;
+ long from;
+ long bin;
+ long peak = 0;
+ int m;
+
+ noise_init();
+ pink_noise_init(&pink, amplitude);
+
+ for ( n = 0 ; n < NOISE_SAMPLES ; n += BLOCK)
+   {
+    pink_noise_generate(&pink, &noise[n], BLOCK);
+   }
+
+ for ( n = 0 ; n < NOISE_SAMPLES ; n++)
+   {
+    power += (double) noise[n] * noise[n];
+
+    if ( labs(noise[n]) > peak )
+      {
+       peak = labs(noise[n]);
+      }
+   }
+
+ rms_db = 20.0 * log10( amplitude / sqrt(power / NOISE_SAMPLES) );
+
+ for ( from = 0 ; from < NOISE_SAMPLES ; from += FFT_SIZE)
+   {
+    for ( n = 0 ; n < FFT_SIZE ; n++)
+      {
+       re[n] = noise[from + n] * ( 0.5 - 0.5 * cos(2.0 * PI * n / FFT_SIZE) );
+       im[n] = 0.0;
+      }
+
+    fft();
+
+    for ( m = FIRST_OCTAVE ; m <= LAST_OCTAVE ; m++)
+      {
+       for ( bin = 1L << m ; bin < 2L << m ; bin++)
+         {
+          octave[m] += ( re[bin] * re[bin] + im[bin] * im[bin] )
+                       / ( 1L << m );
+         }
+      }
+   }
+
+ printf("Pink %5d  RMS %.1f dB below, peak %ld\n", amplitude, rms_db, peak);
+
+ for ( m = FIRST_OCTAVE + 1 ; m <= LAST_OCTAVE ; m++)
+   {
+    step = 10.0 * log10(octave[m] / octave[m - 1]);
+
+    printf("  %5.0f Hz to %5.0f Hz  %5.2f dB\n",
+           (double) SAMPLES_PER_SECOND * ( 1L << ( m - 1 ) ) / FFT_SIZE,
+           (double) SAMPLES_PER_SECOND * ( 1L << m ) / FFT_SIZE, step);
+
+    if ( fabs(step + 3.0) > 1.0 )
+      {
+       fail("pink noise octave step in dB", step);
+      }
+   }
+
+ if ( rms_db < 14.0 || rms_db > 20.0 )
+   {
+    fail("pink noise RMS in dB below the amplitude", rms_db);
+   }
+
+ if ( peak > amplitude )
+   {
+    fail("pink noise peak", peak);
+   }
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(void)
+{
+ test_mls_sequence();
+ test_mls_extract();
+ test_white(32767);
+ test_white(8192);
+ test_pink(32767);
+ test_pink(8192);
+
+ printf("%d failures\n", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of noise_check.c                                                      */
+/*****************************************************************************/
@@ -0,0 +1,470 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pitch_check.c                                                           */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick pitch tracker.               */
+/*                                                                           */
+/*   Runs pitch.c on a PC as main.c does: pitch_process() once a 48 kHz      */
+/*   sample and pitch_task() once a millisecond, that is every 48 samples.   */
+/*                                                                           */
+/*   With no file it makes its own signals, 1 s each: sines from 65 Hz to    */
+/*   480 Hz at -6 and -30 dBFS, a sawtooth with 8 harmonics, and a voice     */
+/*   like pulse train. Once the first 50 ms have passed every estimate must  */
+/*   be voiced and within 3% of the fundamental. Silence and white noise     */
+/*   must give no more than 5% voiced estimates.                             */
+/*                                                                           */
+/*   It also checks the budget: pitch_process() must do no DSPLIB work, no   */
+/*   run of pitch_task() may do more multiply-accumulates than one acorr of  */
+/*   the window, and no estimate may be asked for before the one before is   */
+/*   done. It prints the worst multiply-accumulates and the mean PC time of  */
+/*   each. The C55x cycles are in sched_tasks[] worst_us on a board.         */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o pitch_check tools/pitch_check.c src/pitch.c   */
+/*       tools/host/dsplib.c -lm                                             */
+/*                                                                           */
+/*   pitch_check               Run the tests. Exit status is the failures.   */
+/*   pitch_check in.wav        Print the estimates for a 16-bit 48 kHz WAV.  */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "tms320.h"
+#include "dsplib.h"
+#include "pitch.h"
+
+#define SAMPLES_PER_SECOND  48000
+#define SAMPLES_PER_TICK    48          /* pitch_task() once a millisecond  */
+#define SIGNAL_SAMPLES      48000       /* 1 s                              */
+#define SETTLE_SAMPLES      2400        /* 50 ms                            */
+#define MAX_SAMPLES         ( 60L * SAMPLES_PER_SECOND )
+#define TOLERANCE           0.03
+#define UNVOICED_FRACTION   0.05
+#define PI                  3.14159265358979
+
+#define SINE                0
+#define SAWTOOTH            1
+#define PULSES              2
+
+static const double frequencies[] = { 65.0, 82.4, 110.0, 147.0, 196.0,
+                                      262.0, 330.0, 392.0, 480.0 };
+static const double levels[] = { -6.0, -30.0 };
+
+#define FREQUENCIES ( sizeof(frequencies) / sizeof(frequencies[0]) )
+#define LEVELS      ( sizeof(levels) / sizeof(levels[0]) )
+
+static DATA samples[MAX_SAMPLES];
+static unsigned long noise_seed = 1;
+static unsigned long process_macs = 0;  /* Worst of one call                */
+static unsigned long task_macs = 0;
+static double process_ns = 0.0;        /* Total of all calls               */
+static double task_ns = 0.0;
+static double process_calls = 0.0;
+static double task_calls = 0.0;
+static int failures = 0;
+
+/*****************************************************************************/
+/* noise()                                                                   */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: Uniform noise from -1 to 1.                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static double noise(void)
+{
+ noise_seed = ( noise_seed * 1103515245UL + 12345UL ) & 0x7FFFFFFFUL;
+ return ( noise_seed / 1073741824.0 ) - 1.0;
+}
+
+/*****************************************************************************/
+/* make()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* One second of a sine, a sawtooth or pulses at frequency, peak level dBFS. */
+/* The pulses are a 1 ms raised cosine each period, a crude glottal pulse.   */
+/*                                                                           */
+/*****************************************************************************/
+
+static long make(int shape, double frequency, double level)
+{
+ double amplitude = 32767.0 * pow(10.0, level / 20.0);
+ double t;
+ double value;
+ double position;
+ long n;
+ int k;
+
+ for ( n = 0 ; n < SIGNAL_SAMPLES ; n++ )
+   {
+    t = (double) n / SAMPLES_PER_SECOND;
+    value = 0.0;
+
+    if ( SINE == shape )
+      {
+       value = sin(2.0 * PI * frequency * t);
+      }
+    else if ( SAWTOOTH == shape )
+      {
+       for ( k = 1 ; k <= 8 ; k++ )
+         {
+          value += 0.55 * sin(2.0 * PI * k * frequency * t) / k;
+         }
+      }
+    else
+      {
+       position = fmod(t * frequency, 1.0) / frequency;
+
+       if ( position < 0.001 )
+         {
+          value = 0.5 - 0.5 * cos(2.0 * PI * position / 0.001);
+         }
+      }
+
+    samples[n] = (DATA) floor(amplitude * value + 0.5);
+   }
+
+ return SIGNAL_SAMPLES;
+}
+
+/*****************************************************************************/
+/* elapsed_ns()                                                              */
+/*****************************************************************************/
+
+static double elapsed_ns(const struct timespec *start)
+{
+ struct timespec end;
+
+ clock_gettime(CLOCK_MONOTONIC, &end);
+
+ return ( end.tv_sec - start->tv_sec ) * 1e9
+        + ( end.tv_nsec - start->tv_nsec );
+}
+
+/*****************************************************************************/
+/* run()                                                                     */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* pitch_process() on each sample and pitch_task() each 48. Counts the       */
+/* estimates after the first settle samples, and those of them voiced within */
+/* TOLERANCE of expected. With print set each new estimate is printed.       */
+/*                                                                           */
+/*****************************************************************************/
+
+static void run(long count, long settle, double expected, int print,
+                long *estimates, long *voiced, long *right)
+{
+ Uint32 frame;
+ struct timespec start;
+ unsigned long macs;
+ double ns;
+ double hz;
+ long n;
+
+ pitch_init(PITCH_UNBIASED);
+ frame = pitch_estimate.frame;
+ *estimates = *voiced = *right = 0;
+
+ for ( n = 0 ; n < count ; n++ )
+   {
+    macs = dsplib_host_macs;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pitch_process(samples[n]);
+    ns = elapsed_ns(&start);
+
+    if ( dsplib_host_macs - macs > process_macs )
+      {
+       process_macs = dsplib_host_macs - macs;
+      }
+
+    process_ns += ns;
+    process_calls++;
+
+    if ( SAMPLES_PER_TICK - 1 != n % SAMPLES_PER_TICK )
+      {
+       continue;
+      }
+
+    macs = dsplib_host_macs;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pitch_task(NULL);
+    ns = elapsed_ns(&start);
+
+    if ( dsplib_host_macs - macs > task_macs )
+      {
+       task_macs = dsplib_host_macs - macs;
+      }
+
+    task_ns += ns;
+    task_calls++;
+
+    /* The frame count goes up as each estimate is done */
+
+    if ( pitch_estimate.frame == frame || n < settle )
+      {
+       continue;
+      }
+
+    frame = pitch_estimate.frame;
+    hz = pitch_estimate.frequency / 16.0;
+    (*estimates)++;
+
+    if ( pitch_estimate.voiced )
+      {
+       (*voiced)++;
+
+       if ( fabs(hz - expected) <= TOLERANCE * expected )
+         {
+          (*right)++;
+         }
+      }
+
+    if ( print )
+      {
+       printf("%8.3f s  %7.2f Hz  confidence %5.3f%s\n",
+              (double) n / SAMPLES_PER_SECOND, hz,
+              pitch_estimate.confidence / 32768.0,
+              pitch_estimate.voiced ? "" : "  unvoiced");
+      }
+   }
+
+ if ( pitch_estimate.late )
+   {
+    printf("FAIL %u estimates asked for before the one before was done\n",
+           pitch_estimate.late);
+    failures++;
+   }
+}
+
+/*****************************************************************************/
+/* test_voiced()                                                             */
+/*****************************************************************************/
+
+static void test_voiced(int shape, const char *name)
+{
+ long estimates;
+ long voiced;
+ long right;
+ int f;
+ int l;
+
+ for ( l = 0 ; l < (int) LEVELS ; l++ )
+   {
+    for ( f = 0 ; f < (int) FREQUENCIES ; f++ )
+      {
+       make(shape, frequencies[f], levels[l]);
+       run(SIGNAL_SAMPLES, SETTLE_SAMPLES, frequencies[f], 0, &estimates,
+           &voiced, &right);
+
+       if ( right != estimates || 0 == estimates )
+         {
+          printf("FAIL %-8s %6.1f Hz at %3.0f dBFS: %ld of %ld right\n",
+                 name, frequencies[f], levels[l], right, estimates);
+          failures++;
+         }
+      }
+
+    printf("%-8s at %3.0f dBFS, 65 Hz to 480 Hz  done\n", name, levels[l]);
+   }
+}
+
+/*****************************************************************************/
+/* test_unvoiced()                                                           */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Silence, then white noise at -6 dBFS peak.                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_unvoiced(void)
+{
+ long estimates;
+ long voiced;
+ long right;
+ long n;
+
+ memset(samples, 0, sizeof(samples));
+ run(SIGNAL_SAMPLES, SETTLE_SAMPLES, 0.0, 0, &estimates, &voiced, &right);
+
+ if ( voiced )
+   {
+    printf("FAIL %ld of %ld voiced in silence\n", voiced, estimates);
+    failures++;
+   }
+
+ for ( n = 0 ; n < SIGNAL_SAMPLES ; n++ )
+   {
+    samples[n] = (DATA) floor(16384.0 * noise() + 0.5);
+   }
+
+ run(SIGNAL_SAMPLES, SETTLE_SAMPLES, 0.0, 0, &estimates, &voiced, &right);
+
+ printf("Noise: %ld of %ld estimates voiced\n", voiced, estimates);
+
+ if ( voiced > UNVOICED_FRACTION * estimates )
+   {
+    printf("FAIL more than %.0f%% voiced in noise\n",
+           100.0 * UNVOICED_FRACTION);
+    failures++;
+   }
+}
+
+/*****************************************************************************/
+/* test_budget()                                                             */
+/*****************************************************************************/
+
+static void test_budget(void)
+{
+ unsigned long acorr_macs = 0;
+ int j;
+
+ for ( j = 0 ; j < PITCH_MAX_LAG + 2 ; j++ )
+   {
+    acorr_macs += PITCH_WINDOW - j;
+   }
+
+ printf("pitch_process(): worst %lu MACs, mean %.0f ns on this PC\n",
+        process_macs, process_ns / process_calls);
+ printf("pitch_task():    worst %lu MACs, mean %.0f ns on this PC\n",
+        task_macs, task_ns / task_calls);
+
+ if ( process_macs )
+   {
+    printf("FAIL pitch_process() does DSPLIB work\n");
+    failures++;
+   }
+
+ if ( task_macs > acorr_macs )
+   {
+    printf("FAIL a pitch_task() run does more than one acorr, %lu MACs\n",
+           acorr_macs);
+    failures++;
+   }
+}
+
+/*****************************************************************************/
+/* read_wav()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* 16-bit PCM at 48 kHz. Stereo is made mono as stereo_to_mono() does.       */
+/*                                                                           */
+/* RETURNS: Samples read into samples[], at most MAX_SAMPLES, or -1.         */
+/*                                                                           */
+/*****************************************************************************/
+
+static long read_wav(const char *file)
+{
+ FILE *in = fopen(file, "rb");
+ unsigned char header[44];
+ unsigned char chunk[8];
+ unsigned char frame[4];
+ unsigned long size;
+ unsigned channels = 0;
+ unsigned long rate;
+ long count = 0;
+ int left;
+ int right;
+
+ if ( 0 == in || 12 != fread(header, 1, 12, in)
+      || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4) )
+   {
+    printf("FAIL %s is not a WAV file\n", file);
+    return -1;
+   }
+
+ while ( 8 == fread(chunk, 1, 8, in) )
+   {
+    size = chunk[4] | ( chunk[5] << 8 ) | ( (unsigned long) chunk[6] << 16 )
+           | ( (unsigned long) chunk[7] << 24 );
+
+    if ( 0 == memcmp(chunk, "fmt ", 4) && size >= 16 && size <= 40 )
+      {
+       fread(header, 1, size, in);
+       channels = header[2] | ( header[3] << 8 );
+       rate = header[4] | ( header[5] << 8 ) | ( (unsigned long) header[6] << 16 );
+
+       if ( 1 != ( header[0] | ( header[1] << 8 ) )
+            || 16 != ( header[14] | ( header[15] << 8 ) )
+            || SAMPLES_PER_SECOND != rate || channels < 1 || channels > 2 )
+         {
+          printf("FAIL %s is not 16-bit PCM at 48 kHz\n", file);
+          fclose(in);
+          return -1;
+         }
+      }
+    else if ( 0 == memcmp(chunk, "data", 4) && channels )
+      {
+       while ( count < MAX_SAMPLES
+               && channels == fread(frame, 2, channels, in) )
+         {
+          left = (short) ( frame[0] | ( frame[1] << 8 ) );
+          right = ( 2 == channels ) ? (short) ( frame[2] | ( frame[3] << 8 ) )
+                                    : left;
+          samples[count++] = (DATA) ( ( left + right ) / 2 );
+         }
+
+       break;
+      }
+    else
+      {
+       fseek(in, size + ( size & 1 ), SEEK_CUR);
+      }
+   }
+
+ fclose(in);
+ return count;
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ long count;
+ long estimates;
+ long voiced;
+ long right;
+
+ if ( 2 == argc )
+   {
+    count = read_wav(argv[1]);
+
+    if ( count < 0 )
+      {
+       return 1;
+      }
+
+    run(count, 0, 0.0, 1, &estimates, &voiced, &right);
+    printf("%ld samples, %ld of %ld estimates voiced\n", count, voiced,
+           estimates);
+    return 0;
+   }
+
+ if ( 1 != argc )
+   {
+    printf("Usage: pitch_check [in.wav]\n");
+    return 1;
+   }
+
+ test_voiced(SINE, "Sine");
+ test_voiced(SAWTOOTH, "Sawtooth");
+ test_voiced(PULSES, "Pulses");
+ test_unvoiced();
+ test_budget();
+
+ printf("%d failures\n", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of pitch_check.c                                                      */
+/*****************************************************************************/
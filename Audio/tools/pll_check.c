@@ -0,0 +1,346 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pll_check.c                                                             */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick PLL solver.                  */
+/*                                                                           */
+/*   Runs pll_solve.c on a PC. getSysClk() decodes the CGCR registers with   */
+/*   pll_clock_hz(), so that is what each solution is checked against.       */
+/*                                                                           */
+/*   The tests check that the TI configurations in PLL.c decode to the       */
+/*   clocks they are named for, that every clock from the lowest the PLL     */
+/*   can reach to PLL_VCO_MAX_HZ, in 1 kHz steps, is solved with the VCO in  */
+/*   range and the registers decoding to the clock pll_solve() reports, with */
+/*   no other divider and multiplier coming closer, that multiples and       */
+/*   fractions of PLL_AUDIO_HZ come out exact with a whole number of cycles  */
+/*   per 48 kHz sample, and that clocks out of range are refused.            */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o pll_check tools/pll_check.c src/pll_solve.c   */
+/*                                                                           */
+/*   pll_check          Run the tests. Exit status is the failure count.     */
+/*   pll_check -v       Also list the PLL.c table and the audio clocks.      */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "usbstk5505.h"
+#include "pll_solve.h"
+
+#define SWEEP_STEP_HZ   1000UL
+
+typedef struct
+{
+    const char *name;
+    Uint32 hz;                          /* Clock the entry is named for     */
+    Uint16 cgcr[4];
+} TABLE_ENTRY;
+
+/* As pllCfg_xxx in PLL.c for CHIP_C5505_C5515 */
+
+static const TABLE_ENTRY table[] =
+{
+    { "1MHz",      1000000UL, { 0x8895, 0x8000, 0x0806, 0x0247 } },
+    { "2MHz",      2000000UL, { 0x8895, 0x8000, 0x0806, 0x0223 } },
+    { "12MHz",    12000000UL, { 0x8895, 0x8000, 0x0806, 0x0205 } },
+    { "12p288MHz", 12288000UL, { 0x8173, 0x8000, 0x0806, 0x0000 } },
+    { "40MHz",    40000000UL, { 0x8E4A, 0x8000, 0x0806, 0x0202 } },
+    { "60MHz",    60000000UL, { 0x8724, 0x8000, 0x0806, 0x0000 } },
+    { "75MHz",    75000000UL, { 0x88ED, 0x8000, 0x0806, 0x0000 } },
+    { "98MHz",    98000000UL, { 0x8BAB, 0x8000, 0x0806, 0x0000 } },
+    { "100MHz",  100000000UL, { 0x8BE8, 0x8000, 0x0806, 0x0000 } },
+    { "120MHz",  120000000UL, { 0x8E4A, 0x8000, 0x0806, 0x0000 } }
+};
+
+static int verbose = 0;
+static int failures = 0;
+
+/*****************************************************************************/
+/* fail()                                                                    */
+/*****************************************************************************/
+
+static void fail(const char *what, Uint32 hz)
+{
+ printf("FAIL %s at %lu Hz\n", what, (unsigned long) hz);
+ failures++;
+}
+
+/*****************************************************************************/
+/* distance()                                                                */
+/*****************************************************************************/
+
+static Uint32 distance(Uint32 a, Uint32 b)
+{
+ return ( a > b ) ? a - b : b - a;
+}
+
+/*****************************************************************************/
+/* closer_setting()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: 1 if any divider, with the multipliers either side of hz times   */
+/*          it that keep the VCO in range, comes closer to hz than the       */
+/*          multiplier and divider given.                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static int closer_setting(Uint32 hz, Uint32 multiplier, Uint32 divider)
+{
+ unsigned long long lowest = ( PLL_VCO_MIN_HZ + PLL_CLOCKIN_HZ - 1 )
+                             / PLL_CLOCKIN_HZ;
+ unsigned long long highest = PLL_VCO_MAX_HZ / PLL_CLOCKIN_HZ;
+ unsigned long long error;
+ unsigned long long d;
+ unsigned long long m;
+ unsigned long long side;
+
+ error = (unsigned long long) distance(multiplier * PLL_CLOCKIN_HZ,
+                                       hz * divider);
+
+ for ( d = 1 ; d <= PLL_OUTDIV_MAX ; d++ )
+   {
+    for ( side = 0 ; side < 2 ; side++ )
+      {
+       m = ( hz * d ) / PLL_CLOCKIN_HZ + side;
+       m = ( m < lowest ) ? lowest : ( m > highest ) ? highest : m;
+
+       /* |m * 32768 - hz * d| / d < error / divider */
+
+       if ( ( ( m * PLL_CLOCKIN_HZ > hz * d ) ? m * PLL_CLOCKIN_HZ - hz * d
+                                               : hz * d - m * PLL_CLOCKIN_HZ )
+            * divider < error * d )
+         {
+          return 1;
+         }
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* check_solution()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Everything that must hold for any clock pll_solve() accepts.              */
+/*                                                                           */
+/*****************************************************************************/
+
+static void check_solution(Uint32 hz, const PLL_SOLUTION *solution,
+                           Uint32 result)
+{
+ Uint32 multiplier = ( solution->cgcr1 & PLL_CGCR1_M_MASK ) + 4;
+ Uint32 divider = 1;
+ Uint32 vco;
+
+ if ( solution->cgcr4 & PLL_CGCR4_OUTDIVEN )
+   {
+    divider = ( solution->cgcr4 & PLL_CGCR4_ODRATIO_MASK ) + 1;
+   }
+
+ vco = multiplier * PLL_CLOCKIN_HZ;
+
+ if ( result != solution->hz
+      || result != pll_clock_hz(solution->cgcr1, solution->cgcr2,
+                                solution->cgcr4) )
+   {
+    fail("registers do not decode to the clock reported", hz);
+   }
+
+ if ( vco < PLL_VCO_MIN_HZ || vco > PLL_VCO_MAX_HZ )
+   {
+    fail("VCO out of range", hz);
+   }
+
+ if ( ( solution->cgcr1 & ~( PLL_CGCR1_RSVD | PLL_CGCR1_M_MASK ) )
+      || !( solution->cgcr1 & PLL_CGCR1_RSVD )
+      || solution->cgcr2 != PLL_CGCR2_RDBYPASS
+      || solution->cgcr3 != PLL_CGCR3_INIT
+      || ( solution->cgcr4
+           & ~( PLL_CGCR4_OUTDIVEN | PLL_CGCR4_ODRATIO_MASK ) ) )
+   {
+    fail("bad register value", hz);
+   }
+
+ /* A whole multiplier step at the output, plus the rounding down */
+
+ if ( distance(result, hz) > PLL_CLOCKIN_HZ / divider + 1 )
+   {
+    fail("further out than a step", hz);
+   }
+
+ if ( closer_setting(hz, multiplier, divider) )
+   {
+    fail("a closer setting was missed", hz);
+   }
+}
+
+/*****************************************************************************/
+/* test_table()                                                              */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The decoding has to agree with the clocks TI gave these values for.       */
+/*                                                                           */
+/*****************************************************************************/
+
+static void test_table(void)
+{
+ unsigned int n;
+ Uint32 hz;
+
+ for ( n = 0 ; n < sizeof(table) / sizeof(table[0]) ; n++ )
+   {
+    hz = pll_clock_hz(table[n].cgcr[0], table[n].cgcr[1], table[n].cgcr[3]);
+
+    if ( verbose )
+      {
+       printf("pllCfg_%-10s %9lu Hz\n", table[n].name, (unsigned long) hz);
+      }
+
+    if ( distance(hz, table[n].hz) > table[n].hz / 200 )
+      {
+       fail("PLL.c entry decodes to the wrong clock", table[n].hz);
+      }
+   }
+
+ if ( pll_clock_hz(0x8173, 0x8000, 0x0000) != PLL_AUDIO_HZ )
+   {
+    fail("pllCfg_12p288MHz not exact", PLL_AUDIO_HZ);
+   }
+}
+
+/*****************************************************************************/
+/* test_sweep()                                                              */
+/*****************************************************************************/
+
+static void test_sweep(void)
+{
+ PLL_SOLUTION solution;
+ Uint32 lowest;
+ Uint32 hz;
+ Uint32 result;
+ Uint32 solved = 0;
+
+ lowest = ( PLL_VCO_MIN_HZ + PLL_OUTDIV_MAX - 1 ) / PLL_OUTDIV_MAX;
+ lowest = ( ( lowest + SWEEP_STEP_HZ - 1 ) / SWEEP_STEP_HZ ) * SWEEP_STEP_HZ;
+
+ for ( hz = lowest ; hz <= PLL_VCO_MAX_HZ ; hz += SWEEP_STEP_HZ )
+   {
+    result = pll_solve(hz, &solution);
+
+    if ( 0 == result )
+      {
+       fail("not solved", hz);
+       continue;
+      }
+
+    check_solution(hz, &solution, result);
+    solved++;
+   }
+
+ if ( verbose )
+   {
+    printf("%lu clocks from %lu Hz solved\n", (unsigned long) solved,
+           (unsigned long) lowest);
+   }
+}
+
+/*****************************************************************************/
+/* test_audio()                                                              */
+/*****************************************************************************/
+
+static void test_audio(void)
+{
+ PLL_SOLUTION solution;
+ Uint32 hz;
+ Uint32 n;
+
+ for ( n = 1 ; n * PLL_AUDIO_HZ <= PLL_VCO_MAX_HZ ; n++ )
+   {
+    hz = n * PLL_AUDIO_HZ;
+
+    if ( pll_solve(hz, &solution) != hz )
+      {
+       fail("multiple of PLL_AUDIO_HZ not exact", hz);
+       continue;
+      }
+
+    check_solution(hz, &solution, hz);
+
+    if ( hz % 48000 != 0 || hz / 48000 != 256 * n )
+      {
+       fail("cycles per sample not whole", hz);
+      }
+
+    if ( verbose )
+      {
+       printf("%9lu Hz  CGCR1 %04X CGCR4 %04X  %4lu cycles per sample\n",
+              (unsigned long) hz, solution.cgcr1, solution.cgcr4,
+              (unsigned long) ( hz / 48000 ));
+      }
+   }
+
+ for ( n = 2 ; n <= 8 ; n *= 2 )
+   {
+    hz = PLL_AUDIO_HZ / n;
+
+    if ( pll_solve(hz, &solution) != hz )
+      {
+       fail("fraction of PLL_AUDIO_HZ not exact", hz);
+      }
+   }
+}
+
+/*****************************************************************************/
+/* test_refused()                                                            */
+/*****************************************************************************/
+
+static void test_refused(void)
+{
+ static const Uint32 out_of_range[] =
+ {
+    0, 1, 32768, 200000, PLL_VCO_MAX_HZ + 1, 150000000UL, 0xFFFFFFFFUL
+ };
+ PLL_SOLUTION solution;
+ unsigned int n;
+
+ for ( n = 0 ; n < sizeof(out_of_range) / sizeof(out_of_range[0]) ; n++ )
+   {
+    memset(&solution, 0x55, sizeof(solution));
+
+    if ( pll_solve(out_of_range[n], &solution) != 0
+         || solution.cgcr1 != 0x5555 )
+      {
+       fail("out of range clock not refused", out_of_range[n]);
+      }
+   }
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ if ( argc > 1 && 0 == strcmp(argv[1], "-v") )
+   {
+    verbose = 1;
+   }
+
+ test_table();
+ test_sweep();
+ test_audio();
+ test_refused();
+
+ printf("%d failures\n", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of pll_check.c                                                        */
+/*****************************************************************************/
@@ -0,0 +1,464 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 pool_stress.c                                                           */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick block pools.                 */
+/*                                                                           */
+/*   Runs pool.c on a PC. SIGALRM, every STRESS_TICK_US, stands in for an    */
+/*   interrupt: IRQ_globalDisable() blocks it and IRQ_globalRestore() lets   */
+/*   it in again, so the handler can break into the main loop anywhere the   */
+/*   hardware could.                                                         */
+/*                                                                           */
+/*   The tests check that pool_init() refuses bad sizes and alignment, that  */
+/*   every block is handed out once, in range and aligned, that an empty     */
+/*   pool returns NULL and counts it, and that pool_free() refuses pointers  */
+/*   that are not a block start and blocks freed already.                    */
+/*                                                                           */
+/*   Then the main loop and the handler both take and give back blocks at    */
+/*   random from one pool too small for both. Each fills its blocks with     */
+/*   its own pattern and checks it on the way back, so a block handed to     */
+/*   both at once shows up. At the end every block must be free again and    */
+/*   the counts must add up.                                                 */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o pool_stress tools/pool_stress.c src/pool.c    */
+/*                                                                           */
+/*   pool_stress        Run the tests. Exit status is the failure count.     */
+/*   pool_stress -v     Also print the pool statistics.                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+#include "usbstk5505.h"
+#include "csl_intc.h"
+#include "pool.h"
+
+#define BLOCK_WORDS     16
+#define BLOCKS          12
+#define MAIN_HOLD       10              /* Most blocks each side holds      */
+#define ISR_HOLD        4
+#define STRESS_LOOPS    2000000UL
+#define STRESS_TICK_US  20
+
+volatile Uint16 host_ioport[0x10000];
+
+static Uint16 memory[POOL_WORDS(BLOCK_WORDS, BLOCKS)]
+                    __attribute__((aligned(sizeof(void *))));
+static POOL pool;
+
+static Uint16 *main_held[MAIN_HOLD];
+static Uint16 *isr_held[ISR_HOLD];
+static Uint32 main_frees = 0;
+static volatile Uint32 isr_allocs = 0;
+static volatile Uint32 isr_frees = 0;
+static volatile Uint32 interrupts = 0;
+static volatile int isr_failures = 0;
+
+static Uint32 main_seed = 1;
+static Uint32 isr_seed = 2;
+
+static volatile Bool intm = 1;
+static int verbose = 0;
+static int failures = 0;
+
+/*****************************************************************************/
+/* IRQ_globalDisable() and IRQ_globalRestore()                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* INTM is 1 with interrupts off, as on the C55x.                            */
+/*                                                                           */
+/*****************************************************************************/
+
+static void block_alarm(int how)
+{
+ sigset_t set;
+
+ sigemptyset(&set);
+ sigaddset(&set, SIGALRM);
+ sigprocmask(how, &set, 0);
+}
+
+Bool IRQ_globalDisable()
+{
+ Bool old;
+
+ block_alarm(SIG_BLOCK);
+ old = intm;
+ intm = 1;
+ return old;
+}
+
+void IRQ_globalRestore(Bool val)
+{
+ intm = val;
+
+ if ( !val )
+   {
+    block_alarm(SIG_UNBLOCK);
+   }
+}
+
+/*****************************************************************************/
+/* fail()                                                                    */
+/*****************************************************************************/
+
+static void fail(const char *what)
+{
+ printf("FAIL %s\n", what);
+ failures++;
+}
+
+/*****************************************************************************/
+/* next()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* A generator each for the main loop and the handler, as rand() is not      */
+/* safe to call from a signal handler.                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static int next(Uint32 *seed, int range)
+{
+ *seed = *seed * 1103515245UL + 12345UL;
+ return (int) ( ( *seed >> 16 ) & 0x7FFF ) % range;
+}
+
+/*****************************************************************************/
+/* fill() and intact()                                                       */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Every word of a block gets the owner and the block's own address, so a    */
+/* block held twice, or written through a stale pointer, does not check out. */
+/*                                                                           */
+/*****************************************************************************/
+
+static Uint16 pattern(const Uint16 *block, Uint16 owner, int n)
+{
+ return (Uint16) ( owner ^ ( (size_t) block >> 1 ) ^ ( n * 0x9E37 ) );
+}
+
+static void fill(Uint16 *block, Uint16 owner)
+{
+ int n;
+
+ for ( n = 0 ; n < BLOCK_WORDS ; n++ )
+   {
+    block[n] = pattern(block, owner, n);
+   }
+}
+
+static int intact(const Uint16 *block, Uint16 owner)
+{
+ int n;
+
+ for ( n = 0 ; n < BLOCK_WORDS ; n++ )
+   {
+    if ( block[n] != pattern(block, owner, n) )
+      {
+       return 0;
+      }
+   }
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* test_init()                                                               */
+/*****************************************************************************/
+
+static void test_init(void)
+{
+ POOL bad;
+
+ if ( POOL_BAD_SIZE != pool_init(&bad, memory, 0, BLOCKS)
+      || POOL_BAD_SIZE != pool_init(&bad, memory, BLOCK_WORDS, 0)
+      || POOL_BAD_SIZE != pool_init(&bad, memory, BLOCK_WORDS,
+                                    POOL_MAX_BLOCKS + 1)
+      || POOL_BAD_SIZE != pool_init(&bad, 0, BLOCK_WORDS, BLOCKS) )
+   {
+    fail("bad size accepted");
+   }
+
+ if ( POOL_BAD_SIZE != pool_init(&bad, memory, POOL_ALIGN_WORDS + 1, 2)
+      || POOL_BAD_SIZE != pool_init(&bad, memory + 1, BLOCK_WORDS, 2) )
+   {
+    fail("bad alignment accepted");
+   }
+
+ if ( NULL != pool_alloc(&bad) || 0 != pool_available(&bad) )
+   {
+    fail("refused pool not empty");
+   }
+}
+
+/*****************************************************************************/
+/* test_blocks()                                                             */
+/*****************************************************************************/
+
+static void test_blocks(void)
+{
+ Uint16 *held[BLOCKS];
+ int n;
+ int m;
+
+ if ( POOL_OK != pool_init(&pool, memory, BLOCK_WORDS, BLOCKS) )
+   {
+    fail("pool_init() refused a good pool");
+    return;
+   }
+
+ for ( n = 0 ; n < BLOCKS ; n++ )
+   {
+    held[n] = pool_alloc(&pool);
+
+    if ( NULL == held[n] || held[n] < memory
+         || held[n] + BLOCK_WORDS > memory + BLOCKS * BLOCK_WORDS
+         || ( held[n] - memory ) % BLOCK_WORDS )
+      {
+       fail("block out of range or not on a block start");
+       return;
+      }
+
+    for ( m = 0 ; m < n ; m++ )
+      {
+       if ( held[m] == held[n] )
+         {
+          fail("block handed out twice");
+         }
+      }
+   }
+
+ if ( NULL != pool_alloc(&pool) || 1 != pool.stats.failures
+      || 0 != pool_available(&pool) || BLOCKS != pool.stats.peak )
+   {
+    fail("empty pool not reported");
+   }
+
+ if ( POOL_BAD_BLOCK != pool_free(&pool, held[0] + 1)
+      || POOL_BAD_BLOCK != pool_free(&pool, memory - BLOCK_WORDS)
+      || POOL_BAD_BLOCK != pool_free(&pool, memory + BLOCKS * BLOCK_WORDS)
+      || POOL_BAD_BLOCK != pool_free(&pool, memory + 0x10000 * BLOCK_WORDS) )
+   {
+    fail("pointer not on a block start taken back");
+   }
+
+ if ( POOL_OK != pool_free(&pool, held[3])
+      || POOL_NOT_IN_USE != pool_free(&pool, held[3]) )
+   {
+    fail("block freed twice taken back");
+   }
+
+ if ( held[3] != pool_alloc(&pool) || 5 != pool.stats.bad_frees )
+   {
+    fail("pool changed by a refused free");
+   }
+
+ for ( n = 0 ; n < BLOCKS ; n++ )
+   {
+    if ( POOL_OK != pool_free(&pool, held[n]) )
+      {
+       fail("block not taken back");
+      }
+   }
+
+ if ( BLOCKS != pool_available(&pool) || 0 != pool.stats.used )
+   {
+    fail("blocks lost");
+   }
+}
+
+/*****************************************************************************/
+/* alarm_isr()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Entered with SIGALRM blocked, as an ISR is with INTM set.                 */
+/*                                                                           */
+/*****************************************************************************/
+
+static void alarm_isr(int signal)
+{
+ Bool interrupted = intm;
+ int slot = next(&isr_seed, ISR_HOLD);
+
+ (void) signal;
+ intm = 1;
+ interrupts++;
+
+ if ( isr_held[slot] )
+   {
+    if ( !intact(isr_held[slot], 0x1500) )
+      {
+       isr_failures++;
+      }
+
+    if ( POOL_OK != pool_free(&pool, isr_held[slot]) )
+      {
+       isr_failures++;
+      }
+
+    isr_held[slot] = NULL;
+    isr_frees++;
+   }
+ else
+   {
+    isr_held[slot] = pool_alloc(&pool);
+
+    if ( isr_held[slot] )
+      {
+       fill(isr_held[slot], 0x1500);
+       isr_allocs++;
+      }
+   }
+
+ intm = interrupted;
+}
+
+/*****************************************************************************/
+/* test_stress()                                                             */
+/*****************************************************************************/
+
+static void test_stress(void)
+{
+ struct sigaction action;
+ struct itimerval timer;
+ Uint32 loop;
+ Uint32 main_allocs = 0;
+ int slot;
+
+ if ( POOL_OK != pool_init(&pool, memory, BLOCK_WORDS, BLOCKS) )
+   {
+    fail("pool_init() refused a good pool");
+    return;
+   }
+
+ memset(&action, 0, sizeof(action));
+ action.sa_handler = alarm_isr;
+ sigemptyset(&action.sa_mask);
+ sigaction(SIGALRM, &action, 0);
+
+ timer.it_interval.tv_sec = 0;
+ timer.it_interval.tv_usec = STRESS_TICK_US;
+ timer.it_value = timer.it_interval;
+ setitimer(ITIMER_REAL, &timer, 0);
+
+ IRQ_globalRestore(0);
+
+ for ( loop = 0 ; loop < STRESS_LOOPS ; loop++ )
+   {
+    slot = next(&main_seed, MAIN_HOLD);
+
+    if ( main_held[slot] )
+      {
+       if ( !intact(main_held[slot], 0xA000) )
+         {
+          fail("main block changed while held");
+         }
+
+       if ( POOL_OK != pool_free(&pool, main_held[slot]) )
+         {
+          fail("main block not taken back");
+         }
+
+       main_held[slot] = NULL;
+       main_frees++;
+      }
+    else
+      {
+       main_held[slot] = pool_alloc(&pool);
+
+       if ( main_held[slot] )
+         {
+          fill(main_held[slot], 0xA000);
+          main_allocs++;
+         }
+      }
+   }
+
+ IRQ_globalDisable();
+
+ memset(&timer, 0, sizeof(timer));
+ setitimer(ITIMER_REAL, &timer, 0);
+
+ /* Give everything back and see that the counts add up */
+
+ for ( slot = 0 ; slot < MAIN_HOLD ; slot++ )
+   {
+    if ( main_held[slot] && POOL_OK == pool_free(&pool, main_held[slot]) )
+      {
+       main_frees++;
+      }
+   }
+
+ for ( slot = 0 ; slot < ISR_HOLD ; slot++ )
+   {
+    if ( isr_held[slot] && POOL_OK == pool_free(&pool, isr_held[slot]) )
+      {
+       isr_frees++;
+      }
+   }
+
+ if ( isr_failures )
+   {
+    fail("interrupt block changed while held or not taken back");
+   }
+
+ if ( BLOCKS != pool_available(&pool) || 0 != pool.stats.bad_frees )
+   {
+    fail("blocks lost in the stress test");
+   }
+
+ if ( pool.stats.allocs != main_allocs + isr_allocs
+      || main_allocs != main_frees || isr_allocs != isr_frees )
+   {
+    fail("counts do not add up");
+   }
+
+ if ( 0 == interrupts || 0 == pool.stats.failures
+      || BLOCKS != pool.stats.peak )
+   {
+    fail("stress test never filled the pool");
+   }
+
+ if ( verbose )
+   {
+    printf("%lu interrupts, %lu allocs (%lu in the interrupt), "
+           "%lu with none free, peak %u of %u\n",
+           (unsigned long) interrupts, (unsigned long) pool.stats.allocs,
+           (unsigned long) isr_allocs, (unsigned long) pool.stats.failures,
+           pool.stats.peak, BLOCKS);
+   }
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ if ( argc > 1 && 0 == strcmp(argv[1], "-v") )
+   {
+    verbose = 1;
+   }
+
+ IRQ_globalDisable();
+
+ test_init();
+ test_blocks();
+ test_stress();
+
+ printf("%d failures\n", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of pool_stress.c                                                      */
+/*****************************************************************************/
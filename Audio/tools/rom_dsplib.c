@@ -0,0 +1,461 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 rom_dsplib.c                                                            */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick DSPLIB in the boot ROM.      */
+/*                                                                           */
+/*   Writes dsplib_rom.sym, the linker input lnkx.cmd reads when the link    */
+/*   has --define=DSPLIB_ROM. It gives each DSPLIB function declared in      */
+/*   inc/Dsplib.h that is also in the ROM symbol table its ROM address, as   */
+/*   _sine = 0xff....; so the linker never pulls that member out of          */
+/*   55xdsph.lib. Functions not in the ROM still come from the library.      */
+/*                                                                           */
+/*   The ROM symbol table is the one TI gives for the silicon revision on    */
+/*   the board. Lines in nm55 form, "00ff8000 T _sine", or in linker form,   */
+/*   "_sine = 0x00ff8000;", are both read. An address outside PDROM is a     */
+/*   failure, as the table is then not for this part.                        */
+/*                                                                           */
+/*   Given Audio_linkInfo.xml from a link without DSPLIB_ROM, it also lists  */
+/*   the 55xdsph.lib members in that link and the RAM each would free. After */
+/*   the link with DSPLIB_ROM, tools/mem_report.c -b against the first link  */
+/*   shows what was freed in fact. dsplib_bench.c gives the cycles.          */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -o tools/rom_dsplib tools/rom_dsplib.c                              */
+/*                                                                           */
+/*   rom_dsplib rom_symbols inc/Dsplib.h dsplib_rom.sym [link_info.xml]      */
+/*                                                                           */
+/*   Exit status is the failure count.                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define LINE_LENGTH     512
+#define NAME_LENGTH     64
+#define ID_LENGTH       16
+#define MAX_SYMBOLS     2048
+#define MAX_FUNCTIONS   256
+#define MAX_MEMBERS     64
+
+#define PDROM_START     0xFF8000UL      /* Bytes, as in lnkx.cmd            */
+#define PDROM_END       0x1000000UL
+#define DSPLIB_ARCHIVE  "55xdsph.lib"
+
+typedef struct
+{
+    char name[NAME_LENGTH];
+    unsigned long address;
+} SYMBOL;
+
+typedef struct
+{
+    char id[ID_LENGTH];
+    char name[NAME_LENGTH];             /* Member, sine.obj                 */
+    unsigned long bytes;
+} MEMBER;
+
+static SYMBOL symbols[MAX_SYMBOLS];
+static int symbol_count = 0;
+static char functions[MAX_FUNCTIONS][NAME_LENGTH];
+static int function_count = 0;
+static MEMBER members[MAX_MEMBERS];
+static int member_count = 0;
+static int failures = 0;
+
+/*****************************************************************************/
+/* is_hex()                                                                  */
+/*****************************************************************************/
+
+static int is_hex(const char *token)
+{
+ if ( 0 == strncmp(token, "0x", 2) || 0 == strncmp(token, "0X", 2) )
+   {
+    token += 2;
+   }
+
+ if ( strlen(token) < 4 )
+   {
+    return 0;
+   }
+
+ for ( ; *token ; token++ )
+   {
+    if ( !isxdigit((unsigned char) *token) )
+      {
+       return 0;
+      }
+   }
+
+ return 1;
+}
+
+/*****************************************************************************/
+/* read_symbols()                                                            */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* A line with a hex address and a name starting with '_' is a symbol,       */
+/* whichever comes first.                                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static int read_symbols(const char *file)
+{
+ FILE *in = fopen(file, "r");
+ char line[LINE_LENGTH];
+ char *token;
+ char *name;
+ char *address;
+
+ if ( 0 == in )
+   {
+    printf("FAIL cannot open %s\n", file);
+    return 0;
+   }
+
+ while ( fgets(line, sizeof(line), in) && symbol_count < MAX_SYMBOLS )
+   {
+    name = 0;
+    address = 0;
+
+    for ( token = strtok(line, " \t\r\n=;") ; token ;
+          token = strtok(0, " \t\r\n=;") )
+      {
+       if ( '_' == token[0] && 0 == name )
+         {
+          name = token;
+         }
+       else if ( is_hex(token) && 0 == address )
+         {
+          address = token;
+         }
+      }
+
+    if ( name && address && strlen(name) < NAME_LENGTH )
+      {
+       strcpy(symbols[symbol_count].name, name);
+       symbols[symbol_count].address = strtoul(address, 0, 16);
+       symbol_count++;
+      }
+   }
+
+ fclose(in);
+ return 1;
+}
+
+/*****************************************************************************/
+/* read_functions()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The name before the '(' of each prototype in Dsplib.h. Macros, such as    */
+/* cfft() for cfft_SCALE(), are left out.                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static int read_functions(const char *file)
+{
+ FILE *in = fopen(file, "r");
+ char line[LINE_LENGTH];
+ char *open;
+ char *end;
+ char *start;
+
+ if ( 0 == in )
+   {
+    printf("FAIL cannot open %s\n", file);
+    return 0;
+   }
+
+ while ( fgets(line, sizeof(line), in) && function_count < MAX_FUNCTIONS )
+   {
+    open = strchr(line, '(');
+
+    if ( '#' == line[0] || 0 == open || 0 == strchr(open, ';')
+         || strstr(line, "/*") || strstr(line, "*/") )
+      {
+       continue;
+      }
+
+    for ( end = open ; end > line && ' ' == end[-1] ; end-- )
+      {
+      }
+
+    for ( start = end ; start > line
+                        && ( isalnum((unsigned char) start[-1])
+                             || '_' == start[-1] ) ; start-- )
+      {
+      }
+
+    if ( start == end || start == line || end - start >= NAME_LENGTH - 1 )
+      {
+       continue;
+      }
+
+    functions[function_count][0] = '_';
+    memcpy(functions[function_count] + 1, start, end - start);
+    functions[function_count][end - start + 1] = 0;
+    function_count++;
+   }
+
+ fclose(in);
+ return 1;
+}
+
+/*****************************************************************************/
+/* find_symbol()                                                             */
+/*****************************************************************************/
+
+static const SYMBOL *find_symbol(const char *name)
+{
+ int n;
+
+ for ( n = 0 ; n < symbol_count ; n++ )
+   {
+    if ( 0 == strcmp(symbols[n].name, name) )
+      {
+       return &symbols[n];
+      }
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* write_sym()                                                               */
+/*****************************************************************************/
+
+static int write_sym(const char *file, const char *from)
+{
+ FILE *out = fopen(file, "w");
+ const SYMBOL *symbol;
+ int written = 0;
+ int n;
+
+ if ( 0 == out )
+   {
+    printf("FAIL cannot write %s\n", file);
+    return 0;
+   }
+
+ fprintf(out, "/* DSPLIB in the boot ROM. Written by tools/rom_dsplib.c from"
+         " %s */\n\n", from);
+
+ for ( n = 0 ; n < function_count ; n++ )
+   {
+    symbol = find_symbol(functions[n]);
+
+    if ( 0 == symbol )
+      {
+       continue;
+      }
+
+    if ( symbol->address < PDROM_START || symbol->address >= PDROM_END )
+      {
+       printf("FAIL %s at %06lx is not in PDROM\n", symbol->name,
+              symbol->address);
+       failures++;
+       continue;
+      }
+
+    fprintf(out, "%-16s = 0x%06lx;\n", symbol->name, symbol->address);
+    written++;
+   }
+
+ fclose(out);
+
+ printf("%d of %d DSPLIB functions are in the ROM\n", written,
+        function_count);
+ return 1;
+}
+
+/*****************************************************************************/
+/* tag_text()                                                                */
+/*****************************************************************************/
+
+static int tag_text(const char *line, const char *tag, char *text)
+{
+ char open[NAME_LENGTH];
+ const char *from;
+ const char *to;
+
+ sprintf(open, "<%s>", tag);
+ from = strstr(line, open);
+
+ if ( 0 == from )
+   {
+    return 0;
+   }
+
+ from += strlen(open);
+ to = strchr(from, '<');
+
+ if ( 0 == to || to - from >= NAME_LENGTH )
+   {
+    return 0;
+   }
+
+ memcpy(text, from, to - from);
+ text[to - from] = 0;
+ return 1;
+}
+
+/*****************************************************************************/
+/* read_link_info()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The 55xdsph.lib members in the link, and the bytes each puts in memory.   */
+/* The input files come before the components that refer to them.            */
+/*                                                                           */
+/*****************************************************************************/
+
+static int read_link_info(const char *file)
+{
+ FILE *in = fopen(file, "r");
+ char line[LINE_LENGTH];
+ char text[NAME_LENGTH];
+ char id[ID_LENGTH] = "";
+ char archive[NAME_LENGTH] = "";
+ char name[NAME_LENGTH] = "";           /* Member, or section of component  */
+ unsigned long size = 0;
+ char *p;
+ int n;
+
+ if ( 0 == in )
+   {
+    printf("FAIL cannot open %s\n", file);
+    return 0;
+   }
+
+ while ( fgets(line, sizeof(line), in) )
+   {
+    p = strstr(line, " id=\"");
+
+    if ( p && ( strstr(line, "<input_file ")
+                || strstr(line, "<object_component ") ) )
+      {
+       sscanf(p + 5, "%15[^\"]", id);
+       archive[0] = name[0] = 0;
+       size = 0;
+      }
+
+    tag_text(line, "file", archive);
+
+    if ( 0 == name[0] )
+      {
+       tag_text(line, "name", name);
+      }
+
+    if ( tag_text(line, "size", text) )
+      {
+       size = strtoul(text, 0, 0);
+      }
+
+    if ( strstr(line, "</input_file>") && 0 == strcmp(archive, DSPLIB_ARCHIVE)
+         && member_count < MAX_MEMBERS )
+      {
+       strcpy(members[member_count].id, id);
+       strcpy(members[member_count].name, name);
+       members[member_count].bytes = 0;
+       member_count++;
+      }
+
+    if ( strstr(line, "<input_file_ref") && 0 != strncmp(name, ".debug", 6)
+         && ( p = strstr(line, "idref=\"") ) )
+      {
+       for ( n = 0 ; n < member_count ; n++ )
+         {
+          if ( 0 == strncmp(p + 7, members[n].id, strlen(members[n].id))
+               && '"' == p[7 + strlen(members[n].id)] )
+            {
+             members[n].bytes += size;
+            }
+         }
+      }
+   }
+
+ fclose(in);
+ return 1;
+}
+
+/*****************************************************************************/
+/* list_members()                                                            */
+/*****************************************************************************/
+
+static void list_members(void)
+{
+ unsigned long freed = 0;
+ char name[NAME_LENGTH];
+ int n;
+
+ printf("\n%s member     bytes  ROM address\n", DSPLIB_ARCHIVE);
+
+ for ( n = 0 ; n < member_count ; n++ )
+   {
+    sprintf(name, "_%.*s", (int) strcspn(members[n].name, "."),
+            members[n].name);
+
+    if ( find_symbol(name) )
+      {
+       printf("%-20s %6lu  %06lx\n", members[n].name, members[n].bytes,
+              find_symbol(name)->address);
+       freed += members[n].bytes;
+      }
+    else
+      {
+       printf("%-20s %6lu  not in the ROM, stays in RAM\n", members[n].name,
+              members[n].bytes);
+      }
+   }
+
+ printf("RAM freed by DSPLIB_ROM: %lu bytes\n", freed);
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ if ( argc != 4 && argc != 5 )
+   {
+    printf("Usage: rom_dsplib rom_symbols Dsplib.h dsplib_rom.sym "
+           "[link_info.xml]\n");
+    return 1;
+   }
+
+ if ( !read_symbols(argv[1]) || !read_functions(argv[2]) )
+   {
+    return 1;
+   }
+
+ if ( 0 == symbol_count || 0 == function_count )
+   {
+    printf("FAIL no symbols in %s or no functions in %s\n", argv[1],
+           argv[2]);
+    return 1;
+   }
+
+ if ( !write_sym(argv[3], argv[1]) )
+   {
+    return 1;
+   }
+
+ if ( 5 == argc && read_link_info(argv[4]) )
+   {
+    list_members();
+   }
+
+ printf("%d failures\n", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of rom_dsplib.c                                                       */
+/*****************************************************************************/
@@ -0,0 +1,373 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 sched_sim.c                                                             */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick task scheduler.              */
+/*                                                                           */
+/*   Runs sched.c on a PC against a simulated GPT0 and audio loop. Time is   */
+/*   kept in us. Whenever the CPU is busy, in the audio loop or a task,      */
+/*   sched_tick() is called as each ms boundary is passed, as the timer      */
+/*   interrupt would. The audio loop takes one sample every 1/48000 s,       */
+/*   does AUDIO_US of processing and then calls sched_run(). A sample is     */
+/*   lost if the next one replaces it before the loop comes back to read it. */
+/*                                                                           */
+/*   The tests check periods, priority order, one-shot tasks, cancelling,    */
+/*   a full table, the tick counter wrapping, that SCHED_PRIORITY_TICK       */
+/*   tasks preempt a running task, that overruns, deadline misses and runs   */
+/*   over budget are counted and logged once, and that tasks within the      */
+/*   budget never lose a sample.                                             */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o sched_sim tools/sched_sim.c src/sched.c       */
+/*                                                                           */
+/*   sched_sim          Run the tests. Exit status is the failure count.     */
+/*   sched_sim -v       Also list every log record.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "usbstk5505.h"
+#include "csl_intc.h"
+#include "delay.h"
+#include "log.h"
+#include "sched.h"
+
+#define SAMPLE_US       ( 1e6 / 48000 )
+#define AUDIO_US        10.0
+#define TICK_US         ( 1e6 / SCHED_TICK_HZ )
+
+static double now_us = 0.0;             /* Simulated time                   */
+static double next_tick_us = TICK_US;
+static int in_tick = 0;
+static int verbose = 0;
+static int failures = 0;
+
+static Uint16 logged[LOG_FORMATS];
+static unsigned long samples_lost = 0;
+
+/*****************************************************************************/
+/* Stand-ins for the C55x functions used by sched.c                          */
+/*****************************************************************************/
+
+Bool IRQ_globalDisable()
+{
+ return 0;
+}
+
+void IRQ_globalRestore(Bool val)
+{
+}
+
+Uint32 delay_now(void)
+{
+ return (Uint32) now_us;                /* One tick per us                  */
+}
+
+Uint32 delay_ticks_to_us(Uint32 ticks)
+{
+ return ticks;
+}
+
+void log_write(Uint16 id, long a, long b, long c)
+{
+ if ( id < LOG_FORMATS )
+   {
+    logged[id]++;
+   }
+
+ if ( verbose )
+   {
+    printf("    log %2u: %ld %ld %ld\n", id, a, b, c);
+   }
+}
+
+/*****************************************************************************/
+/* busy()                                                                    */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The CPU works for us microseconds. The timer interrupt is taken as each   */
+/* tick comes round, and its own time is not counted.                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static void busy(double us)
+{
+ double end = now_us + us;
+
+ while ( !in_tick && next_tick_us <= end )
+   {
+    now_us = next_tick_us;
+    next_tick_us += TICK_US;
+
+    in_tick = 1;
+    sched_tick();
+    in_tick = 0;
+   }
+
+ now_us = end;
+}
+
+/*****************************************************************************/
+/* run_audio()                                                               */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* The audio loop of main() for ms milliseconds.                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void run_audio(double ms)
+{
+ double end = now_us + ms * 1000.0;
+ double sample = SAMPLE_US * ( (long) ( now_us / SAMPLE_US ) + 1 );
+
+ while ( sample < end )
+   {
+    if ( now_us < sample )
+      {
+       busy(sample - now_us);           /* aic3204_codec_read() waits       */
+      }
+
+    /* Samples that came and went while the loop was busy */
+
+    while ( now_us >= sample + SAMPLE_US )
+      {
+       samples_lost++;
+       sample += SAMPLE_US;
+      }
+
+    busy(AUDIO_US);
+    sched_run();
+
+    sample += SAMPLE_US;
+   }
+}
+
+/*****************************************************************************/
+/* Tasks. The context points at a TASK_STATE.                                */
+/*****************************************************************************/
+
+typedef struct
+{
+    const char *name;
+    double cost_us;                     /* Time each run takes              */
+    unsigned long runs;
+} TASK_STATE;
+
+static char order[64];
+static Uint16 order_length = 0;
+
+static void task(void *context)
+{
+ TASK_STATE *state = (TASK_STATE *) context;
+
+ state->runs++;
+
+ if ( order_length < sizeof(order) - 1 )
+   {
+    order[order_length++] = state->name[0];
+    order[order_length] = 0;
+   }
+
+ busy(state->cost_us);
+}
+
+/*****************************************************************************/
+/* check()                                                                   */
+/*****************************************************************************/
+
+static void check(int ok, const char *what)
+{
+ printf("%s  %s\n", ok ? "PASS" : "FAIL", what);
+
+ if ( !ok )
+   {
+    failures++;
+   }
+}
+
+static void start(void)
+{
+ sched_init();
+ memset(logged, 0, sizeof(logged));
+ order_length = 0;
+ order[0] = 0;
+ samples_lost = 0;
+}
+
+/*****************************************************************************/
+/* Tests                                                                     */
+/*****************************************************************************/
+
+static void test_periods(void)
+{
+ TASK_STATE a = { "a", 2.0, 0 };
+ TASK_STATE b = { "b", 2.0, 0 };
+
+ start();
+ sched_periodic(task, &a, 5, 5, 0);
+ sched_periodic(task, &b, 5, 1, 0);
+ run_audio(1000.0);
+
+ check(a.runs >= 199 && a.runs <= 200, "5 ms task runs 200 times a second");
+ check(b.runs >= 999 && b.runs <= 1000, "1 ms task runs 1000 times a second");
+ check(0 == samples_lost, "no samples lost");
+}
+
+static void test_priority(void)
+{
+ TASK_STATE low = { "L", 1.0, 0 };
+ TASK_STATE high = { "H", 1.0, 0 };
+ TASK_STATE mid = { "M", 1.0, 0 };
+
+ start();
+ sched_periodic(task, &low, 9, 10, 0);
+ sched_periodic(task, &high, 2, 10, 0);
+ sched_periodic(task, &mid, 5, 10, 0);
+ run_audio(30.5);
+
+ check(0 == strcmp(order, "HMLHMLHML"), "released together, run by priority");
+}
+
+static void test_one_shot(void)
+{
+ TASK_STATE once = { "o", 1.0, 0 };
+ Int16 id;
+
+ start();
+ id = sched_one_shot(task, &once, 5, 7, 0);
+ run_audio(6.5);
+ check(0 == once.runs, "one-shot not run before its delay");
+ run_audio(10.0);
+ check(1 == once.runs, "one-shot run once");
+ check(!sched_tasks[id].armed && !sched_tasks[id].ready,
+       "one-shot slot free after the run");
+}
+
+static void test_cancel_and_full(void)
+{
+ TASK_STATE a = { "a", 1.0, 0 };
+ TASK_STATE spare = { "s", 1.0, 0 };
+ Int16 id;
+ Int16 i;
+
+ start();
+ id = sched_periodic(task, &a, 5, 2, 0);
+ run_audio(10.5);
+ sched_cancel(id);
+ a.runs = 0;
+ run_audio(10.0);
+ check(0 == a.runs, "no runs after sched_cancel()");
+
+ for ( i = 0 ; i < SCHED_TASKS ; i++)
+   {
+    sched_periodic(task, &spare, 5, 100, 0);
+   }
+
+ check(SCHED_FULL == sched_periodic(task, &spare, 5, 100, 0),
+       "SCHED_FULL when every slot is used");
+}
+
+static void test_wrap(void)
+{
+ TASK_STATE a = { "a", 1.0, 0 };
+
+ start();
+ sched_now = 0xFFF0;
+ sched_periodic(task, &a, 5, 4, 0);
+ run_audio(100.0);
+ check(a.runs >= 24 && a.runs <= 25, "periods kept when the tick wraps");
+}
+
+static void test_preemption(void)
+{
+ TASK_STATE tick = { "t", 0.5, 0 };
+ TASK_STATE slow = { "s", 3000.0, 0 };
+
+ start();
+ sched_periodic(task, &tick, SCHED_PRIORITY_TICK, 1, 0);
+ sched_one_shot(task, &slow, 5, 1, 0);
+ run_audio(1.5);
+ check(tick.runs >= 4, "tick task runs while a 3 ms task is running");
+}
+
+static void test_overrun(void)
+{
+ TASK_STATE slow = { "s", 2500.0, 0 };
+
+ start();
+ sched_periodic(task, &slow, 5, 2, 0);
+ run_audio(50.0);
+ check(sched_tasks[0].overruns > 0, "2.5 ms task every 2 ms overruns");
+ check(1 == logged[LOG_SCHED_OVERRUN], "overrun logged once");
+}
+
+static void test_deadline(void)
+{
+ TASK_STATE hog = { "h", 4000.0, 0 };
+ TASK_STATE urgent = { "u", 1.0, 0 };
+
+ start();
+ sched_periodic(task, &hog, 2, 5, 0);
+ sched_periodic(task, &urgent, 5, 5, 2);
+ run_audio(50.0);
+ check(sched_tasks[1].misses > 0,
+       "task behind a 4 ms task misses its 2 ms deadline");
+ check(1 == logged[LOG_SCHED_DEADLINE], "deadline miss logged once");
+}
+
+static void test_budget(void)
+{
+ TASK_STATE log_drain = { "l", 3.0, 0 };
+ TASK_STATE step = { "s", 1.0, 0 };
+ TASK_STATE long_task = { "x", 50.0, 0 };
+
+ start();
+ sched_periodic(task, &log_drain, SCHED_PRIORITY_LOW, 1, 0);
+ sched_periodic(task, &step, SCHED_PRIORITY_HIGH, 10, 0);
+ run_audio(200.0);
+ check(0 == samples_lost && 0 == logged[LOG_SCHED_BUDGET],
+       "tasks within SCHED_BUDGET_US lose no samples");
+
+ start();
+ sched_periodic(task, &long_task, 5, 10, 0);
+ run_audio(200.0);
+ check(samples_lost > 0 && sched_tasks[0].over_budget > 0
+       && 1 == logged[LOG_SCHED_BUDGET],
+       "50 us task is over budget and loses samples");
+ printf("      %lu samples lost, worst run %lu us\n", samples_lost,
+        sched_tasks[0].worst_us);
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ if ( argc > 1 && 0 == strcmp(argv[1], "-v") )
+   {
+    verbose = 1;
+   }
+
+ test_periods();
+ test_priority();
+ test_one_shot();
+ test_cancel_and_full();
+ test_wrap();
+ test_preemption();
+ test_overrun();
+ test_deadline();
+ test_budget();
+
+ printf("%d failures\n", failures);
+
+ return failures;
+}
+
+/*****************************************************************************/
+/* End of sched_sim.c                                                        */
+/*****************************************************************************/
@@ -0,0 +1,376 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 uart_client.c                                                           */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick command protocol.            */
+/*                                                                           */
+/*   Sends one command from command.h to the board, or to uart_pty, and      */
+/*   prints the reply. Log frames on the line are counted and skipped; use   */
+/*   log_decode on a capture to read them.                                   */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o uart_client tools/uart_client.c               */
+/*                                                                           */
+/*   uart_client device ping                                                 */
+/*   uart_client device preset 0|1      Bypass or low pass                   */
+/*   uart_client device auto 0|1        Automatic preset switching           */
+/*   uart_client device set name value  name: switch_secs, changes,          */
+/*   uart_client device get name              volume, mute, filter           */
+/*                                                                           */
+/*   filter is the preset 1 low pass cutoff in Hz: 300, 600, 1000, 1200,     */
+/*   2000, 2400, 4000, 4800 (at reset) or 9600.                              */
+/*   uart_client device telemetry                                            */
+/*                                                                           */
+/*   The device is for example /dev/ttyUSB0, set to 115200 baud, 8 bits,     */
+/*   no parity. Exit status is 0 if the reply status is CMD_OK.              */
+/*                                                                           */
+/*****************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+#include "log.h"
+#include "command.h"
+
+#define REPLY_TIMEOUT_MS    1000
+
+static const char *const parameters[CMD_PARAMS] =
+{
+    "switch_secs", "changes", "volume", "mute", "filter"
+};
+
+static const char *const statuses[] =
+{
+    "OK", "bad command", "bad length", "bad value", "bad checksum", "busy"
+};
+
+static int fd = -1;
+static unsigned long log_frames = 0;
+
+/*****************************************************************************/
+/* get_byte()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* RETURNS: The next byte, or -1 if none came in time.                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static int get_byte(void)
+{
+ struct timeval timeout;
+ fd_set readable;
+ unsigned char byte;
+
+ FD_ZERO(&readable);
+ FD_SET(fd, &readable);
+ timeout.tv_sec = REPLY_TIMEOUT_MS / 1000;
+ timeout.tv_usec = ( REPLY_TIMEOUT_MS % 1000 ) * 1000;
+
+ if ( select(fd + 1, &readable, NULL, NULL, &timeout) <= 0
+      || read(fd, &byte, 1) != 1 )
+   {
+    return -1;
+   }
+
+ return byte;
+}
+
+/*****************************************************************************/
+/* transact()                                                                */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* Send a command and wait for its reply, skipping log frames and anything   */
+/* with a bad checksum.                                                      */
+/*                                                                           */
+/* RETURNS: Reply status, or -1 if no reply came. The reply payload after    */
+/*          the status is put in reply, and its length in reply_length.      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int transact(int command, const unsigned char *payload, int length,
+                    unsigned char *reply, int *reply_length)
+{
+ unsigned char frame[5 + CMD_MAX_PAYLOAD];
+ unsigned char in[LOG_FRAME_BYTES + CMD_MAX_PAYLOAD];
+ unsigned int sum = 0;
+ int n = 0;
+ int byte;
+ int i;
+
+ frame[n++] = CMD_SYNC;
+ frame[n++] = command;
+ frame[n++] = length;
+ memcpy(&frame[n], payload, length);
+ n += length;
+
+ for ( i = 1 ; i < n ; i++)
+   {
+    sum += frame[i];
+   }
+
+ frame[n++] = ( 0x100 - ( sum & 0xFF ) ) & 0xFF;
+
+ if ( write(fd, frame, n) != n )
+   {
+    perror("write");
+    return -1;
+   }
+
+ while ( ( byte = get_byte() ) >= 0 )
+   {
+    if ( LOG_SYNC == byte )
+      {
+       for ( i = 1, sum = 0 ; i < LOG_FRAME_BYTES ; i++)
+         {
+          if ( ( byte = get_byte() ) < 0 )
+            {
+             return -1;
+            }
+
+          sum += byte;
+         }
+
+       log_frames += ( 0 == ( sum & 0xFF ) );
+       continue;
+      }
+
+    if ( CMD_SYNC != byte )
+      {
+       continue;
+      }
+
+    /* command, length, length bytes, checksum */
+
+    for ( i = 0 ; i < 2 ; i++)
+      {
+       if ( ( byte = get_byte() ) < 0 )
+         {
+          return -1;
+         }
+
+       in[i] = byte;
+      }
+
+    if ( in[1] < 1 || in[1] > CMD_MAX_PAYLOAD + 1 )
+      {
+       continue;
+      }
+
+    for ( i = 2 ; i < in[1] + 3 ; i++)
+      {
+       if ( ( byte = get_byte() ) < 0 )
+         {
+          return -1;
+         }
+
+       in[i] = byte;
+      }
+
+    for ( i = 0, sum = 0 ; i < in[1] + 3 ; i++)
+      {
+       sum += in[i];
+      }
+
+    if ( ( sum & 0xFF ) != 0 || in[0] != ( command | CMD_REPLY ) )
+      {
+       continue;
+      }
+
+    *reply_length = in[1] - 1;
+    memcpy(reply, &in[3], *reply_length);
+
+    return in[2];
+   }
+
+ return -1;
+}
+
+/*****************************************************************************/
+/* open_device()                                                             */
+/*****************************************************************************/
+
+static int open_device(const char *name)
+{
+ struct termios tio;
+
+ fd = open(name, O_RDWR | O_NOCTTY);
+
+ if ( fd < 0 )
+   {
+    perror(name);
+    return -1;
+   }
+
+ if ( 0 == tcgetattr(fd, &tio) )
+   {
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+    tcsetattr(fd, TCSANOW, &tio);
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* parameter()                                                               */
+/*****************************************************************************/
+
+static int parameter(const char *name)
+{
+ int i;
+
+ for ( i = 0 ; i < CMD_PARAMS ; i++)
+   {
+    if ( 0 == strcmp(name, parameters[i]) )
+      {
+       return i;
+      }
+   }
+
+ fprintf(stderr, "Unknown parameter %s\n", name);
+ exit(2);
+}
+
+static unsigned long get(const unsigned char *p, int bytes)
+{
+ unsigned long value = 0;
+
+ while ( bytes-- > 0 )
+   {
+    value = ( value << 8 ) | p[bytes];
+   }
+
+ return value;
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ unsigned char payload[CMD_MAX_PAYLOAD];
+ unsigned char reply[CMD_MAX_PAYLOAD];
+ int reply_length = 0;
+ int length = 0;
+ int command;
+ int status;
+ long value;
+
+ if ( argc < 3 )
+   {
+    fprintf(stderr, "Usage: uart_client device ping | preset n | auto 0|1"
+                    " | set name value | get name | telemetry\n");
+    return 2;
+   }
+
+ if ( 0 == strcmp(argv[2], "ping") )
+   {
+    command = CMD_PING;
+   }
+ else if ( 0 == strcmp(argv[2], "preset") && argc > 3 )
+   {
+    command = CMD_PRESET;
+    payload[length++] = atoi(argv[3]);
+   }
+ else if ( 0 == strcmp(argv[2], "auto") && argc > 3 )
+   {
+    command = CMD_AUTO;
+    payload[length++] = atoi(argv[3]);
+   }
+ else if ( 0 == strcmp(argv[2], "set") && argc > 4 )
+   {
+    command = CMD_SET;
+    value = strtol(argv[4], NULL, 0);
+    payload[length++] = parameter(argv[3]);
+    payload[length++] = value & 0xFF;
+    payload[length++] = ( value >> 8 ) & 0xFF;
+   }
+ else if ( 0 == strcmp(argv[2], "get") && argc > 3 )
+   {
+    command = CMD_GET;
+    payload[length++] = parameter(argv[3]);
+   }
+ else if ( 0 == strcmp(argv[2], "telemetry") )
+   {
+    command = CMD_TELEMETRY;
+   }
+ else
+   {
+    fprintf(stderr, "Unknown command %s\n", argv[2]);
+    return 2;
+   }
+
+ if ( open_device(argv[1]) != 0 )
+   {
+    return 1;
+   }
+
+ status = transact(command, payload, length, reply, &reply_length);
+
+ if ( status < 0 )
+   {
+    fprintf(stderr, "No reply\n");
+    return 1;
+   }
+
+ if ( CMD_OK != status )
+   {
+    printf("%s\n", status < 6 ? statuses[status] : "unknown status");
+    return 1;
+   }
+
+ if ( CMD_PING == command && reply_length >= 1 )
+   {
+    printf("Protocol version %d\n", reply[0]);
+   }
+ else if ( CMD_GET == command && reply_length >= 2 )
+   {
+    printf("%s = %d\n", argv[3], (short) get(reply, 2));
+   }
+ else if ( CMD_TELEMETRY == command && reply_length >= CMD_TELEMETRY_BYTES )
+   {
+    printf("Preset              %u%s\n", reply[0],
+           reply[1] ? " (switching)" : "");
+    printf("Preset changes      %lu\n", get(&reply[2], 2));
+    printf("Pitch               %.1f Hz, confidence %.2f\n",
+           get(&reply[4], 2) / 16.0, (short) get(&reply[6], 2) / 32768.0);
+    printf("DTMF key            %c\n", reply[8] ? reply[8] : '-');
+    printf("PGA gain            %.1f dB\n", reply[9] / 2.0);
+    printf("AGC gain            %.3f\n", get(&reply[10], 2) / 4096.0);
+    printf("Log records lost    %lu\n", get(&reply[12], 4));
+    printf("I2C errors          %lu\n", get(&reply[16], 4));
+    printf("Task faults         %lu\n", get(&reply[20], 2));
+    printf("UART errors         %lu\n", get(&reply[22], 2));
+    printf("Samples late        %lu\n", get(&reply[24], 4));
+    printf("Processing level    %u%s\n", reply[28],
+           reply[28] ? " (stages shed)" : "");
+   }
+ else
+   {
+    printf("OK\n");
+   }
+
+ if ( log_frames )
+   {
+    fprintf(stderr, "%lu log frames skipped\n", log_frames);
+   }
+
+ close(fd);
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* End of uart_client.c                                                      */
+/*****************************************************************************/
@@ -0,0 +1,269 @@
+/*****************************************************************************/
+/*                                                                           */
+/* FILENAME                                                                  */
+/* 	 uart_pty.c                                                              */
+/*                                                                           */
+/* DESCRIPTION                                                               */
+/*   Host program for the TMS320C5505 USB Stick command protocol.            */
+/*                                                                           */
+/*   Stands in for the board on Linux. Runs command.c behind a pseudo        */
+/*   terminal and prints the name of its slave side, which uart_client and   */
+/*   other programs can open as if it were the USB serial port.              */
+/*                                                                           */
+/*   command_task() is called once per ms, as the scheduler would. Bytes     */
+/*   from the terminal go into the receive buffer read by uart_read(), and   */
+/*   uart_write() sends straight back. Steps switch every switch_secs while  */
+/*   automatic switching is on, and each second a LOG_CLOCK frame is sent,   */
+/*   as log_drain() would, so that clients are tested with log frames on     */
+/*   the line. Codec writes are only printed.                                */
+/*                                                                           */
+/*   Build from the Audio directory:                                         */
+/*                                                                           */
+/*   gcc -Itools/host -Iinc -o uart_pty tools/uart_pty.c src/command.c       */
+/*       src/IIR_low_pass_filters.c                                          */
+/*                                                                           */
+/*   uart_pty           Run until stopped.                                   */
+/*   uart_pty seconds   Stop after that many seconds.                        */
+/*                                                                           */
+/*****************************************************************************/
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+#include "usbstk5505.h"
+#include "csl_intc.h"
+#include "aic3204.h"
+#include "agc.h"
+#include "pitch.h"
+#include "i2c_queue.h"
+#include "log.h"
+#include "sched.h"
+#include "timer.h"
+#include "uart.h"
+#include "supervisor.h"
+#include "IIR_low_pass_filters.h"
+#include "command.h"
+
+#define TICKS_PER_MS    50000           /* delay_now() at 100 MHz           */
+
+volatile Uint16 host_ioport[0x10000];
+
+/* State normally in main.c, timer.c, agc.c, pitch.c and the drivers */
+
+unsigned int Step = 0;
+unsigned int playnum = 0;
+volatile unsigned int auto_switch = 1;
+volatile unsigned int switch_secs = SWITCH_SECS;
+volatile unsigned int change_limit = AUDIOBACK_COUNT;
+char dtmf_key = 0;
+unsigned int low_pass_filter = IIR_LOW_PASS_4800HZ;
+volatile Uint16 agc_gain = AGC_UNITY_GAIN;
+volatile Uint16 agc_pga_gain = 20;
+volatile PITCH_Estimate pitch_estimate = { 220 << 4, 30000, 1, 0 };
+volatile I2C_QUEUE_STATS i2c_queue_stats;
+volatile UART_STATS uart_stats;
+volatile SUPERVISOR_STATS supervisor_stats;
+volatile Uint32 log_dropped = 0;
+SCHED_TASK sched_tasks[SCHED_TASKS];
+
+static int master = -1;
+static Uint8 rx_buffer[UART_RX_BYTES];
+static Uint16 rx_count = 0;
+static Uint16 rx_index = 0;
+
+/*****************************************************************************/
+/* Stand-ins for the C55x functions used by command.c                        */
+/*****************************************************************************/
+
+Bool IRQ_globalDisable()
+{
+ return 0;
+}
+
+void IRQ_globalRestore(Bool val)
+{
+}
+
+Uint16 uart_read(Uint8 *data, Uint16 length)
+{
+ Uint16 count = 0;
+
+ while ( count < length && rx_index < rx_count )
+   {
+    data[count++] = rx_buffer[rx_index++];
+   }
+
+ return count;
+}
+
+Int16 uart_write(const Uint8 *data, Uint16 length)
+{
+ if ( write(master, data, length) != length )
+   {
+    return UART_FULL;
+   }
+
+ uart_stats.tx_bytes += length;
+ return 0;
+}
+
+Int16 aic3204_volume_async(Int16 volume, I2C_Callback callback,
+                           void *context)
+{
+ printf("Codec: DAC volume %d (%.1f dB)\n", volume, volume / 2.0);
+ return 0;
+}
+
+Int16 aic3204_mute_async(Uint16 mute, I2C_Callback callback, void *context)
+{
+ printf("Codec: DAC %s\n", mute ? "muted" : "not muted");
+ return 0;
+}
+
+/*****************************************************************************/
+/* send_log_frame()                                                          */
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/* A frame as log.c makes it.                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static void send_log_frame(Uint16 id, Uint32 ticks, Uint32 argument)
+{
+ Uint8 frame[LOG_FRAME_BYTES];
+ Uint32 values[2 + LOG_ARGS];
+ Uint16 bytes[2 + LOG_ARGS] = { 2, 4, 4, 4, 4 };
+ Uint16 sum = 0;
+ Uint16 n = 0;
+ Uint16 i;
+ Uint16 j;
+
+ values[0] = id;
+ values[1] = ticks;
+ values[2] = argument;
+ values[3] = 0;
+ values[4] = 0;
+
+ frame[n++] = LOG_SYNC;
+
+ for ( i = 0 ; i < 2 + LOG_ARGS ; i++)
+   {
+    for ( j = 0 ; j < bytes[i] ; j++)
+      {
+       frame[n] = ( values[i] >> ( 8 * j ) ) & 0xFF;
+       sum += frame[n++];
+      }
+   }
+
+ frame[n++] = ( 0x100 - ( sum & 0xFF ) ) & 0xFF;
+ (void) uart_write(frame, n);
+}
+
+/*****************************************************************************/
+/* main()                                                                    */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+ struct termios tio;
+ struct timeval timeout;
+ fd_set readable;
+ unsigned long ms = 0;
+ unsigned long stop_ms = 0;
+ unsigned int seconds = 0;
+ Uint16 last_step = 0;
+ Uint16 last_filter = IIR_LOW_PASS_4800HZ;
+ ssize_t got;
+
+ if ( argc > 1 )
+   {
+    stop_ms = strtoul(argv[1], NULL, 0) * 1000;
+   }
+
+ master = posix_openpt(O_RDWR | O_NOCTTY);
+
+ if ( master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 )
+   {
+    perror("pseudo terminal");
+    return 1;
+   }
+
+ /* Raw bytes, as on the UART */
+
+ tcgetattr(master, &tio);
+ cfmakeraw(&tio);
+ tcsetattr(master, TCSANOW, &tio);
+
+ printf("%s\n", ptsname(master));
+ fflush(stdout);
+
+ for ( ms = 1 ; 0 == stop_ms || ms <= stop_ms ; ms++)
+   {
+    FD_ZERO(&readable);
+    FD_SET(master, &readable);
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    if ( rx_index == rx_count
+         && select(master + 1, &readable, NULL, NULL, &timeout) > 0 )
+      {
+       got = read(master, rx_buffer, sizeof(rx_buffer));
+
+       /* An error while no client has the slave side open */
+
+       if ( got <= 0 )
+         {
+          got = 0;
+          usleep(1000);
+         }
+
+       rx_count = got;
+       rx_index = 0;
+       uart_stats.rx_bytes += rx_count;
+      }
+    else if ( rx_index < rx_count )
+      {
+       usleep(1000);
+      }
+
+    command_task(NULL);
+
+    if ( Step != last_step )
+      {
+       printf("Step %u\n", Step);
+       last_step = Step;
+      }
+
+    if ( low_pass_filter != last_filter )
+      {
+       printf("Low pass %u Hz\n", IIR_low_pass_cutoffs[low_pass_filter]);
+       last_filter = low_pass_filter;
+      }
+
+    if ( 0 == ms % 1000 )
+      {
+       send_log_frame(LOG_CLOCK, ms * TICKS_PER_MS, TICKS_PER_MS);
+
+       if ( auto_switch && ++seconds >= switch_secs )
+         {
+          seconds = 0;
+          Step = ++playnum % 2;
+         }
+      }
+
+    fflush(stdout);
+   }
+
+ return 0;
+}
+
+/*****************************************************************************/
+/* End of uart_pty.c                                                         */
+/*****************************************************************************/